@@ -1,30 +1,283 @@
+import argparse
+import math
+import re
 import socket
+import struct
+import threading
 import time
 
 # 模拟 UR 机械臂的 IP (本机) 和端口
 HOST = '127.0.0.1'
 PORT = 30003
 
-server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
-server.bind((HOST, PORT))
-server.listen(1)
+# 30003 实时接口: int32 包长 + 138 个 double，全部大端，共 1108 字节 (CB3.5 格式)
+PACKET_DOUBLES = 138
+PACKET_BYTES = 4 + 8 * PACKET_DOUBLES
 
-print(f"🤖 假机械臂已启动，正在监听 {HOST}:{PORT} ...")
+# 字段在 double 数组中的下标 (= (字节偏移 - 4) / 8)
+IDX_TIME = 0
+IDX_Q_TARGET = 1
+IDX_QD_TARGET = 7
+IDX_Q_ACTUAL = 31
+IDX_QD_ACTUAL = 37
+IDX_TOOL_VECTOR = 55
+IDX_TCP_SPEED = 61
+IDX_TOOL_VECTOR_TARGET = 73
+IDX_ROBOT_MODE = 94
+IDX_SAFETY_MODE = 101
+IDX_SPEED_SCALING = 117
+IDX_PROGRAM_STATE = 131
 
-while True:
+parser = argparse.ArgumentParser(description="模拟 UR 控制器: 接收 URScript，并按实时接口格式推送状态包")
+parser.add_argument('--rate', type=float, default=125.0, help="状态包频率 Hz (CB3: 125, e-Series: 500)")
+parser.add_argument('--drop-every', type=int, default=0, help="每 N 个包故意丢一个，用于验证丢包统计 (0 = 不丢)")
+args = parser.parse_args()
+
+# 简化的运动学仿真 (所有连接共享): 只模拟 TCP 位置，够用来验证指令链路和对比执行时间
+#   speedl / stopl: TCP 速度以加速度 a 趋近目标速度
+#   movel / movep:  沿路径点直线运动，梯形速度；r=0 的点要停稳，r>0 的点不减速直接通过
+#   新程序 (def ... end 或单行 move) 会打断正在执行的运动，和真实控制器一致
+MOVE_RE = re.compile(r'(movel|movep)\(p\[([^\]]*)\]\s*,\s*a=([-\d.eE+]+)\s*,\s*v=([-\d.eE+]+)\s*(?:,\s*r=([-\d.eE+]+))?')
+
+
+class Simulator:
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.t = 0.0
+        self.pose = [0.4, 0.0, 0.3, 0.0, 3.1416, 0.0]
+        self.vel = [0.0, 0.0, 0.0]
+        self.speed_target = [0.0, 0.0, 0.0]
+        self.speed_acc = 0.5
+        self.path = []          # [(xyz, a, v, r)]
+        self.path_speed = 0.0
+
+    def run_speed(self, values, acc):
+        with self.lock:
+            self.path = []
+            self.speed_target = (values + [0.0] * 3)[:3]
+            self.speed_acc = acc
+
+    def run_path(self, moves):
+        with self.lock:
+            self.path = moves
+            self.speed_target = [0.0, 0.0, 0.0]
+            self.path_speed = math.sqrt(sum(v * v for v in self.vel))
+            if moves and len(moves[-1][4]) == 3:
+                self.pose[3:6] = moves[-1][4]
+
+    def step(self, dt):
+        with self.lock:
+            self.t += dt
+            if self.path:
+                self._step_path(dt)
+            else:
+                # 速度模式: 每个分量以加速度限制趋近目标
+                dv = self.speed_acc * dt
+                for i in range(3):
+                    diff = self.speed_target[i] - self.vel[i]
+                    self.vel[i] += max(-dv, min(dv, diff))
+                    self.pose[i] += self.vel[i] * dt
+
+    def _step_path(self, dt):
+        # 已经在位的点直接跳过 (例如第一个点就是当前位置)
+        while self.path and dist(self.pose[:3], self.path[0][0]) < 1e-6 and self.path[0][3] == 0.0 and self.path_speed < 1e-9:
+            self.path.pop(0)
+        if not self.path:
+            self.vel = [0.0, 0.0, 0.0]
+            return
+        xyz, a, v, r, _ = self.path[0]
+        # 到下一个必须停稳的点还剩多远
+        remaining = dist(self.pose[:3], xyz)
+        prev = xyz
+        for (p, _, _, rr, _) in self.path:
+            if p is xyz:
+                if r == 0.0:
+                    break
+                continue
+            remaining += dist(prev, p)
+            prev = p
+            if rr == 0.0:
+                break
+        s = min(v, self.path_speed + a * dt, math.sqrt(2.0 * a * remaining))
+        self.path_speed = s
+        travel = s * dt
+        while self.path and travel > 0.0:
+            xyz = self.path[0][0]
+            d = dist(self.pose[:3], xyz)
+            if d <= travel or d < 1e-6:
+                self.pose[:3] = list(xyz)
+                travel -= d
+                self.path.pop(0)
+                if not self.path or self.path_speed < 1e-9:
+                    break
+            else:
+                for i in range(3):
+                    self.pose[i] += (xyz[i] - self.pose[i]) * travel / d
+                travel = 0.0
+        if self.path:
+            d = dist(self.pose[:3], self.path[0][0])
+            self.vel = [(self.path[0][0][i] - self.pose[i]) / d * s if d > 0 else 0.0 for i in range(3)]
+        else:
+            self.vel = [0.0, 0.0, 0.0]
+            self.path_speed = 0.0
+
+    def snapshot(self):
+        with self.lock:
+            target = self.vel if self.path else self.speed_target
+            return self.t, list(self.pose), list(self.vel), list(target)
+
+
+def dist(a, b):
+    return math.sqrt(sum((a[i] - b[i]) ** 2 for i in range(3)))
+
+
+sim = Simulator()
+
+
+def parse_moves(lines):
+    moves = []
+    for line in lines:
+        m = MOVE_RE.search(line)
+        if not m:
+            continue
+        values = [float(v) for v in m.group(2).split(',')]
+        r = float(m.group(5)) if m.group(5) else 0.0
+        moves.append((values[:3], float(m.group(3)), float(m.group(4)), r, values[3:6]))
+    return moves
+
+
+class ScriptParser:
+    """按行拆分收到的数据；def ... end 收齐后作为一个程序执行"""
+    def __init__(self):
+        self.pending = ''
+        self.program = None
+
+    def feed(self, data):
+        self.pending += data
+        while '\n' in self.pending:
+            line, self.pending = self.pending.split('\n', 1)
+            self.line(line.strip())
+
+    def line(self, line):
+        if not line:
+            return
+        if self.program is not None:
+            if line == 'end':
+                moves = parse_moves(self.program)
+                print(f"📝 收到程序: {len(moves)} 个运动指令")
+                sim.run_path(moves)
+                self.program = None
+            else:
+                self.program.append(line)
+            return
+        if line.startswith('def '):
+            self.program = []
+            return
+        # 显示接收到的URScript命令
+        print(f"📝 收到命令: {line}")
+        if line.startswith('speedl(['):
+            try:
+                values = [float(v) for v in line[len('speedl(['):line.index(']')].split(',')]
+                acc = float(line[line.index(']') + 1:].split(',')[1])
+            except (ValueError, IndexError):
+                return
+            sim.run_speed(values, acc)
+        elif line.startswith('stopl(') or line.startswith('stopj('):
+            try:
+                acc = float(line[line.index('(') + 1:line.index(')')])
+            except ValueError:
+                acc = 0.5
+            sim.run_speed([0.0, 0.0, 0.0], acc)
+        elif line.startswith('movel(') or line.startswith('movep('):
+            sim.run_path(parse_moves([line]))
+
+
+def simulate():
+    period = 1.0 / args.rate
+    start = time.monotonic()
+    n = 0
+    while True:
+        n += 1
+        sim.step(period)
+        delay = start + n * period - time.monotonic()
+        if delay > 0:
+            time.sleep(delay)
+
+
+def make_packet():
+    """生成一帧状态: TCP 来自仿真，关节做缓慢的正弦运动，方便在界面上看到数值变化"""
+    t, pose, vel, target = sim.snapshot()
+    d = [0.0] * PACKET_DOUBLES
+    d[IDX_TIME] = t
+    d[IDX_QD_TARGET:IDX_QD_TARGET + 3] = target
+    for j in range(6):
+        q = 0.3 * math.sin(0.5 * t + j)
+        qd = 0.15 * math.cos(0.5 * t + j)
+        d[IDX_Q_TARGET + j] = q
+        d[IDX_Q_ACTUAL + j] = q
+        d[IDX_QD_ACTUAL + j] = qd
+    d[IDX_TOOL_VECTOR:IDX_TOOL_VECTOR + 6] = pose
+    d[IDX_TCP_SPEED:IDX_TCP_SPEED + 3] = vel
+    d[IDX_TOOL_VECTOR_TARGET:IDX_TOOL_VECTOR_TARGET + 6] = pose
+    d[IDX_ROBOT_MODE] = 7.0         # RUNNING
+    d[IDX_SAFETY_MODE] = 1.0        # NORMAL
+    d[IDX_SPEED_SCALING] = 1.0
+    d[IDX_PROGRAM_STATE] = 1.0
+    return struct.pack('>i%dd' % PACKET_DOUBLES, PACKET_BYTES, *d)
+
+
+def stream_state(conn, stop):
+    """按固定频率推送状态包 (按绝对时刻排期，避免累积漂移)"""
+    period = 1.0 / args.rate
+    start = time.monotonic()
+    n = 0
+    while not stop.is_set():
+        n += 1
+        t = n * period
+        if not (args.drop_every and n % args.drop_every == 0):
+            try:
+                conn.sendall(make_packet())
+            except OSError:
+                break
+        delay = start + t - time.monotonic()
+        if delay > 0:
+            time.sleep(delay)
+
+
+def handle(conn, addr):
+    print(f"✅ Qt程序已连接: {addr}")
+    stop = threading.Event()
+    sender = threading.Thread(target=stream_state, args=(conn, stop), daemon=True)
+    sender.start()
+    parser = ScriptParser()
     try:
-        conn, addr = server.accept()
-        print(f"✅ Qt程序已连接: {addr}")
-        
         # 保持连接，直到 Qt 断开
         while True:
-            data = conn.recv(1024)
+            data = conn.recv(4096)
             if not data:
                 break
-            # 显示接收到的URScript命令
-            command = data.decode('utf-8').strip()
-            print(f"📝 收到命令: {command}")
-        print("❌ Qt程序已断开")
-        conn.close()
+            parser.feed(data.decode('utf-8', errors='replace'))
+    except OSError as e:
+        print(e)
+    stop.set()
+    sender.join()
+    print(f"❌ Qt程序已断开: {addr}")
+    conn.close()
+
+
+server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+server.bind((HOST, PORT))
+server.listen(4)
+
+threading.Thread(target=simulate, daemon=True).start()
+
+print(f"🤖 假机械臂已启动，正在监听 {HOST}:{PORT} | 状态包 {PACKET_BYTES} 字节 @ {args.rate:.0f} Hz ...")
+
+# 真实控制器允许多个客户端同时连接 30003 (程序会开一条发指令、一条收状态)
+while True:
+    try:
+        conn, addr = server.accept()
+        threading.Thread(target=handle, args=(conn, addr), daemon=True).start()
     except Exception as e:
-        print(e)
\ No newline at end of file
+        print(e)
@@ -1,12 +1,30 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 #include "platform/CameraHelper.h"
+#include "tools/Camera/MultiCamViewer.h"
+#include "tools/Trace/LatencyTrace.h"
 #include <QTcpSocket>
+#include <QShortcut>
 #include <QMessageBox>       // 用于展示信息框
 #include <QDateTime>         // 用于生成唯一的文件名
 #include <QDebug>
 #include <QNetworkProxy>
 
+namespace {
+// 指令通道延迟统计 (拼到连接状态的提示里)
+QString motionStatsText(const MotionChannelStats &ms)
+{
+    return QString("\n指令通道: %1 | 重连 %2\n"
+                   "指令: 已发 %3 | 合并 %4 | 被停止作废 %5 | 丢弃 %6 | 未连接拒绝 %7 | 写失败 %8\n"
+                   "排队延迟 平均 %9 / 最大 %10 ms | 响应延迟 平均 %11 / 最大 %12 ms (响应 %13, 超时 %14)")
+        .arg(ms.connected ? "已连接" : "重连中").arg(ms.reconnects)
+        .arg(ms.sent).arg(ms.coalesced).arg(ms.preempted).arg(ms.dropped).arg(ms.rejected).arg(ms.sendErrors)
+        .arg(ms.queueMsAvg, 0, 'f', 3).arg(ms.queueMsMax, 0, 'f', 3)
+        .arg(ms.echoMsAvg, 0, 'f', 1).arg(ms.echoMsMax, 0, 'f', 1)
+        .arg(ms.echoed).arg(ms.echoTimeouts);
+}
+}
+
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
@@ -25,6 +43,9 @@ MainWindow::MainWindow(QWidget *parent)
     connect(m_socket, &QTcpSocket::connected, this, &MainWindow::onSocketConnected);
     connect(m_socket, &QTcpSocket::disconnected, this, &MainWindow::onSocketDisconnected);
     connect(m_socket, &QTcpSocket::errorOccurred, this, &MainWindow::onSocketError);
+    // 30003 会持续推送状态包；这条连接只发指令，收到的数据直接丢弃，避免接收缓冲区无限增长
+    // (状态由 RobotStateReceiver 另开连接、在后台线程解码)
+    connect(m_socket, &QTcpSocket::readyRead, this, [=](){ m_socket->skip(m_socket->bytesAvailable()); });
     // 机械臂控制信号与槽连接
     connect(ui->btn_X_Plus, &QPushButton::pressed, this, [=](){ onJogBtnPressed(0, 1); });
     connect(ui->btn_X_Plus, &QPushButton::released, this, &MainWindow::onJogBtnReleased);
@@ -52,33 +73,48 @@ MainWindow::MainWindow(QWidget *parent)
     int cameraCount = 4;
 
     for(int i = 0; i < cameraCount; i++){
-        cv::VideoCapture cap = createCamera(i);
-        if(cap.isOpened()){
+        // 即使打不开，也要压入一个对象占位，防止后面数组越界
+        // 相机由代理打开并启动采集线程 (每路一个，互不阻塞)；工具窗口再订阅同一路不会重复打开设备
+        auto cam = CameraBroker::instance().subscribe(i);
+        if(cam->isOpened()){
             // 打印最终实际获取到的分辨率 (用于验证)
-            double actualW = cap.get(cv::CAP_PROP_FRAME_WIDTH);
-            double actualH = cap.get(cv::CAP_PROP_FRAME_HEIGHT);
-            qDebug() << "✅ 相机" << i << "初始化成功 | 分辨率:" << actualW << "x" << actualH;
-
-            m_cams.push_back(cap);
-        } else {
-            m_cams.push_back(cv::VideoCapture());     // 即使打不开，也要压入一个空对象占位，防止后面数组越界
-        } 
-
-        m_currentFrames.push_back(cv::Mat());
+            cv::Size actual = cam->frameSize();
+            qDebug() << "✅ 相机" << i << "初始化成功 | 分辨率:" << actual.width << "x" << actual.height;
+        }
+        m_cams.push_back(std::move(cam));
     }
+    m_previews.resize(m_cams.size());
+    m_recorder = std::make_unique<FrameRecorder>();
 
     // 启动定时器
     m_timer = new QTimer(this);
     connect(m_timer, &QTimer::timeout, this, &MainWindow::updateFrames);
-    m_timer->start(33); // 33ms ≈ 30 FPS
+    m_timer->start(33); // 33ms ≈ 30 FPS (只负责显示，采集由各相机线程完成)
+
+    // 延迟覆盖层: F9 开关 (同时开关埋点)，F10 导出 trace；启动时设了 UR_TRACE=1 则默认显示
+    m_traceOverlay = new QLabel(this);
+    m_traceOverlay->setStyleSheet("QLabel { background-color: rgba(0, 0, 0, 160); color: #7CFC00;"
+                                  " font-family: monospace; padding: 6px; }");
+    m_traceOverlay->setAttribute(Qt::WA_TransparentForMouseEvents);
+    m_traceOverlay->move(10, 10);
+    m_traceOverlay->setVisible(LatencyTrace::enabled());
+    connect(new QShortcut(QKeySequence(Qt::Key_F9), this), &QShortcut::activated,
+            this, &MainWindow::toggleTraceOverlay);
+    connect(new QShortcut(QKeySequence(Qt::Key_F10), this), &QShortcut::activated,
+            this, &MainWindow::dumpTrace);
+    connect(new QShortcut(QKeySequence(Qt::Key_F8), this), &QShortcut::activated,
+            this, &MainWindow::showCameraViewer);
 }
 
 MainWindow::~MainWindow()
 {
-    // 程序关闭前释放相机资源
-    for(auto &cap : m_cams){
-        if(cap.isOpened()) cap.release();
-    }
+    // 程序关闭前停止采集线程并释放相机资源
+    m_timer->stop();
+    delete m_camViewer;     // 工具窗口的订阅先退订
+    m_recorder.reset();     // 录像轮询线程引用了相机，先停录像 (会等已提交的帧写完)
+    m_motion.reset();       // 指令通道引用了状态流，先停
+    m_robotState.reset();
+    m_cams.clear();         // 最后一个订阅者退订，代理停止采集线程、关闭设备
 
     delete ui;
 }
@@ -123,6 +159,15 @@ void MainWindow::onSocketConnected()
 
     ui->btn_Connect->setText("断开连接");
     ui->btn_Connect->setEnabled(true);      // 按钮可以按下
+
+    // 另开一条连接接收实时状态，解码在后台线程完成，界面只读最新快照
+    m_robotState = std::make_unique<RobotStateReceiver>(m_socket->peerName(), m_socket->peerPort());
+    m_robotState->start();
+
+    // 指令也走独立连接和线程，界面卡顿不会推迟停止指令
+    m_motion = std::make_unique<MotionCommandChannel>(m_socket->peerName(), m_socket->peerPort());
+    m_motion->setStateSource(m_robotState.get());
+    m_motion->start();
 }
 
 // 断开连接槽函数
@@ -133,6 +178,11 @@ void MainWindow::onSocketDisconnected()
 
     ui->btn_Connect->setText("连接");
     ui->btn_Connect->setEnabled(true);
+
+    m_motion.reset();
+    m_jogging = false;
+    m_robotState.reset();
+    ui->lbl_Status->setToolTip(QString());
 }
 
 // 连接错误槽函数
@@ -162,35 +212,113 @@ void MainWindow::updateFrames()
     // 遍历所有已管理的相机
     for(size_t i = 0; i < m_cams.size(); i++) {
 
-        if(m_cams[i].isOpened()) {
-            cv::Mat frame;
-            m_cams[i] >> frame; // 抓取一帧
+        if(m_cams[i]->isOpened()) {
+            // 从邮箱取本订阅还没显示过的最新帧，不会等待相机；没有新帧就跳过，保留上一次的画面
+            // MJPEG 压缩包按控件尺寸缩小解码 (同一帧同一倍数的解码结果和工具窗口共享)；截图时才从采集邮箱取原图全尺寸解码
+            CameraFrame frame;
+            cv::Mat image;
+            const QSize target = displayLabels[i]->size();
+            if(!m_cams[i]->nextImage(image, cv::Size(target.width(), target.height()), &frame)) continue;
+
+            // 再缩放到控件大小包装成 QImage，全分辨率原图不做任何拷贝
+            const QImage &qimg = m_previews[i].render(image, target);
+            displayLabels[i]->setPixmap(QPixmap::fromImage(qimg));
+            // 采集时间戳 -> 交给控件 (不含之后的重绘 / 合成)
+            if(frame.timestampNs > 0) UR_TRACE_SPAN("preview.display", frame.timestampNs, LatencyTrace::nowNs());
+        }
+    }
+
+    // 每秒刷新一次相机统计 (鼠标悬停在画面上可见)
+    qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    if(nowMs - m_lastStatsMs >= 1000) {
+        m_lastStatsMs = nowMs;
+        for(size_t i = 0; i < m_cams.size(); i++) {
+            if(!m_cams[i]->isOpened()) continue;
+            CaptureStats st = m_cams[i]->stats();
+            CameraShareStats share = m_cams[i]->shareStats();
+            displayLabels[i]->setToolTip(QString("相机%1 | FPS: %2 | 已采集: %3 | 丢帧: %4 | 读取失败: %5\n"
+                                                 "内存分配: 采集 %6 次 / 预览 %7 次 (共 %8 帧)\n"
+                                                 "订阅者 %9 | 解码 %10 次 / 共享 %11 次")
+                                             .arg(i+1).arg(st.fps, 0, 'f', 1)
+                                             .arg(st.captured).arg(st.dropped).arg(st.readErrors)
+                                             .arg(st.allocations).arg(m_previews[i].allocations())
+                                             .arg(m_previews[i].frames())
+                                             .arg(share.subscribers).arg(share.decodes).arg(share.sharedDecodes));
+        }
 
-            if(!frame.empty()) {
-                // 1. 存入缓存（必须存原始 BGR 数据，用于保存图片）
-                m_currentFrames[i] = frame.clone();
+        // 录像统计 (鼠标悬停在录像按钮上可见)
+        RecorderStats rec = m_recorder->stats();
+        if(!ui->btn_Record->isEnabled() && !m_recorder->isRecording() && !m_recorder->isFinishing()) {
+            ui->btn_Record->setText("开始录像");    // 上一次录像已经收尾
+            ui->btn_Record->setEnabled(true);
+        }
+        ui->btn_Record->setToolTip(QString("录像: 写入 %1 帧 (%2 MB, %3 个分段) | 丢帧 %4 | 排队 %5 帧\n"
+                                           "MJPEG 原样写入 %6 帧 | 编码 %7 ms/帧 | 截图 %8 张 | 错误 %9")
+                                       .arg(rec.written).arg(rec.bytesWritten / 1048576.0, 0, 'f', 1)
+                                       .arg(rec.segments).arg(rec.dropped).arg(rec.queued)
+                                       .arg(rec.passthrough).arg(rec.encodeMsAvg, 0, 'f', 2)
+                                       .arg(rec.snapshots).arg(rec.errors));
+
+        // 机械臂实时状态 (鼠标悬停在连接状态上可见)
+        RobotState rs;
+        if(m_robotState && m_robotState->latest(rs)) {
+            StateStreamStats ss = m_robotState->stats();
+            ui->lbl_Status->setToolTip(QString("TCP: X %1  Y %2  Z %3 (mm) | RX %4  RY %5  RZ %6\n"
+                                               "状态流: %7 Hz | 抖动 %8 ms | 最大间隔 %9 ms | 丢包 %10 | 错帧 %11 | 重连 %12")
+                                           .arg(rs.tcpPose[0] * 1000, 0, 'f', 1)
+                                           .arg(rs.tcpPose[1] * 1000, 0, 'f', 1)
+                                           .arg(rs.tcpPose[2] * 1000, 0, 'f', 1)
+                                           .arg(rs.tcpPose[3], 0, 'f', 3)
+                                           .arg(rs.tcpPose[4], 0, 'f', 3)
+                                           .arg(rs.tcpPose[5], 0, 'f', 3)
+                                           .arg(ss.rateHz, 0, 'f', 1)
+                                           .arg(ss.jitterMs, 0, 'f', 2)
+                                           .arg(ss.maxIntervalMs, 0, 'f', 1)
+                                           .arg(ss.gaps).arg(ss.framingErrors).arg(ss.reconnects)
+                                       + (m_motion ? motionStatsText(m_motion->stats()) : QString()));
+        }
 
-                // 2. 转换并显示
-                QImage qimg = matToQImage(frame);
-                displayLabels[i]->setPixmap(QPixmap::fromImage(qimg));
-            }
+        // 延迟覆盖层
+        if(m_traceOverlay->isVisible()) {
+            const std::string summary = LatencyTrace::summaryText();
+            m_traceOverlay->setText("延迟 (p50 / p99)  F9 关闭 | F10 导出\n"
+                                    + (summary.empty() ? QString("暂无数据") : QString::fromStdString(summary)));
+            m_traceOverlay->adjustSize();
+            m_traceOverlay->raise();
         }
     }
 }
 
-// 辅助函数：Mat (OpenCV) -> QImage (Qt)
-QImage MainWindow::matToQImage(const cv::Mat &mat)
+// F9: 打开时清零统计，从现在开始记录
+void MainWindow::toggleTraceOverlay()
 {
-    // 1. 颜色转换 BGR -> RGB
-    cv::Mat rgb;
-    cv::cvtColor(mat, rgb, cv::COLOR_BGR2RGB);
+    const bool on = !m_traceOverlay->isVisible();
+    if(on) LatencyTrace::reset();
+    LatencyTrace::setEnabled(on);
+    m_traceOverlay->setText("延迟 (p50 / p99)  等待数据...");
+    m_traceOverlay->adjustSize();
+    m_traceOverlay->setVisible(on);
+    m_traceOverlay->raise();
+}
 
-    // 2. 构造 QImage
-    QImage img((const uchar*)rgb.data, rgb.cols, rgb.rows, rgb.step, QImage::Format_RGB888);
+// F8: 工具箱 多相机监视器 (非模态；打开时订阅相机，关闭时退订，和主界面共享同一组设备)
+void MainWindow::showCameraViewer()
+{
+    if(!m_camViewer) m_camViewer = new MultiCamViewer(this);
+    m_camViewer->show();
+    m_camViewer->raise();
+    m_camViewer->activateWindow();
+}
 
-    // 3. 重要：深拷贝
-    // 必须 copy()，因为 rgb 是局部变量，函数结束后内存会被释放
-    return img.copy();
+// F10: 导出各线程最近的事件，chrome://tracing 或 Perfetto 打开
+void MainWindow::dumpTrace()
+{
+    QString filename = QString("Trace_%1.json").arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+    if(LatencyTrace::writeChromeTrace(filename.toStdString())) {
+        ui->lbl_Status->setText("延迟 trace 已导出: " + filename);
+    } else {
+        QMessageBox::warning(this, "警告", "trace 导出失败: " + filename);
+    }
 }
 
 // 截图保存按钮
@@ -200,51 +328,75 @@ void MainWindow::on_btn_Capture_clicked()
     QString timestamp = QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
     bool savedAny = false;
 
-    for(size_t i = 0; i < m_currentFrames.size(); i++) {
-        if(!m_currentFrames[i].empty()) {
+    for(size_t i = 0; i < m_cams.size(); i++) {
+        // 直接取采集邮箱里的最新原图 (只增加引用计数，不拷贝)
+        CameraFrame frame;
+        if(m_cams[i]->isOpened() && m_cams[i]->latestFrame(frame)) {
             // 文件名示例: Cam1_20251217_203000.jpg
             QString filename = QString("Cam%1_%2.jpg").arg(i+1).arg(timestamp);
 
-            // 使用 OpenCV 保存图片 (质量好，且兼容性强)
-            // 注意：imwrite 需要 std::string
-            cv::imwrite(filename.toStdString(), m_currentFrames[i]);
-
-            qDebug() << "已保存:" << filename;
-            savedAny = true;
+            // 只入队，编码和写盘在录像器的后台线程完成 (MJPEG 压缩包原样保存，不用重新编码)
+            if(m_recorder->saveSnapshot(filename.toStdString(), frame)) {
+                qDebug() << "已提交截图:" << filename;
+                savedAny = true;
+            } else {
+                qDebug() << "⚠️ 截图队列已满，丢弃:" << filename;
+            }
         }
     }
 
     if(savedAny) {
         // 状态栏提示一下即可，不弹窗打扰操作
-        ui->lbl_Status->setText("截图已保存至运行目录");
+        ui->lbl_Status->setText("截图已提交，后台保存至运行目录");
     } else {
         QMessageBox::warning(this, "警告", "当前没有图像数据，无法保存！");
     }
 }
 
-// 机械臂控制
-// 1. 指令发送函数
-void MainWindow::sendURScript(QString cmd)
+// 录像按钮: 开始 / 停止连续录像
+void MainWindow::on_btn_Record_clicked()
 {
-    if(m_socket->state() != QAbstractSocket::ConnectedState) {
-        qDebug() << "⚠️ 未连接机械臂，指令发送失败";
+    if(m_recorder->isRecording()) {
+        // 不在界面线程等落盘 (排队的帧和写缓冲可能要几秒)，写线程写完索引后由统计定时器恢复按钮
+        m_recorder->requestStop();
+        ui->btn_Record->setText("正在写入...");
+        ui->btn_Record->setEnabled(false);
         return;
     }
+    if(m_recorder->isFinishing()) return;
 
-    // URScript 必须以换行符 '\n' 结尾，否则机器不执行
-    cmd.append("\n");
-
-    QByteArray data = cmd.toUtf8();
-    qint64 bytesWritten = m_socket->write(data);
+    // 只录已打开的相机；多路时按采集时间戳对齐成组写入，之后可以按时间同时定位各路画面
+    std::vector<const CameraCapture*> sources;
+    for(const auto &cam : m_cams) {
+        if(cam->isOpened()) sources.push_back(&cam->capture());
+    }
+    if(sources.empty()) {
+        QMessageBox::warning(this, "警告", "没有可用的相机，无法录像！");
+        return;
+    }
 
-    if(bytesWritten == -1) {
-        qDebug() << "⚠️ 写入失败";
+    RecordingOptions options;
+    options.aligned = sources.size() > 1;
+    // 文件示例: Rec_20251217_203000_000.urrec, Rec_20251217_203000_001.urrec ...
+    QString base = QString("Rec_%1").arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+    if(!m_recorder->startRecording(base.toStdString(), options, sources)) {
+        QMessageBox::warning(this, "警告", "无法创建录像文件！");
         return;
-    } else if(bytesWritten != data.size()) {
-        qDebug() << "⚠️ 写入部分数据，实际写入" << bytesWritten << "字节";
+    }
+    ui->btn_Record->setText("停止录像");
+}
+
+// 机械臂控制
+// 1. 指令发送函数 (只入队，格式化和写 socket 在指令通道线程完成)
+void MainWindow::sendURScript(QString cmd)
+{
+    if(!m_motion || !m_motion->isConnected()) {
+        qDebug() << "⚠️ 指令通道未连接，指令发送失败";
         return;
-    } else {
-        m_socket->flush();  // 确保立即发送缓冲区数据
+    }
+
+    if(m_motion->sendScript(cmd.toUtf8()) == 0) {
+        qDebug() << "⚠️ 指令没有入队 (队列已满或通道刚断开)，丢弃:" << cmd;
     }
 }
 
@@ -257,26 +409,39 @@ void MainWindow::onJogBtnPressed(int axis, int direction)
     double speeds[6] = {0, 0, 0, 0, 0, 0};
     speeds[axis] = direction * MOVE_VEL;
 
-    // 拼接 URScript 字符串: speedl([x,y,z,rx,ry,rz], a, t)
-    // t 设置为 100秒，意味着“一直动下去”，直到发 stopl
-    QString script = QString("speedl([%1, %2, %3, 0, 0, 0], %4, 100)")
-                         .arg(speeds[0]).arg(speeds[1]).arg(speeds[2])
-                         .arg(MOVE_ACC);
+    // 指令通道断线重连期间不允许点动: 松开按钮时的 stopl 也发不出去
+    if(!m_motion || !m_motion->isConnected()) {
+        qDebug() << "⚠️ 指令通道未连接，不能点动";
+        ui->lbl_Status->setText("指令通道未连接，不能点动");
+        return;
+    }
 
-    qDebug() << "📤 发送指令:" << script;
-    sendURScript(script);
+    // speedl([Vx, Vy, Vz, 0, 0, 0], a, t): t 设置为 100秒，意味着“一直动下去”，直到发 stopl
+    // 连续触发时，还没发出的旧速度会被新速度覆盖
+    qDebug() << "📤 点动: 轴" << axis << "方向" << direction;
+    if(m_motion->sendSpeed(speeds, MOVE_ACC, 100) == 0) {
+        qDebug() << "⚠️ 指令通道刚断开，点动没有发出";
+        return;
+    }
+    m_jogging = true;
 }
 
 // 3. 实现松开按钮（立即停止）
 void MainWindow::onJogBtnReleased()
 {
-    // stopl(a): 线性停止
-    QString script = QString("stopl(%1)").arg(MOVE_ACC);
+    const bool wasJogging = m_jogging;
+    m_jogging = false;
+    if(!m_motion) return;
 
+    // stopl(a): 线性停止；优先级最高，并作废尚未发出的速度指令
     qDebug() << "🛑 发送停止";
-    sendURScript(script);
+    if(m_motion->sendStop(MOVE_ACC) == 0 && wasJogging) {
+        // 点动过程中通道断线: 停止指令会在重连后第一个发出，但机械臂现在可能还在按之前的速度运动
+        qDebug() << "❌ 停止指令没能发出 (指令通道未连接)";
+        ui->lbl_Status->setText("停止指令未送达！");
+        ui->lbl_Status->setStyleSheet("color: darkred; font-weight: bold;");
+        QMessageBox::critical(this, "停止失败",
+                              "指令通道已断开，停止指令没能发出 (重连后会自动补发)。\n"
+                              "机械臂可能仍在运动，请立即使用示教器急停！");
+    }
 }
-
-
-
-
@@ -5,10 +5,18 @@
 #include <QAbstractSocket>      // 引入Socket错误枚举
 #include <QTimer>               // 定时器
 #include <opencv2/opencv.hpp>   // OpenCV头文件
-#include "tools/YoloDetector.h"  // 引入螺母检测工具
+#include <memory>
+#include "tools/Detector/YoloDetector.h"  // 引入螺母检测工具
+#include "tools/Camera/CameraBroker.h"    // 相机代理: 每路相机只打开一次，界面 / 工具窗口共享
+#include "tools/Camera/PreviewRenderer.h" // 零拷贝预览渲染
+#include "tools/Camera/FrameRecorder.h"   // 异步截图 / 连续录像
+#include "tools/Robot/RobotStateReceiver.h" // 实时状态流后台接收
+#include "tools/Robot/MotionCommandChannel.h" // 运动指令后台发送
 
 
 class QTcpSocket;   // 前置声明
+class QLabel;
+class MultiCamViewer;
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -35,6 +43,7 @@ private slots:
     // 相机画面显示及保存
     void updateFrames();            // 定时器触发：读取并显示画面
     void on_btn_Capture_clicked();  // 按钮触发：保存图片
+    void on_btn_Record_clicked();   // 按钮触发：开始 / 停止录像
 
     // 机械臂控制
     void sendURScript(QString emd); // 通用指令发送函数
@@ -42,19 +51,29 @@ private slots:
     void onJogBtnPressed(int axis, int direction);  // axis: 0=X, 1=Y, 2=Z; direction: 1=正, -1=负
     void onJogBtnReleased();
 
+    // 延迟埋点
+    void toggleTraceOverlay();      // F9: 开关埋点和延迟覆盖层
+    void dumpTrace();               // F10: 导出 Chrome trace JSON
+
+    void showCameraViewer();        // F8: 工具箱 多相机监视器
+
 private:
     Ui::MainWindow *ui;
 
     // 创建指针；成员变量加 m_ 前缀，一眼看出这是成员变量，不是局部变量
     QTcpSocket *m_socket;   // TCP通讯
+    std::unique_ptr<RobotStateReceiver> m_robotState;   // 30003 实时状态 (独立连接 + 独立线程)
+    std::unique_ptr<MotionCommandChannel> m_motion;     // 运动指令 (独立连接 + 独立线程，停止指令优先)
+    bool m_jogging = false;                             // 点动速度已入队，松开按钮时必须确认停止送达
 
     // 视觉相关变量
     QTimer *m_timer;                        // 负责刷新画面的定时器
-    std::vector<cv::VideoCapture> m_cams;   // 管理所有相机对象
-    std::vector<cv::Mat> m_currentFrames;   // 缓存当前的原始画面（用于保存）
-
-    // 辅助函数：将 OpenCV 的 Mat (BGR) 转为 Qt 的 QImage (RGB)
-    QImage matToQImage(const cv::Mat &mat);
+    std::vector<std::unique_ptr<CameraSubscription>> m_cams; // 每路相机的订阅 (采集线程由相机代理管理)
+    std::vector<PreviewRenderer> m_previews;// 每路相机的预览渲染器 (缓冲区复用)
+    std::unique_ptr<FrameRecorder> m_recorder; // 截图 / 录像在后台编码、写盘，不卡界面
+    qint64 m_lastStatsMs = 0;               // 上次刷新相机统计的时间
+    QLabel *m_traceOverlay = nullptr;       // 各探针 p50 / p99 (半透明，叠在画面上)
+    MultiCamViewer *m_camViewer = nullptr;  // 多相机监视器 (第一次打开时创建，和主界面共享相机)
 
     // 预定义速度和加速度
     const double MOVE_ACC = 0.5;    // m/s^2
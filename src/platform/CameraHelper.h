@@ -3,6 +3,8 @@
 
 #include <opencv2/opencv.hpp>
 #include <QDebug>
+#include <cstdint>
+#include <memory>
 
 /**
  * @brief 跨平台相机初始化函数
@@ -11,4 +13,83 @@
  */
 cv::VideoCapture createCamera(int index);
 
+// 相机后端
+enum class CameraBackend {
+    OpenCV,     // cv::VideoCapture (Windows: DirectShow, Linux: CAP_V4L2)，所有平台可用
+    V4L2Native, // 仅 Linux: 原生 V4L2 mmap 流式采集，带驱动时间戳和帧序号
+    Playback    // 回放 FrameRecorder 录下的录像 (UR_CAMERA_PLAYBACK)，不需要相机硬件
+};
+
+/**
+ * @brief 相机数据源接口
+ * 采集线程只依赖这个接口，具体用 OpenCV 还是原生驱动由 createCameraSource() 决定。
+ */
+class CameraSource
+{
+public:
+    virtual ~CameraSource() = default;
+
+    virtual bool isOpened() const = 0;
+    virtual cv::Size frameSize() const = 0;
+
+    /**
+     * @brief 等待下一帧 (不解码)
+     * @param timestampNs 采集时间戳 (steady_clock / CLOCK_MONOTONIC 纳秒)；后端没有驱动时间戳时填 0
+     * @param sequence 驱动帧序号；后端不提供时填 0
+     */
+    virtual bool grab(int64_t& timestampNs, uint64_t& sequence) = 0;
+    // 把刚 grab 到的帧转换成 BGR 写入 bgr (尺寸不变时复用 bgr 的内存)
+    virtual bool retrieve(cv::Mat& bgr) = 0;
+
+    /**
+     * @brief 取出刚 grab 到的 MJPEG 压缩包，不解码 (解码推迟到消费者按需进行)
+     * @param packet 输出缓冲区 (容量够用时复用，不够时按驱动缓冲区大小重新分配)
+     * @param bytes 有效长度
+     * @return 后端不提供压缩数据 (OpenCV 后端 / 非 MJPEG 格式) 时返回 false，此时只能用 retrieve()
+     */
+    virtual bool retrievePacket(cv::Mat& packet, size_t& bytes) {
+        (void)packet;
+        (void)bytes;
+        return false;
+    }
+
+    virtual void release() = 0;
+};
+
+// OpenCV VideoCapture 后端 (所有平台通用，也是原生后端失败时的回退方案)
+class OpenCvCameraSource : public CameraSource
+{
+public:
+    explicit OpenCvCameraSource(cv::VideoCapture cap) : m_cap(cap) {}
+    ~OpenCvCameraSource() override { release(); }
+
+    bool isOpened() const override { return m_cap.isOpened(); }
+    cv::Size frameSize() const override;
+    bool grab(int64_t& timestampNs, uint64_t& sequence) override;
+    bool retrieve(cv::Mat& bgr) override;
+    void release() override;
+
+private:
+    cv::VideoCapture m_cap;
+};
+
+/**
+ * @brief 按指定后端创建相机数据源
+ * 原生后端在当前平台不可用或打开失败时，自动回退到 OpenCV (createCamera)；回放后端不回退。
+ * @param index 相机索引 (Linux 下对应 /dev/video<index>)
+ */
+std::unique_ptr<CameraSource> createCameraSource(int index, CameraBackend backend);
+
+/**
+ * @brief 默认后端: 读取环境变量 UR_CAMERA_BACKEND (opencv / v4l2 / playback)
+ * 未设置时: 设置了 UR_CAMERA_PLAYBACK 则为回放，否则为 OpenCV
+ */
+CameraBackend defaultCameraBackend();
+
+/**
+ * @brief 回放后端: 回放 UR_CAMERA_PLAYBACK 指定的录像 (FrameRecorder 的 basePath) 里的第 index 路
+ * 回放方式见 PlaybackOptions::fromEnvironment()；录像打不开时返回未打开的数据源
+ */
+std::unique_ptr<CameraSource> createPlaybackCameraSource(int index);
+
 #endif // CAMERAHELPER_H
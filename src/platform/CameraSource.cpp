@@ -0,0 +1,48 @@
+#include "CameraHelper.h"
+#include "tools/Camera/PlaybackCameraSource.h"
+#include <cstdlib>
+#include <cstring>
+
+// ================= OpenCV 通用后端 =================
+
+cv::Size OpenCvCameraSource::frameSize() const {
+    if (!m_cap.isOpened()) return cv::Size();
+    return cv::Size(static_cast<int>(m_cap.get(cv::CAP_PROP_FRAME_WIDTH)),
+                    static_cast<int>(m_cap.get(cv::CAP_PROP_FRAME_HEIGHT)));
+}
+
+bool OpenCvCameraSource::grab(int64_t& timestampNs, uint64_t& sequence) {
+    // VideoCapture 拿不到驱动时间戳，由调用者在 grab 返回时打时间戳
+    timestampNs = 0;
+    sequence = 0;
+    return m_cap.grab();
+}
+
+bool OpenCvCameraSource::retrieve(cv::Mat& bgr) {
+    return m_cap.retrieve(bgr) && !bgr.empty();
+}
+
+void OpenCvCameraSource::release() {
+    if (m_cap.isOpened()) m_cap.release();
+}
+
+// ================= 后端选择 =================
+
+CameraBackend defaultCameraBackend() {
+    const char *env = std::getenv("UR_CAMERA_BACKEND");
+    if (env && std::strcmp(env, "v4l2") == 0) return CameraBackend::V4L2Native;
+    if (env && std::strcmp(env, "playback") == 0) return CameraBackend::Playback;
+    if (!env && std::getenv("UR_CAMERA_PLAYBACK")) return CameraBackend::Playback;
+    return CameraBackend::OpenCV;
+}
+
+// ================= 录像回放后端 =================
+
+std::unique_ptr<CameraSource> createPlaybackCameraSource(int index) {
+    const char *base = std::getenv("UR_CAMERA_PLAYBACK");
+    if (!base || !*base) {
+        qDebug() << "❌ 回放后端需要设置 UR_CAMERA_PLAYBACK=<录像路径>";
+        return createPlaybackSource(index, std::string());
+    }
+    return createPlaybackSource(index, base, PlaybackOptions::fromEnvironment());
+}
@@ -1,4 +1,8 @@
 #include "../CameraHelper.h"
+#include "V4l2Camera.h"
+#include <linux/videodev2.h>
+#include <algorithm>
+#include <cstring>
 
 cv::VideoCapture createCamera(int index) {
     cv::VideoCapture cap;
@@ -17,3 +21,102 @@ cv::VideoCapture createCamera(int index) {
     }
     return cap;
 }
+
+// ================= 原生 V4L2 后端 =================
+
+namespace {
+
+class V4l2CameraSource : public CameraSource
+{
+public:
+    bool open(int index, const V4l2Camera::Config& config) {
+        return m_cam.open("/dev/video" + std::to_string(index), config);
+    }
+
+    bool isOpened() const override { return m_cam.isOpened(); }
+    cv::Size frameSize() const override { return cv::Size(m_cam.width(), m_cam.height()); }
+
+    bool grab(int64_t& timestampNs, uint64_t& sequence) override {
+        // 上一帧没有 retrieve 就直接还给驱动
+        if (m_holding) {
+            m_cam.requeue(m_buf);
+            m_holding = false;
+        }
+        if (!m_cam.dequeue(m_buf)) return false;
+        m_holding = true;
+        timestampNs = m_buf.timestampNs;
+        sequence = m_buf.sequence;
+        return true;
+    }
+
+    bool retrieve(cv::Mat& bgr) override {
+        if (!m_holding) return false;
+
+        // 直接在 mmap 内存上构造 Mat 头，唯一的一次写入就是转换成 BGR
+        bool ok = true;
+        if (m_cam.fourcc() == V4L2_PIX_FMT_MJPEG) {
+            cv::Mat packet(1, static_cast<int>(m_buf.bytesUsed), CV_8UC1, const_cast<uint8_t*>(m_buf.data));
+            cv::imdecode(packet, cv::IMREAD_COLOR, &bgr);
+            ok = !bgr.empty();
+        } else if (m_cam.fourcc() == V4L2_PIX_FMT_YUYV) {
+            cv::Mat yuyv(m_cam.height(), m_cam.width(), CV_8UC2, const_cast<uint8_t*>(m_buf.data), m_cam.bytesPerLine());
+            cv::cvtColor(yuyv, bgr, cv::COLOR_YUV2BGR_YUYV);
+        } else if (m_cam.fourcc() == V4L2_PIX_FMT_BGR24) {
+            cv::Mat src(m_cam.height(), m_cam.width(), CV_8UC3, const_cast<uint8_t*>(m_buf.data), m_cam.bytesPerLine());
+            src.copyTo(bgr);
+        } else {
+            ok = false;
+        }
+
+        m_cam.requeue(m_buf);
+        m_holding = false;
+        return ok;
+    }
+
+    bool retrievePacket(cv::Mat& packet, size_t& bytes) override {
+        if (!m_holding || m_cam.fourcc() != V4L2_PIX_FMT_MJPEG) return false;
+
+        // 驱动缓冲区必须尽快还回去，所以拷贝一次压缩数据 (只有几百 KB，远小于解码成本)
+        bytes = m_buf.bytesUsed;
+        if (packet.empty() || packet.total() < bytes) {
+            packet.create(1, static_cast<int>(std::max(bytes, m_cam.maxPacketBytes())), CV_8UC1);
+        }
+        std::memcpy(packet.data, m_buf.data, bytes);
+
+        m_cam.requeue(m_buf);
+        m_holding = false;
+        return true;
+    }
+
+    void release() override {
+        if (m_holding) m_cam.requeue(m_buf);
+        m_holding = false;
+        m_cam.close();
+    }
+
+private:
+    V4l2Camera m_cam;
+    V4l2Camera::Buffer m_buf;
+    bool m_holding = false;     // 当前是否持有一个驱动缓冲区
+};
+
+} // namespace
+
+std::unique_ptr<CameraSource> createCameraSource(int index, CameraBackend backend) {
+    if (backend == CameraBackend::Playback) return createPlaybackCameraSource(index);
+    if (backend == CameraBackend::V4L2Native) {
+        // 与 createCamera() 保持相同的格式要求: MJPG 1920x1080
+        V4l2Camera::Config config;
+        config.fourcc = V4L2_PIX_FMT_MJPEG;
+        config.width = 1920;
+        config.height = 1080;
+
+        auto src = std::make_unique<V4l2CameraSource>();
+        if (src->open(index, config)) {
+            qDebug() << "🐧 [Linux] 相机" << index << "使用原生 V4L2 后端";
+            return src;
+        }
+        qDebug() << "⚠️ [Linux] 相机" << index << "原生 V4L2 打开失败，回退到 OpenCV";
+    }
+    return std::make_unique<OpenCvCameraSource>(createCamera(index));
+}
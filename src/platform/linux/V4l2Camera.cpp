@@ -0,0 +1,220 @@
+#include "V4l2Camera.h"
+#include <QDebug>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <linux/videodev2.h>
+
+V4l2Camera::~V4l2Camera() {
+    close();
+}
+
+int V4l2Camera::xioctl(unsigned long request, void* arg) const {
+    // 被信号打断时重试
+    int r;
+    do {
+        r = ioctl(m_fd, request, arg);
+    } while (r == -1 && errno == EINTR);
+    return r;
+}
+
+bool V4l2Camera::open(const std::string& device, const Config& config) {
+    close();
+
+    m_fd = ::open(device.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (m_fd < 0) {
+        qDebug() << "❌ [V4L2] 无法打开设备" << device.c_str() << ":" << strerror(errno);
+        return false;
+    }
+
+    // 1. 确认是支持流式 I/O 的采集设备
+    v4l2_capability cap{};
+    if (xioctl(VIDIOC_QUERYCAP, &cap) == -1 ||
+        !(cap.capabilities & V4L2_CAP_VIDEO_CAPTURE) ||
+        !(cap.capabilities & V4L2_CAP_STREAMING)) {
+        qDebug() << "❌ [V4L2]" << device.c_str() << "不是支持流式采集的设备";
+        close();
+        return false;
+    }
+
+    // 2. 设置格式 (驱动可能会改成它支持的最接近的值)
+    v4l2_format fmt{};
+    fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    fmt.fmt.pix.width = config.width;
+    fmt.fmt.pix.height = config.height;
+    fmt.fmt.pix.pixelformat = config.fourcc;
+    fmt.fmt.pix.field = V4L2_FIELD_ANY;
+    if (xioctl(VIDIOC_S_FMT, &fmt) == -1) {
+        qDebug() << "❌ [V4L2] VIDIOC_S_FMT 失败:" << strerror(errno);
+        close();
+        return false;
+    }
+    m_width = fmt.fmt.pix.width;
+    m_height = fmt.fmt.pix.height;
+    m_fourcc = fmt.fmt.pix.pixelformat;
+    m_bytesPerLine = fmt.fmt.pix.bytesperline;
+
+    // 3. 帧率 (不是所有驱动都支持，失败不致命)
+    v4l2_streamparm parm{};
+    parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    parm.parm.capture.timeperframe.numerator = 1;
+    parm.parm.capture.timeperframe.denominator = config.fps;
+    xioctl(VIDIOC_S_PARM, &parm);
+
+    // 4. 申请驱动缓冲区 (队列深度)
+    v4l2_requestbuffers req{};
+    req.count = config.bufferCount;
+    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    req.memory = V4L2_MEMORY_MMAP;
+    if (xioctl(VIDIOC_REQBUFS, &req) == -1 || req.count < 2) {
+        qDebug() << "❌ [V4L2] VIDIOC_REQBUFS 失败:" << strerror(errno);
+        close();
+        return false;
+    }
+
+    // 5. 映射每个缓冲区并放入驱动队列
+    m_buffers.resize(req.count);
+    for (uint32_t i = 0; i < req.count; ++i) {
+        v4l2_buffer buf{};
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        buf.index = i;
+        if (xioctl(VIDIOC_QUERYBUF, &buf) == -1) {
+            qDebug() << "❌ [V4L2] VIDIOC_QUERYBUF 失败:" << strerror(errno);
+            close();
+            return false;
+        }
+
+        void *start = mmap(nullptr, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, buf.m.offset);
+        if (start == MAP_FAILED) {
+            qDebug() << "❌ [V4L2] mmap 失败:" << strerror(errno);
+            close();
+            return false;
+        }
+        m_buffers[i].start = start;
+        m_buffers[i].length = buf.length;
+
+        if (xioctl(VIDIOC_QBUF, &buf) == -1) {
+            qDebug() << "❌ [V4L2] VIDIOC_QBUF 失败:" << strerror(errno);
+            close();
+            return false;
+        }
+    }
+
+    // 6. 开始采集
+    v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (xioctl(VIDIOC_STREAMON, &type) == -1) {
+        qDebug() << "❌ [V4L2] VIDIOC_STREAMON 失败:" << strerror(errno);
+        close();
+        return false;
+    }
+    m_streaming = true;
+
+    qDebug() << "🐧 [V4L2] 原生采集已启动" << device.c_str()
+             << "|" << m_width << "x" << m_height << "| 队列深度:" << m_buffers.size();
+    return true;
+}
+
+void V4l2Camera::close() {
+    if (m_fd < 0) return;
+
+    if (m_streaming) {
+        v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        xioctl(VIDIOC_STREAMOFF, &type);
+        m_streaming = false;
+    }
+    for (auto &m : m_buffers) {
+        if (m.start) munmap(m.start, m.length);
+    }
+    m_buffers.clear();
+
+    // 释放驱动端缓冲区
+    v4l2_requestbuffers req{};
+    req.count = 0;
+    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    req.memory = V4L2_MEMORY_MMAP;
+    xioctl(VIDIOC_REQBUFS, &req);
+
+    ::close(m_fd);
+    m_fd = -1;
+}
+
+bool V4l2Camera::dequeue(Buffer& out, int timeoutMs) {
+    if (!isOpened()) return false;
+
+    // 等待驱动填好一个缓冲区
+    pollfd pfd{};
+    pfd.fd = m_fd;
+    pfd.events = POLLIN;
+    int r;
+    do {
+        r = poll(&pfd, 1, timeoutMs);
+    } while (r == -1 && errno == EINTR);
+    if (r <= 0) return false;   // 超时或出错
+
+    v4l2_buffer buf{};
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    if (xioctl(VIDIOC_DQBUF, &buf) == -1) {
+        if (errno != EAGAIN) qDebug() << "⚠️ [V4L2] VIDIOC_DQBUF 失败:" << strerror(errno);
+        return false;
+    }
+
+    // 驱动报告数据损坏的帧直接还回去
+    if (buf.flags & V4L2_BUF_FLAG_ERROR) {
+        xioctl(VIDIOC_QBUF, &buf);
+        return false;
+    }
+
+    out.data = static_cast<const uint8_t*>(m_buffers[buf.index].start);
+    out.bytesUsed = buf.bytesused;
+    out.index = buf.index;
+    out.sequence = buf.sequence;
+    // V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC: 与 std::chrono::steady_clock 同一个时钟
+    out.timestampNs = static_cast<int64_t>(buf.timestamp.tv_sec) * 1000000000LL
+                      + static_cast<int64_t>(buf.timestamp.tv_usec) * 1000LL;
+    return true;
+}
+
+bool V4l2Camera::requeue(const Buffer& buf) {
+    if (!isOpened() || buf.index >= m_buffers.size()) return false;
+
+    v4l2_buffer b{};
+    b.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    b.memory = V4L2_MEMORY_MMAP;
+    b.index = buf.index;
+    return xioctl(VIDIOC_QBUF, &b) != -1;
+}
+
+int V4l2Camera::exportDmabuf(uint32_t index) const {
+    if (m_fd < 0 || index >= m_buffers.size()) return -1;
+
+    v4l2_exportbuffer exp{};
+    exp.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    exp.index = index;
+    exp.flags = O_RDONLY | O_CLOEXEC;
+    if (xioctl(VIDIOC_EXPBUF, &exp) == -1) {
+        qDebug() << "⚠️ [V4L2] VIDIOC_EXPBUF 失败:" << strerror(errno);
+        return -1;
+    }
+    return exp.fd;
+}
+
+size_t V4l2Camera::maxPacketBytes() const {
+    size_t maxLen = 0;
+    for (const auto &m : m_buffers) maxLen = std::max(maxLen, m.length);
+    return maxLen;
+}
+
+bool V4l2Camera::ownsPointer(const uint8_t* p) const {
+    for (const auto &m : m_buffers) {
+        const uint8_t *begin = static_cast<const uint8_t*>(m.start);
+        if (p >= begin && p < begin + m.length) return true;
+    }
+    return false;
+}
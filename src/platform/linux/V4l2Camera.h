@@ -0,0 +1,96 @@
+#ifndef V4L2CAMERA_H
+#define V4L2CAMERA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 原生 V4L2 相机 (mmap 流式采集)
+ *
+ * 直接使用 VIDIOC_REQBUFS / QBUF / DQBUF 与驱动交互，而不是经过 OpenCV 的 CAP_V4L2 封装:
+ *   - 驱动缓冲区队列深度可配置；
+ *   - dequeue() 返回的数据直接指向 mmap 映射的驱动缓冲区，没有任何拷贝；
+ *   - 每帧都带驱动给出的单调时钟时间戳 (CLOCK_MONOTONIC) 和帧序号。
+ * 拿到的缓冲区用完后必须 requeue() 还给驱动，否则队列会被耗尽。
+ *
+ * 可以用内核自带的虚拟驱动 vivid 测试: sudo modprobe vivid
+ */
+class V4l2Camera
+{
+public:
+    struct Config {
+        int width = 1920;
+        int height = 1080;
+        uint32_t fourcc = 0x47504A4D;   // 'MJPG' (v4l2_fourcc('M','J','P','G'))
+        int fps = 30;
+        int bufferCount = 4;            // 驱动队列深度 (驱动可能会调整)
+    };
+
+    // 一帧驱动缓冲区 (指向 mmap 内存，零拷贝)
+    struct Buffer {
+        const uint8_t *data = nullptr;
+        size_t bytesUsed = 0;       // 有效数据长度 (MJPEG 为压缩包大小)
+        uint32_t index = 0;         // 驱动缓冲区编号，requeue 时使用
+        uint32_t sequence = 0;      // 驱动帧序号 (跳号说明驱动层丢帧)
+        int64_t timestampNs = 0;    // 驱动时间戳 (CLOCK_MONOTONIC, 纳秒)
+    };
+
+    V4l2Camera() = default;
+    ~V4l2Camera();
+
+    V4l2Camera(const V4l2Camera&) = delete;
+    V4l2Camera& operator=(const V4l2Camera&) = delete;
+
+    /**
+     * @brief 打开设备、协商格式、申请并映射缓冲区、开始采集
+     * @param device 设备路径，例如 /dev/video0
+     */
+    bool open(const std::string& device, const Config& config);
+    void close();
+    bool isOpened() const { return m_fd >= 0 && m_streaming; }
+
+    /**
+     * @brief 等待并取出一帧
+     * @param out 输出缓冲区描述 (数据指向 mmap 内存)
+     * @param timeoutMs 超时时间
+     */
+    bool dequeue(Buffer& out, int timeoutMs = 1000);
+    // 把缓冲区还给驱动
+    bool requeue(const Buffer& buf);
+
+    /**
+     * @brief 导出某个缓冲区的 DMABUF 文件描述符 (VIDIOC_EXPBUF)
+     * 可以交给 GPU / 编码器直接导入，完全绕过 CPU。调用者负责 close()。
+     * @return fd，失败返回 -1
+     */
+    int exportDmabuf(uint32_t index) const;
+
+    // 协商后的实际参数
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    uint32_t fourcc() const { return m_fourcc; }
+    uint32_t bytesPerLine() const { return m_bytesPerLine; }
+    size_t bufferCount() const { return m_buffers.size(); }
+    size_t maxPacketBytes() const;              // 单个缓冲区最大字节数 (压缩包上限)
+    bool ownsPointer(const uint8_t* p) const;   // p 是否位于某个 mmap 缓冲区内 (测试用)
+
+private:
+    struct Mapping {
+        void *start = nullptr;
+        size_t length = 0;
+    };
+
+    int xioctl(unsigned long request, void* arg) const;
+
+    int m_fd = -1;
+    bool m_streaming = false;
+    std::vector<Mapping> m_buffers;
+    int m_width = 0;
+    int m_height = 0;
+    uint32_t m_fourcc = 0;
+    uint32_t m_bytesPerLine = 0;
+};
+
+#endif // V4L2CAMERA_H
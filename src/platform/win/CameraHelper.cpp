@@ -15,3 +15,12 @@ cv::VideoCapture createCamera(int index) {
     }
     return cap;
 }
+
+std::unique_ptr<CameraSource> createCameraSource(int index, CameraBackend backend) {
+    if (backend == CameraBackend::Playback) return createPlaybackCameraSource(index);
+    // Windows 没有原生 V4L2，统一走 DirectShow
+    if (backend == CameraBackend::V4L2Native) {
+        qDebug() << "⚠️ [Windows] 不支持原生 V4L2 后端，回退到 OpenCV";
+    }
+    return std::make_unique<OpenCvCameraSource>(createCamera(index));
+}
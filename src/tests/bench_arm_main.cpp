@@ -0,0 +1,177 @@
+#include "tools/Path_Plan/ArmCollisionChecker.h"
+#include "tools/Path_Plan/RRTPlanner.h"
+#include "tools/Robot/URKinematics.h"
+#include <QDebug>
+#include <QLoggingCategory>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+// UR12e 整臂碰撞检测吞吐: 每秒检查多少个关节构型
+//   1. 正运动学: 逐个 double (UR12e::forward) vs SoA 批量 (UR12e::forwardBatch)，并核对位置误差
+//   2. 胶囊体 vs 球: 逐个标量 (ArmCollisionChecker::collides) vs 批量 SIMD (checkBatch)，障碍物 10 ~ 200 个
+//   3. 逆运动学: 批量解析解 (每个位姿全部 8 组解) 的吞吐和往返误差，整条直线路径逐点逆解
+//   4. 关节空间 RRT-Connect (RRTPlanner::planJointPath): 绕过一根柱子
+// 用法:
+//   ./Arm_Bench [configs=200000] [seed=1]
+
+namespace {
+double nowNs() {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+UR12e::JointBatch makeConfigs(int count, std::mt19937& gen) {
+    std::uniform_real_distribution<float> u(-(float)CV_PI, (float)CV_PI);
+    UR12e::JointBatch q;
+    q.resize(count);
+    for (int j = 0; j < UR12e::kDof; ++j) {
+        for (auto &v : q.q[j]) v = u(gen);
+    }
+    return q;
+}
+
+// 工作空间 (同 RRTPlanner) 里的随机球，避开底座附近 (否则几乎所有构型都撞)
+std::vector<SphereObstacle> makeObstacles(int count, std::mt19937& gen) {
+    std::uniform_real_distribution<float> ux(-0.8f, 0.8f), uy(-0.8f, 0.8f), uz(0.0f, 1.0f), ur(0.02f, 0.05f);
+    std::vector<SphereObstacle> obs;
+    while ((int)obs.size() < count) {
+        const SphereObstacle o{cv::Point3f(ux(gen), uy(gen), uz(gen)), ur(gen)};
+        if (std::hypot(o.center.x, o.center.y) < 0.3f) continue;
+        obs.push_back(o);
+    }
+    return obs;
+}
+
+double mcps(double configs, double ns) { return configs / ns * 1e3; }    // 百万构型 / 秒
+}
+
+int main(int argc, char *argv[]) {
+    const int count = argc > 1 ? std::max(1, std::atoi(argv[1])) : 200000;
+    const unsigned seed = argc > 2 ? (unsigned)std::atoi(argv[2]) : 1u;
+    qDebug() << "🚀 启动整臂碰撞检测吞吐测试...";
+
+    std::mt19937 gen(seed);
+    const UR12e::JointBatch q = makeConfigs(count, gen);
+    std::vector<JointVector> qs(count);
+    for (int k = 0; k < count; ++k) qs[k] = q.get(k);
+
+    // ---- 1. 正运动学 ----
+    volatile double sink = 0.0;    // 防止逐个计算被优化掉
+    double t0 = nowNs();
+    for (int k = 0; k < count; ++k) sink += UR12e::flangePose(qs[k])(2, 3);
+    const double tScalarFk = nowNs() - t0;
+
+    UR12e::FrameBatch frames;
+    UR12e::forwardBatch(q, frames);     // 预分配
+    t0 = nowNs();
+    UR12e::forwardBatch(q, frames);
+    const double tBatchFk = nowNs() - t0;
+
+    double maxErr = 0.0;
+    for (int k = 0; k < count; k += 97) {
+        cv::Matx44d ref[UR12e::kDof];
+        UR12e::forward(qs[k], ref);
+        for (int f = 1; f <= UR12e::kDof; ++f) {
+            const cv::Point3f p = frames.origin(f, k);
+            maxErr = std::max({maxErr, std::abs(p.x - ref[f - 1](0, 3)), std::abs(p.y - ref[f - 1](1, 3)),
+                               std::abs(p.z - ref[f - 1](2, 3))});
+        }
+    }
+    std::printf("正运动学 %d 组: 逐个 double %.2f M/s | SoA 批量 %.2f M/s | %.1fx | 最大位置误差 %.2e m\n",
+                count, mcps(count, tScalarFk), mcps(count, tBatchFk), tScalarFk / tBatchFk, maxErr);
+
+    // ---- 2. 整臂碰撞检测 ----
+    std::printf("%8s | %14s | %14s | %8s | %8s | %s\n",
+                "障碍物", "标量 M构型/s", "批量 M构型/s", "加速比", "碰撞率", "不一致");
+    bool ok = maxErr < 1e-4;
+    for (int obsCount : {10, 50, 200}) {
+        ArmCollisionChecker checker;
+        checker.setObstacles(makeObstacles(obsCount, gen));
+
+        std::vector<uint8_t> ref(count), hit;
+        t0 = nowNs();
+        for (int k = 0; k < count; ++k) ref[k] = checker.collides(qs[k]);
+        const double tScalar = nowNs() - t0;
+
+        checker.checkBatch(q, hit);
+        t0 = nowNs();
+        const size_t hits = checker.checkBatch(q, hit);
+        const double tBatch = nowNs() - t0;
+
+        // double 和 float 算出的距离在胶囊表面附近可能差一点，只允许极少数不一致
+        int mismatch = 0;
+        for (int k = 0; k < count; ++k) mismatch += ref[k] != hit[k];
+        ok = ok && mismatch <= count / 1000;
+        std::printf("%8d | %14.2f | %14.2f | %7.1fx | %7.1f%% | %d\n", obsCount,
+                    mcps(count, tScalar), mcps(count, tBatch), tScalar / tBatch, 100.0 * hits / count, mismatch);
+    }
+
+    // ---- 3. 逆运动学 ----
+    std::vector<cv::Matx44d> poses(count);
+    for (int k = 0; k < count; ++k) poses[k] = UR12e::flangePose(qs[k]);
+    std::vector<UR12e::IKSolutions> sols(count);
+    t0 = nowNs();
+    UR12e::inverseBatch(poses.data(), poses.size(), sols.data());
+    const double tIk = nowNs() - t0;
+    double ikErr = 0.0, solutions = 0.0;
+    for (int k = 0; k < count; k += 97) {
+        for (int s = 0; s < sols[k].count; ++s) {
+            const cv::Matx44d T = UR12e::flangePose(sols[k].q[s]);
+            for (int r = 0; r < 3; ++r) {
+                for (int c = 0; c < 4; ++c) ikErr = std::max(ikErr, std::abs(T(r, c) - poses[k](r, c)));
+            }
+        }
+    }
+    for (const auto &s : sols) solutions += s.count;
+
+    // 姿态不变、沿 y 走 0.6 m 的直线，每 0.1 mm 一个点
+    const JointVector lineStart{0.3, -1.9, 1.6, -1.3, -CV_PI / 2, 0.2};
+    std::vector<cv::Matx44d> line(6000, UR12e::flangePose(lineStart));
+    for (size_t i = 0; i < line.size(); ++i) line[i](1, 3) += 1e-4 * i;
+    std::vector<JointVector> joints;
+    t0 = nowNs();
+    const UR12e::IKPathResult lineIk = UR12e::inversePath(line, lineStart, joints);
+    const double tLine = nowNs() - t0;
+    ok = ok && ikErr < 1e-8 && lineIk.ok;
+    std::printf("逆运动学 %d 个位姿: %.0f 个/ms (平均 %.1f 组解) | 往返最大误差 %.2e | "
+                "直线路径 %zu 点逐点选解 %.0f 个/ms，最大关节步长 %.4f rad%s\n",
+                count, count / tIk * 1e6, solutions / count, ikErr, line.size(), line.size() / tLine * 1e6,
+                lineIk.maxStep, lineIk.ok ? "" : " (失败)");
+
+    // ---- 4. 关节空间规划 ----
+    // 基座从 -60° 转到 +60°，其余关节不动时手腕在 (-0.43, -0.17) 附近扫过；在那里立一根竖直的柱子
+    std::vector<SphereObstacle> pillar;
+    for (float z = 0.0f; z <= 1.0f + 1e-4f; z += 0.08f) pillar.push_back({cv::Point3f(-0.45f, -0.15f, z), 0.06f});
+    const JointVector start{-CV_PI / 3, -2.0, 1.8, -1.4, -CV_PI / 2, 0.0};
+    const JointVector goal{CV_PI / 3, -2.0, 1.8, -1.4, -CV_PI / 2, 0.0};
+
+    QLoggingCategory::setFilterRules("default.debug=false");
+    const int runs = 20;
+    int success = 0;
+    double totalMs = 0.0, checked = 0.0, length = 0.0;
+    ArmCollisionChecker direct;
+    direct.setObstacles(pillar);
+    for (int r = 0; r < runs; ++r) {
+        RRTPlanner planner;
+        planner.setSeed(seed + r);
+        for (const auto &o : pillar) planner.addObstacle(o);
+        const std::vector<JointVector> path = planner.planJointPath(start, goal);
+        const PlanStats &st = planner.lastStats();
+        totalMs += st.totalMs;
+        checked += (double)st.configsChecked;
+        if (path.empty()) continue;
+        ++success;
+        length += st.pathLength;
+        for (size_t k = 1; k < path.size(); ++k) {
+            if (direct.motionCollides(path[k - 1], path[k], 0.02)) { ok = false; break; }
+        }
+    }
+    std::printf("关节空间 RRT-Connect (柱子 %zu 个球，直接转过去%s): 成功 %d/%d | 平均 %.2f ms | "
+                "平均检查 %.0f 个构型 (%.2f M/s) | 平均长度 %.2f rad\n",
+                pillar.size(), direct.motionCollides(start, goal, 0.02) ? "会碰撞" : "不碰撞",
+                success, runs, totalMs / runs, checked / runs, checked / totalMs * 1e-3,
+                success ? length / success : 0.0);
+    return ok && success == runs ? 0 : 1;
+}
@@ -0,0 +1,114 @@
+#include "tools/Path_Plan/CollisionChecker.h"
+#include <QDebug>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+// 碰撞检测规模测试: 10 / 100 / 1000 / 10000 个球形障碍物
+// 对比 原始逐个标量检测 vs CollisionChecker (只用 SoA SIMD) vs CollisionChecker (网格粗筛 + SoA SIMD)，
+// 并逐条核对三者结果完全一致
+// 用法:
+//   ./Collision_Bench [queries=20000] [seed=1]
+
+namespace {
+// 工作空间与 RRTPlanner 一致
+const float kXMin = -0.8f, kXMax = 0.8f;
+const float kYMin = -0.8f, kYMax = 0.8f;
+const float kZMin = 0.0f, kZMax = 1.0f;
+const float kThreshold = 0.01f;     // 安全余量 (障碍物多时用小余量，否则整个空间都被占满)
+
+struct Segment {
+    cv::Point3f p1, p2;
+};
+
+double nowNs() {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 障碍物总体积约占工作空间的 10%，数量越多球越小 (模拟视觉给出的稠密小障碍)
+std::vector<SphereObstacle> makeObstacles(int count, std::mt19937& gen) {
+    std::uniform_real_distribution<float> ux(kXMin, kXMax), uy(kYMin, kYMax), uz(kZMin, kZMax);
+    std::uniform_real_distribution<float> scale(0.5f, 1.5f);
+    const float volume = (kXMax - kXMin) * (kYMax - kYMin) * (kZMax - kZMin);
+    const float rEff = std::cbrt(0.1f * volume * 3.0f / (4.0f * float(CV_PI) * count));
+
+    std::vector<SphereObstacle> obs(count);
+    for (auto &o : obs) {
+        o.center = cv::Point3f(ux(gen), uy(gen), uz(gen));
+        o.radius = std::max(0.001f, rEff * scale(gen) - kThreshold);
+    }
+    return obs;
+}
+
+// 90% 是 RRT 单步长度 (5cm)，10% 是路径平滑时的长线段 (50cm)，少量退化成点
+std::vector<Segment> makeSegments(int count, std::mt19937& gen) {
+    std::uniform_real_distribution<float> ux(kXMin, kXMax), uy(kYMin, kYMax), uz(kZMin, kZMax);
+    std::normal_distribution<float> dir(0.0f, 1.0f);
+    std::vector<Segment> segs(count);
+    for (int i = 0; i < count; ++i) {
+        cv::Point3f d(dir(gen), dir(gen), dir(gen));
+        const float len = (i % 100 == 0) ? 0.0f : ((i % 10 == 0) ? 0.5f : 0.05f);
+        const float n = std::sqrt(d.dot(d)) + 1e-9f;
+        segs[i].p1 = cv::Point3f(ux(gen), uy(gen), uz(gen));
+        segs[i].p2 = segs[i].p1 + d * (len / n);
+    }
+    return segs;
+}
+}
+
+int main(int argc, char *argv[]) {
+    const int queries = argc > 1 ? std::atoi(argv[1]) : 20000;
+    const unsigned seed = argc > 2 ? (unsigned)std::atoi(argv[2]) : 1u;
+    qDebug() << "🚀 启动碰撞检测规模测试...";
+
+    std::mt19937 gen(seed);
+    const std::vector<Segment> segs = makeSegments(queries, gen);
+
+    std::printf("%8s | %12s | %12s | %12s | %8s | %8s | %s\n",
+                "障碍物", "标量 ns/次", "SoA ns/次", "网格+SoA", "加速比", "命中率", "结果一致");
+    for (int count : {10, 100, 1000, 10000}) {
+        const std::vector<SphereObstacle> obs = makeObstacles(count, gen);
+        CollisionChecker simdOnly, full;
+        simdOnly.setObstacles(obs);
+        simdOnly.setBroadPhaseEnabled(false);
+        full.setObstacles(obs);
+        // 第一次查询会建 SoA / 网格，放在计时之外
+        simdOnly.segmentCollides(segs[0].p1, segs[0].p2, kThreshold);
+        full.segmentCollides(segs[0].p1, segs[0].p2, kThreshold);
+
+        std::vector<char> ref(segs.size()), a(segs.size()), b(segs.size());
+
+        double t0 = nowNs();
+        for (size_t i = 0; i < segs.size(); ++i) {
+            bool hit = false;
+            for (const auto &o : obs) {
+                if (CollisionChecker::segmentHitsSphere(segs[i].p1, segs[i].p2, o, kThreshold)) { hit = true; break; }
+            }
+            ref[i] = hit;
+        }
+        const double tRef = nowNs() - t0;
+
+        t0 = nowNs();
+        for (size_t i = 0; i < segs.size(); ++i) a[i] = simdOnly.segmentCollides(segs[i].p1, segs[i].p2, kThreshold);
+        const double tSimd = nowNs() - t0;
+
+        t0 = nowNs();
+        for (size_t i = 0; i < segs.size(); ++i) b[i] = full.segmentCollides(segs[i].p1, segs[i].p2, kThreshold);
+        const double tFull = nowNs() - t0;
+
+        int mismatch = 0, hits = 0;
+        for (size_t i = 0; i < segs.size(); ++i) {
+            mismatch += (ref[i] != a[i]) + (ref[i] != b[i]);
+            hits += ref[i];
+        }
+
+        const double n = (double)segs.size();
+        std::printf("%8d | %12.1f | %12.1f | %12.1f | %7.1fx | %7.1f%% | %s\n",
+                    count, tRef / n, tSimd / n, tFull / n, tRef / tFull, 100.0 * hits / n,
+                    mismatch == 0 ? "是" : "否 ❌");
+        if (mismatch) return 1;
+    }
+    return 0;
+}
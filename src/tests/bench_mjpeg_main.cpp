@@ -0,0 +1,162 @@
+#include "tools/Camera/MjpegDecoder.h"
+#include "platform/CameraHelper.h"
+#include <QDebug>
+#include <chrono>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include "platform/linux/V4l2Camera.h"
+#include <linux/videodev2.h>
+#endif
+
+// MJPEG 解码 CPU 开销对比
+// 用法:
+//   ./MJPEG_Bench                     合成一张 1080p JPEG，比较各缩放比例的解码开销
+//   ./MJPEG_Bench image.jpg [次数]     用指定 JPEG 文件比较
+//   ./MJPEG_Bench --camera 0 [帧数]    真实相机: 当前 cap >> frame 路径 vs 原生 V4L2 压缩包 + 缩小解码 (仅 Linux)
+
+namespace {
+
+// 进程 CPU 时间 (包含 OpenCV 内部线程)，比墙钟时间更能反映解码开销
+double cpuSeconds() {
+    return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+}
+
+double wallSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void report(const char* name, int frames, double cpu, double wall, const cv::Size& size) {
+    std::printf("%-34s %5dx%-5d  CPU %7.3f ms/帧   墙钟 %7.3f ms/帧\n",
+                name, size.width, size.height,
+                frames > 0 ? cpu * 1000.0 / frames : 0.0,
+                frames > 0 ? wall * 1000.0 / frames : 0.0);
+}
+
+// 合成一张带纹理的 1080p 图，避免纯色图解码过快、结果失真
+std::vector<uchar> makeSyntheticJpeg() {
+    cv::Mat img(1080, 1920, CV_8UC3);
+    cv::randu(img, cv::Scalar(0, 0, 0), cv::Scalar(255, 255, 255));
+    for (int i = 0; i < 40; ++i) {
+        cv::rectangle(img, cv::Rect(i * 45, i * 25, 300, 200), cv::Scalar(i * 6, 255 - i * 6, 128), -1);
+    }
+    std::vector<uchar> jpeg;
+    cv::imencode(".jpg", img, jpeg, {cv::IMWRITE_JPEG_QUALITY, 85});
+    return jpeg;
+}
+
+int benchFile(const std::vector<uchar>& jpeg, int iterations) {
+    qDebug() << "📦 压缩包大小:" << jpeg.size() << "字节 | 迭代:" << iterations
+             << "| libjpeg 直接解码:" << MjpegDecoder::usingLibjpeg();
+
+    // 基准: 当前路径等价于 imdecode 全尺寸解码
+    {
+        cv::Mat out;
+        double c0 = cpuSeconds(), w0 = wallSeconds();
+        for (int i = 0; i < iterations; ++i) out = cv::imdecode(jpeg, cv::IMREAD_COLOR);
+        report("cv::imdecode 全尺寸 (基准)", iterations, cpuSeconds() - c0, wallSeconds() - w0, out.size());
+    }
+
+    MjpegDecoder decoder;
+    const int scales[] = {1, 2, 4, 8};
+    for (int scale : scales) {
+        cv::Mat out;
+        double c0 = cpuSeconds(), w0 = wallSeconds();
+        for (int i = 0; i < iterations; ++i) decoder.decode(jpeg.data(), jpeg.size(), scale, out);
+        std::string name = "MjpegDecoder 1/" + std::to_string(scale);
+        report(name.c_str(), iterations, cpuSeconds() - c0, wallSeconds() - w0, out.size());
+    }
+
+    // 对照: 全尺寸解码后再缩小到 1/4 (没有 DCT 域缩放时的做法)
+    {
+        cv::Mat full, small;
+        double c0 = cpuSeconds(), w0 = wallSeconds();
+        for (int i = 0; i < iterations; ++i) {
+            decoder.decode(jpeg.data(), jpeg.size(), 1, full);
+            cv::resize(full, small, cv::Size(full.cols / 4, full.rows / 4), 0, 0, cv::INTER_AREA);
+        }
+        report("全尺寸解码 + resize 1/4", iterations, cpuSeconds() - c0, wallSeconds() - w0, small.size());
+    }
+    return 0;
+}
+
+int benchCamera(int index, int frames) {
+    // 1. 当前路径: createCamera() + cap >> frame (采集线程内全尺寸解码)
+    {
+        cv::VideoCapture cap = createCamera(index);
+        if (!cap.isOpened()) {
+            qDebug() << "❌ 无法打开相机" << index;
+            return 1;
+        }
+        cv::Mat frame;
+        cap >> frame;   // 预热
+        double c0 = cpuSeconds(), w0 = wallSeconds();
+        for (int i = 0; i < frames; ++i) cap >> frame;
+        report("cap >> frame (当前路径)", frames, cpuSeconds() - c0, wallSeconds() - w0, frame.size());
+        cap.release();
+    }
+
+#if defined(__linux__)
+    // 2. 原生 V4L2: 只拷贝压缩包，按预览需要缩小解码
+    const int scales[] = {1, 4, 8};
+    for (int scale : scales) {
+        V4l2Camera cam;
+        V4l2Camera::Config config;
+        config.fourcc = V4L2_PIX_FMT_MJPEG;
+        if (!cam.open("/dev/video" + std::to_string(index), config) || cam.fourcc() != V4L2_PIX_FMT_MJPEG) {
+            qDebug() << "⚠️ 相机不支持原生 MJPEG 采集，跳过对比";
+            return 0;
+        }
+
+        MjpegDecoder decoder;
+        cv::Mat out;
+        int decoded = 0;
+        double c0 = cpuSeconds(), w0 = wallSeconds();
+        for (int i = 0; i < frames; ++i) {
+            V4l2Camera::Buffer buf;
+            if (!cam.dequeue(buf)) continue;
+            if (decoder.decode(buf.data, buf.bytesUsed, scale, out)) decoded++;
+            cam.requeue(buf);
+        }
+        std::string name = "V4L2 压缩包 + 解码 1/" + std::to_string(scale);
+        report(name.c_str(), decoded, cpuSeconds() - c0, wallSeconds() - w0, out.size());
+    }
+#endif
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    qDebug() << "🚀 启动 MJPEG 解码基准测试...";
+
+    if (argc > 2 && std::strcmp(argv[1], "--camera") == 0) {
+        int frames = argc > 3 ? std::atoi(argv[3]) : 300;
+        return benchCamera(std::atoi(argv[2]), frames);
+    }
+
+    std::vector<uchar> jpeg;
+    int iterations = 200;
+    if (argc > 1) {
+        FILE *f = std::fopen(argv[1], "rb");
+        if (!f) {
+            qDebug() << "❌ 无法读取文件" << argv[1];
+            return 1;
+        }
+        std::fseek(f, 0, SEEK_END);
+        jpeg.resize(static_cast<size_t>(std::ftell(f)));
+        std::fseek(f, 0, SEEK_SET);
+        size_t n = std::fread(jpeg.data(), 1, jpeg.size(), f);
+        std::fclose(f);
+        jpeg.resize(n);
+        if (argc > 2) iterations = std::atoi(argv[2]);
+    } else {
+        jpeg = makeSyntheticJpeg();
+    }
+    return benchFile(jpeg, iterations);
+}
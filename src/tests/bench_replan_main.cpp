@@ -0,0 +1,174 @@
+#include "tools/Path_Plan/RRTPlanner.h"
+#include "tools/Path_Plan/ReplanSession.h"
+#include <QDebug>
+#include <QLoggingCategory>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// 动态障碍物重规划基准: 起点终点之间一堵带两个洞的墙，一个球按相机帧率在墙前来回移动、轮流挡住两个洞，
+// 每帧对比 增量重规划 (ReplanSession，保留树) 和 从头规划 (RRTPlanner::planPath)
+// 用法:
+//   ./Replan_Bench [--frames 200] [--seed 1] [--speed 0.02] [--obstacles 20] [--nn kdtree|grid|brute]
+// --speed 是球每帧移动的距离 (米)
+
+namespace {
+
+const cv::Point3f kStart(-0.5f, 0.0f, 0.5f);
+const cv::Point3f kGoal(0.5f, 0.0f, 0.5f);
+const float kMovingRadius = 0.1f;
+
+// 静态场景: x = 0 处一堵球墙，在 y = ±0.3 各留一个洞；再加 count 个随机杂物
+std::vector<SphereObstacle> makeStatic(int count, uint32_t seed) {
+    std::vector<SphereObstacle> obs;
+    for (float y = -0.8f; y <= 0.8f + 1e-4f; y += 0.08f) {
+        for (float z = 0.0f; z <= 1.0f + 1e-4f; z += 0.08f) {
+            if (std::abs(std::abs(y) - 0.3f) < 0.12f && std::abs(z - 0.5f) < 0.12f) continue;
+            obs.push_back({cv::Point3f(0.0f, y, z), 0.05f});
+        }
+    }
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> ux(-0.8f, 0.8f), uy(-0.8f, 0.8f), uz(0.0f, 1.0f), ur(0.03f, 0.08f);
+    for (int added = 0; added < count;) {
+        SphereObstacle o{cv::Point3f(ux(gen), uy(gen), uz(gen)), ur(gen)};
+        const float keepOut = o.radius + 0.1f;
+        if (cv::norm(o.center - kStart) < keepOut || cv::norm(o.center - kGoal) < keepOut) continue;
+        // 不堵死墙上的洞
+        if (std::abs(o.center.x) < keepOut && std::abs(std::abs(o.center.y) - 0.3f) < keepOut) continue;
+        obs.push_back(o);
+        ++added;
+    }
+    return obs;
+}
+
+// 第 frame 帧动态球的位置: 在墙前 (x = -0.15) 沿 y 往返，轮流挡住两个洞
+SphereObstacle movingAt(int frame, float speed) {
+    const float amplitude = 0.4f;
+    const float period = 4.0f * amplitude / speed;      // 帧数
+    const float phase = 2.0f * float(CV_PI) * frame / period;
+    return {cv::Point3f(-0.15f, amplitude * std::sin(phase), 0.5f), kMovingRadius};
+}
+
+struct Series {
+    std::vector<double> ms;
+    int failures = 0;
+    int invalidPaths = 0;
+    double length = 0.0;
+};
+
+double pct(std::vector<double> v, double p) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    const size_t idx = (size_t)std::ceil(p / 100.0 * v.size());
+    return v[std::min(v.size() - 1, idx > 0 ? idx - 1 : 0)];
+}
+
+bool pathValid(const std::vector<cv::Point3f>& path, const CollisionChecker& checker) {
+    for (size_t k = 1; k < path.size(); ++k) {
+        if (checker.segmentCollides(path[k - 1], path[k])) return false;
+    }
+    return !path.empty();
+}
+
+void record(Series& s, const std::vector<cv::Point3f>& path, double ms, const CollisionChecker& checker) {
+    s.ms.push_back(ms);
+    if (path.empty()) { ++s.failures; return; }
+    if (!pathValid(path, checker)) ++s.invalidPaths;
+    for (size_t k = 1; k < path.size(); ++k) s.length += cv::norm(path[k] - path[k - 1]);
+}
+
+void printRow(const char* name, const Series& s, int frames) {
+    const int ok = frames - s.failures;
+    std::printf("%-14s | %8.3f %8.3f %8.3f %8.3f | %5d %5d | %7.3f\n", name,
+                pct(s.ms, 50), pct(s.ms, 90), pct(s.ms, 99), pct(s.ms, 100),
+                s.failures, s.invalidPaths, ok > 0 ? s.length / ok : 0.0);
+}
+
+double msSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+}
+
+int main(int argc, char *argv[]) {
+    int frames = 200;
+    uint32_t seed = 1;
+    float speed = 0.02f;
+    int staticCount = 20;
+    NNIndexType nn = NNIndexType::KdTree;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--frames") && hasValue) frames = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--seed") && hasValue) seed = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--speed") && hasValue) speed = (float)std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--obstacles") && hasValue) staticCount = std::max(0, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--nn") && hasValue) {
+            const char *v = argv[++i];
+            if (!std::strcmp(v, "kdtree")) nn = NNIndexType::KdTree;
+            else if (!std::strcmp(v, "grid")) nn = NNIndexType::GridHash;
+            else if (!std::strcmp(v, "brute")) nn = NNIndexType::BruteForce;
+            else { std::fprintf(stderr, "未知的 --nn: %s (可选 kdtree / grid / brute)\n", v); return 1; }
+        } else {
+            std::fprintf(stderr, "用法: %s [--frames 200] [--seed 1] [--speed 0.02] [--obstacles 20] [--nn kdtree|grid|brute]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // planPath / replan 失败时会打 qDebug，跑几百帧时关掉
+    QLoggingCategory::setFilterRules("default.debug=false");
+
+    const std::vector<SphereObstacle> statics = makeStatic(staticCount, seed);
+
+    ReplanSession session;
+    session.setSeed(seed);
+    session.setNearestNeighborType(nn);
+    session.reset(kStart, kGoal);
+    for (const auto &o : statics) session.addObstacle(o);
+    const int moving = session.addObstacle(movingAt(0, speed));
+    session.replan();   // 第 0 帧: 建树，不计入统计
+
+    Series incremental, scratchRrt, scratchConnect;
+    double invalidated = 0.0, discarded = 0.0, reattached = 0.0;
+    int reused = 0;
+    for (int f = 1; f <= frames; ++f) {
+        const SphereObstacle obs = movingAt(f, speed);
+
+        auto t0 = std::chrono::steady_clock::now();
+        session.updateObstacle(moving, obs);
+        std::vector<cv::Point3f> path = session.replan();
+        record(incremental, path, msSince(t0), session.collisionChecker());
+        const ReplanStats &rs = session.lastStats();
+        invalidated += rs.invalidatedEdges;
+        discarded += rs.discarded;
+        reattached += rs.reattached;
+        reused += rs.reused ? 1 : 0;
+
+        // 从头规划: 每帧新建规划器 (同样的障碍物)，原始 RRT 和 RRT-Connect 各一次
+        for (PlannerMode mode : {PlannerMode::RRT, PlannerMode::RRTConnect}) {
+            RRTPlanner planner;
+            planner.setSeed(seed + f);
+            planner.setNearestNeighborType(nn);
+            planner.setMode(mode);
+            for (const auto &o : statics) planner.addObstacle(o);
+            planner.addObstacle(obs);
+            t0 = std::chrono::steady_clock::now();
+            path = planner.planPath(kStart, kGoal);
+            record(mode == PlannerMode::RRT ? scratchRrt : scratchConnect, path, msSince(t0),
+                   planner.collisionChecker());
+        }
+    }
+
+    std::printf("动态障碍物重规划: %d 帧 | 墙 + 随机障碍 %d 个 | 动态球 R=%.2f m，每帧移动 %.3f m\n",
+                frames, staticCount, kMovingRadius, speed);
+    std::printf("%-14s | %8s %8s %8s %8s | %5s %5s | %7s\n",
+                "方式", "p50 ms", "p90 ms", "p99 ms", "最长 ms", "失败", "无效", "长度 m");
+    printRow("增量 (保留树)", incremental, frames);
+    printRow("从头 RRT", scratchRrt, frames);
+    printRow("从头 Connect", scratchConnect, frames);
+    std::printf("增量: 每帧平均切断 %.1f 条边，接回 %.1f 棵子树，丢弃 %.1f 个节点；原路径直接可用 %d/%d 帧，最终树 %zu 个节点\n",
+                invalidated / frames, reattached / frames, discarded / frames, reused, frames, session.treeSize());
+    return incremental.invalidPaths == 0 ? 0 : 1;
+}
@@ -0,0 +1,463 @@
+#include "tools/Path_Plan/RRTPlanner.h"
+#include "tools/Path_Plan/PathSmoother.h"
+#include <QDebug>
+#include <QLoggingCategory>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <string>
+
+// RRT 确定性基准测试
+// 每个场景跑 N 次，第 t 次的种子是 seed + t。同样的参数每次运行的迭代次数 / 树大小 / 路径完全相同，
+// 只有耗时会变，方便对比性能回退
+// 用法:
+//   ./RRT_Bench [--trials 50] [--seed 1] [--nn kdtree|grid|brute] [--mode rrt|connect|parallel|all]
+//               [--scenario 名字] [--json out.json|-] [--smooth] [--budget 毫秒] [--batch [线程数]]
+// --mode all 时每个场景依次用四种算法跑，对比首次出解时间 (成功试验的耗时分布)
+// --budget 时用带时间预算的 RRT* (planPath 的 budget 版本)，输出首解时间和预算内各时刻的路径长度 (代价-时间曲线)
+// --smooth 时对每条成功的路径做捷径剪枝 + 样条 + 时间参数化，对比前后的长度和执行时间
+// --batch 时每个场景再把 N 次试验作为一批查询交给 planBatch，对比逐个 planPath 的总耗时 (结果相同，只比吞吐)
+
+namespace {
+
+struct Scenario {
+    std::string name;
+    cv::Point3f start, goal;
+    std::vector<SphereObstacle> obstacles;
+};
+
+// ================= 场景库 =================
+
+// 随机杂物: count 个球，避开起点终点
+Scenario makeClutter(int count, uint32_t seed) {
+    Scenario s;
+    s.name = "clutter_" + std::to_string(count);
+    s.start = cv::Point3f(-0.6f, -0.6f, 0.2f);
+    s.goal = cv::Point3f(0.6f, 0.6f, 0.8f);
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> ux(-0.8f, 0.8f), uy(-0.8f, 0.8f), uz(0.0f, 1.0f), ur(0.03f, 0.08f);
+    while ((int)s.obstacles.size() < count) {
+        SphereObstacle o{cv::Point3f(ux(gen), uy(gen), uz(gen)), ur(gen)};
+        const float keepOut = o.radius + 0.1f;
+        if (cv::norm(o.center - s.start) < keepOut || cv::norm(o.center - s.goal) < keepOut) continue;
+        s.obstacles.push_back(o);
+    }
+    return s;
+}
+
+std::vector<Scenario> buildScenarios() {
+    std::vector<Scenario> list;
+
+    // 1. 空场景
+    Scenario empty;
+    empty.name = "empty";
+    empty.start = cv::Point3f(-0.5f, -0.5f, 0.2f);
+    empty.goal = cv::Point3f(0.5f, 0.5f, 0.8f);
+    list.push_back(empty);
+
+    // 2. 起点终点正中间一个球
+    Scenario single;
+    single.name = "single_sphere";
+    single.start = cv::Point3f(-0.5f, 0.0f, 0.5f);
+    single.goal = cv::Point3f(0.5f, 0.0f, 0.5f);
+    single.obstacles.push_back({cv::Point3f(0.0f, 0.0f, 0.5f), 0.2f});
+    list.push_back(single);
+
+    // 3. 窄通道: x = 0 处一堵球墙，只在 (y=0.3, z=0.6) 附近留一个洞
+    Scenario narrow;
+    narrow.name = "narrow_passage";
+    narrow.start = cv::Point3f(-0.5f, 0.0f, 0.5f);
+    narrow.goal = cv::Point3f(0.5f, 0.0f, 0.5f);
+    for (float y = -0.8f; y <= 0.8f + 1e-4f; y += 0.08f) {
+        for (float z = 0.0f; z <= 1.0f + 1e-4f; z += 0.08f) {
+            if (std::abs(y - 0.3f) < 0.12f && std::abs(z - 0.6f) < 0.12f) continue;
+            narrow.obstacles.push_back({cv::Point3f(0.0f, y, z), 0.05f});
+        }
+    }
+    list.push_back(narrow);
+
+    // 4. 不同密度的随机杂物
+    list.push_back(makeClutter(20, 7));
+    list.push_back(makeClutter(80, 7));
+    list.push_back(makeClutter(200, 7));
+
+    // 5. 终点在笼子里: 以终点为球心的球壳上铺满小球，只在 +z 方向开口
+    Scenario cage;
+    cage.name = "goal_in_cage";
+    cage.start = cv::Point3f(-0.5f, -0.5f, 0.3f);
+    cage.goal = cv::Point3f(0.4f, 0.4f, 0.5f);
+    const int shell = 200;
+    const float golden = float(CV_PI) * (3.0f - std::sqrt(5.0f));
+    for (int k = 0; k < shell; ++k) {
+        // 斐波那契球面均匀取点
+        const float zz = 1.0f - 2.0f * (k + 0.5f) / shell;
+        const float rr = std::sqrt(1.0f - zz * zz);
+        const cv::Point3f dir(rr * std::cos(golden * k), rr * std::sin(golden * k), zz);
+        if (dir.z > 0.85f) continue;    // 开口
+        cage.obstacles.push_back({cage.goal + dir * 0.25f, 0.05f});
+    }
+    list.push_back(cage);
+
+    return list;
+}
+
+// ================= 统计 =================
+
+struct Summary {
+    double p50 = 0, p90 = 0, p99 = 0, mean = 0, min = 0, max = 0;
+};
+
+Summary summarize(std::vector<double> v) {
+    Summary s;
+    if (v.empty()) return s;
+    std::sort(v.begin(), v.end());
+    auto pct = [&](double p) {
+        // 最近秩法 (nearest-rank)
+        size_t idx = (size_t)std::ceil(p / 100.0 * v.size());
+        return v[std::min(v.size() - 1, idx > 0 ? idx - 1 : 0)];
+    };
+    s.p50 = pct(50); s.p90 = pct(90); s.p99 = pct(99);
+    s.min = v.front(); s.max = v.back();
+    double sum = 0;
+    for (double x : v) sum += x;
+    s.mean = sum / v.size();
+    return s;
+}
+
+std::string summaryJson(const Summary& s) {
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "{\"p50\": %.4f, \"p90\": %.4f, \"p99\": %.4f, \"mean\": %.4f, \"min\": %.4f, \"max\": %.4f}",
+                  s.p50, s.p90, s.p99, s.mean, s.min, s.max);
+    return buf;
+}
+
+struct ScenarioResult {
+    std::string name;
+    PlannerMode mode = PlannerMode::RRT;
+    size_t obstacles = 0;
+    int trials = 0;
+    int successes = 0;
+    Summary wallMs, iterations, treeSize, nearestMs, collisionMs, pathLength;
+    Summary solveMs;    // 首次出解时间 (只统计成功的试验)
+    // --smooth: 后处理前后 (只统计成功的试验)
+    Summary smoothMs, smoothLength, rawDuration, smoothDuration;
+    // --budget: 首解长度、改进次数，以及预算的 10% / 25% / 50% / 100% 时刻的路径长度
+    Summary firstLength, improvements;
+    Summary costAt[4];
+};
+
+const double kBudgetFractions[4] = {0.1, 0.25, 0.5, 1.0};
+
+const char* modeName(PlannerMode mode) {
+    switch (mode) {
+    case PlannerMode::RRT:        return "rrt";
+    case PlannerMode::RRTConnect: return "connect";
+    case PlannerMode::Parallel:   return "parallel";
+    case PlannerMode::RRTStar:    return "rrtstar";
+    }
+    return "unknown";
+}
+
+ScenarioResult runScenario(const Scenario& sc, int trials, uint32_t seed, NNIndexType nn, PlannerMode mode,
+                           bool smooth, double budgetMs) {
+    std::vector<double> wall, iters, tree, nearest, collision, length, solve;
+    std::vector<double> smoothMs, smoothLength, rawDuration, smoothDuration;
+    std::vector<double> firstLength, improvements, costAt[4];
+    ScenarioResult r;
+    r.name = sc.name;
+    r.mode = mode;
+    r.obstacles = sc.obstacles.size();
+    r.trials = trials;
+
+    for (int t = 0; t < trials; ++t) {
+        RRTPlanner planner;
+        for (const auto &o : sc.obstacles) planner.addObstacle(o);
+        planner.setSeed(seed + (uint32_t)t);
+        planner.setNearestNeighborType(nn);
+        planner.setProfiling(true);
+        planner.setMode(mode);
+
+        const std::vector<cv::Point3f> path = budgetMs > 0
+            ? planner.planPath(sc.start, sc.goal, std::chrono::microseconds((int64_t)(budgetMs * 1000.0)))
+            : planner.planPath(sc.start, sc.goal);
+        const PlanStats &st = planner.lastStats();
+        wall.push_back(st.totalMs);
+        iters.push_back(st.iterations);
+        tree.push_back((double)st.treeSize);
+        nearest.push_back(st.nearestMs);
+        collision.push_back(st.collisionMs);
+        if (st.success) {
+            ++r.successes;
+            length.push_back(st.pathLength);
+            solve.push_back(st.firstSolutionMs);
+            firstLength.push_back(st.firstPathLength);
+            improvements.push_back((double)st.costCurve.size());
+            if (budgetMs > 0) {
+                // 每个时刻取当时最好的长度 (那时还没有解就不计入)
+                for (int f = 0; f < 4; ++f) {
+                    float best = -1.0f;
+                    for (const CostSample &c : st.costCurve) {
+                        if (c.ms <= kBudgetFractions[f] * budgetMs) best = c.cost;
+                    }
+                    if (best > 0.0f) costAt[f].push_back(best);
+                }
+            }
+
+            if (smooth) {
+                SmootherOptions opt;
+                opt.seed = seed + (uint32_t)t;
+                PathSmoother smoother(planner.collisionChecker(), opt);
+                SmoothingReport rep;
+                smoother.process(path, &rep);
+                smoothMs.push_back(rep.elapsedMs);
+                smoothLength.push_back(rep.smoothLength);
+                rawDuration.push_back(rep.rawDuration);
+                smoothDuration.push_back(rep.smoothDuration);
+            }
+        }
+    }
+
+    r.wallMs = summarize(wall);
+    r.iterations = summarize(iters);
+    r.treeSize = summarize(tree);
+    r.nearestMs = summarize(nearest);
+    r.collisionMs = summarize(collision);
+    r.pathLength = summarize(length);
+    r.solveMs = summarize(solve);
+    r.smoothMs = summarize(smoothMs);
+    r.smoothLength = summarize(smoothLength);
+    r.rawDuration = summarize(rawDuration);
+    r.smoothDuration = summarize(smoothDuration);
+    r.firstLength = summarize(firstLength);
+    r.improvements = summarize(improvements);
+    for (int f = 0; f < 4; ++f) r.costAt[f] = summarize(costAt[f]);
+    return r;
+}
+
+// 同一个场景的 N 次试验: 逐个 planPath vs 一次 planBatch (两边的种子相同，路径完全一致)
+struct BatchResult {
+    std::string name;
+    int queries = 0;
+    int successes = 0;
+    int threads = 0;
+    double sequentialMs = 0.0;
+    double batchMs = 0.0;
+};
+
+BatchResult runBatch(const Scenario& sc, int trials, uint32_t seed, NNIndexType nn, PlannerMode mode, int threads) {
+    RRTPlanner planner;
+    for (const auto &o : sc.obstacles) planner.addObstacle(o);
+    planner.setNearestNeighborType(nn);
+    planner.setMode(mode);
+    std::vector<PlanQuery> queries(trials, PlanQuery{sc.start, sc.goal});
+
+    // 逐个规划: 种子和 planBatch 给每个查询分配的一样 (规划器引擎依次吐出的数)
+    BatchResult r;
+    r.name = sc.name;
+    r.queries = trials;
+    std::mt19937 seeds(seed);
+    std::vector<cv::Point3f> path;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int t = 0; t < trials; ++t) {
+        planner.setSeed((uint32_t)seeds());
+        planner.planPath(sc.start, sc.goal, path);
+    }
+    r.sequentialMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    planner.setSeed(seed);
+    for (const PlanResult &res : planner.planBatch(queries, threads)) r.successes += res.stats.success ? 1 : 0;
+    r.batchMs = planner.lastStats().totalMs;
+    r.threads = planner.lastStats().workers;
+    return r;
+}
+
+bool parseNN(const char* s, NNIndexType& out) {
+    if (!std::strcmp(s, "kdtree")) out = NNIndexType::KdTree;
+    else if (!std::strcmp(s, "grid")) out = NNIndexType::GridHash;
+    else if (!std::strcmp(s, "brute")) out = NNIndexType::BruteForce;
+    else return false;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    int trials = 50;
+    uint32_t seed = 1;
+    NNIndexType nn = NNIndexType::KdTree;
+    std::string only, jsonPath;
+    bool smooth = false;
+    double budgetMs = 0.0;
+    int batchThreads = -1;      // -1: 不跑批量对比；0: 线程池全部线程
+    std::vector<PlannerMode> modes{PlannerMode::RRT};
+
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--trials") && hasValue) trials = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--seed") && hasValue) seed = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--scenario") && hasValue) only = argv[++i];
+        else if (!std::strcmp(argv[i], "--json") && hasValue) jsonPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--smooth")) smooth = true;
+        else if (!std::strcmp(argv[i], "--budget") && hasValue) budgetMs = std::max(0.0, std::atof(argv[++i]));
+        else if (!std::strcmp(argv[i], "--batch")) {
+            batchThreads = 0;
+            if (hasValue && argv[i + 1][0] != '-') batchThreads = std::max(0, std::atoi(argv[++i]));
+        }
+        else if (!std::strcmp(argv[i], "--mode") && hasValue) {
+            const char *m = argv[++i];
+            if (!std::strcmp(m, "rrt")) modes = {PlannerMode::RRT};
+            else if (!std::strcmp(m, "connect")) modes = {PlannerMode::RRTConnect};
+            else if (!std::strcmp(m, "parallel")) modes = {PlannerMode::Parallel};
+            else if (!std::strcmp(m, "rrtstar")) modes = {PlannerMode::RRTStar};
+            else if (!std::strcmp(m, "all")) modes = {PlannerMode::RRT, PlannerMode::RRTConnect, PlannerMode::Parallel, PlannerMode::RRTStar};
+            else {
+                std::fprintf(stderr, "未知的 --mode: %s (可选 rrt / connect / parallel / rrtstar / all)\n", m);
+                return 1;
+            }
+        }
+        else if (!std::strcmp(argv[i], "--nn") && hasValue) {
+            if (!parseNN(argv[++i], nn)) {
+                std::fprintf(stderr, "未知的 --nn: %s (可选 kdtree / grid / brute)\n", argv[i]);
+                return 1;
+            }
+        } else {
+            std::fprintf(stderr, "用法: %s [--trials 50] [--seed 1] [--nn kdtree|grid|brute] [--mode rrt|connect|parallel|rrtstar|all] [--scenario 名字] [--json out.json|-] [--smooth] [--budget 毫秒] [--batch [线程数]]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // 时间预算版本总是 RRT*
+    if (budgetMs > 0) modes = {PlannerMode::RRTStar};
+
+    // planPath 每次成功/失败都会打一行 qDebug，跑几百次时关掉
+    QLoggingCategory::setFilterRules("default.debug=false");
+
+    std::vector<ScenarioResult> results;
+    std::printf("%-16s %-8s %5s %7s | %9s %9s | %9s %9s | %8s %8s | %8s %8s | %7s\n",
+                "场景", "算法", "障碍", "成功率", "p50 ms", "p90 ms", "出解p50", "出解p90",
+                "p50 迭代", "p50 节点", "最近邻ms", "碰撞ms", "p50 长度");
+    for (const Scenario &sc : buildScenarios()) {
+        if (!only.empty() && sc.name != only) continue;
+        for (PlannerMode mode : modes) {
+            ScenarioResult r = runScenario(sc, trials, seed, nn, mode, smooth, budgetMs);
+            std::printf("%-16s %-8s %5zu %6.0f%% | %9.2f %9.2f | %9.2f %9.2f | %8.0f %8.0f | %8.2f %8.2f | %7.3f\n",
+                        r.name.c_str(), modeName(mode), r.obstacles, 100.0 * r.successes / r.trials,
+                        r.wallMs.p50, r.wallMs.p90, r.solveMs.p50, r.solveMs.p90,
+                        r.iterations.p50, r.treeSize.p50,
+                        r.nearestMs.mean, r.collisionMs.mean, r.pathLength.p50);
+            results.push_back(r);
+        }
+    }
+
+    if (smooth) {
+        std::printf("\n路径后处理 (p50): v=%.2f m/s a=%.2f m/s^2\n", SmootherOptions().maxVel, SmootherOptions().maxAcc);
+        std::printf("%-16s %-8s | %9s %9s | %9s %9s | %9s\n",
+                    "场景", "算法", "原长度 m", "平滑后 m", "原时间 s", "平滑后 s", "处理 ms");
+        for (const ScenarioResult &r : results) {
+            if (r.successes == 0) continue;
+            std::printf("%-16s %-8s | %9.3f %9.3f | %9.2f %9.2f | %9.2f\n",
+                        r.name.c_str(), modeName(r.mode), r.pathLength.p50, r.smoothLength.p50,
+                        r.rawDuration.p50, r.smoothDuration.p50, r.smoothMs.p50);
+        }
+    }
+
+    if (budgetMs > 0) {
+        std::printf("\nRRT* 代价-时间曲线 (预算 %.1f ms，各列为 p50 路径长度 m，该时刻还没有解的试验不计入)\n", budgetMs);
+        std::printf("%-16s | %9s %9s | %9s %9s %9s %9s | %7s\n",
+                    "场景", "首解 ms", "首解 m", "10%", "25%", "50%", "100%", "改进次数");
+        for (const ScenarioResult &r : results) {
+            if (r.successes == 0) continue;
+            std::printf("%-16s | %9.2f %9.3f | %9.3f %9.3f %9.3f %9.3f | %7.0f\n",
+                        r.name.c_str(), r.solveMs.p50, r.firstLength.p50,
+                        r.costAt[0].p50, r.costAt[1].p50, r.costAt[2].p50, r.costAt[3].p50, r.improvements.p50);
+        }
+    }
+
+    std::vector<BatchResult> batches;
+    if (batchThreads >= 0 && budgetMs <= 0) {
+        // 并行模式在批量规划里按基础算法逐个查询，这里直接用第一个非并行的算法
+        PlannerMode mode = PlannerMode::RRTConnect;
+        for (PlannerMode m : modes) {
+            if (m != PlannerMode::Parallel) { mode = m; break; }
+        }
+        std::printf("\n批量规划 (%s, 每个场景 %d 个查询): 逐个 planPath vs planBatch\n", modeName(mode), trials);
+        std::printf("%-16s %7s %5s | %10s %10s | %7s | %9s\n",
+                    "场景", "成功率", "线程", "逐个 ms", "批量 ms", "加速比", "查询/s");
+        for (const Scenario &sc : buildScenarios()) {
+            if (!only.empty() && sc.name != only) continue;
+            const BatchResult b = runBatch(sc, trials, seed, nn, mode, batchThreads);
+            std::printf("%-16s %6.0f%% %5d | %10.2f %10.2f | %6.2fx | %9.0f\n",
+                        b.name.c_str(), 100.0 * b.successes / b.queries, b.threads, b.sequentialMs, b.batchMs,
+                        b.sequentialMs / std::max(b.batchMs, 1e-6), 1000.0 * b.queries / std::max(b.batchMs, 1e-6));
+            batches.push_back(b);
+        }
+    }
+
+    if (!jsonPath.empty()) {
+        std::ostringstream js;
+        js << "{\n  \"seed\": " << seed << ",\n  \"trials\": " << trials << ",\n  \"budget_ms\": " << budgetMs
+           << ",\n  \"nn\": \"" << nnIndexTypeName(nn) << "\",\n  \"scenarios\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const ScenarioResult &r = results[i];
+            js << "    {\"name\": \"" << r.name << "\", \"mode\": \"" << modeName(r.mode)
+               << "\", \"obstacles\": " << r.obstacles
+               << ", \"success_rate\": " << (double)r.successes / r.trials
+               << ",\n     \"wall_ms\": " << summaryJson(r.wallMs)
+               << ",\n     \"solve_ms\": " << summaryJson(r.solveMs)
+               << ",\n     \"iterations\": " << summaryJson(r.iterations)
+               << ",\n     \"tree_size\": " << summaryJson(r.treeSize)
+               << ",\n     \"nearest_ms\": " << summaryJson(r.nearestMs)
+               << ",\n     \"collision_ms\": " << summaryJson(r.collisionMs)
+               << ",\n     \"path_length\": " << summaryJson(r.pathLength)
+               << ",\n     \"first_length\": " << summaryJson(r.firstLength);
+            if (budgetMs > 0) {
+                js << ",\n     \"improvements\": " << summaryJson(r.improvements);
+                for (int f = 0; f < 4; ++f) {
+                    js << ",\n     \"length_at_" << (int)(kBudgetFractions[f] * 100) << "pct\": " << summaryJson(r.costAt[f]);
+                }
+            }
+            if (smooth) {
+                js << ",\n     \"smooth_ms\": " << summaryJson(r.smoothMs)
+                   << ",\n     \"smooth_length\": " << summaryJson(r.smoothLength)
+                   << ",\n     \"raw_duration_s\": " << summaryJson(r.rawDuration)
+                   << ",\n     \"smooth_duration_s\": " << summaryJson(r.smoothDuration);
+            }
+            js << "}"
+               << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        js << "  ]";
+        if (!batches.empty()) {
+            js << ",\n  \"batch\": [\n";
+            for (size_t i = 0; i < batches.size(); ++i) {
+                const BatchResult &b = batches[i];
+                js << "    {\"name\": \"" << b.name << "\", \"queries\": " << b.queries
+                   << ", \"success_rate\": " << (double)b.successes / b.queries << ", \"threads\": " << b.threads
+                   << ", \"sequential_ms\": " << b.sequentialMs << ", \"batch_ms\": " << b.batchMs << "}"
+                   << (i + 1 < batches.size() ? ",\n" : "\n");
+            }
+            js << "  ]";
+        }
+        js << "\n}\n";
+
+        if (jsonPath == "-") {
+            std::fputs(js.str().c_str(), stdout);
+        } else {
+            std::ofstream f(jsonPath);
+            f << js.str();
+            if (!f) {
+                std::fprintf(stderr, "❌ 写入 JSON 失败: %s\n", jsonPath.c_str());
+                return 1;
+            }
+            std::printf("JSON 已写入: %s\n", jsonPath.c_str());
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,169 @@
+#include "tools/Path_Plan/RRTPlanner.h"
+#include "tools/Robot/MockUrController.h"
+#include "tools/Robot/MotionCommandChannel.h"
+#include "tools/Robot/RobotStateReceiver.h"
+#include "tools/Robot/TrajectoryExecutor.h"
+#include "tools/Trace/LatencyTrace.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+// 轨迹执行对比: 同一条 RRT 路径，整段转接程序 (Blended) vs 逐点 movel (PointByPoint)
+// 需要一个在线的控制器: URSim、本机的 Mock_UR / mock_ur.py，或者加 --mock 在进程内启动模拟控制器 (500 Hz)
+// 用法:
+//   ./Traj_Bench [--host 127.0.0.1] [--port 30003] [--trials 3] [--seed 1] [--vel 0.1] [--acc 0.5] [--movel] [--mock]
+// 设置 UR_TRACE=1 时最后输出各延迟探针 (规划、指令排队 / 发送、状态回显) 的分位数
+
+namespace {
+
+struct Options {
+    QString host = "127.0.0.1";
+    quint16 port = 30003;
+    int trials = 3;
+    uint32_t seed = 1;
+    double vel = 0.1;
+    double acc = 0.5;
+    bool moveL = false;
+    bool mock = false;
+};
+
+// 基座坐标系下机械臂前方的一块空间 (与 mock_ur.py 的初始位姿一致)
+const cv::Point3f kStart(0.4f, 0.0f, 0.3f);
+const cv::Point3f kGoal(-0.3f, 0.4f, 0.5f);
+
+std::vector<SphereObstacle> makeObstacles(int count, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> ux(-0.5f, 0.6f), uy(-0.3f, 0.6f), uz(0.1f, 0.7f), ur(0.03f, 0.06f);
+    std::vector<SphereObstacle> obs;
+    while ((int)obs.size() < count) {
+        SphereObstacle o{cv::Point3f(ux(gen), uy(gen), uz(gen)), ur(gen)};
+        const float keepOut = o.radius + 0.1f;
+        if (cv::norm(o.center - kStart) < keepOut || cv::norm(o.center - kGoal) < keepOut) continue;
+        obs.push_back(o);
+    }
+    return obs;
+}
+
+// 周期调用 update() 直到结束
+bool runToEnd(TrajectoryExecutor& exec) {
+    while (exec.update() == ExecutionState::Running) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    return exec.state() == ExecutionState::Finished;
+}
+
+bool moveTo(TrajectoryExecutor& exec, const cv::Point3f& p) {
+    return exec.execute({p}, TrajectoryMode::PointByPoint) && runToEnd(exec);
+}
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        auto next = [&](const char* name) -> const char* {
+            if (std::strcmp(argv[i], name) != 0 || i + 1 >= argc) return nullptr;
+            return argv[++i];
+        };
+        const char* v;
+        if ((v = next("--host"))) opt.host = v;
+        else if ((v = next("--port"))) opt.port = quint16(std::atoi(v));
+        else if ((v = next("--trials"))) opt.trials = std::max(1, std::atoi(v));
+        else if ((v = next("--seed"))) opt.seed = uint32_t(std::atoi(v));
+        else if ((v = next("--vel"))) opt.vel = std::atof(v);
+        else if ((v = next("--acc"))) opt.acc = std::atof(v);
+        else if (std::strcmp(argv[i], "--movel") == 0) opt.moveL = true;
+        else if (std::strcmp(argv[i], "--mock") == 0) opt.mock = true;
+        else { std::fprintf(stderr, "未知参数: %s\n", argv[i]); return 2; }
+    }
+    qDebug() << "🚀 启动轨迹执行对比测试...";
+
+    // 1. 规划
+    const std::vector<SphereObstacle> obstacles = makeObstacles(20, opt.seed);
+    RRTPlanner planner;
+    planner.setSeed(opt.seed);
+    planner.setMode(PlannerMode::RRTConnect);
+    for (const auto &o : obstacles) planner.addObstacle(o);
+    const std::vector<cv::Point3f> path = planner.planPath(kStart, kGoal);
+    if (path.empty()) {
+        std::fprintf(stderr, "规划失败\n");
+        return 1;
+    }
+    CollisionChecker checker;
+    checker.setObstacles(obstacles);
+
+    // 2. 连接控制器 (--mock: 先在本进程里起一个模拟控制器)
+    std::unique_ptr<MockUrController> mock;
+    if (opt.mock) {
+        MockControllerOptions mo;
+        mo.host = opt.host;
+        mo.ports = {opt.port};
+        mo.rateHz = 500.0;
+        mo.logCommands = false;
+        mock = std::make_unique<MockUrController>(mo);
+        if (!mock->start()) return 1;
+    }
+    RobotStateReceiver receiver(opt.host, opt.port);
+    receiver.start();
+    MotionCommandChannel channel(opt.host, opt.port);
+    channel.setStateSource(&receiver);
+    channel.start();
+
+    RobotState rs;
+    for (int i = 0; i < 300 && !(receiver.latest(rs) && channel.isConnected()); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (!receiver.latest(rs) || !channel.isConnected()) {
+        std::fprintf(stderr, "连不上控制器 %s:%d (先启动 URSim / Mock_UR，或加 --mock)\n", qPrintable(opt.host), opt.port);
+        return 1;
+    }
+
+    TrajectoryExecutor exec(channel, receiver);
+    TrajectoryOptions to;
+    to.vel = opt.vel;
+    to.acc = opt.acc;
+    to.useMoveP = !opt.moveL;
+    exec.setOptions(to);
+    exec.setCollisionChecker(&checker);
+
+    std::printf("路径: %zu 个点，长度 %.3f m | v=%.3f m/s a=%.2f m/s^2 | %s\n",
+                path.size(), planner.lastStats().pathLength, opt.vel, opt.acc, opt.moveL ? "movel" : "movep");
+    std::printf("%14s | %6s | %6s | %8s | %10s | %10s | %10s\n",
+                "方式", "指令数", "转接点", "字节数", "平均 ms", "最短 ms", "最长 ms");
+
+    for (TrajectoryMode mode : {TrajectoryMode::Blended, TrajectoryMode::PointByPoint}) {
+        double sum = 0.0, best = 1e30, worst = 0.0;
+        TrajectoryReport last;
+        for (int t = 0; t < opt.trials; ++t) {
+            if (!moveTo(exec, kStart)) { std::fprintf(stderr, "回到起点失败\n"); return 1; }
+            if (!exec.execute(path, mode) || !runToEnd(exec)) {
+                std::fprintf(stderr, "执行失败 (进度 %.1f%%)\n", exec.progress() * 100.0);
+                return 1;
+            }
+            last = exec.report();
+            sum += last.totalMs;
+            best = std::min(best, last.totalMs);
+            worst = std::max(worst, last.totalMs);
+        }
+        std::printf("%14s | %6d | %6d | %8d | %10.1f | %10.1f | %10.1f\n",
+                    mode == TrajectoryMode::Blended ? "整段转接" : "逐点",
+                    last.commands, last.blended, last.programBytes, sum / opt.trials, best, worst);
+    }
+
+    const MotionChannelStats ms = channel.stats();
+    std::printf("指令通道: 已发 %llu | 排队平均 %.3f ms | 响应平均 %.1f ms\n",
+                (unsigned long long)ms.sent, ms.queueMsAvg, ms.echoMsAvg);
+    if (mock) {
+        const MockControllerStats mst = mock->stats();
+        std::printf("模拟控制器: 收到指令 %llu | 收到 -> 体现在状态包 平均 %.2f / 最大 %.2f ms | 发包排期延后 平均 %.3f / 最大 %.3f ms\n",
+                    (unsigned long long)mst.commands, mst.reflectMsAvg, mst.reflectMsMax, mst.sendLateMsAvg,
+                    mst.sendLateMsMax);
+    }
+    if (LatencyTrace::enabled()) std::printf("延迟探针:\n%s\n", LatencyTrace::summaryText().c_str());
+    return 0;
+}
@@ -0,0 +1,330 @@
+#include "tools/Detector/YoloDetector.h"
+#include "tools/Detector/DetectionPipeline.h"
+#include "tools/Camera/CameraCapture.h"
+#include "tools/Camera/PlaybackCameraSource.h"
+#include <QDebug>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+
+// YOLO 检测吞吐量对比: 逐张 detect() vs 一次前向的 detectBatch()，
+// 以及 30 FPS 输入下异步流水线 (DetectionPipeline) 的端到端延迟和丢帧，
+// 还有输出解析 (后处理) 的新旧实现对比
+// 用法:
+//   ./YOLO_Bench model.onnx [image.jpg] [batch=4] [iterations=20]
+//       跑模型时会把一次推理的输出张量录到 yolo_output.bin
+//   ./YOLO_Bench --decode [yolo_output.bin] [iterations=2000]
+//       只测后处理: 旧实现 (转置 + 标量循环) vs YoloDecoder，不需要模型；不给文件时用合成张量
+//   ./YOLO_Bench model.onnx --playback <录像 basePath> [秒数=10]
+//       用录下的多路画面 (FrameRecorder) 按原始节奏循环回放，经 CameraCapture 送进流水线，
+//       每次运行输入完全相同，不需要相机
+// 不给图片时用随机噪声图 (只比较吞吐量，不关心检测结果)
+
+namespace {
+double nowSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ================= 后处理对比 =================
+
+// 旧版解析 (原 YoloDetector::decodeOutput 的写法，保留作为基准):
+// 先把 [dims, anchors] 转置成 [anchors, dims]，再逐行标量判断第 4 列
+void legacyDecode(const cv::Mat& output, const cv::Size& imgSize, std::vector<Detection>& detections) {
+    detections.clear();
+    int dimensions = output.size[1];
+    int rows = output.size[2];
+    float* slice = const_cast<float*>(output.ptr<float>());
+
+    cv::Mat output0;
+    if (dimensions > rows) {
+        rows = output.size[1];
+        dimensions = output.size[2];
+        output0 = cv::Mat(rows, dimensions, CV_32F, slice);
+    } else {
+        cv::Mat raw(dimensions, rows, CV_32F, slice);
+        cv::transpose(raw, output0);
+    }
+
+    float* data = (float*)output0.data;
+    float x_factor = (float)imgSize.width / 640;
+    float y_factor = (float)imgSize.height / 640;
+
+    std::vector<int> class_ids;
+    std::vector<float> confidences;
+    std::vector<cv::Rect> boxes;
+    for (int i = 0; i < rows; ++i) {
+        float conf = data[4];
+        if (conf > 0.5f) {
+            float cx = data[0], cy = data[1], w = data[2], h = data[3];
+            boxes.push_back(cv::Rect(int((cx - 0.5 * w) * x_factor), int((cy - 0.5 * h) * y_factor),
+                                     int(w * x_factor), int(h * y_factor)));
+            confidences.push_back(conf);
+            class_ids.push_back(0);
+        }
+        data += dimensions;
+    }
+
+    std::vector<int> nms_result;
+    cv::dnn::NMSBoxes(boxes, confidences, 0.5f, 0.4f, nms_result);
+    for (int idx : nms_result) detections.push_back({class_ids[idx], confidences[idx], boxes[idx]});
+}
+
+// 张量文件格式: 3 个 int32 维度 + float32 数据
+bool saveTensor(const std::string& path, const cv::Mat& t) {
+    std::ofstream f(path, std::ios::binary);
+    if (!f || t.dims != 3 || t.type() != CV_32F || !t.isContinuous()) return false;
+    int32_t shape[3] = {t.size[0], t.size[1], t.size[2]};
+    f.write(reinterpret_cast<const char*>(shape), sizeof(shape));
+    f.write(reinterpret_cast<const char*>(t.ptr<float>()), t.total() * sizeof(float));
+    return bool(f);
+}
+
+bool loadTensor(const std::string& path, cv::Mat& t) {
+    std::ifstream f(path, std::ios::binary);
+    int32_t shape[3] = {0, 0, 0};
+    if (!f.read(reinterpret_cast<char*>(shape), sizeof(shape))) return false;
+    if (shape[0] <= 0 || shape[1] <= 0 || shape[2] <= 0) return false;
+    int sizes[3] = {shape[0], shape[1], shape[2]};
+    t.create(3, sizes, CV_32F);
+    return bool(f.read(reinterpret_cast<char*>(t.ptr<float>()), t.total() * sizeof(float)));
+}
+
+// 合成一个单类别输出 [1, 5, 8400]: 大部分 anchor 是低分噪声，少数几簇高分框
+cv::Mat syntheticTensor() {
+    const int dims = 5, anchors = 8400;
+    int sizes[3] = {1, dims, anchors};
+    cv::Mat t(3, sizes, CV_32F);
+    float *d = t.ptr<float>();
+    cv::RNG rng(12345);
+    for (int i = 0; i < anchors; ++i) {
+        d[i] = rng.uniform(0.f, 640.f);
+        d[anchors + i] = rng.uniform(0.f, 640.f);
+        d[2 * anchors + i] = rng.uniform(10.f, 120.f);
+        d[3 * anchors + i] = rng.uniform(10.f, 120.f);
+        d[4 * anchors + i] = rng.uniform(0.f, 0.3f);
+    }
+    for (int k = 0; k < 40; ++k) {
+        int i = rng.uniform(0, anchors);
+        d[4 * anchors + i] = rng.uniform(0.55f, 0.95f);
+    }
+    return t;
+}
+
+bool sameDetections(const std::vector<Detection>& a, const std::vector<Detection>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].class_id != b[i].class_id || a[i].confidence != b[i].confidence || a[i].box != b[i].box)
+            return false;
+    }
+    return true;
+}
+
+void benchDecode(const cv::Mat& tensor, const cv::Size& imgSize, int iterations) {
+    const int dims = std::min(tensor.size[1], tensor.size[2]);
+    const int anchors = std::max(tensor.size[1], tensor.size[2]);
+    const bool anchorMajor = tensor.size[1] > tensor.size[2];
+
+    YoloDecoder decoder;
+    const InputTransform tf = InputTransform::stretch(imgSize, cv::Size(640, 640));
+    std::vector<Detection> oldDet, newDet;
+
+    // 预热 + 结果校验
+    legacyDecode(tensor, imgSize, oldDet);
+    decoder.decode(tensor.ptr<float>(), dims, anchors, anchorMajor, tf, newDet);
+
+    double t0 = nowSeconds();
+    for (int it = 0; it < iterations; ++it) legacyDecode(tensor, imgSize, oldDet);
+    double legacy = nowSeconds() - t0;
+
+    t0 = nowSeconds();
+    for (int it = 0; it < iterations; ++it)
+        decoder.decode(tensor.ptr<float>(), dims, anchors, anchorMajor, tf, newDet);
+    double fast = nowSeconds() - t0;
+
+    std::printf("后处理 [%d x %d]%s, iterations = %d, 检测框 %zu 个\n", dims, anchors,
+                anchorMajor ? " (anchor 优先)" : "", iterations, newDet.size());
+    std::printf("旧实现 (转置 + 标量) : %8.1f us/帧\n", legacy * 1e6 / iterations);
+    std::printf("YoloDecoder          : %8.1f us/帧\n", fast * 1e6 / iterations);
+    std::printf("加速比               : %8.2fx\n", legacy / fast);
+    if (dims == 5) {
+        std::printf("结果一致             : %s\n", sameDetections(oldDet, newDet) ? "是" : "否 ❌");
+    } else {
+        // 旧实现只看第一个类别的分数，多类别模型结果本来就不同
+        std::printf("结果一致             : 跳过 (多类别模型，旧实现只看类别 0)\n");
+    }
+}
+
+// 模拟一路 30 FPS 相机持续送帧，统计流水线的端到端延迟
+void benchPipeline(YoloDetector& detector, const cv::Mat& img, int seconds) {
+    DetectionPipeline pipeline(detector);
+    pipeline.start();
+
+    const auto period = std::chrono::microseconds(33333);
+    auto next = std::chrono::steady_clock::now();
+    const int frames = seconds * 30;
+    for (int i = 1; i <= frames; ++i) {
+        CameraFrame frame;
+        frame.image = img;
+        frame.size = img.size();
+        frame.seq = i;
+        frame.timestampNs = nowNs();
+        pipeline.submit(0, frame);
+
+        next += period;
+        std::this_thread::sleep_until(next);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(500)); // 等最后几帧出结果
+    PipelineStats st = pipeline.stats();
+    pipeline.stop();
+
+    std::printf("流水线 (30 FPS 输入, %d 秒): 提交 %llu | 完成 %llu | 丢弃旧帧 %llu\n",
+                seconds, (unsigned long long)st.submitted, (unsigned long long)st.completed,
+                (unsigned long long)st.droppedStale);
+    std::printf("端到端延迟 (采集 -> 结果): 平均 %.2f ms | 最近一帧 %.2f ms\n",
+                st.avgLatencyMs, st.lastLatencyMs);
+}
+
+// 录像回放驱动的流水线: 和 MainWindow 一样每路一个 CameraCapture，轮询最新帧提交
+int benchPlayback(YoloDetector& detector, const std::string& base, int seconds) {
+    PlaybackOptions options;
+    options.loop = true;
+    options.rebaseTimestamps = true;    // 时间戳平移到回放时钟，端到端延迟才有意义
+    auto session = PlaybackSession::open(base);
+    if (!session) {
+        std::printf("❌ 打不开录像: %s\n", base.c_str());
+        return 1;
+    }
+    std::vector<std::unique_ptr<CameraCapture>> cams;
+    for (int c = 0; c < session->recording().cameraCount(); ++c) {
+        auto cam = std::make_unique<CameraCapture>(c, createPlaybackSource(c, base, options));
+        if (cam->isOpened()) cams.push_back(std::move(cam));
+    }
+
+    DetectionPipeline pipeline(detector);
+    std::atomic<uint64_t> detections{0};
+    pipeline.setResultCallback([&](const DetectionResult& r) { detections.fetch_add(r.detections.size()); });
+    pipeline.start();
+    for (auto &cam : cams) cam->start();
+
+    std::vector<uint64_t> lastSeq(cams.size(), 0);
+    const auto end = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+    while (std::chrono::steady_clock::now() < end) {
+        CameraFrame frame;
+        for (size_t c = 0; c < cams.size(); ++c) {
+            if (cams[c]->latestFrame(frame, lastSeq[c])) {
+                lastSeq[c] = frame.seq;
+                pipeline.submit(cams[c]->index(), frame);
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    for (auto &cam : cams) cam->stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(500)); // 等最后几帧出结果
+    PipelineStats st = pipeline.stats();
+    pipeline.stop();
+
+    std::printf("回放流水线 (%zu 路录像, %d 秒): 提交 %llu | 完成 %llu | 丢弃旧帧 %llu | 检测框 %llu\n",
+                cams.size(), seconds, (unsigned long long)st.submitted, (unsigned long long)st.completed,
+                (unsigned long long)st.droppedStale, (unsigned long long)detections.load());
+    std::printf("端到端延迟 (采集 -> 结果): 平均 %.2f ms | 最近一帧 %.2f ms\n",
+                st.avgLatencyMs, st.lastLatencyMs);
+    return 0;
+}
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        std::printf("用法: %s model.onnx [image.jpg] [batch=4] [iterations=20]\n", argv[0]);
+        std::printf("      %s --decode [tensor.bin] [iterations=2000]\n", argv[0]);
+        std::printf("      %s model.onnx --playback <录像> [秒数=10]\n", argv[0]);
+        return 1;
+    }
+
+    if (std::strcmp(argv[1], "--decode") == 0) {
+        cv::Mat tensor;
+        if (argc > 2 && !loadTensor(argv[2], tensor)) {
+            std::printf("❌ 读取张量失败: %s\n", argv[2]);
+            return 1;
+        }
+        if (tensor.empty()) tensor = syntheticTensor();
+        const int iterations = argc > 3 ? std::atoi(argv[3]) : 2000;
+        benchDecode(tensor, cv::Size(1920, 1080), iterations);
+        return 0;
+    }
+    qDebug() << "🚀 启动 YOLO 吞吐量测试...";
+
+    YoloDetector detector;
+    if (!detector.loadModel(argv[1])) return 1;
+
+    if (argc > 3 && std::strcmp(argv[2], "--playback") == 0) {
+        return benchPlayback(detector, argv[3], argc > 4 ? std::max(1, std::atoi(argv[4])) : 10);
+    }
+
+    cv::Mat img;
+    if (argc > 2) img = cv::imread(argv[2]);
+    if (img.empty()) {
+        img = cv::Mat(1080, 1920, CV_8UC3);
+        cv::randu(img, cv::Scalar(0, 0, 0), cv::Scalar(255, 255, 255));
+    }
+    const int batch = argc > 3 ? std::atoi(argv[3]) : 4;
+    const int iterations = argc > 4 ? std::atoi(argv[4]) : 20;
+
+    // 模拟多路相机: 同一张图的多个副本 (各自独立内存)
+    std::vector<cv::Mat> imgs;
+    for (int i = 0; i < batch; ++i) imgs.push_back(img.clone());
+
+    // 预热 (第一次 forward 会做图优化 / 内存分配)
+    cv::Mat debugImg;
+    detector.detect(img, debugImg);
+    detector.detectBatch(imgs);
+
+    // 1. 逐张推理
+    double t0 = nowSeconds();
+    for (int it = 0; it < iterations; ++it) {
+        for (const auto &m : imgs) detector.detect(m, debugImg);
+    }
+    double single = nowSeconds() - t0;
+
+    // 2. 批量推理
+    t0 = nowSeconds();
+    size_t found = 0;
+    for (int it = 0; it < iterations; ++it) {
+        auto results = detector.detectBatch(imgs);
+        found += results.empty() ? 0 : results[0].size();
+    }
+    double batched = nowSeconds() - t0;
+
+    const double images = static_cast<double>(batch) * iterations;
+    std::printf("batch = %d, iterations = %d, 模型支持动态 batch: %s\n",
+                batch, iterations, detector.batchSupported() ? "是" : "否 (已退化为逐张)");
+    std::printf("逐张 detect()      : %8.2f 张/秒  (%7.2f ms/张)\n", images / single, single * 1000.0 / images);
+    std::printf("批量 detectBatch() : %8.2f 张/秒  (%7.2f ms/张)\n", images / batched, batched * 1000.0 / images);
+    std::printf("加速比             : %8.2fx\n", single / batched);
+    (void)found;
+
+    // 3. 录一次输出张量，对比后处理新旧实现
+    cv::Mat blob, output;
+    detector.preprocess(img, blob);
+    if (detector.forward(blob, output)) {
+        output = output.clone();    // forward 的输出缓冲区会被复用
+        if (saveTensor("yolo_output.bin", output)) std::printf("输出张量已保存: yolo_output.bin\n");
+        int sizes[3] = {1, output.size[1], output.size[2]};
+        benchDecode(cv::Mat(3, sizes, CV_32F, output.ptr<float>()), img.size(), 2000);
+    }
+
+    // 4. 异步流水线
+    benchPipeline(detector, img, 5);
+    return 0;
+}
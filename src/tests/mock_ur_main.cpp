@@ -0,0 +1,74 @@
+#include "tools/Robot/MockUrController.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+// C++ 版模拟 UR 控制器: 按 125 / 500 Hz 推送 30003 实时状态包，speedl / stopl / movel / movep 和 def ... end 程序
+// 会作用到仿真的 TCP 上并体现在状态流里，每条指令记录接收时间戳。可同时监听多个端口、接受多个客户端。
+// 和 mock_ur.py 行为一致，但发包节奏稳定，可以用来在本机测指令 -> 状态的延迟 (例如 Traj_Bench)。
+// 用法:
+//   ./Mock_UR [--host 127.0.0.1] [--port 30003]... [--rate 125] [--drop-every 0] [--log commands.csv] [--quiet]
+// Ctrl+C 退出；每 5 秒打印一次统计
+
+namespace {
+std::atomic<bool> g_quit{false};
+
+void onSignal(int) {
+    g_quit.store(true);
+}
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    MockControllerOptions options;
+    options.ports.clear();
+    for (int i = 1; i < argc; ++i) {
+        auto next = [&](const char* name) -> const char* {
+            if (std::strcmp(argv[i], name) != 0 || i + 1 >= argc) return nullptr;
+            return argv[++i];
+        };
+        const char* v;
+        if ((v = next("--host"))) options.host = v;
+        else if ((v = next("--port"))) options.ports.push_back(quint16(std::atoi(v)));
+        else if ((v = next("--rate"))) options.rateHz = std::atof(v);
+        else if ((v = next("--drop-every"))) options.dropEvery = std::atoi(v);
+        else if ((v = next("--log"))) options.commandLogPath = v;
+        else if (std::strcmp(argv[i], "--quiet") == 0) options.logCommands = false;
+        else { std::fprintf(stderr, "未知参数: %s\n", argv[i]); return 2; }
+    }
+    if (options.ports.empty()) options.ports.push_back(30003);
+
+    MockUrController controller(options);
+    if (!controller.start()) return 1;
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    auto lastPrint = std::chrono::steady_clock::now();
+    MockControllerStats last;
+    while (!g_quit.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        const auto now = std::chrono::steady_clock::now();
+        const double elapsed = std::chrono::duration<double>(now - lastPrint).count();
+        if (elapsed < 5.0) continue;
+        const MockControllerStats s = controller.stats();
+        std::printf("📊 连接 %d | 发包 %.1f 包/s (故意丢 %llu, 积压跳过 %llu) | 排期延后 平均 %.3f / 最大 %.3f ms | "
+                    "指令 %llu (不认识 %llu) | 收到 -> 体现在状态包 平均 %.2f / 最大 %.2f ms\n",
+                    s.clients, (s.packetsSent - last.packetsSent) / elapsed, (unsigned long long)s.packetsDropped,
+                    (unsigned long long)s.packetsBlocked, s.sendLateMsAvg, s.sendLateMsMax,
+                    (unsigned long long)s.commands, (unsigned long long)s.unknownCommands, s.reflectMsAvg,
+                    s.reflectMsMax);
+        std::fflush(stdout);
+        last = s;
+        lastPrint = now;
+    }
+
+    controller.stop();
+    qDebug() << "⏹️ 模拟控制器已退出";
+    return 0;
+}
@@ -0,0 +1,250 @@
+#include "tools/Robot/RobotState.h"
+#include "tools/Robot/MotionCommandChannel.h"
+#include "tools/Robot/MockUrController.h"
+#include "tools/Robot/URKinematics.h"
+#include <QDebug>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+// 机械臂通信测试 (不需要真机):
+//   30003 实时状态包按 UR 官方 "Real-Time Interface" 文档的字节偏移手工拼包解码，
+//   不用 RobotStateEncoder (编码器和解码器共用一张偏移表，往返一致证明不了偏移对)；编码器的输出也按文档偏移抽查；
+//   指令通道对着进程内的模拟控制器 (MockUrController) 发指令，检查控制器实际收到了什么 (含断线重连)；
+//   UR12e 逆运动学往返
+
+namespace {
+
+void putBE(std::vector<unsigned char>& packet, size_t offset, double v) {
+    uint64_t bits;
+    std::memcpy(&bits, &v, 8);
+    for (int i = 7; i >= 0; --i) {
+        packet[offset + i] = static_cast<unsigned char>(bits & 0xFF);
+        bits >>= 8;
+    }
+}
+
+double getBE(const std::vector<unsigned char>& packet, size_t offset) {
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; ++i) bits = (bits << 8) | packet[offset + i];
+    double v;
+    std::memcpy(&v, &bits, 8);
+    return v;
+}
+
+// 最多等 timeoutMs 毫秒直到条件成立
+bool waitFor(const std::function<bool()>& done, int timeoutMs) {
+    for (int i = 0; i < timeoutMs / 10 && !done(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return done();
+}
+
+MockControllerOptions mockOptions(quint16 port) {
+    MockControllerOptions mo;
+    mo.ports = {port};
+    mo.logCommands = false;
+    return mo;
+}
+
+} // namespace
+
+// CB3.5 格式 1108 字节: 各字段写在文档里的字节偏移上，关节电压 (V actual, 996 ~ 1043) 填干扰值
+static bool checkLiteralOffsets() {
+    const size_t bytes = 1108;
+    std::vector<unsigned char> packet(bytes, 0);
+    packet[0] = 0x00; packet[1] = 0x00; packet[2] = 0x04; packet[3] = 0x54;   // 1108
+
+    putBE(packet, 4, 12.5);                                     // time
+    for (int i = 0; i < 6; ++i) putBE(packet, 252 + 8 * i, 0.1 * (i + 1));   // q actual
+    for (int i = 0; i < 6; ++i) putBE(packet, 444 + 8 * i, -0.2 * (i + 1));  // tool vector actual
+    putBE(packet, 684, 5.0);                                    // digital input bits
+    putBE(packet, 756, 7.0);                                    // robot mode: RUNNING
+    putBE(packet, 812, 1.0);                                    // safety mode: NORMAL
+    putBE(packet, 940, 0.5);                                    // speed scaling
+    for (int i = 0; i < 6; ++i) putBE(packet, 996 + 8 * i, 48.0 + i);        // V actual
+    putBE(packet, 1044, 129.0);                                 // digital outputs (0x81)
+    putBE(packet, 1052, 2.0);                                   // program state: PLAYING
+
+    RobotState st;
+    bool ok = RobotStateDecoder::readLength(packet.data()) == bytes &&
+              RobotStateDecoder::decode(packet.data(), bytes, st);
+    ok = ok && st.time == 12.5 && st.digitalInputs == 5 && st.robotMode == 7.0 && st.safetyMode == 1.0 &&
+         st.speedScaling == 0.5 && st.digitalOutputs == 0x81 && st.programState == 2.0 && st.validFields == 18;
+    for (int i = 0; ok && i < 6; ++i) {
+        ok = st.qActual[i] == 0.1 * (i + 1) && st.tcpPose[i] == -0.2 * (i + 1);
+    }
+
+    qDebug() << (ok ? "✅" : "❌") << "状态包按文档偏移解码: 数字输出" << st.digitalOutputs << "程序状态" << st.programState
+             << "字段组" << st.validFields;
+    return ok;
+}
+
+// 30003 状态包: 模拟控制器编码的包，接收端解码后字段必须原样还原
+static bool checkRobotStateCodec() {
+    RobotState in;
+    in.time = 12.345;
+    for (int i = 0; i < 6; ++i) {
+        in.qTarget[i] = 0.1 * i - 0.25;
+        in.qdTarget[i] = -0.01 * i;
+        in.qActual[i] = 1.0 / (i + 3);
+        in.tcpPose[i] = 0.3 - 0.07 * i;
+        in.tcpSpeed[i] = 1e-3 * i;
+        in.jointModes[i] = 253.0;
+    }
+    in.digitalInputs = 0x5A;
+    in.digitalOutputs = 0x81;
+    in.robotMode = 7.0;
+    in.safetyMode = 1.0;
+    in.speedScaling = 0.75;
+    in.programState = 2.0;
+
+    std::vector<unsigned char> packet(RobotStateEncoder::kPacketBytes);
+    const size_t bytes = RobotStateEncoder::encode(in, packet.data());
+    RobotState out;
+    bool ok = bytes == RobotStateEncoder::kPacketBytes && RobotStateDecoder::readLength(packet.data()) == bytes &&
+              RobotStateDecoder::decode(packet.data(), bytes, out);
+    // 编码器也按文档偏移写: 数字输出在 1044，程序状态在 1052 (不经过共用的偏移表)
+    ok = ok && getBE(packet, 1044) == 129.0 && getBE(packet, 1052) == 2.0 && getBE(packet, 252) == in.qActual[0];
+    ok = ok && out.time == in.time && out.digitalInputs == in.digitalInputs &&
+         out.digitalOutputs == in.digitalOutputs && out.speedScaling == in.speedScaling &&
+         out.programState == in.programState && out.validFields == 18;
+    for (int i = 0; ok && i < 6; ++i) {
+        ok = out.qTarget[i] == in.qTarget[i] && out.qdTarget[i] == in.qdTarget[i] && out.qActual[i] == in.qActual[i] &&
+             out.tcpPose[i] == in.tcpPose[i] && out.tcpSpeed[i] == in.tcpSpeed[i] && out.jointModes[i] == in.jointModes[i];
+    }
+    qDebug() << (ok ? "✅" : "❌") << "状态包编解码往返检查:" << bytes << "字节, 字段组" << out.validFields;
+    return ok;
+}
+
+// 急停: 停止之前排队的脚本 (如 movel) 必须作废，控制器收到 stopl 之后不能再收到别的指令
+static bool checkStopDropsQueuedScripts() {
+    const quint16 port = 30093;
+    MockUrController mock(mockOptions(port));
+    if (!mock.start()) return false;
+
+    const QByteArray movel("movel(p[-0.4, -0.2, 0.3, 0, 3.14, 0], a=0.5, v=0.1, r=0)");
+    MotionCommandChannel channel("127.0.0.1", port);
+    const bool rejectedOffline = channel.sendScript(movel) == 0;    // 还没连上，直接拒绝
+    channel.start();
+    bool ok = waitFor([&] { return channel.isConnected(); }, 3000);
+
+    // 一口气排满脚本再停止: 通道线程来不及发出的脚本都由停止作废，发出的和作废的加起来一条不少
+    const int scripts = 16;
+    int queued = 0;
+    for (int i = 0; i < scripts; ++i) queued += channel.sendScript(movel) != 0;
+    const bool stopSent = channel.sendStop(0.5) != 0;
+    waitFor([&] { const MotionChannelStats st = channel.stats(); return st.sent + st.preempted == uint64_t(queued + 1); }, 3000);
+    // 多等一会儿，确认之后没有再发出别的指令
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    const MotionChannelStats st = channel.stats();
+    channel.stop();
+    const std::vector<MockCommandRecord> received = mock.recentCommands();
+    mock.stop();
+
+    ok = ok && rejectedOffline && queued == scripts && stopSent && st.sent + st.preempted == uint64_t(queued + 1) &&
+         received.size() == st.sent && !received.empty() && received.back().kind == MockCommandKind::Stop;
+    qDebug() << (ok ? "✅" : "❌") << "停止作废排队脚本: 发出" << st.sent << "条, 作废" << st.preempted
+             << "条, 控制器收到" << received.size() << "条";
+    return ok;
+}
+
+// 断线重连: 控制器掉线期间速度 / 脚本被拒绝；点动松开时的停止指令保留下来，控制器回来后第一个发出
+static bool checkReconnect() {
+    const quint16 port = 30094;
+    auto mock = std::make_unique<MockUrController>(mockOptions(port));
+    if (!mock->start()) return false;
+
+    MotionCommandChannel channel("127.0.0.1", port);
+    channel.start();
+    bool ok = waitFor([&] { return channel.isConnected(); }, 3000);
+    mock->stop();
+    ok = ok && waitFor([&] { return !channel.isConnected(); }, 3000);
+
+    const double speeds[6] = {0.1, 0.0, 0.0, 0.0, 0.0, 0.0};
+    const bool rejected = channel.sendSpeed(speeds, 0.5, 100) == 0 && channel.sendScript("stopj(1.0)") == 0;
+    const bool stopHeld = channel.sendStop(0.5) == 0;      // 没发出去，调用方要收到 0
+
+    mock = std::make_unique<MockUrController>(mockOptions(port));
+    ok = ok && mock->start();
+    ok = ok && waitFor([&] { return channel.stats().sent > 0; }, 5000);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    const MotionChannelStats st = channel.stats();
+    channel.stop();
+    const std::vector<MockCommandRecord> received = mock->recentCommands();
+    mock->stop();
+
+    ok = ok && rejected && stopHeld && st.reconnects >= 1 && st.rejected == 2 && st.sent == 1 &&
+         received.size() == 1 && received[0].kind == MockCommandKind::Stop;
+    qDebug() << (ok ? "✅" : "❌") << "断线重连: 重连" << st.reconnects << "次, 未连接拒绝" << st.rejected
+             << "条, 重连后补发停止" << received.size() << "条";
+    return ok;
+}
+
+// 逆运动学: 随机构型 -> 正解 -> 全部逆解，每组逆解的正解都要回到同一位姿，且其中一组就是原构型
+static bool checkInverseKinematics() {
+    std::mt19937 gen(21);
+    std::uniform_real_distribution<double> u(-CV_PI, CV_PI);
+    const int n = 500;
+    std::vector<JointVector> qs(n);
+    std::vector<cv::Matx44d> poses(n);
+    for (int k = 0; k < n; ++k) {
+        for (double &v : qs[k]) v = u(gen);
+        poses[k] = UR12e::flangePose(qs[k]);
+    }
+    std::vector<UR12e::IKSolutions> sols(n);
+    UR12e::inverseBatch(poses.data(), n, sols.data());
+
+    bool ok = true;
+    double maxErr = 0.0;
+    for (int k = 0; ok && k < n; ++k) {
+        bool found = false;
+        for (int s = 0; s < sols[k].count; ++s) {
+            const cv::Matx44d T = UR12e::flangePose(sols[k].q[s]);
+            for (int r = 0; r < 3; ++r) {
+                for (int c = 0; c < 4; ++c) maxErr = std::max(maxErr, std::abs(T(r, c) - poses[k](r, c)));
+            }
+            double d = 0.0;
+            for (int j = 0; j < UR12e::kDof; ++j) d = std::max(d, std::abs(std::remainder(sols[k].q[s][j] - qs[k][j], 2.0 * CV_PI)));
+            found = found || d < 1e-6;
+        }
+        ok = found && maxErr < 1e-8;
+    }
+
+    // 直线路径 (姿态不变) 逐点逆解: 第一个点就是 seed 所在的分支，之后关节连续
+    const JointVector seed{0.3, -1.9, 1.6, -1.3, -CV_PI / 2, 0.2};
+    const cv::Matx44d p0 = UR12e::flangePose(seed);
+    std::vector<cv::Matx44d> line;
+    for (int i = 0; i <= 200; ++i) {
+        cv::Matx44d T = p0;
+        T(1, 3) += 0.002 * i;       // 沿 y 走 40 cm
+        line.push_back(T);
+    }
+    std::vector<JointVector> joints;
+    const UR12e::IKPathResult path = UR12e::inversePath(line, seed, joints, 0.1);
+    for (int j = 0; ok && j < UR12e::kDof; ++j) ok = path.ok && std::abs(joints[0][j] - seed[j]) < 1e-9;
+    ok = ok && joints.size() == line.size() && path.maxStep < 0.05;
+
+    qDebug() << (ok ? "✅" : "❌") << "逆运动学往返检查:" << n << "个位姿, 最大误差" << maxErr
+             << ", 直线路径最大关节步长" << path.maxStep << "rad";
+    return ok;
+}
+
+int main() {
+    qDebug() << "🚀 启动机械臂通信测试...";
+
+    if (!checkLiteralOffsets()) return 1;
+    if (!checkRobotStateCodec()) return 1;
+    if (!checkStopDropsQueuedScripts()) return 1;
+    if (!checkReconnect()) return 1;
+    if (!checkInverseKinematics()) return 1;
+
+    qDebug() << "🎉 机械臂通信测试全部通过";
+    return 0;
+}
@@ -1,10 +1,214 @@
 #include "RRTPlanner.h"
+#include "PathSmoother.h"
+#include "ReplanSession.h"
+#include "ArmCollisionChecker.h"
 #include <QDebug>
 #include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+
+// 三种最近邻索引对同一批随机点的查询结果必须和线性扫描完全一致
+static bool checkNearestNeighborIndexes() {
+    const cv::Point3f lo(-0.8f, -0.8f, 0.0f), hi(0.8f, 0.8f, 1.0f);
+    auto ref = createNearestNeighborIndex(NNIndexType::BruteForce, lo, hi);
+    auto kd = createNearestNeighborIndex(NNIndexType::KdTree, lo, hi);
+    auto grid = createNearestNeighborIndex(NNIndexType::GridHash, lo, hi, 0.1f);
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> dis(-1.0f, 1.2f);    // 故意包含工作空间外的点
+    int mismatch = 0;
+    std::vector<int> a, b, c;
+    for (int i = 0; i < 5000; ++i) {
+        cv::Point3f q(dis(gen), dis(gen), dis(gen));
+        if (i > 0) {
+            int r = ref->nearest(q);
+            if (kd->nearest(q) != r || grid->nearest(q) != r) ++mismatch;
+            if (i % 100 == 0) {
+                ref->withinRadius(q, 0.15f, a);
+                kd->withinRadius(q, 0.15f, b);
+                grid->withinRadius(q, 0.15f, c);
+                std::sort(a.begin(), a.end());
+                std::sort(b.begin(), b.end());
+                std::sort(c.begin(), c.end());
+                if (a != b || a != c) ++mismatch;
+            }
+        }
+        ref->insert(i, q);
+        kd->insert(i, q);
+        grid->insert(i, q);
+    }
+    qDebug() << (mismatch == 0 ? "✅" : "❌") << "最近邻索引一致性检查, 不一致次数:" << mismatch;
+    return mismatch == 0;
+}
+
+// 增量重规划: 把一个障碍物挪到当前路径上，修补后的路径必须首尾不变且无碰撞
+static bool checkReplanSession() {
+    const cv::Point3f start(-0.5f, 0.0f, 0.5f), goal(0.5f, 0.0f, 0.5f);
+    ReplanSession session;
+    session.setSeed(3);
+    session.reset(start, goal);
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<float> ux(-0.8f, 0.8f), uz(0.0f, 1.0f), ur(0.03f, 0.06f);
+    for (int i = 0; i < 30; ++i) {
+        SphereObstacle o{cv::Point3f(ux(gen), ux(gen), uz(gen)), ur(gen)};
+        if (cv::norm(o.center - start) < 0.2 || cv::norm(o.center - goal) < 0.2) continue;
+        session.addObstacle(o);
+    }
+    const int moving = session.addObstacle({cv::Point3f(0.0f, 0.6f, 0.5f), 0.06f});
+
+    bool ok = true;
+    int cuts = 0;
+    std::vector<cv::Point3f> path = session.replan();
+    for (int frame = 0; frame < 20 && ok; ++frame) {
+        if (path.empty()) { ok = false; break; }
+        // 每帧挪到当前路径中点，保证一定会切断边
+        const cv::Point3f mid = path[path.size() / 2];
+        session.updateObstacle(moving, {mid + cv::Point3f(0.0f, 0.0f, 0.02f), 0.06f});
+        path = session.replan();
+        cuts += session.lastStats().invalidatedEdges;
+        if (path.empty() || cv::norm(path.front() - start) > 1e-6 || cv::norm(path.back() - goal) > 1e-6) ok = false;
+        for (size_t k = 1; ok && k < path.size(); ++k) {
+            if (session.collisionChecker().segmentCollides(path[k - 1], path[k])) ok = false;
+        }
+    }
+    ok = ok && cuts > 0;
+    qDebug() << (ok ? "✅" : "❌") << "增量重规划检查, 切断的边:" << cuts << ", 树节点:" << session.treeSize();
+    return ok;
+}
+
+// 带时间预算的 RRT*: 代价曲线单调下降、按时返回、可以从其他线程取消
+static bool checkAnytimePlanning() {
+    RRTPlanner planner;
+    planner.setSeed(5);
+    planner.addObstacle({cv::Point3f(0.0f, 0.0f, 0.5f), 0.2f});
+    const cv::Point3f start(-0.5f, 0.0f, 0.5f), goal(0.5f, 0.0f, 0.5f);
+
+    int callbacks = 0;
+    planner.setImprovementCallback([&](const std::vector<cv::Point3f>&, float, double) { ++callbacks; });
+    const std::vector<cv::Point3f> path = planner.planPath(start, goal, std::chrono::milliseconds(50));
+    const PlanStats st = planner.lastStats();
+    // 预算用满才返回；上限放得很宽 (负载高的机器上调度会推迟返回)，只防止跑飞
+    bool ok = !path.empty() && callbacks == (int)st.costCurve.size() && st.totalMs >= 50.0 && st.totalMs < 50.0 * 20;
+    for (size_t k = 1; ok && k < st.costCurve.size(); ++k) ok = st.costCurve[k].cost < st.costCurve[k - 1].cost;
+    for (size_t k = 1; ok && k < path.size(); ++k) ok = !planner.checkCollision(path[k - 1], path[k]);
+    ok = ok && st.pathLength <= st.firstPathLength + 1e-4f;
+
+    // 预算 10 秒，30ms 后从另一个线程取消
+    std::thread canceller([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        planner.cancel();
+    });
+    planner.planPath(start, goal, std::chrono::seconds(10));
+    canceller.join();
+    ok = ok && planner.lastStats().cancelled && planner.lastStats().totalMs < 5000.0;
+
+    // 规划开始前就取消: 不能被吞掉；返回后标志清除，下一次规划正常用满预算
+    planner.cancel();
+    planner.planPath(start, goal, std::chrono::seconds(10));
+    ok = ok && planner.lastStats().cancelled && planner.lastStats().totalMs < 5000.0;
+    planner.planPath(start, goal, std::chrono::milliseconds(20));
+    ok = ok && !planner.lastStats().cancelled && planner.lastStats().success;
+
+    qDebug() << (ok ? "✅" : "❌") << "RRT* 时间预算检查: 首解" << st.firstSolutionMs << "ms, 长度"
+             << st.firstPathLength << "->" << st.pathLength << ", 改进" << st.costCurve.size() << "次";
+    return ok;
+}
+
+// 批量规划: 结果和线程数无关，并且和用同样种子逐个 planPath 的结果完全相同 (工作区复用不能残留上一次的状态)
+static bool checkPlanBatch() {
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<float> ux(-0.8f, 0.8f), uz(0.0f, 1.0f);
+    std::vector<SphereObstacle> obstacles;
+    for (int i = 0; i < 60; ++i) obstacles.push_back({cv::Point3f(ux(gen), ux(gen), uz(gen)), 0.05f});
+    std::vector<PlanQuery> queries;
+    while (queries.size() < 8) {
+        const PlanQuery q{cv::Point3f(ux(gen), ux(gen), uz(gen)), cv::Point3f(ux(gen), ux(gen), uz(gen))};
+        bool free = true;
+        for (const auto &o : obstacles) {
+            free = free && cv::norm(o.center - q.start) > 0.15 && cv::norm(o.center - q.goal) > 0.15;
+        }
+        if (free) queries.push_back(q);
+    }
+
+    RRTPlanner planner;
+    for (const auto &o : obstacles) planner.addObstacle(o);
+    planner.setMode(PlannerMode::RRTConnect);
+    planner.setSeed(21);
+    const std::vector<PlanResult> single = planner.planBatch(queries, 1);
+    planner.setSeed(21);
+    const std::vector<PlanResult> multi = planner.planBatch(queries);
+
+    // 每个查询的种子是规划器引擎依次吐出的数
+    std::mt19937 seeds(21);
+    bool ok = single.size() == queries.size() && multi.size() == queries.size();
+    int found = 0;
+    for (size_t q = 0; ok && q < queries.size(); ++q) {
+        planner.setSeed((uint32_t)seeds());
+        const std::vector<cv::Point3f> path = planner.planPath(queries[q].start, queries[q].goal);
+        ok = !path.empty() && multi[q].path == single[q].path && multi[q].path == path &&
+             multi[q].stats.iterations == planner.lastStats().iterations;
+        ok = ok && cv::norm(path.front() - queries[q].start) < 1e-6 && cv::norm(path.back() - queries[q].goal) < 1e-6;
+        for (size_t k = 1; ok && k < path.size(); ++k) ok = !planner.checkCollision(path[k - 1], path[k]);
+        found += ok ? 1 : 0;
+    }
+    qDebug() << (ok ? "✅" : "❌") << "批量规划检查:" << found << "/" << queries.size() << "条路径与逐个规划一致";
+    return ok;
+}
+
+// UR12e 运动学 + 整臂碰撞检测: 零位法兰位置、批量与逐个一致、关节空间规划绕开障碍
+static bool checkArmCollision() {
+    // 零位: 手臂水平伸直，法兰在 (a2 + a3, -(d4 + d6), d1 - d5)
+    const cv::Matx44d home = UR12e::flangePose(JointVector{0, 0, 0, 0, 0, 0});
+    bool ok = std::abs(home(0, 3) - (-1.18425)) < 1e-6 && std::abs(home(1, 3) - (-0.2907)) < 1e-6 &&
+              std::abs(home(2, 3) - 0.06085) < 1e-6;
+
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<float> u(-(float)CV_PI, (float)CV_PI);
+    UR12e::JointBatch batch;
+    batch.resize(203);      // 不是向量宽度的整数倍，覆盖尾部
+    for (auto &q : batch.q) for (auto &v : q) v = u(gen);
+    UR12e::FrameBatch frames;
+    UR12e::forwardBatch(batch, frames);
+    for (size_t k = 0; ok && k < batch.size(); ++k) {
+        const cv::Matx44d flange = UR12e::flangePose(batch.get(k));
+        const cv::Point3f p = frames.origin(UR12e::kDof, k);
+        ok = std::abs(p.x - flange(0, 3)) < 1e-4 && std::abs(p.y - flange(1, 3)) < 1e-4 && std::abs(p.z - flange(2, 3)) < 1e-4;
+    }
+
+    ArmCollisionChecker arm;
+    arm.setObstacles({{cv::Point3f(-0.6f, -0.2f, 0.5f), 0.1f}, {cv::Point3f(0.5f, 0.4f, 0.3f), 0.08f}});
+    std::vector<uint8_t> hit;
+    const size_t hits = arm.checkBatch(batch, hit);
+    for (size_t k = 0; ok && k < batch.size(); ++k) ok = (hit[k] != 0) == arm.collides(batch.get(k));
+    ok = ok && hits > 0 && hits < batch.size();
+
+    // 基座转过去会扫到柱子，规划出的每一段都不能碰
+    RRTPlanner planner;
+    planner.setSeed(11);
+    for (float z = 0.0f; z <= 1.0f; z += 0.08f) planner.addObstacle({cv::Point3f(-0.45f, -0.15f, z), 0.06f});
+    const JointVector start{-CV_PI / 3, -2.0, 1.8, -1.4, -CV_PI / 2, 0.0};
+    const JointVector goal{CV_PI / 3, -2.0, 1.8, -1.4, -CV_PI / 2, 0.0};
+    const std::vector<JointVector> path = planner.planJointPath(start, goal);
+    ok = ok && planner.armCollisionChecker().motionCollides(start, goal, 0.02) && path.size() >= 2 &&
+         path.front() == start && path.back() == goal;
+    for (size_t k = 1; ok && k < path.size(); ++k) ok = !planner.armCollisionChecker().motionCollides(path[k - 1], path[k], 0.02);
+
+    qDebug() << (ok ? "✅" : "❌") << "整臂碰撞检测: 批量碰撞" << hits << "/" << batch.size()
+             << ", 关节空间路径" << path.size() << "个点, 检查构型" << (qulonglong)planner.lastStats().configsChecked;
+    return ok;
+}
 
 int main() {
     qDebug() << "🚀 启动 RRT 路径规划测试...";
 
+    if (!checkNearestNeighborIndexes()) return 1;
+    if (!checkReplanSession()) return 1;
+    if (!checkAnytimePlanning()) return 1;
+    if (!checkPlanBatch()) return 1;
+    if (!checkArmCollision()) return 1;
+
     RRTPlanner planner;
 
     // 1. 设置障碍物 (挡在起点和终点中间)
@@ -36,5 +240,33 @@ int main() {
         qDebug() << "❌ 规划失败!";
     }
 
+    // 5. 路径后处理: 平滑后的轨迹必须首尾不变、无碰撞、不超速度 / 加速度限制
+    if (!path.empty()) {
+        PathSmoother smoother(planner.collisionChecker());
+        SmoothingReport report;
+        TimedTrajectory traj = smoother.process(path, &report);
+        const SmootherOptions &opt = smoother.options();
+        const auto &S = traj.samples;
+        bool ok = cv::norm(S.front().pos - start) < 1e-5 && cv::norm(S.back().pos - goal) < 1e-5;
+        for (size_t i = 0; ok && i + 1 < S.size(); ++i) {
+            const double dt = S[i + 1].t - S[i].t;
+            if (planner.collisionChecker().segmentCollides(S[i].pos, S[i + 1].pos, opt.threshold)) ok = false;
+            if (S[i].speed > opt.maxVel + 1e-9) ok = false;
+            if (dt > 0 && std::abs(S[i + 1].speed - S[i].speed) / dt > opt.maxAcc + 1e-6) ok = false;
+        }
+        qDebug() << (ok ? "✅" : "❌") << "路径平滑: 长度" << report.rawLength << "->" << report.smoothLength
+                 << "m, 执行时间" << report.rawDuration << "->" << report.smoothDuration << "s";
+        if (!ok) return 1;
+    }
+
+    // 6. 不同最近邻索引的规划耗时对比
+    for (NNIndexType type : {NNIndexType::BruteForce, NNIndexType::KdTree, NNIndexType::GridHash}) {
+        planner.setNearestNeighborType(type);
+        auto t0 = std::chrono::steady_clock::now();
+        std::vector<cv::Point3f> p = planner.planPath(start, goal);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        qDebug() << "⏱️" << nnIndexTypeName(type) << ":" << ms << "ms, 路径点数" << p.size();
+    }
+
     return 0;
 }
@@ -0,0 +1,80 @@
+#include "tools/Trace/LatencyTrace.h"
+#include <QDebug>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 延迟埋点测试: 探针注册、每线程直方图合并、Chrome trace 导出、清零 (不依赖规划 / 相机等模块)
+
+// 主线程上的一段 UR_TRACE_SCOPE (RAII 计时)
+static void tracedScope() {
+    UR_TRACE_SCOPE("test.scope");
+}
+
+// 延迟埋点: 关闭时不记录；多线程记录后合并的分位数误差 < 3%；Chrome trace 每线程保留最近 kEventsPerThread 条
+static bool checkLatencyTrace() {
+    static const int probe = LatencyTrace::probe("test.latency");
+    LatencyTrace::setEnabled(false);
+    { UR_TRACE_SCOPE("test.latency"); }
+    bool ok = LatencyTrace::snapshot().empty();
+
+    LatencyTrace::setEnabled(true);
+    tracedScope();
+
+    // 4 个线程各记录 1 ~ 10000 us (全部记录完才退出，否则退出线程的缓冲区会被后来的线程复用)
+    const int threads = 4, perThread = 10000;
+    std::atomic<int> finished{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&finished] {
+            for (int i = 1; i <= perThread; ++i) LatencyTrace::record(probe, 0, int64_t(i) * 1000);
+            finished.fetch_add(1);
+            while (finished.load() < threads) std::this_thread::yield();
+        });
+    }
+    for (auto &w : workers) w.join();
+
+    ProbeStats st, scope;
+    for (const ProbeStats &ps : LatencyTrace::snapshot()) {
+        if (ps.name == "test.latency") st = ps;
+        if (ps.name == "test.scope") scope = ps;
+    }
+    auto near = [](double v, double ref) { return std::abs(v - ref) <= 0.03 * ref; };
+    ok = ok && st.count == uint64_t(threads * perThread) && near(st.p50Ms, 5.0) && near(st.p99Ms, 9.9) &&
+         near(st.maxMs, 10.0) && near(st.meanMs, 5.0) && scope.count == 1;
+
+    // 导出后每个记录线程的最近 kEventsPerThread 条都在
+    const std::string file = "trace_test.json";
+    ok = ok && LatencyTrace::writeChromeTrace(file);
+    std::stringstream buf;
+    buf << std::ifstream(file).rdbuf();
+    std::remove(file.c_str());
+    const std::string json = buf.str();
+    size_t events = 0;
+    for (size_t pos = 0; (pos = json.find("\"name\":\"test.latency\",\"tid\"", pos)) != std::string::npos; ++pos) ++events;
+    ok = ok && json.find("\"traceEvents\"") != std::string::npos && json.find("\"test.scope\"") != std::string::npos &&
+         events == size_t(threads) * LatencyTrace::kEventsPerThread;
+
+    // 清零后不再出现
+    LatencyTrace::reset();
+    ok = ok && LatencyTrace::snapshot().empty();
+    LatencyTrace::setEnabled(false);
+
+    qDebug() << (ok ? "✅" : "❌") << "延迟埋点检查: p50" << st.p50Ms << "ms, p99" << st.p99Ms << "ms, 导出事件"
+             << events;
+    return ok;
+}
+
+int main() {
+    qDebug() << "🚀 启动延迟埋点测试...";
+
+    if (!checkLatencyTrace()) return 1;
+
+    qDebug() << "🎉 延迟埋点测试全部通过";
+    return 0;
+}
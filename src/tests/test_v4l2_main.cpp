@@ -0,0 +1,112 @@
+#include "platform/linux/V4l2Camera.h"
+#include <QDebug>
+#include <linux/videodev2.h>
+#include <time.h>
+#include <unistd.h>
+#include <string>
+
+// 原生 V4L2 后端测试
+// 推荐使用内核虚拟驱动，无需真实相机:
+//   sudo modprobe vivid
+//   ./V4L2_Test /dev/video0
+
+static int64_t monotonicNowNs() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+int main(int argc, char *argv[]) {
+    std::string device = argc > 1 ? argv[1] : "/dev/video0";
+    qDebug() << "🚀 启动 V4L2 原生后端测试:" << device.c_str();
+
+    // 1. 打开设备 (vivid 默认支持 YUYV 640x480)
+    V4l2Camera cam;
+    V4l2Camera::Config config;
+    config.width = 640;
+    config.height = 480;
+    config.fourcc = V4L2_PIX_FMT_YUYV;
+    config.bufferCount = 3;
+    if (!cam.open(device, config)) {
+        qDebug() << "❌ 测试失败: 无法打开设备 (是否已 modprobe vivid?)";
+        return 1;
+    }
+    qDebug() << "📐 协商结果:" << cam.width() << "x" << cam.height()
+             << "| 队列深度:" << cam.bufferCount();
+
+    if (cam.bufferCount() < 2) {
+        qDebug() << "❌ 测试失败: 驱动缓冲区数量不足";
+        return 1;
+    }
+
+    // 2. 连续采集，检查零拷贝、帧序号、时间戳
+    const int kFrames = 60;
+    bool ok = true;
+    int64_t lastStamp = 0;
+    int64_t firstStamp = 0;
+    int64_t lastSeq = -1;
+    int gaps = 0;
+
+    for (int i = 0; i < kFrames; ++i) {
+        V4l2Camera::Buffer buf;
+        if (!cam.dequeue(buf, 2000)) {
+            qDebug() << "❌ 第" << i << "帧超时";
+            ok = false;
+            break;
+        }
+
+        if (!cam.ownsPointer(buf.data) || buf.bytesUsed == 0) {
+            qDebug() << "❌ 帧数据没有指向 mmap 缓冲区";
+            ok = false;
+        }
+        if (lastSeq >= 0 && static_cast<int64_t>(buf.sequence) <= lastSeq) {
+            qDebug() << "❌ 帧序号没有递增:" << lastSeq << "->" << buf.sequence;
+            ok = false;
+        }
+        if (lastSeq >= 0 && static_cast<int64_t>(buf.sequence) > lastSeq + 1) gaps++;
+        if (buf.timestampNs <= lastStamp) {
+            qDebug() << "❌ 时间戳没有递增";
+            ok = false;
+        }
+        // 驱动时间戳必须是单调时钟，且就在 "刚才"
+        int64_t age = monotonicNowNs() - buf.timestampNs;
+        if (age < 0 || age > 1000000000LL) {
+            qDebug() << "❌ 时间戳不是 CLOCK_MONOTONIC, 偏差(ns):" << age;
+            ok = false;
+        }
+
+        if (i == 0) firstStamp = buf.timestampNs;
+        lastSeq = buf.sequence;
+        lastStamp = buf.timestampNs;
+
+        if (!cam.requeue(buf)) {
+            qDebug() << "❌ requeue 失败";
+            ok = false;
+            break;
+        }
+    }
+
+    if (ok) {
+        double seconds = (lastStamp - firstStamp) / 1e9;
+        qDebug() << "⏱️ 平均帧率:" << (seconds > 0 ? (kFrames - 1) / seconds : 0.0)
+                 << "| 驱动层跳号:" << gaps;
+    }
+
+    // 3. DMABUF 导出 (部分驱动不支持，只提示不判失败)
+    int fd = cam.exportDmabuf(0);
+    if (fd >= 0) {
+        qDebug() << "✅ DMABUF 导出成功, fd =" << fd;
+        ::close(fd);
+    } else {
+        qDebug() << "⚠️ 驱动不支持 DMABUF 导出";
+    }
+
+    cam.close();
+
+    if (ok) {
+        qDebug() << "✅ 测试通过: 零拷贝 mmap 采集 + 单调时间戳 + 帧序号正常!";
+        return 0;
+    }
+    qDebug() << "❌ 测试失败!";
+    return 1;
+}
@@ -0,0 +1,220 @@
+#include "CameraBroker.h"
+#include <QDebug>
+#include <chrono>
+#include <vector>
+
+namespace {
+// 缩小倍数 1 / 2 / 4 / 8 对应的缓存位置
+int scaleSlot(int scale) {
+    return scale >= 8 ? 3 : scale >= 4 ? 2 : scale >= 2 ? 1 : 0;
+}
+
+// 每个缩小倍数最多留几块换下来的缓冲区 (订阅者还拿着上一帧时也能不分配新内存)
+const size_t kSpareBuffers = 2;
+}
+
+// 一路相机: 共享的采集器 + 每个缩小倍数最新一帧的解码结果
+class CameraDevice
+{
+public:
+    CameraDevice(int index, std::unique_ptr<CameraSource> source) : capture(index, std::move(source)) {}
+
+    /**
+     * @brief 按 scale 解码 frame；这一帧这个倍数已经有人解过就直接共享
+     * 解码在锁外进行，两个订阅者同时解同一帧时各解一次，只缓存其中一份
+     */
+    bool decode(const CameraFrame& frame, int scale, MjpegDecoder& decoder, cv::Mat& bgr);
+    CameraShareStats shareStats() const;
+
+    CameraCapture capture;
+    std::atomic<int> subscribers{0};    // 在 CameraBroker::m_mutex 下修改
+
+private:
+    struct Cache {
+        uint64_t seq = 0;
+        cv::Mat bgr;
+        std::vector<cv::Mat> spare;     // 换下来的旧结果，没人再引用时拿来复用
+    };
+
+    mutable std::mutex m_mutex;
+    Cache m_cache[4];
+    uint64_t m_decodes = 0;
+    uint64_t m_sharedDecodes = 0;
+};
+
+bool CameraDevice::decode(const CameraFrame& frame, int scale, MjpegDecoder& decoder, cv::Mat& bgr) {
+    // 采集线程已经解码好的全尺寸图: 直接共享，不进缓存 (缓存会一直占着采集槽位的内存)
+    if (scale == 1 && !frame.image.empty()) {
+        bgr = frame.image;
+        return true;
+    }
+
+    Cache &cache = m_cache[scaleSlot(scale)];
+    cv::Mat buffer;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (cache.seq == frame.seq && !cache.bgr.empty()) {
+            ++m_sharedDecodes;
+            bgr = cache.bgr;
+            return true;
+        }
+        // 借一块只剩缓存自己引用的旧缓冲区，尺寸不变时解码器原地写入
+        for (size_t i = 0; i < cache.spare.size(); ++i) {
+            if (cache.spare[i].u && cache.spare[i].u->refcount == 1) {
+                buffer = std::move(cache.spare[i]);
+                cache.spare.erase(cache.spare.begin() + i);
+                break;
+            }
+        }
+    }
+
+    if (!decoder.decodeFrame(frame, scale, buffer)) return false;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_decodes;
+        if (frame.seq > cache.seq) {
+            if (!cache.bgr.empty() && cache.spare.size() < kSpareBuffers) cache.spare.push_back(cache.bgr);
+            cache.seq = frame.seq;
+            cache.bgr = buffer;
+        }
+    }
+    bgr = buffer;
+    return true;
+}
+
+CameraShareStats CameraDevice::shareStats() const {
+    CameraShareStats s;
+    s.subscribers = subscribers.load();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    s.decodes = m_decodes;
+    s.sharedDecodes = m_sharedDecodes;
+    return s;
+}
+
+// ================= 订阅 =================
+CameraSubscription::CameraSubscription(CameraBroker *broker, CameraDevice *device,
+                                       const CameraSubscriberOptions& options)
+    : m_broker(broker)
+    , m_device(device)
+    , m_options(options)
+{
+}
+
+CameraSubscription::~CameraSubscription() {
+    m_broker->unsubscribe(m_device);
+}
+
+int CameraSubscription::index() const {
+    return m_device->capture.index();
+}
+
+bool CameraSubscription::isOpened() const {
+    return m_device->capture.isOpened();
+}
+
+cv::Size CameraSubscription::frameSize() const {
+    return m_device->capture.frameSize();
+}
+
+CaptureStats CameraSubscription::stats() const {
+    return m_device->capture.stats();
+}
+
+CameraShareStats CameraSubscription::shareStats() const {
+    return m_device->shareStats();
+}
+
+const CameraCapture& CameraSubscription::capture() const {
+    return m_device->capture;
+}
+
+bool CameraSubscription::nextFrame(CameraFrame& out) {
+    CameraFrame frame;
+    if (!m_device->capture.latestFrame(frame, m_lastSeq)) return false;
+
+    // 限速: 时间戳倒退 (回放从头循环) 时重新计时
+    if (m_options.maxFps > 0.0 && m_lastStampNs > 0 && frame.timestampNs >= m_lastStampNs) {
+        const int64_t intervalNs = static_cast<int64_t>(1e9 / m_options.maxFps);
+        if (frame.timestampNs - m_lastStampNs < intervalNs - intervalNs / 10) return false;
+    }
+    m_lastSeq = frame.seq;
+    m_lastStampNs = frame.timestampNs;
+    out = frame;
+    return true;
+}
+
+bool CameraSubscription::latestFrame(CameraFrame& out, uint64_t afterSeq) const {
+    return m_device->capture.latestFrame(out, afterSeq);
+}
+
+bool CameraSubscription::nextImage(cv::Mat& bgr, cv::Size minSize, CameraFrame *frame) {
+    CameraFrame f;
+    if (!nextFrame(f)) return false;
+    if (minSize.area() <= 0) minSize = m_options.size;
+    const cv::Size full = f.size.area() > 0 ? f.size : f.image.size();
+    const int scale = minSize.area() > 0 ? MjpegDecoder::pickScale(full, minSize) : 1;
+    if (!m_device->decode(f, scale, m_decoder, bgr)) return false;
+    if (frame) *frame = f;
+    return true;
+}
+
+// ================= 代理 =================
+CameraBroker::CameraBroker() = default;
+
+CameraBroker::~CameraBroker() {
+    if (!m_devices.empty()) qDebug() << "⚠️ 相机代理析构时还有" << m_devices.size() << "路相机没有退订";
+}
+
+std::unique_ptr<CameraSubscription> CameraBroker::subscribe(int index, const CameraSubscriberOptions& options) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    // 同一路的上一个设备还在关闭 (等采集线程退出、驱动释放)，关完才能重新打开
+    m_closed.wait(lock, [&] { return m_closing[index] == 0; });
+
+    std::unique_ptr<CameraDevice> &slot = m_devices[index];
+    if (!slot) {
+        std::unique_ptr<CameraSource> source = m_factory ? m_factory(index)
+                                                         : createCameraSource(index, defaultCameraBackend());
+        slot = std::make_unique<CameraDevice>(index, std::move(source));
+        if (slot->capture.isOpened()) {
+            slot->capture.start();
+            qDebug() << "📷 相机" << index << "已打开 (代理)";
+        }
+    }
+    slot->subscribers.fetch_add(1);
+    return std::unique_ptr<CameraSubscription>(new CameraSubscription(this, slot.get(), options));
+}
+
+void CameraBroker::unsubscribe(CameraDevice *device) {
+    std::unique_ptr<CameraDevice> closing;
+    int index = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (device->subscribers.fetch_sub(1) > 1) return;
+        index = device->capture.index();
+        auto it = m_devices.find(index);
+        closing = std::move(it->second);
+        m_devices.erase(it);
+        ++m_closing[index];
+    }
+
+    // 停采集线程、关设备 (可能要等驱动超时)，不占着代理的锁
+    const bool wasOpened = closing->capture.isOpened();
+    closing.reset();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        --m_closing[index];
+    }
+    m_closed.notify_all();
+    if (wasOpened) qDebug() << "📷 相机" << index << "已关闭 (最后一个订阅者退订)";
+}
+
+int CameraBroker::deviceCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<int>(m_devices.size());
+}
+
+void CameraBroker::setSourceFactory(SourceFactory factory) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_factory = std::move(factory);
+}
@@ -0,0 +1,127 @@
+#ifndef CAMERABROKER_H
+#define CAMERABROKER_H
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include "CameraCapture.h"
+#include "MjpegDecoder.h"
+
+// 订阅参数: 每个订阅者自己的帧率和分辨率
+struct CameraSubscriberOptions {
+    double maxFps = 0.0;        // 最多按这个帧率取帧 (0 表示相机出多少取多少)
+    cv::Size size;              // nextImage() 默认的解码尺寸下限 (空表示原图)
+};
+
+// 一路相机在代理里的共享情况
+struct CameraShareStats {
+    int subscribers = 0;        // 当前订阅者数
+    uint64_t decodes = 0;       // 实际解码次数
+    uint64_t sharedDecodes = 0; // 直接用了别的订阅者解码结果的次数
+};
+
+class CameraBroker;
+class CameraDevice;
+
+/**
+ * @brief 订阅者对一路相机的句柄，析构即退订
+ *
+ * 同一路相机的所有订阅共用一个 CameraCapture (一个设备句柄、一个采集线程)；
+ * 每个订阅各自记录看到了哪一帧，并按自己的 maxFps 限速。
+ * 一个订阅只能在一个线程里用 (通常是界面线程)，不同的订阅可以在不同线程。
+ */
+class CameraSubscription
+{
+public:
+    ~CameraSubscription();
+
+    CameraSubscription(const CameraSubscription&) = delete;
+    CameraSubscription& operator=(const CameraSubscription&) = delete;
+
+    int index() const;
+    bool isOpened() const;
+    cv::Size frameSize() const;
+    CaptureStats stats() const;
+    CameraShareStats shareStats() const;
+    const CameraSubscriberOptions& options() const { return m_options; }
+
+    // 共享的采集器 (录像、截图直接用，不要 start / stop 它)
+    const CameraCapture& capture() const;
+
+    /**
+     * @brief 本订阅还没取过的最新帧
+     * 按 maxFps 限速: 距离上次取到的帧不够一个间隔时返回 false (允许 10% 抖动)
+     */
+    bool nextFrame(CameraFrame& out);
+
+    // 最新帧，不限速，也不影响 nextFrame() 的进度 (截图用)
+    bool latestFrame(CameraFrame& out, uint64_t afterSeq = 0) const;
+
+    /**
+     * @brief nextFrame() 并解码成不小于 minSize 的 BGR 图 (MJPEG 按 1/2 ~ 1/8 缩小解码，不做最后的精确缩放)
+     * 同一帧、同一缩小倍数只解码一次，结果在订阅者之间共享，所以 bgr 只读。
+     * @param minSize 为空时用 options().size；都为空时解码原图
+     * @param frame 非空时输出这一帧 (时间戳、序号等)
+     */
+    bool nextImage(cv::Mat& bgr, cv::Size minSize = cv::Size(), CameraFrame *frame = nullptr);
+
+private:
+    friend class CameraBroker;
+    CameraSubscription(CameraBroker *broker, CameraDevice *device, const CameraSubscriberOptions& options);
+
+    CameraBroker *m_broker;
+    CameraDevice *m_device;     // 归代理所有，至少活到本订阅退订
+    CameraSubscriberOptions m_options;
+    uint64_t m_lastSeq = 0;
+    int64_t m_lastStampNs = 0;
+    MjpegDecoder m_decoder;     // 每个订阅自己的解码器 (不同订阅可能在不同线程解码)
+};
+
+/**
+ * @brief 进程内的相机代理: 每个设备只打开一次，按引用计数分发给任意多个订阅者
+ *
+ * 第一个订阅者订阅时打开设备、启动采集线程；最后一个订阅者退订时停止线程、关闭设备，
+ * 所以主界面和工具窗口同时看同一路相机不会重复占用 USB 带宽，也不会因为设备被占用而打不开。
+ * 设备打不开时订阅照样返回 (isOpened() 为 false)，等所有订阅者退订后下次订阅会重新尝试打开。
+ * 所有订阅必须在 main() 返回前释放。
+ */
+class CameraBroker
+{
+public:
+    using SourceFactory = std::function<std::unique_ptr<CameraSource>(int index)>;
+
+    static CameraBroker& instance() {
+        static CameraBroker broker;
+        return broker;
+    }
+
+    ~CameraBroker();
+    CameraBroker(const CameraBroker&) = delete;
+    CameraBroker& operator=(const CameraBroker&) = delete;
+
+    std::unique_ptr<CameraSubscription> subscribe(int index,
+                                                  const CameraSubscriberOptions& options = CameraSubscriberOptions());
+
+    // 当前打开着 (有订阅者) 的设备数
+    int deviceCount() const;
+
+    // 替换打开设备的方式 (默认 createCameraSource(index, defaultCameraBackend()))，基准程序用录像回放
+    void setSourceFactory(SourceFactory factory);
+
+private:
+    friend class CameraSubscription;
+    CameraBroker();
+    void unsubscribe(CameraDevice *device);     // 订阅析构时调用；最后一个订阅者退订时关闭设备
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_closed;
+    std::map<int, std::unique_ptr<CameraDevice>> m_devices;
+    std::map<int, int> m_closing;               // 正在关闭的设备 (关完之前不能重新打开同一路)
+    SourceFactory m_factory;
+};
+
+#endif // CAMERABROKER_H
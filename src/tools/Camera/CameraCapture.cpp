@@ -0,0 +1,124 @@
+#include "CameraCapture.h"
+#include "tools/Trace/LatencyTrace.h"
+#include "tools/Common/SteadyClock.h"
+#include <chrono>
+#include <QDebug>
+
+CameraCapture::CameraCapture(int index, CameraBackend backend)
+    : m_index(index)
+    , m_source(createCameraSource(index, backend))
+{
+}
+
+CameraCapture::CameraCapture(int index, std::unique_ptr<CameraSource> source)
+    : m_index(index)
+    , m_source(std::move(source))
+{
+}
+
+CameraCapture::~CameraCapture() {
+    stop();
+    m_source->release();
+}
+
+bool CameraCapture::isOpened() const {
+    return m_source->isOpened();
+}
+
+cv::Size CameraCapture::frameSize() const {
+    return m_source->frameSize();
+}
+
+void CameraCapture::start() {
+    if (!m_source->isOpened() || m_running.load()) return;
+    m_running.store(true);
+    m_thread = std::thread(&CameraCapture::run, this);
+}
+
+void CameraCapture::stop() {
+    m_running.store(false);
+    // 注意: 如果相机正卡在 grab() 里，这里要等驱动超时才能返回
+    if (m_thread.joinable()) m_thread.join();
+}
+
+bool CameraCapture::latestFrame(CameraFrame& out, uint64_t afterSeq) const {
+    return m_mailbox.readLatest(out, afterSeq);
+}
+
+CaptureStats CameraCapture::stats() const {
+    CaptureStats s;
+    s.captured = m_captured.load();
+    s.dropped = m_dropped.load();
+    s.readErrors = m_readErrors.load();
+    s.allocations = m_allocations.load();
+    s.fps = m_fps.load();
+    return s;
+}
+
+void CameraCapture::run() {
+    uint64_t seq = 0;
+    const cv::Size frameSize = m_source->frameSize();
+
+    // 帧率统计窗口
+    const int64_t kFpsWindowNs = 1000000000LL;
+    int64_t windowStart = steadyNowNs();
+    uint64_t windowFrames = 0;
+    LatencyTrace::setThreadName("camera " + std::to_string(m_index));
+
+    while (m_running.load()) {
+        // 1. grab() 只把数据从驱动取出来；后端没有驱动时间戳时，以返回时刻作为采集时间戳
+        int64_t stamp = 0;
+        uint64_t deviceSeq = 0;
+        if (!m_source->grab(stamp, deviceSeq)) {
+            m_readErrors.fetch_add(1);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5)); // 避免坏相机空转占满 CPU
+            continue;
+        }
+        if (stamp == 0) stamp = steadyNowNs();
+        UR_TRACE_SCOPE("camera.capture");  // 取出 + 发布 (不含等待下一帧)
+
+        // 2. 拿一个空闲槽位，直接解码进去 (槽位内存会被复用)
+        CameraFrame *slot = m_mailbox.acquireWriteSlot();
+        if (!slot) {
+            m_dropped.fetch_add(1);
+            continue;
+        }
+        const uchar *imageBefore = slot->image.data;
+        const uchar *packetBefore = slot->packet.data;
+        bool ok;
+        if (m_keepCompressed && m_source->retrievePacket(slot->packet, slot->packetBytes)) {
+            // 只保留压缩包，消费者按各自需要的比例解码
+            if (!slot->image.empty()) slot->image.release();
+            ok = true;
+        } else {
+            slot->packetBytes = 0;
+            ok = m_source->retrieve(slot->image);
+        }
+        if (!ok) {
+            m_readErrors.fetch_add(1);
+            continue;
+        }
+        if ((slot->image.data && slot->image.data != imageBefore) ||
+            (slot->packet.data && slot->packet.data != packetBefore)) {
+            m_allocations.fetch_add(1);
+        }
+        slot->size = slot->image.empty() ? frameSize : slot->image.size();
+        slot->timestampNs = stamp;
+        slot->seq = ++seq;
+        slot->deviceSeq = deviceSeq;
+
+        // 3. 发布
+        if (m_mailbox.publish(slot)) m_dropped.fetch_add(1);
+        m_captured.fetch_add(1);
+
+        // 4. 帧率
+        ++windowFrames;
+        const int64_t elapsed = stamp - windowStart;
+        if (elapsed >= kFpsWindowNs) {
+            m_fps.store(windowFrames * 1e9 / elapsed);
+            windowStart = stamp;
+            windowFrames = 0;
+        }
+    }
+    qDebug() << "⏹️ 相机" << m_index << "采集线程退出";
+}
@@ -0,0 +1,86 @@
+#ifndef CAMERACAPTURE_H
+#define CAMERACAPTURE_H
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include "FrameMailbox.h"
+#include "platform/CameraHelper.h"
+
+// 单路相机的运行统计
+struct CaptureStats {
+    uint64_t captured = 0;      // 成功采集的帧数
+    uint64_t dropped = 0;       // 没被任何消费者读到就被覆盖 / 无空闲槽位的帧数
+    uint64_t readErrors = 0;    // grab/retrieve 失败次数
+    uint64_t allocations = 0;   // 帧缓冲区 (重新) 分配次数，稳态下不应再增长
+    double fps = 0.0;           // 最近一个统计窗口 (约 1 秒) 的实际帧率
+};
+
+/**
+ * @brief 单路相机采集器：每路相机一个独立线程
+ *
+ * 线程循环 grab/retrieve，把最新帧和采集时间戳发布到 FrameMailbox。
+ * 一路相机卡住只会卡住它自己的线程，不会拖慢其他相机和界面。
+ */
+class CameraCapture
+{
+public:
+    /**
+     * @brief 通过 createCameraSource() 打开相机 (不启动线程)
+     * @param index 相机索引
+     * @param backend 相机后端 (原生后端不可用时自动回退到 OpenCV)
+     */
+    explicit CameraCapture(int index, CameraBackend backend = defaultCameraBackend());
+    // 使用外部创建好的数据源 (例如 PlaybackCameraSource 回放录像)
+    CameraCapture(int index, std::unique_ptr<CameraSource> source);
+    ~CameraCapture();
+
+    CameraCapture(const CameraCapture&) = delete;
+    CameraCapture& operator=(const CameraCapture&) = delete;
+
+    bool isOpened() const;
+    int index() const { return m_index; }
+    cv::Size frameSize() const;
+
+    /**
+     * @brief 是否只保留 MJPEG 压缩包，把解码推迟给消费者 (默认开启)
+     * 后端不提供压缩包时 (OpenCV 后端 / 非 MJPEG 格式) 仍然在采集线程全尺寸解码。
+     * 需在 start() 之前设置。
+     */
+    void setKeepCompressed(bool keep) { m_keepCompressed = keep; }
+
+    // 启动 / 停止采集线程 (stop 会等待线程退出)
+    void start();
+    void stop();
+
+    /**
+     * @brief 读取最新帧 (不阻塞采集线程)
+     * @param out 输出帧，与邮箱共享像素内存
+     * @param afterSeq 只要比这个序号新的帧
+     * @return 是否拿到了新帧
+     */
+    bool latestFrame(CameraFrame& out, uint64_t afterSeq = 0) const;
+
+    CaptureStats stats() const;
+
+private:
+    void run();     // 采集线程主循环
+
+    int m_index;
+    std::unique_ptr<CameraSource> m_source;
+    bool m_keepCompressed = true;
+    FrameMailbox m_mailbox;
+
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+
+    // 统计计数 (采集线程写，任意线程读)
+    std::atomic<uint64_t> m_captured{0};
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<uint64_t> m_readErrors{0};
+    std::atomic<uint64_t> m_allocations{0};
+    std::atomic<double> m_fps{0.0};
+};
+
+#endif // CAMERACAPTURE_H
@@ -0,0 +1,120 @@
+#ifndef FRAMEMAILBOX_H
+#define FRAMEMAILBOX_H
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+
+// 一帧采集结果
+struct CameraFrame {
+    cv::Mat image;              // BGR 图像 (引用计数共享，不做深拷贝)；只保留压缩包时为空
+    cv::Mat packet;             // MJPEG 压缩包 (按容量分配的缓冲区，有效长度见 packetBytes)
+    size_t packetBytes = 0;     // 压缩包有效长度 (0 表示没有压缩包)
+    cv::Size size;              // 原图尺寸 (image 为空时也有效)
+    int64_t timestampNs = 0;    // 采集时间戳 (steady_clock, 纳秒；原生 V4L2 后端为驱动时间戳)
+    uint64_t seq = 0;           // 帧序号，从 1 开始；0 表示无效帧
+    uint64_t deviceSeq = 0;     // 驱动帧序号 (仅原生后端提供，跳号说明驱动层丢帧)
+};
+
+/**
+ * @brief 单生产者 / 多消费者的 "最新帧" 邮箱 (无锁)
+ *
+ * 采集线程只往空闲槽位里写，写完后原子地把它发布为 "最新帧"；
+ * 消费者 (界面 / 检测 / 录像) 只拷贝 cv::Mat 头 (引用计数 +1)，永远不会阻塞采集。
+ * 旧帧没人读就会被新帧顶掉，这正是我们想要的 "只看最新画面" 语义。
+ */
+class FrameMailbox
+{
+public:
+    // 槽位数: 1 个最新帧 + 1 个正在写 + 2 个并发读者的余量
+    static constexpr int kSlots = 4;
+
+    FrameMailbox() {
+        for (auto &pin : m_pins) pin.store(0);
+    }
+    FrameMailbox(const FrameMailbox&) = delete;
+    FrameMailbox& operator=(const FrameMailbox&) = delete;
+
+    /**
+     * @brief [采集线程] 取一个可写槽位
+     * @return 槽位指针；所有槽位都被读者占用时返回 nullptr (本帧只能丢弃)
+     */
+    CameraFrame* acquireWriteSlot() {
+        const int latest = m_latest.load();
+        for (int n = 0; n < kSlots; ++n) {
+            // 轮转选择，优先复用最旧的槽位，减少与读者冲突
+            int idx = (m_writeCursor + n) % kSlots;
+            if (idx == latest || m_pins[idx].load() != 0) continue;
+
+            m_writeCursor = (idx + 1) % kSlots;
+            CameraFrame &slot = m_slots[idx];
+            // 如果消费者还持有这块图像内存 (例如截图缓存)，不能原地覆盖，
+            // 释放后让 retrieve() 重新分配一块新的。
+            // 注意: refcount 只会被其他线程减小，读到旧值最多导致一次多余的分配。
+            if (slot.image.u && slot.image.u->refcount > 1) {
+                slot.image.release();
+            }
+            if (slot.packet.u && slot.packet.u->refcount > 1) {
+                slot.packet.release();
+            }
+            return &slot;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief [采集线程] 发布刚写完的槽位为最新帧
+     * @return true 表示上一帧还没被任何消费者读过就被覆盖了 (记为丢帧)
+     */
+    bool publish(CameraFrame* slot) {
+        const int idx = static_cast<int>(slot - m_slots);
+        const bool prevUnread = m_latestSeq.load() > m_consumedSeq.load();
+        m_latest.store(idx);
+        m_latestSeq.store(slot->seq);
+        return prevUnread;
+    }
+
+    /**
+     * @brief [任意线程] 读取最新帧
+     * @param out 输出帧 (只拷贝 Mat 头，共享像素内存)
+     * @param afterSeq 只有序号大于它的帧才算新帧，传 0 表示任何帧都要
+     * @return 是否拿到了新帧
+     */
+    bool readLatest(CameraFrame& out, uint64_t afterSeq = 0) const {
+        for (;;) {
+            const int idx = m_latest.load();
+            if (idx < 0) return false;
+
+            // 先钉住槽位，再确认它仍然是最新帧；否则说明采集线程可能正在改写它，重试
+            m_pins[idx].fetch_add(1);
+            if (m_latest.load() != idx) {
+                m_pins[idx].fetch_sub(1);
+                continue;
+            }
+
+            const CameraFrame &slot = m_slots[idx];
+            const bool fresh = slot.seq > afterSeq;
+            if (fresh) {
+                out = slot;
+                // 记录 "已被读过的最大序号"，多个读者并发时取最大值
+                uint64_t seen = m_consumedSeq.load();
+                while (seen < slot.seq && !m_consumedSeq.compare_exchange_weak(seen, slot.seq)) {}
+            }
+            m_pins[idx].fetch_sub(1);
+            return fresh;
+        }
+    }
+
+    // 最新帧序号 (0 表示还没有任何帧)
+    uint64_t latestSeq() const { return m_latestSeq.load(); }
+
+private:
+    CameraFrame m_slots[kSlots];
+    std::atomic<int> m_latest{-1};              // 最新帧所在槽位 (-1 表示还没有帧)
+    mutable std::atomic<int> m_pins[kSlots];    // 每个槽位当前的读者数
+    std::atomic<uint64_t> m_latestSeq{0};       // 最新帧序号
+    mutable std::atomic<uint64_t> m_consumedSeq{0}; // 被读过的最大序号 (用于统计丢帧)
+    int m_writeCursor = 0;                      // 只由采集线程访问
+};
+
+#endif // FRAMEMAILBOX_H
@@ -0,0 +1,529 @@
+#include "FrameRecorder.h"
+#include "CameraCapture.h"
+#include "tools/Common/SteadyClock.h"
+#include <QDebug>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+int64_t wallNowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+bool writeWholeFile(const std::string& path, const std::vector<uchar>& data) {
+    std::FILE *f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    const bool ok = data.empty() || std::fwrite(data.data(), data.size(), 1, f) == 1;
+    return (std::fclose(f) == 0) && ok;
+}
+
+// 缓冲区池最多留这么多块 (够 4 路相机各排十几帧)
+const size_t kMaxPooledBuffers = 64;
+
+// JPEG 标准 Huffman 表 (ITU T.81 附录 K.3) 组成的 DHT 段:
+// UVC 相机的 MJPEG 帧大多省略 DHT，解码器会自动补，但原样存成 .jpg 后很多看图软件打不开
+const uchar kStandardDht[] = {
+    0xFF, 0xC4, 0x01, 0xA2,
+    // 亮度 DC
+    0x00, 0x00, 0x01, 0x05, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B,
+    // 色度 DC
+    0x01, 0x00, 0x03, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B,
+    // 亮度 AC
+    0x10, 0x00, 0x02, 0x01, 0x03, 0x03, 0x02, 0x04, 0x03, 0x05, 0x05, 0x04, 0x04, 0x00, 0x00, 0x01, 0x7D,
+    0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07,
+    0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xA1, 0x08, 0x23, 0x42, 0xB1, 0xC1, 0x15, 0x52, 0xD1, 0xF0,
+    0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0A, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2A, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+    0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+    0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+    0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7,
+    0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3, 0xC4, 0xC5,
+    0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xE1, 0xE2,
+    0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8,
+    0xF9, 0xFA,
+    // 色度 AC
+    0x11, 0x00, 0x02, 0x01, 0x02, 0x04, 0x04, 0x03, 0x04, 0x07, 0x05, 0x04, 0x04, 0x00, 0x01, 0x02, 0x77,
+    0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71,
+    0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xA1, 0xB1, 0xC1, 0x09, 0x23, 0x33, 0x52, 0xF0,
+    0x15, 0x62, 0x72, 0xD1, 0x0A, 0x16, 0x24, 0x34, 0xE1, 0x25, 0xF1, 0x17, 0x18, 0x19, 0x1A, 0x26,
+    0x27, 0x28, 0x29, 0x2A, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+    0x49, 0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+    0x69, 0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+    0x88, 0x89, 0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5,
+    0xA6, 0xA7, 0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3,
+    0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA,
+    0xE2, 0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8,
+    0xF9, 0xFA,
+};
+static_assert(sizeof(kStandardDht) == 2 + 0x1A2, "DHT 段长度");
+
+// 压缩包拷进 out；没有 DHT 段时在 SOS 之前补上标准表，保证存下来的是完整的 JPEG 文件
+void copyJpeg(const uchar* data, size_t size, std::vector<uchar>& out) {
+    size_t insertAt = 0;
+    for (size_t i = 2; i + 4 <= size && data[0] == 0xFF && data[1] == 0xD8;) {
+        if (data[i] != 0xFF) break;                     // 格式不对，原样保存
+        const uchar marker = data[i + 1];
+        if (marker == 0xFF) { ++i; continue; }          // 填充字节
+        if (marker == 0xC4) break;                      // 已经有 DHT
+        if (marker == 0xDA) { insertAt = i; break; }    // 扫描数据开始 (SOS)
+        i += 2 + ((size_t(data[i + 2]) << 8) | data[i + 3]);
+    }
+    if (insertAt == 0) {
+        out.assign(data, data + size);
+        return;
+    }
+    out.reserve(size + sizeof(kStandardDht));
+    out.assign(data, data + insertAt);
+    out.insert(out.end(), kStandardDht, kStandardDht + sizeof(kStandardDht));
+    out.insert(out.end(), data + insertAt, data + size);
+}
+}
+
+FrameRecorder::FrameRecorder(int encoderThreads, size_t queueCapacity)
+    : m_queueCapacity(std::max<size_t>(1, queueCapacity))
+{
+    if (encoderThreads <= 0) {
+        // 一路 1080p BGR 编码约 10 ms，4 路 30 FPS 要 1 ~ 2 个核；MJPEG 原样写入几乎不占 CPU
+        encoderThreads = (int)std::min(4u, std::max(1u, std::thread::hardware_concurrency() / 2));
+    }
+    for (int i = 0; i < encoderThreads; ++i) {
+        m_encoders.emplace_back(&FrameRecorder::encodeLoop, this);
+    }
+}
+
+FrameRecorder::~FrameRecorder() {
+    stopRecording();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    // 编码线程会先把队列里剩下的截图写完再退出
+    m_encodeCv.notify_all();
+    for (auto &t : m_encoders) t.join();
+}
+
+std::vector<uchar> FrameRecorder::takeBuffer() {
+    std::lock_guard<std::mutex> lock(m_poolMutex);
+    if (m_pool.empty()) return {};
+    std::vector<uchar> buffer = std::move(m_pool.back());
+    m_pool.pop_back();
+    return buffer;
+}
+
+void FrameRecorder::returnBuffer(std::vector<uchar>&& buffer) {
+    if (buffer.capacity() == 0) return;
+    buffer.clear();
+    std::lock_guard<std::mutex> lock(m_poolMutex);
+    if (m_pool.size() < kMaxPooledBuffers) m_pool.push_back(std::move(buffer));
+}
+
+FrameRecorder::Job FrameRecorder::makeJob(int camera, const CameraFrame& frame) {
+    Job job;
+    job.camera = camera;
+    job.frame.size = frame.size;
+    job.frame.timestampNs = frame.timestampNs;
+    job.frame.seq = frame.seq;
+    job.frame.deviceSeq = frame.deviceSeq;
+    if (frame.packetBytes > 0) {
+        // 压缩包本身就是 JPEG，拷出来 (几百 KB) 就不用编码了；
+        // 不共享是为了不占着采集邮箱的缓冲区 (否则采集线程每帧都要重新分配)
+        job.data = takeBuffer();
+        copyJpeg(frame.packet.data, frame.packetBytes, job.data);
+    } else {
+        job.frame.image = frame.image;
+    }
+    return job;
+}
+
+bool FrameRecorder::enqueue(std::vector<Job>& jobs, bool asSet) {
+    m_submitted.fetch_add(jobs.size());
+    bool accepted = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const bool snapshot = jobs.front().snapshot;
+        if (!m_stopping && (snapshot || m_recording.load()) &&
+            m_encodeQueue.size() + jobs.size() <= m_queueCapacity) {
+            const uint64_t setId = asSet ? m_nextSetId++ : 0;
+            for (auto &job : jobs) {
+                job.setId = setId;
+                if (!job.snapshot) ++m_pendingRecord;
+                m_encodeQueue.push_back(std::move(job));
+            }
+            accepted = true;
+        }
+    }
+    if (!accepted) {
+        m_dropped.fetch_add(jobs.size());
+        for (auto &job : jobs) returnBuffer(std::move(job.data));
+        return false;
+    }
+    if (jobs.size() == 1) {
+        m_encodeCv.notify_one();
+    } else {
+        m_encodeCv.notify_all();
+    }
+    return true;
+}
+
+bool FrameRecorder::saveSnapshot(const std::string& path, const CameraFrame& frame) {
+    std::vector<Job> jobs;
+    jobs.push_back(makeJob(0, frame));
+    jobs.back().snapshot = true;
+    jobs.back().path = path;
+    return enqueue(jobs, false);
+}
+
+bool FrameRecorder::submit(int camera, const CameraFrame& frame) {
+    if (!m_recording.load()) return false;
+    std::vector<Job> jobs;
+    jobs.push_back(makeJob(camera, frame));
+    return enqueue(jobs, false);
+}
+
+bool FrameRecorder::submitSet(const std::vector<CameraFrame>& frames) {
+    if (!m_recording.load() || frames.empty()) return false;
+    std::vector<Job> jobs;
+    jobs.reserve(frames.size());
+    for (size_t i = 0; i < frames.size(); ++i) jobs.push_back(makeJob((int)i, frames[i]));
+    return enqueue(jobs, true);
+}
+
+void FrameRecorder::flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idleCv.wait(lock, [this] {
+        return m_encodeQueue.empty() && m_encoding == 0 && m_writeQueue.empty() && !m_writing;
+    });
+}
+
+RecorderStats FrameRecorder::stats() const {
+    RecorderStats s;
+    s.submitted = m_submitted.load();
+    s.dropped = m_dropped.load();
+    s.written = m_written.load();
+    s.bytesWritten = m_bytesWritten.load();
+    s.snapshots = m_snapshots.load();
+    s.errors = m_errors.load();
+    s.passthrough = m_passthrough.load();
+    s.segments = m_segments.load();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    s.queued = m_encodeQueue.size();
+    s.bufferedBytes = m_writeQueueBytes;
+    s.encodeMsAvg = m_encoded ? m_encodeMsSum / m_encoded : 0.0;
+    return s;
+}
+
+// ================= 编码线程 =================
+void FrameRecorder::encodeLoop() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_encodeCv.wait(lock, [this] { return m_stopping || !m_encodeQueue.empty(); });
+            if (m_encodeQueue.empty()) return;      // 停止且没有剩余任务
+            job = std::move(m_encodeQueue.front());
+            m_encodeQueue.pop_front();
+            ++m_encoding;
+        }
+
+        bool ok = true;
+        if (!job.data.empty()) {
+            m_passthrough.fetch_add(1);
+        } else if (job.frame.image.empty()) {
+            ok = false;
+        } else {
+            const int64_t t0 = steadyNowNs();
+            job.data = takeBuffer();
+            ok = cv::imencode(".jpg", job.frame.image, job.data, {cv::IMWRITE_JPEG_QUALITY, m_jpegQuality.load()});
+            const double ms = (steadyNowNs() - t0) * 1e-6;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_encoded;
+            m_encodeMsSum += ms;
+        }
+        job.frame.image.release();      // 尽早归还采集缓冲区
+
+        if (job.snapshot) {
+            if (ok && writeWholeFile(job.path, job.data)) {
+                m_snapshots.fetch_add(1);
+            } else {
+                m_errors.fetch_add(1);
+                qDebug() << "❌ 截图保存失败:" << QString::fromStdString(job.path);
+            }
+            returnBuffer(std::move(job.data));
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_encoding;
+            m_idleCv.notify_all();
+            continue;
+        }
+
+        if (!ok) {
+            m_errors.fetch_add(1);
+            returnBuffer(std::move(job.data));
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_encoding;
+            --m_pendingRecord;
+            m_writeCv.notify_one();     // 可能是停止后的最后一帧，写线程在等
+            m_idleCv.notify_all();
+            continue;
+        }
+
+        {
+            // 反压: 写队列里攒的数据超过上限时在这里等写线程
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_spaceCv.wait(lock, [this] {
+                return m_writeQueueBytes < m_options.maxWriteBufferBytes || m_writeQueue.empty();
+            });
+            m_writeQueueBytes += job.data.size();
+            m_writeQueue.push_back(std::move(job));
+            --m_encoding;
+            --m_pendingRecord;
+        }
+        m_writeCv.notify_one();
+        m_idleCv.notify_all();
+    }
+}
+
+// ================= 写文件线程 =================
+void FrameRecorder::writeLoop() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            // 停止后要等编码线程把已入队的录像帧都交过来，写队列清空才算写完
+            m_writeCv.wait(lock, [this] {
+                return !m_writeQueue.empty() || (!m_recording.load() && m_pendingRecord == 0);
+            });
+            if (m_writeQueue.empty()) break;
+            job = std::move(m_writeQueue.front());
+            m_writeQueue.pop_front();
+            m_writeQueueBytes -= job.data.size();
+            m_writing = true;
+        }
+        m_spaceCv.notify_all();
+
+        writeRecord(job);
+        returnBuffer(std::move(job.data));
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_writing = false;
+        }
+        m_idleCv.notify_all();
+    }
+    closeSegment();
+
+    const RecorderStats s = stats();
+    qDebug() << "⏹️ 录像结束 | 写入" << s.written << "帧 |" << s.segments << "个分段 | 丢帧" << s.dropped
+             << "| 错误" << s.errors;
+    m_writerRunning.store(false);
+}
+
+bool FrameRecorder::openSegment(int segment) {
+    const std::string path = RecFormat::segmentPath(m_basePath, segment);
+    m_file = std::fopen(path.c_str(), "wb");
+    if (!m_file) {
+        qDebug() << "❌ 无法创建录像文件:" << QString::fromStdString(path);
+        return false;
+    }
+    std::setvbuf(m_file, nullptr, _IOFBF, 1 << 20);
+
+    RecFormat::RecFileHeader header{};
+    std::memcpy(header.magic, RecFormat::kFileMagic, sizeof(header.magic));
+    header.version = RecFormat::kVersion;
+    header.segment = (uint32_t)segment;
+    header.wallStartMs = m_wallStartMs;
+    header.steadyStartNs = m_steadyStartNs;
+    header.cameraCount = (uint32_t)std::max(0, m_options.cameraCount);
+    if (std::fwrite(&header, sizeof(header), 1, m_file) != 1) {
+        std::fclose(m_file);
+        m_file = nullptr;
+        m_errors.fetch_add(1);
+        return false;
+    }
+    m_segment = segment;
+    m_segmentOffset = sizeof(header);
+    m_index.clear();
+    m_segments.fetch_add(1);
+    return true;
+}
+
+void FrameRecorder::closeSegment() {
+    if (!m_file) return;
+    RecFormat::RecFooter footer{};
+    footer.indexOffset = m_segmentOffset;
+    footer.entryCount = m_index.size();
+    std::memcpy(footer.magic, RecFormat::kIndexMagic, sizeof(footer.magic));
+
+    bool ok = m_index.empty() ||
+              std::fwrite(m_index.data(), sizeof(RecFormat::RecIndexEntry), m_index.size(), m_file) == m_index.size();
+    ok = ok && std::fwrite(&footer, sizeof(footer), 1, m_file) == 1;
+    ok = (std::fclose(m_file) == 0) && ok;
+    m_file = nullptr;
+    if (!ok) {
+        m_errors.fetch_add(1);
+        qDebug() << "❌ 录像分段" << m_segment << "索引写入失败 (读取时会顺序扫描重建)";
+    }
+}
+
+void FrameRecorder::writeRecord(Job& job) {
+    const uint64_t recordBytes = sizeof(RecFormat::RecFrameHeader) + job.data.size();
+    // 当前分段写不下就换下一个 (一个分段至少写一帧，防止超大帧导致无限换段)
+    if (m_file && !m_index.empty() && m_segmentOffset + recordBytes > m_options.segmentBytes) {
+        closeSegment();
+        openSegment(m_segment + 1);
+    }
+    if (!m_file) {
+        m_errors.fetch_add(1);
+        return;
+    }
+
+    RecFormat::RecFrameHeader header{};
+    header.magic = RecFormat::kFrameMagic;
+    header.camera = (uint16_t)job.camera;
+    header.codec = RecFormat::CodecJpeg;
+    header.seq = job.frame.seq;
+    header.timestampNs = job.frame.timestampNs;
+    header.setId = job.setId;
+    header.width = (uint16_t)job.frame.size.width;
+    header.height = (uint16_t)job.frame.size.height;
+    header.bytes = (uint32_t)job.data.size();
+
+    if (std::fwrite(&header, sizeof(header), 1, m_file) != 1 ||
+        std::fwrite(job.data.data(), job.data.size(), 1, m_file) != 1) {
+        // 写到一半失败，文件位置已经不可信: 关掉这个分段，后面的帧记为错误
+        m_errors.fetch_add(1);
+        qDebug() << "❌ 录像写入失败，停止写入分段" << m_segment;
+        closeSegment();
+        return;
+    }
+
+    RecFormat::RecIndexEntry entry{};
+    entry.offset = m_segmentOffset;
+    entry.timestampNs = header.timestampNs;
+    entry.seq = header.seq;
+    entry.setId = header.setId;
+    entry.bytes = header.bytes;
+    entry.camera = header.camera;
+    entry.codec = header.codec;
+    entry.width = header.width;
+    entry.height = header.height;
+    m_index.push_back(entry);
+
+    m_segmentOffset += recordBytes;
+    m_written.fetch_add(1);
+    m_bytesWritten.fetch_add(recordBytes);
+}
+
+// ================= 录像控制 =================
+bool FrameRecorder::startRecording(const std::string& basePath, const RecordingOptions& options,
+                                   const std::vector<const CameraCapture*>& sources) {
+    std::lock_guard<std::mutex> control(m_controlMutex);
+    if (m_recording.load() || m_writerRunning.load()) return false;
+    if (m_writer.joinable()) m_writer.join();   // 上一次录像的写线程已经收尾退出
+
+    m_basePath = basePath;
+    m_options = options;
+    if (!sources.empty()) m_options.cameraCount = (int)sources.size();
+    m_wallStartMs = wallNowMs();
+    m_steadyStartNs = steadyNowNs();
+    m_segments.store(0);
+    // 第一个分段在这里打开，打不开直接返回失败；之后文件只由写线程访问
+    if (!openSegment(0)) return false;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_nextSetId = 1;
+        m_recording.store(true);
+    }
+    m_writerRunning.store(true);
+    m_writer = std::thread(&FrameRecorder::writeLoop, this);
+    if (!sources.empty()) {
+        m_polling.store(true);
+        m_poller = std::thread(&FrameRecorder::pollLoop, this, sources, m_options);
+    }
+    qDebug() << "🎬 开始录像:" << QString::fromStdString(basePath) << "| 相机" << m_options.cameraCount
+             << "路 | 对齐:" << m_options.aligned << "| 编码线程" << m_encoders.size();
+    return true;
+}
+
+void FrameRecorder::beginStop() {
+    if (!m_recording.load()) return;
+
+    // 轮询线程每隔几毫秒醒一次，join 很快
+    m_polling.store(false);
+    if (m_poller.joinable()) m_poller.join();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_recording.store(false);
+    }
+    // 剩下的编码、落盘和写索引都在写线程里做完
+    m_writeCv.notify_all();
+}
+
+void FrameRecorder::requestStop() {
+    std::lock_guard<std::mutex> control(m_controlMutex);
+    beginStop();
+}
+
+void FrameRecorder::stopRecording() {
+    std::lock_guard<std::mutex> control(m_controlMutex);
+    beginStop();
+    if (m_writer.joinable()) m_writer.join();
+}
+
+// ================= 采集轮询线程 =================
+void FrameRecorder::pollLoop(std::vector<const CameraCapture*> sources, RecordingOptions options) {
+    const size_t n = sources.size();
+    const int64_t toleranceNs = (int64_t)(options.alignToleranceMs * 1e6);
+    std::vector<uint64_t> lastSeq(n, 0);
+    // 对齐模式: 每路等着凑组的帧 (已经转成任务，不占着采集邮箱的缓冲区)
+    std::vector<Job> pending(n);
+    std::vector<bool> hasPending(n, false);
+
+    while (m_polling.load()) {
+        for (size_t i = 0; i < n; ++i) {
+            CameraFrame frame;
+            if (!sources[i]->isOpened() || !sources[i]->latestFrame(frame, lastSeq[i])) continue;
+            // 序号跳了说明两次轮询之间有帧被邮箱顶掉了
+            if (lastSeq[i] != 0 && frame.seq > lastSeq[i] + 1) m_dropped.fetch_add(frame.seq - lastSeq[i] - 1);
+            lastSeq[i] = frame.seq;
+
+            if (!options.aligned) {
+                submit((int)i, frame);
+                continue;
+            }
+            if (hasPending[i]) {
+                // 上一帧没凑成组就被新帧替换
+                m_dropped.fetch_add(1);
+                returnBuffer(std::move(pending[i].data));
+            }
+            pending[i] = makeJob((int)i, frame);
+            hasPending[i] = true;
+        }
+
+        if (options.aligned && std::all_of(hasPending.begin(), hasPending.end(), [](bool b) { return b; })) {
+            size_t oldest = 0;
+            int64_t newestNs = pending[0].frame.timestampNs;
+            for (size_t i = 1; i < n; ++i) {
+                if (pending[i].frame.timestampNs < pending[oldest].frame.timestampNs) oldest = i;
+                newestNs = std::max(newestNs, pending[i].frame.timestampNs);
+            }
+            if (newestNs - pending[oldest].frame.timestampNs <= toleranceNs) {
+                enqueue(pending, true);
+                pending.assign(n, Job());
+                hasPending.assign(n, false);
+            } else {
+                // 对不齐: 丢掉最旧的一帧，等那一路的下一帧
+                m_dropped.fetch_add(1);
+                returnBuffer(std::move(pending[oldest].data));
+                pending[oldest] = Job();
+                hasPending[oldest] = false;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(options.pollIntervalMs));
+    }
+    for (auto &job : pending) returnBuffer(std::move(job.data));
+}
@@ -0,0 +1,196 @@
+#ifndef FRAMERECORDER_H
+#define FRAMERECORDER_H
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "FrameMailbox.h"
+#include "RecordingFormat.h"
+
+class CameraCapture;
+
+// 连续录像参数
+struct RecordingOptions {
+    bool aligned = false;               // 多相机对齐录制: 每路各凑一帧、时间差不超过 alignToleranceMs 才整组写入
+    double alignToleranceMs = 10.0;
+    int cameraCount = 0;                // 写进文件头的相机路数 (指定了 sources 时取 sources 的数量)
+    uint64_t segmentBytes = 1ULL << 30; // 分段大小上限，写满后换下一个分段文件
+    size_t maxWriteBufferBytes = 256u << 20;  // 已编码、等待落盘的数据上限，超过后编码线程等待 (反压)
+    int pollIntervalMs = 2;             // 从相机邮箱取帧的轮询间隔 (只在指定了 sources 时使用)
+};
+
+// 录像 / 截图统计
+struct RecorderStats {
+    uint64_t submitted = 0;             // 提交的帧数 (含截图)
+    uint64_t dropped = 0;               // 队列满或相机帧被覆盖而没能录下的帧数
+    uint64_t written = 0;               // 已写进录像文件的帧数
+    uint64_t bytesWritten = 0;
+    uint64_t snapshots = 0;             // 已保存的截图数
+    uint64_t errors = 0;                // 编码 / 写文件失败次数
+    uint64_t passthrough = 0;           // MJPEG 压缩包原样写入 (不用重新编码) 的帧数
+    size_t queued = 0;                  // 当前等待编码的帧数
+    size_t bufferedBytes = 0;           // 当前等待落盘的字节数
+    double encodeMsAvg = 0.0;           // 需要编码的帧的平均编码耗时
+    int segments = 0;                   // 本次录像已打开的分段数
+};
+
+/**
+ * @brief 异步截图 / 连续录像
+ *
+ *   submit / saveSnapshot ──> [有界编码队列] ──> 编码线程 x N ──> [按字节数限量的写队列] ──> 写文件线程
+ *
+ * 调用方 (界面 / 采集轮询线程) 只拷贝 Mat 头或 MJPEG 压缩包，从不等待编码和磁盘。
+ * MJPEG 压缩包原样写入 (本来就是 JPEG，缺 Huffman 表时补上标准表)，只有已解码的 BGR 帧才在编码线程里 imencode。
+ * 磁盘跟不上时写队列满了，编码线程停下来等，编码队列随之填满，
+ * 之后提交的帧直接丢弃并计数 —— 反压只会丢帧，不会拖住相机和界面。
+ *
+ * 录像写成分段容器 (格式见 RecordingFormat.h)，每帧带采集时间戳，关闭分段时写索引，
+ * 之后可以用 RecordingReader 按时间定位单路或对齐的多路画面。
+ */
+class FrameRecorder
+{
+public:
+    /**
+     * @param encoderThreads 编码线程数，0 表示按 CPU 核数自动选 (1 ~ 4)
+     * @param queueCapacity 编码队列容量 (帧)
+     */
+    explicit FrameRecorder(int encoderThreads = 0, size_t queueCapacity = 48);
+    ~FrameRecorder();
+
+    FrameRecorder(const FrameRecorder&) = delete;
+    FrameRecorder& operator=(const FrameRecorder&) = delete;
+
+    // BGR 帧的 JPEG 质量 (MJPEG 压缩包原样保存，不受影响)
+    void setJpegQuality(int quality) { m_jpegQuality.store(quality); }
+
+    /**
+     * @brief 异步保存一张截图 (不阻塞)
+     * @return 编码队列已满时返回 false
+     */
+    bool saveSnapshot(const std::string& path, const CameraFrame& frame);
+
+    /**
+     * @brief 开始连续录像
+     * @param basePath 分段文件名前缀，实际文件为 <basePath>_000.urrec ...
+     * @param sources 非空时由内部线程轮询这些相机的最新帧自动提交 (第 i 个相机记为第 i 路)；
+     *                为空时由调用方 submit / submitSet
+     * @return 已经在录像或第一个分段打不开时返回 false
+     */
+    bool startRecording(const std::string& basePath, const RecordingOptions& options = RecordingOptions(),
+                        const std::vector<const CameraCapture*>& sources = {});
+    /**
+     * @brief 请求停止录像 (不阻塞，界面线程用)
+     * 立即不再接收新帧；已提交的帧由写线程编码落盘、写完最后一个分段的索引后自行退出，
+     * 期间 isFinishing() 为 true，不能开始下一次录像
+     */
+    void requestStop();
+    // 停止录像: 等已提交的帧编码、落盘，写完最后一个分段的索引后返回
+    void stopRecording();
+    bool isRecording() const { return m_recording.load(); }
+    // 已请求停止，写线程还在收尾
+    bool isFinishing() const { return !m_recording.load() && m_writerRunning.load(); }
+
+    // 录像时提交一帧 (不阻塞)，队列满时丢弃并返回 false
+    bool submit(int camera, const CameraFrame& frame);
+    /**
+     * @brief 提交对齐的一组帧，frames[i] 为第 i 路 (不阻塞)
+     * 整组一起入队或一起丢弃，写入时带同一个组编号
+     */
+    bool submitSet(const std::vector<CameraFrame>& frames);
+
+    // 等编码队列和写队列都清空 (截图全部落盘)
+    void flush();
+
+    RecorderStats stats() const;
+    int encoderThreads() const { return (int)m_encoders.size(); }
+
+private:
+    struct Job {
+        bool snapshot = false;
+        int camera = 0;
+        uint64_t setId = 0;
+        CameraFrame frame;          // 只在需要编码时持有 (共享像素内存)
+        std::vector<uchar> data;    // JPEG 数据: 压缩包在提交时拷进来，BGR 帧在编码线程里填
+        std::string path;           // 截图文件名
+    };
+
+    // 把帧转成待编码的任务 (压缩包拷贝到池里的缓冲区，图像只共享)
+    Job makeJob(int camera, const CameraFrame& frame);
+    // 一起入队 (asSet 时分配同一个组编号)；放不下就整批丢弃
+    bool enqueue(std::vector<Job>& jobs, bool asSet);
+    void encodeLoop();
+    void writeLoop();
+    void pollLoop(std::vector<const CameraCapture*> sources, RecordingOptions options);
+    // 停掉轮询线程、不再接收新帧并叫醒写线程收尾 (调用方持有 m_controlMutex)
+    void beginStop();
+
+    // 写文件线程用: 分段管理
+    bool openSegment(int segment);
+    void closeSegment();
+    void writeRecord(Job& job);
+
+    std::vector<uchar> takeBuffer();
+    void returnBuffer(std::vector<uchar>&& buffer);
+
+    const size_t m_queueCapacity;
+    std::atomic<int> m_jpegQuality{90};
+
+    // 编码队列 / 写队列共用一把锁 (每秒百来帧，竞争可以忽略)
+    mutable std::mutex m_mutex;
+    std::condition_variable m_encodeCv;     // 编码队列非空 / 停止
+    std::condition_variable m_writeCv;      // 写队列非空 / 录像帧全部交给写线程
+    std::condition_variable m_spaceCv;      // 写队列有空间
+    std::condition_variable m_idleCv;       // 有任务完成 (flush 等待)
+    std::deque<Job> m_encodeQueue;
+    std::deque<Job> m_writeQueue;
+    size_t m_writeQueueBytes = 0;
+    size_t m_encoding = 0;                  // 编码线程手上的任务数
+    bool m_writing = false;                 // 写线程手上有一帧
+    size_t m_pendingRecord = 0;             // 已入队还没交给写线程的录像帧
+    bool m_stopping = false;
+
+    std::vector<std::thread> m_encoders;
+    std::thread m_writer;
+    std::thread m_poller;
+    std::atomic<bool> m_recording{false};
+    std::atomic<bool> m_polling{false};
+    std::atomic<bool> m_writerRunning{false};   // 写线程还没写完索引退出
+    std::mutex m_controlMutex;              // start / stop 互斥
+
+    // 录像参数 (start 时设置，写线程只读)
+    std::string m_basePath;
+    RecordingOptions m_options;
+    int64_t m_wallStartMs = 0;
+    int64_t m_steadyStartNs = 0;
+    uint64_t m_nextSetId = 1;               // 只在持有 m_mutex 时修改
+
+    // 写线程状态
+    std::FILE *m_file = nullptr;
+    int m_segment = -1;
+    uint64_t m_segmentOffset = 0;
+    std::vector<RecFormat::RecIndexEntry> m_index;
+
+    // 缓冲区池 (压缩包拷贝 / 编码输出复用，稳态下不再分配)
+    std::mutex m_poolMutex;
+    std::vector<std::vector<uchar>> m_pool;
+
+    std::atomic<uint64_t> m_submitted{0};
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<uint64_t> m_written{0};
+    std::atomic<uint64_t> m_bytesWritten{0};
+    std::atomic<uint64_t> m_snapshots{0};
+    std::atomic<uint64_t> m_errors{0};
+    std::atomic<uint64_t> m_passthrough{0};
+    uint64_t m_encoded = 0;                 // 以下两个持有 m_mutex 时修改
+    double m_encodeMsSum = 0.0;
+    std::atomic<int> m_segments{0};
+};
+
+#endif // FRAMERECORDER_H
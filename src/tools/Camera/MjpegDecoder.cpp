@@ -0,0 +1,158 @@
+#include "MjpegDecoder.h"
+#include "tools/Trace/LatencyTrace.h"
+
+#ifdef HAVE_LIBJPEG
+#include <csetjmp>
+#include <cstdio>
+#include <jpeglib.h>
+#endif
+
+namespace {
+// 输出缓冲区如果还被别人引用 (例如曾经共享过采集帧)，不能原地覆盖
+void detachShared(cv::Mat& bgr) {
+    if (bgr.u && bgr.u->refcount > 1) bgr.release();
+}
+
+int normalizeScale(int scaleDenom) {
+    if (scaleDenom >= 8) return 8;
+    if (scaleDenom >= 4) return 4;
+    if (scaleDenom >= 2) return 2;
+    return 1;
+}
+}
+
+#ifdef HAVE_LIBJPEG
+
+// libjpeg 默认出错会直接 exit()，这里改为 longjmp 回到 decode()
+struct JpegErrorManager {
+    jpeg_error_mgr pub;
+    jmp_buf jump;
+};
+
+static void onJpegError(j_common_ptr cinfo) {
+    JpegErrorManager *err = reinterpret_cast<JpegErrorManager*>(cinfo->err);
+    longjmp(err->jump, 1);
+}
+
+static void onJpegMessage(j_common_ptr /*cinfo*/) {
+    // 相机 MJPEG 常见 "Corrupt JPEG data" 警告，忽略，避免刷屏
+}
+
+struct MjpegDecoder::Impl {
+    jpeg_decompress_struct cinfo;
+    JpegErrorManager err;
+
+    Impl() {
+        cinfo.err = jpeg_std_error(&err.pub);
+        err.pub.error_exit = onJpegError;
+        err.pub.output_message = onJpegMessage;
+        jpeg_create_decompress(&cinfo);
+    }
+    ~Impl() { jpeg_destroy_decompress(&cinfo); }
+};
+
+MjpegDecoder::MjpegDecoder() : m_impl(new Impl) {}
+
+bool MjpegDecoder::decode(const uint8_t* data, size_t size, int scaleDenom, cv::Mat& bgr) {
+    if (!data || size == 0) return false;
+    jpeg_decompress_struct &cinfo = m_impl->cinfo;
+
+    if (setjmp(m_impl->err.jump)) {
+        jpeg_abort_decompress(&cinfo);
+        return false;
+    }
+
+    // 注意: UVC 相机的 MJPEG 往往省略 Huffman 表，libjpeg-turbo 会自动补上标准表
+    jpeg_mem_src(&cinfo, const_cast<unsigned char*>(data), static_cast<unsigned long>(size));
+    jpeg_read_header(&cinfo, TRUE);
+
+    // DCT 域缩放: 只做 1/scale 尺寸的 IDCT
+    cinfo.scale_num = 1;
+    cinfo.scale_denom = normalizeScale(scaleDenom);
+    cinfo.dct_method = JDCT_IFAST;
+#ifdef JCS_EXTENSIONS
+    cinfo.out_color_space = JCS_EXT_BGR;    // libjpeg-turbo 直接输出 BGR
+#else
+    cinfo.out_color_space = JCS_RGB;
+#endif
+
+    jpeg_start_decompress(&cinfo);
+    detachShared(bgr);
+    bgr.create(static_cast<int>(cinfo.output_height), static_cast<int>(cinfo.output_width), CV_8UC3);
+    while (cinfo.output_scanline < cinfo.output_height) {
+        JSAMPROW row = bgr.ptr<JSAMPLE>(static_cast<int>(cinfo.output_scanline));
+        jpeg_read_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_decompress(&cinfo);
+
+#ifndef JCS_EXTENSIONS
+    cv::cvtColor(bgr, bgr, cv::COLOR_RGB2BGR);
+#endif
+    return true;
+}
+
+bool MjpegDecoder::usingLibjpeg() { return true; }
+
+#else // 没有 libjpeg: 使用 OpenCV 的缩放解码
+
+struct MjpegDecoder::Impl {};
+
+MjpegDecoder::MjpegDecoder() : m_impl(new Impl) {}
+
+bool MjpegDecoder::decode(const uint8_t* data, size_t size, int scaleDenom, cv::Mat& bgr) {
+    if (!data || size == 0) return false;
+
+    int flags = cv::IMREAD_COLOR;
+    switch (normalizeScale(scaleDenom)) {
+    case 2: flags = cv::IMREAD_REDUCED_COLOR_2; break;
+    case 4: flags = cv::IMREAD_REDUCED_COLOR_4; break;
+    case 8: flags = cv::IMREAD_REDUCED_COLOR_8; break;
+    default: break;
+    }
+
+    cv::Mat packet(1, static_cast<int>(size), CV_8UC1, const_cast<uint8_t*>(data));
+    detachShared(bgr);
+    cv::imdecode(packet, flags, &bgr);
+    return !bgr.empty();
+}
+
+bool MjpegDecoder::usingLibjpeg() { return false; }
+
+#endif // HAVE_LIBJPEG
+
+MjpegDecoder::~MjpegDecoder() = default;
+MjpegDecoder::MjpegDecoder(MjpegDecoder&&) noexcept = default;
+MjpegDecoder& MjpegDecoder::operator=(MjpegDecoder&&) noexcept = default;
+
+bool MjpegDecoder::decodeFrame(const CameraFrame& frame, int scaleDenom, cv::Mat& bgr) {
+    // 1. 只有压缩包: 直接按比例解码
+    if (frame.image.empty()) {
+        if (frame.packet.empty() || frame.packetBytes == 0) return false;
+        UR_TRACE_SCOPE("camera.decode");
+        return decode(frame.packet.data, frame.packetBytes, scaleDenom, bgr);
+    }
+
+    // 2. 采集线程已经全尺寸解码过 (OpenCV 后端 / 非 MJPEG 格式)
+    scaleDenom = normalizeScale(scaleDenom);
+    if (scaleDenom == 1) {
+        bgr = frame.image;      // 共享内存，不拷贝
+    } else {
+        detachShared(bgr);
+        cv::resize(frame.image, bgr,
+                   cv::Size((frame.image.cols + scaleDenom - 1) / scaleDenom,
+                            (frame.image.rows + scaleDenom - 1) / scaleDenom),
+                   0, 0, cv::INTER_AREA);
+    }
+    return true;
+}
+
+int MjpegDecoder::pickScale(const cv::Size& full, const cv::Size& target) {
+    // 从最小的 1/8 开始试，第一个不小于目标尺寸的就是答案
+    for (int denom = 8; denom > 1; denom /= 2) {
+        // libjpeg 缩放后尺寸向上取整
+        int w = (full.width + denom - 1) / denom;
+        int h = (full.height + denom - 1) / denom;
+        if (w >= target.width && h >= target.height) return denom;
+    }
+    return 1;
+}
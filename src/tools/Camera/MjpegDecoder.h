@@ -0,0 +1,65 @@
+#ifndef MJPEGDECODER_H
+#define MJPEGDECODER_H
+
+#include <opencv2/opencv.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "FrameMailbox.h"
+
+/**
+ * @brief 按需缩放解码 MJPEG 帧
+ *
+ * JPEG 可以在 DCT 域直接按 1/2、1/4、1/8 缩小解码 (只做部分 IDCT)，
+ * 代价远小于 "全分辨率解码 + resize"。预览用小比例，截图 / 录像用原尺寸。
+ *
+ * 有 libjpeg(-turbo) 时直接调用 scale_num/scale_denom，并复用解码器状态；
+ * 否则回退到 cv::imdecode(IMREAD_REDUCED_COLOR_x)，OpenCV 内部同样是 DCT 域缩放。
+ * 一个实例只能在一个线程里用。
+ */
+class MjpegDecoder
+{
+public:
+    MjpegDecoder();
+    ~MjpegDecoder();
+
+    MjpegDecoder(const MjpegDecoder&) = delete;
+    MjpegDecoder& operator=(const MjpegDecoder&) = delete;
+    MjpegDecoder(MjpegDecoder&&) noexcept;
+    MjpegDecoder& operator=(MjpegDecoder&&) noexcept;
+
+    /**
+     * @brief 解码一帧
+     * @param data 压缩数据
+     * @param size 数据长度
+     * @param scaleDenom 缩小倍数，只能是 1 / 2 / 4 / 8
+     * @param bgr 输出 BGR 图像 (尺寸不变时复用内存)
+     */
+    bool decode(const uint8_t* data, size_t size, int scaleDenom, cv::Mat& bgr);
+    bool decode(const cv::Mat& packet, int scaleDenom, cv::Mat& bgr) {
+        return decode(packet.data, packet.total() * packet.elemSize(), scaleDenom, bgr);
+    }
+
+    /**
+     * @brief 按需解码一帧采集结果
+     * 帧里只有 MJPEG 压缩包时按比例解码；已经有解码图像时按比例缩小 (scaleDenom 为 1 时直接共享)。
+     */
+    bool decodeFrame(const CameraFrame& frame, int scaleDenom, cv::Mat& bgr);
+
+    /**
+     * @brief 选出满足目标尺寸的最大缩小倍数
+     * @param full 原图尺寸
+     * @param target 需要的最小尺寸 (解码结果宽高都不小于它)
+     * @return 1 / 2 / 4 / 8
+     */
+    static int pickScale(const cv::Size& full, const cv::Size& target);
+
+    // 是否使用了 libjpeg(-turbo) 直接解码 (否则为 OpenCV 回退路径)
+    static bool usingLibjpeg();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+#endif // MJPEGDECODER_H
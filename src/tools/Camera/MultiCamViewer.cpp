@@ -1,10 +1,14 @@
 #include "MultiCamViewer.h"
-#include "ui_MultiCamViewer.h"
-#include "../platform/CameraHelper.h" // 复用你的相机驱动
+#include "ui_CameraTestTool.h"
+
+namespace {
+// 工具窗口只做监视，不需要跟相机一样的帧率
+const double kViewerFps = 15.0;
+}
 
 MultiCamViewer::MultiCamViewer(QWidget *parent) :
     QDialog(parent),
-    ui(new Ui::MultiCamViewer)
+    ui(new Ui::Dialog)
 {
     ui->setupUi(this);
     this->setWindowTitle("🛠️ 工具箱: 多相机监视器");
@@ -14,33 +18,40 @@ MultiCamViewer::MultiCamViewer(QWidget *parent) :
 }
 
 MultiCamViewer::~MultiCamViewer() {
+    m_cams.clear();
     delete ui;
 }
 
 void MultiCamViewer::showEvent(QShowEvent *event) {
-    // 窗口打开时，初始化相机
-    // 假设你有 4 个相机，ID 分别为 0,1,2,3
-    // 注意：如果 MainWindow 占用了 ID 0，这里可能会冲突，需要做资源管理
-    // 简单起见，这里假设是独立的或者是 ID 1,2,3,4
-    for(int i=0; i<4; ++i) {
-        m_caps.push_back(createCamera(i));
+    // 窗口打开时，通过相机代理订阅 4 路相机 (ID 0,1,2,3)
+    // 主界面已经打开的相机直接共享它的采集线程，不会重复打开设备、也不多占 USB 带宽；
+    // 主界面没打开的才由代理打开 (UR_CAMERA_BACKEND=playback 时回放录像，没有相机硬件也能打开)
+    CameraSubscriberOptions options;
+    options.maxFps = kViewerFps;
+    for(int i = (int)m_cams.size(); i < 4; ++i) {
+        m_cams.push_back(CameraBroker::instance().subscribe(i, options));
     }
-    m_timer->start(30); // 30ms 刷新
+    m_previews.resize(m_cams.size());
+    m_timer->start(30); // 30ms 刷新 (实际帧率由订阅限速)
     QDialog::showEvent(event);
 }
 
-void MultiCamViewer::closeEvent(QCloseEvent *event) {
-    // 窗口关闭时，释放相机资源
+void MultiCamViewer::hideEvent(QHideEvent *event) {
+    // 窗口隐藏 / 关闭时退订；如果没有别的订阅者，代理会停止采集并关闭设备
     m_timer->stop();
-    for(auto &cap : m_caps) {
-        if(cap.isOpened()) cap.release();
-    }
-    m_caps.clear();
-    QDialog::closeEvent(event);
+    m_cams.clear();
+    QDialog::hideEvent(event);
 }
 
 void MultiCamViewer::updateCameras() {
-    // 遍历读取并显示
-    // 逻辑和你原来的 updateFrames 类似，只是不用做视觉识别，纯显示
-    // ui->lbl_Cam1->setPixmap(...)
+    // 遍历读取并显示: 和主界面的 updateFrames 一样，只是不用做视觉识别，纯显示
+    QLabel* labels[] = {ui->lbl_Cam1_2, ui->lbl_Cam2_2, ui->lbl_Cam3_2, ui->lbl_Cam4_2};
+    for(size_t i = 0; i < m_cams.size(); ++i) {
+        if(!m_cams[i]->isOpened()) continue;
+        // 按本窗口的控件尺寸解码；主界面正好用同一个缩小倍数时直接共享它的解码结果
+        cv::Mat image;
+        const QSize target = labels[i]->size();
+        if(!m_cams[i]->nextImage(image, cv::Size(target.width(), target.height()))) continue;
+        labels[i]->setPixmap(QPixmap::fromImage(m_previews[i].render(image, target)));
+    }
 }
@@ -4,9 +4,12 @@
 #include <QDialog>
 #include <QTimer>
 #include <opencv2/opencv.hpp>
+#include <memory>
 #include <vector>
+#include "CameraBroker.h"
+#include "PreviewRenderer.h"
 
-namespace Ui { class MultiCamViewer; }
+namespace Ui { class Dialog; }  // CameraTestTool.ui
 
 class MultiCamViewer : public QDialog // 继承自 Dialog，作为弹窗运行
 {
@@ -17,17 +20,18 @@ public:
     ~MultiCamViewer();
 
 protected:
-    // 窗口显示/关闭时自动开启/停止相机，节省资源
+    // 窗口显示时订阅相机，隐藏 / 关闭时退订，节省资源
     void showEvent(QShowEvent *event) override;
-    void closeEvent(QCloseEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
 
 private slots:
     void updateCameras(); // 定时刷新函数
 
 private:
-    Ui::MultiCamViewer *ui;
+    Ui::Dialog *ui;
     QTimer *m_timer;
-    std::vector<cv::VideoCapture> m_caps; // 管理多个相机
+    std::vector<std::unique_ptr<CameraSubscription>> m_cams; // 经相机代理订阅 (主界面已打开的相机直接共享，不重复打开)
+    std::vector<PreviewRenderer> m_previews;                 // 每路一个预览渲染器 (缓冲区复用)
 };
 
 #endif // MULTICAMVIEWER_H
@@ -0,0 +1,161 @@
+#include "PlaybackCameraSource.h"
+#include "tools/Common/SteadyClock.h"
+#include <QDebug>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace {
+bool envFlag(const char* name) {
+    const char *env = std::getenv(name);
+    return env && (std::strcmp(env, "1") == 0 || std::strcmp(env, "true") == 0);
+}
+}
+
+PlaybackOptions PlaybackOptions::fromEnvironment() {
+    PlaybackOptions options;
+    if (const char *mode = std::getenv("UR_CAMERA_PLAYBACK_MODE")) options.realtime = std::strcmp(mode, "fast") != 0;
+    if (const char *speed = std::getenv("UR_CAMERA_PLAYBACK_SPEED")) {
+        const double v = std::atof(speed);
+        if (v > 0.0) options.speed = v;
+    }
+    options.loop = envFlag("UR_CAMERA_PLAYBACK_LOOP");
+    options.rebaseTimestamps = envFlag("UR_CAMERA_PLAYBACK_REBASE");
+    return options;
+}
+
+// ================= PlaybackSession =================
+
+std::shared_ptr<PlaybackSession> PlaybackSession::open(const std::string& basePath) {
+    // 多路相机各自创建数据源，同一个录像只映射一次
+    static std::mutex mutex;
+    static std::map<std::string, std::weak_ptr<PlaybackSession>> sessions;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (auto existing = sessions[basePath].lock()) return existing;
+
+    auto session = std::shared_ptr<PlaybackSession>(new PlaybackSession());
+    if (!session->m_reader.open(basePath) || session->m_reader.frameCount() == 0) {
+        qDebug() << "❌ 无法打开回放录像:" << QString::fromStdString(basePath);
+        return nullptr;
+    }
+
+    // 时间轴: 全部相机里最早 / 最晚的时间戳，以及帧最多的那一路的平均帧间隔
+    const RecordingReader &r = session->m_reader;
+    int64_t first = INT64_MAX, last = INT64_MIN, period = 0;
+    size_t most = 0;
+    for (int c = 0; c < r.cameraCount(); ++c) {
+        const auto &frames = r.frames(c);
+        if (frames.empty()) continue;
+        first = std::min(first, frames.front().timestampNs);
+        last = std::max(last, frames.back().timestampNs);
+        if (frames.size() > most && frames.size() > 1) {
+            most = frames.size();
+            period = (frames.back().timestampNs - frames.front().timestampNs) / (int64_t)(frames.size() - 1);
+        }
+    }
+    session->m_firstNs = first;
+    session->m_spanNs = std::max<int64_t>(1, last - first + period);
+    sessions[basePath] = session;
+    qDebug() << "▶️ 回放录像:" << QString::fromStdString(basePath) << "|" << r.cameraCount() << "路"
+             << r.frameCount() << "帧 | 时长" << session->m_spanNs / 1e9 << "s";
+    return session;
+}
+
+int64_t PlaybackSession::startNs() {
+    int64_t start = m_startNs.load();
+    if (start != 0) return start;
+    const int64_t now = steadyNowNs();
+    // 几路同时第一次取帧时只有一路能设置成功，其他路用它设置的起点
+    return m_startNs.compare_exchange_strong(start, now) ? now : start;
+}
+
+// ================= PlaybackCameraSource =================
+
+PlaybackCameraSource::PlaybackCameraSource(std::shared_ptr<PlaybackSession> session, int camera,
+                                           const PlaybackOptions& options)
+    : m_session(std::move(session))
+    , m_options(options)
+{
+    if (m_options.speed <= 0.0) m_options.speed = 1.0;
+    if (!m_session) return;
+    const auto &frames = m_session->recording().frames(camera);
+    if (frames.empty()) return;
+
+    m_frames = &frames;
+    m_size = frames.front().size;
+    m_lastSeq = frames.back().seq;
+    for (const auto &f : frames) m_maxBytes = std::max<size_t>(m_maxBytes, f.bytes);
+}
+
+bool PlaybackCameraSource::grab(int64_t& timestampNs, uint64_t& sequence) {
+    if (!m_frames) return false;
+    if (m_next >= m_frames->size()) {
+        if (!m_options.loop || m_frames->empty()) {
+            m_finished.store(true);
+            return false;
+        }
+        m_next = 0;
+        ++m_loop;
+    }
+    m_current = &(*m_frames)[m_next++];
+
+    // 这一帧在回放时间轴上的位置 (相对录像里最早的一帧)
+    const int64_t offsetNs = m_current->timestampNs - m_session->firstTimestampNs() +
+                             (int64_t)m_loop * m_session->loopSpanNs();
+    const int64_t dueNs = m_session->startNs() + (int64_t)(offsetNs / m_options.speed);
+    if (m_options.realtime) {
+        const int64_t waitNs = dueNs - steadyNowNs();
+        if (waitNs > 0) std::this_thread::sleep_for(std::chrono::nanoseconds(waitNs));
+    }
+
+    timestampNs = m_options.rebaseTimestamps ? dueNs : m_session->firstTimestampNs() + offsetNs;
+    sequence = m_current->seq + m_loop * m_lastSeq;
+    m_played.fetch_add(1);
+    return true;
+}
+
+bool PlaybackCameraSource::retrieve(cv::Mat& bgr) {
+    if (!m_current) return false;
+    const uchar *data = m_session->recording().data(*m_current);
+    if (!data) return false;
+    // 直接在映射内存上构造 Mat 头解码，不拷贝压缩数据
+    cv::Mat packet(1, (int)m_current->bytes, CV_8UC1, const_cast<uchar*>(data));
+    cv::imdecode(packet, cv::IMREAD_COLOR, &bgr);
+    m_current = nullptr;
+    return !bgr.empty();
+}
+
+bool PlaybackCameraSource::retrievePacket(cv::Mat& packet, size_t& bytes) {
+    if (!m_current) return false;
+    const uchar *data = m_session->recording().data(*m_current);
+    if (!data) return false;
+
+    // 和 V4L2 后端一样拷一次压缩数据: 采集槽位里的帧可能比这个数据源活得更久，不能直接指向映射内存
+    bytes = m_current->bytes;
+    if (packet.empty() || packet.total() < bytes) packet.create(1, (int)m_maxBytes, CV_8UC1);
+    std::memcpy(packet.data, data, bytes);
+    m_current = nullptr;
+    return true;
+}
+
+void PlaybackCameraSource::release() {
+    m_current = nullptr;
+    m_frames = nullptr;
+    m_session.reset();
+}
+
+std::unique_ptr<CameraSource> createPlaybackSource(int index, const std::string& basePath,
+                                                   const PlaybackOptions& options) {
+    auto source = std::make_unique<PlaybackCameraSource>(PlaybackSession::open(basePath), index, options);
+    if (source->isOpened()) {
+        qDebug() << "▶️ 相机" << index << "使用录像回放 |" << (options.realtime ? "实时" : "尽快") << "| 倍速"
+                 << options.speed << "| 循环" << options.loop;
+    } else {
+        qDebug() << "⚠️ 录像里没有相机" << index;
+    }
+    return source;
+}
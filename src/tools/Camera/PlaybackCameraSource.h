@@ -0,0 +1,100 @@
+#ifndef PLAYBACKCAMERASOURCE_H
+#define PLAYBACKCAMERASOURCE_H
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "platform/CameraHelper.h"
+#include "RecordingReader.h"
+
+// 回放参数
+struct PlaybackOptions {
+    bool realtime = true;           // true: 按录制时的帧间隔 (除以 speed) 出帧；false: 尽快出帧
+    double speed = 1.0;
+    bool loop = false;              // 放完从头再放，时间戳和帧序号继续往后递增
+    bool rebaseTimestamps = false;  // 时间戳平移到回放时钟上 (保持帧间隔)，端到端延迟才有意义；默认保留原始采集时间戳
+
+    /**
+     * @brief 从环境变量读取 (没设置的保持默认)
+     * UR_CAMERA_PLAYBACK_MODE=realtime|fast, UR_CAMERA_PLAYBACK_SPEED=<倍速>,
+     * UR_CAMERA_PLAYBACK_LOOP=1, UR_CAMERA_PLAYBACK_REBASE=1
+     */
+    static PlaybackOptions fromEnvironment();
+};
+
+/**
+ * @brief 几路回放共享的录像和时间轴
+ *
+ * 录像只映射一次；第一路开始取帧的时刻作为共同起点，
+ * 之后每一路都按 "起点 + (采集时间戳 - 录像里最早的时间戳) / speed" 出帧，各路之间保持录制时的相对时间。
+ */
+class PlaybackSession
+{
+public:
+    // 打开录像；同一个 basePath 仍在使用时返回同一个实例。打不开时返回 nullptr
+    static std::shared_ptr<PlaybackSession> open(const std::string& basePath);
+
+    const RecordingReader& recording() const { return m_reader; }
+    int64_t firstTimestampNs() const { return m_firstNs; }
+    // 一轮的时长: 最早到最晚的时间戳再加一个平均帧间隔 (循环时下一轮接在后面)
+    int64_t loopSpanNs() const { return m_spanNs; }
+    // 回放起点 (steady_clock ns)，第一次调用时确定
+    int64_t startNs();
+
+private:
+    RecordingReader m_reader;
+    int64_t m_firstNs = 0;
+    int64_t m_spanNs = 0;
+    std::atomic<int64_t> m_startNs{0};
+};
+
+/**
+ * @brief 录像回放相机: 把 FrameRecorder 录下的某一路当成一台相机
+ *
+ * 和原生 V4L2 后端一样提供 MJPEG 压缩包 (retrievePacket)，采集线程、预览、检测、录像都不用改；
+ * 压缩数据直接从内存映射的录像文件里取，回放本身几乎不占 CPU。
+ * grab 返回录制时的采集时间戳和帧序号 (rebaseTimestamps 时平移到回放时钟)，
+ * 录制时丢的帧在回放里同样表现为帧序号跳号。放完 (不循环) 后 grab 返回 false。
+ */
+class PlaybackCameraSource : public CameraSource
+{
+public:
+    PlaybackCameraSource(std::shared_ptr<PlaybackSession> session, int camera,
+                         const PlaybackOptions& options = PlaybackOptions());
+
+    bool isOpened() const override { return m_frames != nullptr; }
+    cv::Size frameSize() const override { return m_size; }
+    bool grab(int64_t& timestampNs, uint64_t& sequence) override;
+    bool retrieve(cv::Mat& bgr) override;
+    bool retrievePacket(cv::Mat& packet, size_t& bytes) override;
+    void release() override;
+
+    bool finished() const { return m_finished.load(); }
+    uint64_t framesPlayed() const { return m_played.load(); }
+
+private:
+    std::shared_ptr<PlaybackSession> m_session;
+    PlaybackOptions m_options;
+    const std::vector<RecordedFrame> *m_frames = nullptr;   // 这一路的帧 (录像里没有这一路时为空)
+    cv::Size m_size;
+    size_t m_maxBytes = 0;          // 最大的一帧，压缩包缓冲区按它分配
+    uint64_t m_lastSeq = 0;         // 这一路最后一帧的序号 (循环时帧序号的偏移)
+
+    size_t m_next = 0;
+    uint64_t m_loop = 0;
+    const RecordedFrame *m_current = nullptr;   // grab 到、还没 retrieve 的帧
+    std::atomic<bool> m_finished{false};
+    std::atomic<uint64_t> m_played{0};
+};
+
+/**
+ * @brief 回放 basePath 里的第 index 路 (多路共享同一个 PlaybackSession)
+ * 录像打不开或没有这一路时返回未打开的数据源 (不会退回到真实相机)
+ */
+std::unique_ptr<CameraSource> createPlaybackSource(int index, const std::string& basePath,
+                                                   const PlaybackOptions& options = PlaybackOptions());
+
+#endif // PLAYBACKCAMERASOURCE_H
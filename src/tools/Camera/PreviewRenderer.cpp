@@ -0,0 +1,56 @@
+#include "PreviewRenderer.h"
+#include "tools/Trace/LatencyTrace.h"
+#include <algorithm>
+
+const QImage& PreviewRenderer::render(const cv::Mat& bgr, const QSize& target)
+{
+    if (bgr.empty() || target.isEmpty()) return m_view;
+    ++m_frames;
+    UR_TRACE_SCOPE("preview.convert");
+
+    // 1. 缩放到控件尺寸 (只缩小)；目标缓冲区尺寸不变时 OpenCV 会直接复用内存
+    cv::Size dst(std::min(target.width(), bgr.cols), std::min(target.height(), bgr.rows));
+    const uchar *before = m_scaled.data;
+    if (dst == bgr.size()) {
+        bgr.copyTo(m_scaled);
+    } else {
+        cv::resize(bgr, m_scaled, dst, 0, 0, cv::INTER_AREA);
+    }
+    bool reallocated = (m_scaled.data != before);
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    // 2. Qt 5.14+ 直接支持 BGR888，无需颜色转换
+    const cv::Mat &shown = m_scaled;
+    const QImage::Format format = QImage::Format_BGR888;
+#else
+    // 2. 旧版 Qt 只能转成 RGB，但只转换缩小后的小图，且缓冲区复用
+    const uchar *rgbBefore = m_rgb.data;
+    cv::cvtColor(m_scaled, m_rgb, cv::COLOR_BGR2RGB);
+    reallocated = reallocated || (m_rgb.data != rgbBefore);
+    const cv::Mat &shown = m_rgb;
+    const QImage::Format format = QImage::Format_RGB888;
+#endif
+
+    // 3. 缓冲区换了地址或尺寸变了才需要重建视图 (QImage 不拥有这块内存)。
+    //    控件缩放后 resize 可能在原地址上放下新尺寸的图，只比地址的话视图会沿用旧的宽高和行距
+    if (reallocated) ++m_allocations;
+    if (m_view.isNull() || m_view.constBits() != shown.data || m_view.width() != shown.cols ||
+        m_view.height() != shown.rows || static_cast<size_t>(m_view.bytesPerLine()) != shown.step) {
+        m_view = QImage(shown.data, shown.cols, shown.rows, static_cast<int>(shown.step), format);
+    }
+    return m_view;
+}
+
+const QImage& PreviewRenderer::render(const CameraFrame& frame, const QSize& target)
+{
+    if (!frame.image.empty()) return render(frame.image, target);
+    if (target.isEmpty()) return m_view;
+
+    // 只有压缩包: 选不小于控件尺寸的最大缩小倍数，解码量降到 1/4 ~ 1/64
+    int scale = MjpegDecoder::pickScale(frame.size, cv::Size(target.width(), target.height()));
+    const uchar *before = m_decoded.data;
+    if (!m_decoder.decodeFrame(frame, scale, m_decoded)) return m_view;
+    if (before && m_decoded.data != before) ++m_allocations;
+
+    return render(m_decoded, target);
+}
@@ -0,0 +1,51 @@
+#ifndef PREVIEWRENDERER_H
+#define PREVIEWRENDERER_H
+
+#include <opencv2/opencv.hpp>
+#include <QImage>
+#include <QSize>
+#include <cstdint>
+#include "FrameMailbox.h"
+#include "MjpegDecoder.h"
+
+/**
+ * @brief 预览画面渲染器 (每个显示控件一个)
+ *
+ * 旧流程每帧要做 clone + cvtColor + QImage::copy 共约 4 次 1080p 全图拷贝，
+ * 这里改为:
+ *   1. 先缩放到控件的实际尺寸 (INTER_AREA)，之后的工作量只和控件大小有关；
+ *   2. 缩放结果写入预分配、循环复用的缓冲区，尺寸不变时不再分配内存；
+ *   3. 用 QImage::Format_BGR888 直接包装 BGR 数据，不做颜色转换、不做深拷贝。
+ * 如果帧里只有 MJPEG 压缩包，则按控件尺寸选 1/2、1/4、1/8 在 DCT 域缩小解码。
+ * 分配计数器用于确认稳态下每帧零分配 (QPixmap 的上传由 Qt 管理，不计入)。
+ */
+class PreviewRenderer
+{
+public:
+    PreviewRenderer() = default;
+
+    /**
+     * @brief 渲染一帧
+     * @param bgr 原始 BGR 图像 (只读，不会被拷贝保存)
+     * @param target 显示控件的尺寸 (只缩小，不放大)
+     * @return 包装内部缓冲区的 QImage，下一次 render() 之前有效
+     */
+    const QImage& render(const cv::Mat& bgr, const QSize& target);
+    // 渲染一帧采集结果 (只有压缩包时先按控件尺寸缩小解码)
+    const QImage& render(const CameraFrame& frame, const QSize& target);
+
+    uint64_t frames() const { return m_frames; }             // 已渲染帧数
+    uint64_t allocations() const { return m_allocations; }   // 缓冲区 (重新) 分配次数，首帧之后应保持不变
+
+private:
+    MjpegDecoder m_decoder;
+    cv::Mat m_decoded;  // 缩小解码缓冲区 (BGR)，尺寸不变时复用
+    cv::Mat m_scaled;   // 缩放缓冲区 (BGR)，尺寸不变时复用
+    cv::Mat m_rgb;      // 仅旧版 Qt (无 Format_BGR888) 使用的颜色转换缓冲区
+    QImage m_view;      // 指向 m_scaled / m_rgb 的零拷贝视图
+
+    uint64_t m_frames = 0;
+    uint64_t m_allocations = 0;
+};
+
+#endif // PREVIEWRENDERER_H
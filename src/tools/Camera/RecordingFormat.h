@@ -0,0 +1,85 @@
+#ifndef RECORDINGFORMAT_H
+#define RECORDINGFORMAT_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+/**
+ * @brief 连续录像的分段容器格式 (.urrec)，FrameRecorder 写、RecordingReader 读
+ *
+ * 一次录像按大小切成若干分段: <base>_000.urrec, <base>_001.urrec ...，每个分段可以单独读:
+ *
+ *   [文件头 RecFileHeader]
+ *   [帧头 RecFrameHeader][JPEG 数据] x N      (按写入顺序，不同相机交错)
+ *   [索引 RecIndexEntry x N][文件尾 RecFooter]  (分段关闭时写入)
+ *
+ * 程序崩溃时分段没有索引，读取端按帧头顺序扫描重建。
+ * 所有字段都是小端、定长，结构体按 8 字节对齐排好，不含编译器填充，直接整块读写。
+ */
+namespace RecFormat {
+
+constexpr char kFileMagic[8] = {'U', 'R', 'R', 'E', 'C', '0', '1', '\0'};
+constexpr char kIndexMagic[8] = {'U', 'R', 'R', 'E', 'C', 'I', 'D', 'X'};
+constexpr uint32_t kFrameMagic = 0x4D415246;     // "FRAM"
+constexpr uint32_t kVersion = 1;
+
+// 数据编码 (目前只有 JPEG: MJPEG 相机的压缩包原样写入，其余相机编码成 JPEG)
+enum Codec : uint16_t { CodecJpeg = 0 };
+
+struct RecFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t segment;           // 分段号，从 0 开始
+    int64_t wallStartMs;        // 录像开始时的系统时间 (ms since epoch)
+    int64_t steadyStartNs;      // 同一时刻的 steady_clock (ns)，帧时间戳减去它再加 wallStartMs 就是墙钟时间
+    uint32_t cameraCount;       // 录像的相机路数 (0 表示不确定)
+    uint32_t reserved;
+};
+
+struct RecFrameHeader {
+    uint32_t magic;             // kFrameMagic
+    uint16_t camera;
+    uint16_t codec;
+    uint64_t seq;               // 采集帧序号
+    int64_t timestampNs;        // 采集时间戳 (steady_clock)
+    uint64_t setId;             // 多相机对齐录制时同一组帧的编号 (从 1 开始)，单路为 0
+    uint16_t width;
+    uint16_t height;
+    uint32_t bytes;             // 后面的数据长度
+};
+
+struct RecIndexEntry {
+    uint64_t offset;            // 帧头在分段文件里的偏移
+    int64_t timestampNs;
+    uint64_t seq;
+    uint64_t setId;
+    uint32_t bytes;
+    uint16_t camera;
+    uint16_t codec;
+    uint16_t width;
+    uint16_t height;
+    uint32_t reserved;
+};
+
+struct RecFooter {
+    uint64_t indexOffset;       // 第一条索引的偏移
+    uint64_t entryCount;
+    char magic[8];              // kIndexMagic
+};
+
+static_assert(sizeof(RecFileHeader) == 40, "RecFileHeader 布局");
+static_assert(sizeof(RecFrameHeader) == 40, "RecFrameHeader 布局");
+static_assert(sizeof(RecIndexEntry) == 48, "RecIndexEntry 布局");
+static_assert(sizeof(RecFooter) == 24, "RecFooter 布局");
+
+// 第 segment 个分段的文件名
+inline std::string segmentPath(const std::string& basePath, int segment) {
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), "_%03d.urrec", segment);
+    return basePath + suffix;
+}
+
+}
+
+#endif // RECORDINGFORMAT_H
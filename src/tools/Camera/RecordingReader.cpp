@@ -0,0 +1,236 @@
+#include "RecordingReader.h"
+#include <QDebug>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// 一个分段文件的只读映射
+struct RecordingReader::MappedSegment {
+    const uchar *data = nullptr;
+    uint64_t size = 0;
+#if defined(_WIN32)
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+
+    bool map(const std::string& path) {
+#if defined(_WIN32)
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER bytes;
+        if (!GetFileSizeEx(file, &bytes) || bytes.QuadPart == 0) return false;
+        size = (uint64_t)bytes.QuadPart;
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) return false;
+        data = static_cast<const uchar*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        return data != nullptr;
+#else
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) return false;
+        size = (uint64_t)st.st_size;
+        void *p = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) return false;
+        data = static_cast<const uchar*>(p);
+        // 回放基本是顺序读，让内核加大预读
+        madvise(p, size, MADV_SEQUENTIAL);
+        return true;
+#endif
+    }
+
+    ~MappedSegment() {
+#if defined(_WIN32)
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (data) munmap(const_cast<uchar*>(data), size);
+        if (fd >= 0) ::close(fd);
+#endif
+    }
+};
+
+namespace {
+const std::vector<RecordedFrame> kNoFrames;
+}
+
+RecordingReader::RecordingReader() = default;
+
+RecordingReader::~RecordingReader() {
+    close();
+}
+
+void RecordingReader::close() {
+    m_segments.clear();
+    m_frames.clear();
+    m_recovered = 0;
+}
+
+bool RecordingReader::open(const std::string& basePath) {
+    close();
+    for (int segment = 0;; ++segment) {
+        const std::string path = RecFormat::segmentPath(basePath, segment);
+        auto seg = std::make_unique<MappedSegment>();
+        if (!seg->map(path)) break;
+
+        RecFormat::RecFileHeader header{};
+        if (seg->size < sizeof(header)) break;
+        std::memcpy(&header, seg->data, sizeof(header));
+        if (std::memcmp(header.magic, RecFormat::kFileMagic, sizeof(header.magic)) != 0 ||
+            header.version != RecFormat::kVersion) {
+            qDebug() << "❌ 不是录像分段或版本不支持:" << QString::fromStdString(path);
+            break;
+        }
+        if (segment == 0) {
+            m_wallStartMs = header.wallStartMs;
+            m_steadyStartNs = header.steadyStartNs;
+            m_frames.resize(header.cameraCount);
+        }
+        if (!loadIndex(*seg, segment)) {
+            ++m_recovered;
+            scanSegment(*seg, segment);
+        }
+        m_segments.push_back(std::move(seg));
+    }
+
+    for (auto &cam : m_frames) {
+        std::stable_sort(cam.begin(), cam.end(), [](const RecordedFrame& a, const RecordedFrame& b) {
+            return a.timestampNs < b.timestampNs;
+        });
+    }
+    if (m_recovered > 0) qDebug() << "⚠️ 录像有" << m_recovered << "个分段没有索引，已扫描重建";
+    return !m_segments.empty();
+}
+
+size_t RecordingReader::frameCount() const {
+    size_t n = 0;
+    for (const auto &cam : m_frames) n += cam.size();
+    return n;
+}
+
+const std::vector<RecordedFrame>& RecordingReader::frames(int camera) const {
+    if (camera < 0 || camera >= (int)m_frames.size()) return kNoFrames;
+    return m_frames[camera];
+}
+
+void RecordingReader::addFrame(const RecFormat::RecIndexEntry& entry, int segment) {
+    RecordedFrame frame;
+    frame.camera = entry.camera;
+    frame.seq = entry.seq;
+    frame.timestampNs = entry.timestampNs;
+    frame.setId = entry.setId;
+    frame.size = cv::Size(entry.width, entry.height);
+    frame.segment = segment;
+    frame.offset = entry.offset + sizeof(RecFormat::RecFrameHeader);
+    frame.bytes = entry.bytes;
+    if (frame.camera >= (int)m_frames.size()) m_frames.resize(frame.camera + 1);
+    m_frames[frame.camera].push_back(frame);
+}
+
+bool RecordingReader::loadIndex(const MappedSegment& seg, int segment) {
+    const uint64_t size = seg.size;
+    if (size < sizeof(RecFormat::RecFileHeader) + sizeof(RecFormat::RecFooter)) return false;
+
+    RecFormat::RecFooter footer{};
+    std::memcpy(&footer, seg.data + size - sizeof(footer), sizeof(footer));
+    if (std::memcmp(footer.magic, RecFormat::kIndexMagic, sizeof(footer.magic)) != 0 ||
+        footer.indexOffset + footer.entryCount * sizeof(RecFormat::RecIndexEntry) + sizeof(footer) != size) {
+        return false;
+    }
+
+    // 先整体校验，索引坏了就整段改用扫描 (不会加进一半)
+    std::vector<RecFormat::RecIndexEntry> entries(footer.entryCount);
+    if (!entries.empty()) std::memcpy(entries.data(), seg.data + footer.indexOffset, entries.size() * sizeof(entries[0]));
+    for (const auto &e : entries) {
+        if (e.offset + sizeof(RecFormat::RecFrameHeader) + e.bytes > footer.indexOffset) return false;
+    }
+    for (const auto &e : entries) addFrame(e, segment);
+    return true;
+}
+
+void RecordingReader::scanSegment(const MappedSegment& seg, int segment) {
+    const uint64_t size = seg.size;
+    uint64_t offset = sizeof(RecFormat::RecFileHeader);
+    while (offset + sizeof(RecFormat::RecFrameHeader) <= size) {
+        RecFormat::RecFrameHeader header;
+        std::memcpy(&header, seg.data + offset, sizeof(header));
+        if (header.magic != RecFormat::kFrameMagic) break;
+        const uint64_t end = offset + sizeof(header) + header.bytes;
+        if (end > size) break;      // 最后一帧没写完
+
+        RecFormat::RecIndexEntry entry{};
+        entry.offset = offset;
+        entry.timestampNs = header.timestampNs;
+        entry.seq = header.seq;
+        entry.setId = header.setId;
+        entry.bytes = header.bytes;
+        entry.camera = header.camera;
+        entry.codec = header.codec;
+        entry.width = header.width;
+        entry.height = header.height;
+        addFrame(entry, segment);
+        offset = end;
+    }
+}
+
+long RecordingReader::seek(int camera, int64_t timestampNs) const {
+    const auto &cam = frames(camera);
+    if (cam.empty()) return -1;
+    auto it = std::upper_bound(cam.begin(), cam.end(), timestampNs,
+                               [](int64_t t, const RecordedFrame& f) { return t < f.timestampNs; });
+    if (it == cam.begin()) return 0;
+    return (long)(it - cam.begin()) - 1;
+}
+
+bool RecordingReader::alignedSet(int64_t timestampNs, int64_t toleranceNs,
+                                 std::vector<const RecordedFrame*>& out) const {
+    out.assign(m_frames.size(), nullptr);
+    bool ok = !m_frames.empty();
+    for (size_t c = 0; c < m_frames.size(); ++c) {
+        const long k = seek((int)c, timestampNs);
+        if (k < 0) {
+            ok = false;
+            continue;
+        }
+        // seek 给的是不晚于 t 的那一帧，和后一帧比一下谁更近
+        const auto &cam = m_frames[c];
+        size_t best = (size_t)k;
+        if (best + 1 < cam.size() &&
+            std::llabs(cam[best + 1].timestampNs - timestampNs) < std::llabs(cam[best].timestampNs - timestampNs)) {
+            ++best;
+        }
+        out[c] = &cam[best];
+        ok = ok && std::llabs(cam[best].timestampNs - timestampNs) <= toleranceNs;
+    }
+    return ok;
+}
+
+const uchar* RecordingReader::data(const RecordedFrame& frame) const {
+    if (frame.segment < 0 || frame.segment >= (int)m_segments.size()) return nullptr;
+    const MappedSegment &seg = *m_segments[frame.segment];
+    if (frame.offset + frame.bytes > seg.size) return nullptr;
+    return seg.data + frame.offset;
+}
+
+bool RecordingReader::readData(const RecordedFrame& frame, std::vector<uchar>& out) const {
+    const uchar *p = data(frame);
+    if (!p) return false;
+    out.assign(p, p + frame.bytes);
+    return true;
+}
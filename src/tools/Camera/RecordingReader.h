@@ -0,0 +1,86 @@
+#ifndef RECORDINGREADER_H
+#define RECORDINGREADER_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "RecordingFormat.h"
+
+// 录像里的一帧 (只是位置信息，数据用 RecordingReader::data / readData 取)
+struct RecordedFrame {
+    int camera = 0;
+    uint64_t seq = 0;
+    int64_t timestampNs = 0;    // 采集时间戳 (steady_clock)
+    uint64_t setId = 0;         // 对齐录制的组编号，单路录制为 0
+    cv::Size size;
+    int segment = 0;
+    uint64_t offset = 0;        // 数据 (帧头之后) 在分段文件里的偏移
+    uint32_t bytes = 0;
+};
+
+/**
+ * @brief 读取 FrameRecorder 写的分段录像 (.urrec)
+ *
+ * open() 把全部分段内存映射进来并读入索引，每路相机的帧按时间戳排好序，之后按时间定位只是二分查找，
+ * 取数据 (data) 直接返回映射内存里的指针，不拷贝、不做系统调用。
+ * 分段没有索引 (录像时程序崩溃) 时顺序扫描帧头重建，最后一帧不完整就丢掉。
+ * open / close 之外的接口都是只读的，多个线程 (例如多路回放) 可以共享同一个实例。
+ */
+class RecordingReader
+{
+public:
+    RecordingReader();
+    ~RecordingReader();
+
+    RecordingReader(const RecordingReader&) = delete;
+    RecordingReader& operator=(const RecordingReader&) = delete;
+
+    // basePath 同 FrameRecorder::startRecording；一个分段都打不开时返回 false
+    bool open(const std::string& basePath);
+    void close();
+
+    int segmentCount() const { return (int)m_segments.size(); }
+    int recoveredSegments() const { return m_recovered; }  // 靠扫描重建索引的分段数
+    int cameraCount() const { return (int)m_frames.size(); }
+    int64_t wallStartMs() const { return m_wallStartMs; }
+    int64_t steadyStartNs() const { return m_steadyStartNs; }
+    size_t frameCount() const;
+
+    // 第 camera 路的全部帧 (按时间戳排序)
+    const std::vector<RecordedFrame>& frames(int camera) const;
+
+    /**
+     * @brief 第 camera 路里时间戳 <= timestampNs 的最后一帧
+     * @return 在 frames(camera) 里的下标；早于第一帧时返回 0，这一路没有帧时返回 -1
+     */
+    long seek(int camera, int64_t timestampNs) const;
+
+    /**
+     * @brief 对齐的多路画面: 每一路取时间戳离 timestampNs 最近的帧
+     * @param out out[i] 为第 i 路 (这一路没有帧时为 nullptr)
+     * @return 各路都有帧、且和 timestampNs 的偏差都不超过 toleranceNs 时返回 true
+     */
+    bool alignedSet(int64_t timestampNs, int64_t toleranceNs, std::vector<const RecordedFrame*>& out) const;
+
+    // 一帧的 JPEG 数据 (指向映射内存，长度为 frame.bytes，在 close 之前有效)；越界时返回 nullptr
+    const uchar* data(const RecordedFrame& frame) const;
+    // 拷贝一帧的 JPEG 数据 (尺寸够时复用 out 的内存)
+    bool readData(const RecordedFrame& frame, std::vector<uchar>& out) const;
+
+private:
+    struct MappedSegment;   // 平台相关的文件映射 (mmap / MapViewOfFile)
+
+    bool loadIndex(const MappedSegment& seg, int segment);
+    void scanSegment(const MappedSegment& seg, int segment);
+    void addFrame(const RecFormat::RecIndexEntry& entry, int segment);
+
+    std::vector<std::unique_ptr<MappedSegment>> m_segments;
+    std::vector<std::vector<RecordedFrame>> m_frames;   // [相机][帧]
+    int m_recovered = 0;
+    int64_t m_wallStartMs = 0;
+    int64_t m_steadyStartNs = 0;
+};
+
+#endif // RECORDINGREADER_H
@@ -0,0 +1,14 @@
+#ifndef STEADYCLOCK_H
+#define STEADYCLOCK_H
+
+#include <chrono>
+#include <cstdint>
+
+// 单调时钟 (steady_clock) 的纳秒读数。
+// 采集时间戳、指令入队 / 发出、状态包到达等各线程的时间都用它，彼此可以直接相减
+inline int64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif // STEADYCLOCK_H
@@ -0,0 +1,169 @@
+#include "DetectionPipeline.h"
+#include "tools/Camera/MjpegDecoder.h"
+#include "tools/Trace/LatencyTrace.h"
+#include "tools/Common/SteadyClock.h"
+#include <QDebug>
+
+namespace {
+// 检测输入边长 (与 YoloDetector 的 INPUT_W 一致)
+const int kDetectInputSize = 640;
+}
+
+DetectionPipeline::DetectionPipeline(YoloDetector& detector)
+    : m_detector(detector)
+{
+}
+
+DetectionPipeline::~DetectionPipeline() {
+    stop();
+}
+
+void DetectionPipeline::start() {
+    if (m_running.load()) return;
+    m_inputQueue.reopen();
+    m_blobQueue.reopen();
+    m_outputQueue.reopen();
+    m_running.store(true);
+
+    m_threads.emplace_back(&DetectionPipeline::preprocessLoop, this);
+    m_threads.emplace_back(&DetectionPipeline::inferenceLoop, this);
+    m_threads.emplace_back(&DetectionPipeline::postprocessLoop, this);
+}
+
+void DetectionPipeline::stop() {
+    if (!m_running.exchange(false)) return;
+
+    // 关闭队列会唤醒所有阻塞在 pop() 上的线程
+    m_inputQueue.close();
+    m_blobQueue.close();
+    m_outputQueue.close();
+    for (auto &t : m_threads) {
+        if (t.joinable()) t.join();
+    }
+    m_threads.clear();
+}
+
+void DetectionPipeline::submit(int cameraIndex, const CameraFrame& frame) {
+    if (!m_running.load()) return;
+
+    Job job;
+    job.cameraIndex = cameraIndex;
+    job.frame = frame;
+    m_submitted.fetch_add(1);
+    m_droppedStale.fetch_add(m_inputQueue.push(std::move(job)));
+}
+
+bool DetectionPipeline::latestResult(DetectionResult& out, uint64_t afterId) const {
+    std::lock_guard<std::mutex> lock(m_resultMutex);
+    if (m_latest.id <= afterId) return false;
+    out = m_latest;
+    return true;
+}
+
+PipelineStats DetectionPipeline::stats() const {
+    PipelineStats s;
+    s.submitted = m_submitted.load();
+    s.droppedStale = m_droppedStale.load();
+    s.completed = m_completed.load();
+    s.lastLatencyMs = m_lastLatencyMs.load();
+    std::lock_guard<std::mutex> lock(m_resultMutex);
+    s.avgLatencyMs = s.completed ? m_latencySumMs / s.completed : 0.0;
+    return s;
+}
+
+// ================= 阶段 1: 预处理 =================
+void DetectionPipeline::preprocessLoop() {
+    MjpegDecoder decoder;   // 每个线程自己的解码器
+    LatencyTrace::setThreadName("detect preprocess");
+    Job job;
+    while (m_inputQueue.pop(job)) {
+        UR_TRACE_SCOPE("detect.preprocess");
+        // 检测输入是 640，按长边 640 选缩小倍数 (1080p -> 1/2 解码)
+        const cv::Size full = job.frame.size.area() > 0 ? job.frame.size : job.frame.image.size();
+        cv::Size need(kDetectInputSize, kDetectInputSize);
+        if (full.width > 0 && full.height > 0) {
+            if (full.width >= full.height) need.height = kDetectInputSize * full.height / full.width;
+            else need.width = kDetectInputSize * full.width / full.height;
+        }
+        int scale = MjpegDecoder::pickScale(full, need);
+        if (!decoder.decodeFrame(job.frame, scale, job.image)) continue;
+        // 不缩小时 decodeFrame 直接共享采集帧内存，后面要在上面画框，必须拷贝一份
+        if (job.image.data == job.frame.image.data) job.image = job.image.clone();
+
+        // 源帧像素已经不需要了，尽早释放对采集缓冲区的引用
+        job.frame.image.release();
+        job.frame.packet.release();
+
+        m_detector.preprocess(job.image, job.blob);
+        m_droppedStale.fetch_add(m_blobQueue.push(std::move(job)));
+        job = Job();
+    }
+}
+
+// ================= 阶段 2: 推理 (唯一访问 cv::dnn::Net 的线程) =================
+void DetectionPipeline::inferenceLoop() {
+    LatencyTrace::setThreadName("detect inference");
+    Job job;
+    while (m_blobQueue.pop(job)) {
+        UR_TRACE_SCOPE("detect.inference");
+        if (!m_detector.forward(job.blob, job.output)) continue;
+        job.blob.release();
+        m_droppedStale.fetch_add(m_outputQueue.push(std::move(job)));
+        job = Job();
+    }
+}
+
+// ================= 阶段 3: 后处理 =================
+void DetectionPipeline::postprocessLoop() {
+    YoloDecoder decoder;    // 后处理线程自己的解码器 (缓冲区复用，不与 detect() 共享)
+    LatencyTrace::setThreadName("detect postprocess");
+    Job job;
+    while (m_outputQueue.pop(job)) {
+        UR_TRACE_SCOPE("detect.postprocess");
+        DetectionResult result;
+        result.id = m_completed.load() + 1;
+        result.cameraIndex = job.cameraIndex;
+        result.frameSeq = job.frame.seq;
+        result.captureNs = job.frame.timestampNs;
+
+        m_detector.decodeOutput(job.output, 0, job.image.size(), result.detections, &decoder);
+
+        // 坐标还原到原图尺寸 (检测输入可能是缩小解码的)
+        const cv::Size full = job.frame.size.area() > 0 ? job.frame.size : job.image.size();
+        const float sx = (float)full.width / job.image.cols;
+        const float sy = (float)full.height / job.image.rows;
+        float bestConf = -1.0f;
+        for (Detection &det : result.detections) {
+            if (det.confidence > bestConf) {
+                bestConf = det.confidence;
+                result.bestCenter = cv::Point2f((det.box.x + det.box.width / 2.0f) * sx,
+                                                (det.box.y + det.box.height / 2.0f) * sy);
+            }
+        }
+
+        // 画框 (在检测输入图上画，不再拷贝全尺寸原图)
+        m_detector.drawDetections(job.image, result.detections);
+        result.overlay = job.image;
+        if (sx != 1.0f || sy != 1.0f) {
+            for (Detection &det : result.detections) {
+                det.box = cv::Rect(int(det.box.x * sx), int(det.box.y * sy),
+                                   int(det.box.width * sx), int(det.box.height * sy));
+            }
+        }
+
+        result.doneNs = steadyNowNs();
+        if (result.captureNs > 0) UR_TRACE_SPAN("detect.latency", result.captureNs, result.doneNs);  // 采集 -> 检测结果
+        const double latencyMs = result.captureNs > 0 ? (result.doneNs - result.captureNs) / 1e6 : 0.0;
+        m_lastLatencyMs.store(latencyMs);
+
+        if (m_callback) m_callback(result);
+        {
+            std::lock_guard<std::mutex> lock(m_resultMutex);
+            m_latencySumMs += latencyMs;
+            m_latest = std::move(result);
+        }
+        m_completed.fetch_add(1);
+        job = Job();
+    }
+    qDebug() << "⏹️ 检测流水线退出";
+}
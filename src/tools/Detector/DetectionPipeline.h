@@ -0,0 +1,108 @@
+#ifndef DETECTIONPIPELINE_H
+#define DETECTIONPIPELINE_H
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "YoloDetector.h"
+#include "LatestQueue.h"
+#include "tools/Camera/FrameMailbox.h"
+
+// 一帧的检测结果
+struct DetectionResult {
+    uint64_t id = 0;                // 结果序号 (流水线内单调递增，从 1 开始)
+    int cameraIndex = -1;
+    uint64_t frameSeq = 0;          // 源帧序号
+    int64_t captureNs = 0;          // 源帧采集时间戳 (steady_clock 纳秒)
+    int64_t doneNs = 0;             // 后处理完成时间 (同一时钟)，doneNs - captureNs 即端到端延迟
+    std::vector<Detection> detections;
+    cv::Point2f bestCenter{-1, -1}; // 置信度最高的目标中心 (没有目标为 -1,-1)
+    cv::Mat overlay;                // 画好检测框的图 (检测输入分辨率)
+};
+
+// 流水线运行统计
+struct PipelineStats {
+    uint64_t submitted = 0;         // 提交的帧数
+    uint64_t droppedStale = 0;      // 因为下游处理不过来而丢掉的旧帧
+    uint64_t completed = 0;         // 输出结果数
+    double lastLatencyMs = 0.0;     // 最近一帧端到端延迟 (采集 -> 结果)
+    double avgLatencyMs = 0.0;      // 平均端到端延迟
+};
+
+/**
+ * @brief 异步分阶段检测流水线
+ *
+ *   submit() ──> [预处理线程: 解码 + blob] ──> [推理线程: forward] ──> [后处理线程: 解析 + NMS + 画框] ──> 结果
+ *
+ * 三个阶段各一个线程，阶段之间是容量很小的 LatestQueue，
+ * 所以第 N 帧在 forward 时第 N+1 帧已经在做预处理。
+ * 推理跟不上时，队列会自动丢掉旧帧，推理线程拿到的总是最新一帧。
+ * 每个结果都带源帧的采集时间戳，可以直接算端到端延迟。
+ */
+class DetectionPipeline
+{
+public:
+    using ResultCallback = std::function<void(const DetectionResult&)>;
+
+    // detector 需已 loadModel，且在流水线运行期间不能在别处调用它的 forward()
+    explicit DetectionPipeline(YoloDetector& detector);
+    ~DetectionPipeline();
+
+    DetectionPipeline(const DetectionPipeline&) = delete;
+    DetectionPipeline& operator=(const DetectionPipeline&) = delete;
+
+    void start();
+    void stop();
+
+    /**
+     * @brief 提交一帧 (不阻塞)
+     * 帧只有 MJPEG 压缩包时，在预处理线程里按检测输入尺寸 (640) 缩小解码。
+     */
+    void submit(int cameraIndex, const CameraFrame& frame);
+
+    // 取最新结果 (id > afterId 时返回 true)
+    bool latestResult(DetectionResult& out, uint64_t afterId = 0) const;
+
+    // 结果回调 (在后处理线程调用，注意线程安全)；需在 start() 之前设置
+    void setResultCallback(ResultCallback cb) { m_callback = std::move(cb); }
+
+    PipelineStats stats() const;
+
+private:
+    struct Job {
+        int cameraIndex = -1;
+        CameraFrame frame;      // 源帧 (引用计数共享)
+        cv::Mat image;          // 解码后的检测输入图
+        cv::Mat blob;
+        cv::Mat output;         // 网络输出
+    };
+
+    void preprocessLoop();
+    void inferenceLoop();
+    void postprocessLoop();
+
+    YoloDetector &m_detector;
+
+    LatestQueue<Job> m_inputQueue{1};   // submit -> 预处理 (只保留最新)
+    LatestQueue<Job> m_blobQueue{1};    // 预处理 -> 推理 (只保留最新)
+    LatestQueue<Job> m_outputQueue{2};  // 推理 -> 后处理
+
+    std::vector<std::thread> m_threads;
+    std::atomic<bool> m_running{false};
+    ResultCallback m_callback;
+
+    mutable std::mutex m_resultMutex;
+    DetectionResult m_latest;
+
+    std::atomic<uint64_t> m_submitted{0};
+    std::atomic<uint64_t> m_droppedStale{0};
+    std::atomic<uint64_t> m_completed{0};
+    std::atomic<double> m_lastLatencyMs{0.0};
+    double m_latencySumMs = 0.0;        // 只由后处理线程修改，读取时加 m_resultMutex
+};
+
+#endif // DETECTIONPIPELINE_H
@@ -0,0 +1,78 @@
+#ifndef LATESTQUEUE_H
+#define LATESTQUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+/**
+ * @brief 有界队列：满了就丢掉最旧的元素
+ *
+ * 用在实时流水线的阶段之间: 下游处理不过来时，上游永远不会被阻塞，
+ * 下游拿到的总是最新的数据 (容量为 1 时就是 "只保留最新一帧")。
+ */
+template <typename T>
+class LatestQueue
+{
+public:
+    explicit LatestQueue(size_t capacity = 1) : m_capacity(capacity ? capacity : 1) {}
+
+    /**
+     * @brief 放入一个元素 (不阻塞)
+     * @return 因为队列已满而被丢掉的旧元素个数
+     */
+    size_t push(T item) {
+        size_t dropped = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_closed) return 1;
+            while (m_items.size() >= m_capacity) {
+                m_items.pop_front();
+                ++dropped;
+            }
+            m_items.push_back(std::move(item));
+        }
+        m_cv.notify_one();
+        return dropped;
+    }
+
+    /**
+     * @brief 取出最旧的元素，队列为空时阻塞等待
+     * @return close() 之后返回 false
+     */
+    bool pop(T& out) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [this] { return m_closed || !m_items.empty(); });
+        if (m_closed) return false;
+        out = std::move(m_items.front());
+        m_items.pop_front();
+        return true;
+    }
+
+    // 关闭队列，唤醒所有等待者 (用于停止工作线程)
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+            m_items.clear();
+        }
+        m_cv.notify_all();
+    }
+
+    // 重新打开 (stop 之后再次 start)
+    void reopen() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = false;
+        m_items.clear();
+    }
+
+private:
+    const size_t m_capacity;
+    std::deque<T> m_items;
+    bool m_closed = false;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+};
+
+#endif // LATESTQUEUE_H
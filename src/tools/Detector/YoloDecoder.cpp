@@ -0,0 +1,156 @@
+#include "YoloDecoder.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+
+// ================= SIMD 兼容层 =================
+// OpenCV 4.8 起通用向量指令改为函数写法 (v_gt)，旧版本只有运算符写法
+#if CV_SIMD128
+namespace {
+inline cv::v_float32x4 simdGreater(const cv::v_float32x4& a, const cv::v_float32x4& b) {
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 8)
+    return cv::v_gt(a, b);
+#else
+    return a > b;
+#endif
+}
+}
+#endif
+
+// ================= 坐标变换 =================
+
+InputTransform InputTransform::stretch(const cv::Size& img, const cv::Size& input) {
+    InputTransform tf;
+    tf.scaleX = (float)input.width / img.width;
+    tf.scaleY = (float)input.height / img.height;
+    tf.invX = (float)img.width / input.width;
+    tf.invY = (float)img.height / input.height;
+    return tf;
+}
+
+InputTransform InputTransform::letterbox(const cv::Size& img, const cv::Size& input) {
+    InputTransform tf;
+    const float r = std::min((float)input.width / img.width, (float)input.height / img.height);
+    tf.scaleX = tf.scaleY = r;
+    tf.invX = tf.invY = 1.0f / r;
+    tf.padX = (input.width - img.width * r) * 0.5f;
+    tf.padY = (input.height - img.height * r) * 0.5f;
+    return tf;
+}
+
+// ================= 解码 =================
+
+void YoloDecoder::decode(const float* data, int dims, int anchors, bool anchorMajor,
+                         const InputTransform& tf, std::vector<Detection>& detections) {
+    detections.clear();
+    m_candidates.clear();
+    m_boxes.clear();
+    m_nmsBoxes.clear();
+    m_scores.clear();
+    m_classIds.clear();
+    if (!data || dims < 5 || anchors <= 0) return;
+
+    // 1. 找出通过阈值的 anchor
+    if (anchorMajor) scanAnchorMajor(data, dims, anchors);
+    else scanChannelMajor(data, dims, anchors);
+
+    // 2. 只对候选 anchor 读取框坐标，并还原到原图
+    // 不同类别的框加上不同偏移，一次 NMSBoxes 就等价于按类别分别 NMS
+    const float classOffset = 4096.0f;
+    for (int i : m_candidates) {
+        float cx, cy, w, h;
+        if (anchorMajor) {
+            const float *row = data + (size_t)i * dims;
+            cx = row[0]; cy = row[1]; w = row[2]; h = row[3];
+        } else {
+            cx = data[i];
+            cy = data[(size_t)anchors + i];
+            w = data[2 * (size_t)anchors + i];
+            h = data[3 * (size_t)anchors + i];
+        }
+
+        const double left = (cx - 0.5 * w - tf.padX) * tf.invX;
+        const double top = (cy - 0.5 * h - tf.padY) * tf.invY;
+        cv::Rect box(int(left), int(top), int(w * tf.invX), int(h * tf.invY));
+
+        const int cls = m_argMax[i];
+        m_boxes.push_back(box);
+        m_nmsBoxes.push_back(cv::Rect(box.x + int(cls * classOffset), box.y, box.width, box.height));
+        m_scores.push_back(m_maxScore[i]);
+        m_classIds.push_back(cls);
+    }
+
+    // 3. NMS (非极大值抑制)
+    m_keep.clear();
+    cv::dnn::NMSBoxes(m_nmsBoxes, m_scores, scoreThreshold, nmsThreshold, m_keep);
+
+    detections.reserve(m_keep.size());
+    for (int idx : m_keep) {
+        detections.push_back({m_classIds[idx], m_scores[idx], m_boxes[idx]});
+    }
+}
+
+// [dims, anchors] 布局: 每个类别的分数是连续的一行
+void YoloDecoder::scanChannelMajor(const float* data, int dims, int anchors) {
+    const int numClasses = dims - 4;
+    const float *scores = data + 4 * (size_t)anchors;
+
+    m_maxScore.resize(anchors);
+    m_argMax.resize(anchors);
+
+    // 1. 逐行求 arg-max (单类别模型就是直接拷贝第一行)
+    std::copy(scores, scores + anchors, m_maxScore.begin());
+    std::fill(m_argMax.begin(), m_argMax.end(), 0);
+    for (int c = 1; c < numClasses; ++c) {
+        const float *row = scores + (size_t)c * anchors;
+        int i = 0;
+#if CV_SIMD128
+        const cv::v_int32x4 vc = cv::v_setall_s32(c);
+        for (; i + 4 <= anchors; i += 4) {
+            cv::v_float32x4 s = cv::v_load(row + i);
+            cv::v_float32x4 m = cv::v_load(&m_maxScore[i]);
+            cv::v_float32x4 gt = simdGreater(s, m);
+            cv::v_store(&m_maxScore[i], cv::v_select(gt, s, m));
+            cv::v_int32x4 id = cv::v_load(&m_argMax[i]);
+            cv::v_store(&m_argMax[i], cv::v_select(cv::v_reinterpret_as_s32(gt), vc, id));
+        }
+#endif
+        for (; i < anchors; ++i) {
+            if (row[i] > m_maxScore[i]) {
+                m_maxScore[i] = row[i];
+                m_argMax[i] = c;
+            }
+        }
+    }
+
+    // 2. SIMD 阈值筛选: 一次比较 4 个 anchor，全不通过就整组跳过
+    const float *best = m_maxScore.data();
+    int i = 0;
+#if CV_SIMD128
+    const cv::v_float32x4 thr = cv::v_setall_f32(scoreThreshold);
+    for (; i + 4 <= anchors; i += 4) {
+        int mask = cv::v_signmask(simdGreater(cv::v_load(best + i), thr));
+        while (mask) {
+            int bit = 0;
+            while (!(mask & (1 << bit))) ++bit;
+            m_candidates.push_back(i + bit);
+            mask &= ~(1 << bit);
+        }
+    }
+#endif
+    for (; i < anchors; ++i) {
+        if (best[i] > scoreThreshold) m_candidates.push_back(i);
+    }
+}
+
+// [anchors, dims] 布局: 每行是一个 anchor，只能逐行标量处理
+void YoloDecoder::scanAnchorMajor(const float* data, int dims, int anchors) {
+    m_maxScore.resize(anchors);
+    m_argMax.resize(anchors);
+    for (int i = 0; i < anchors; ++i) {
+        const float *row = data + (size_t)i * dims + 4;
+        const float *top = std::max_element(row, row + dims - 4);
+        m_maxScore[i] = *top;
+        m_argMax[i] = int(top - row);
+        if (*top > scoreThreshold) m_candidates.push_back(i);
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef YOLODECODER_H
+#define YOLODECODER_H
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+struct Detection {
+    int class_id;
+    float confidence;
+    cv::Rect box;
+};
+
+/**
+ * @brief 网络输入坐标 -> 原图坐标的变换
+ * 直接拉伸 (stretch) 时 pad 为 0；letterbox 时 scaleX == scaleY，pad 为灰边宽度。
+ * 还原公式: x_原图 = (x_输入 - padX) * invX  (invX = 1 / scaleX，预先算好，避免逐框除法)
+ */
+struct InputTransform {
+    float scaleX = 1.0f;    // 原图 -> 网络输入
+    float scaleY = 1.0f;
+    float invX = 1.0f;      // 网络输入 -> 原图
+    float invY = 1.0f;
+    float padX = 0.0f;
+    float padY = 0.0f;
+
+    // 直接拉伸到 input 尺寸 (YoloDetector 默认预处理)
+    static InputTransform stretch(const cv::Size& img, const cv::Size& input);
+    // 等比缩放 + 居中填充到 input 尺寸
+    static InputTransform letterbox(const cv::Size& img, const cv::Size& input);
+};
+
+/**
+ * @brief YOLO 输出后处理引擎 (免转置 + SIMD 阈值筛选 + 缓冲区复用)
+ *
+ * YOLOv8/v12 的输出是 [4+classes, anchors] 的 "通道优先" 布局，
+ * 置信度在内存里本来就是连续的一行。所以这里不做 cv::transpose，而是:
+ *   1. 多类别时逐行取类别分数的最大值 (arg-max)，每一行都是连续内存，可以 SIMD；
+ *   2. 用 SIMD 对置信度行做阈值比较，一次判断 4 个 anchor；
+ *   3. 只对通过阈值的少数 anchor 去读 cx/cy/w/h 四行；
+ *   4. 按类别做 NMS。
+ * 所有中间缓冲区都是成员变量，跨调用复用，稳态下不再分配内存。
+ * 一个实例只能在一个线程里用。
+ */
+class YoloDecoder
+{
+public:
+    float scoreThreshold = 0.5f;    // 置信度阈值
+    float nmsThreshold = 0.4f;      // 非极大值抑制阈值
+
+    /**
+     * @brief 解析一张图的输出
+     * @param data 输出数据 (某个 batch 切片的起始地址)
+     * @param dims 每个 anchor 的维度 (4 + classes)
+     * @param anchors anchor 数量 (640 输入为 8400)
+     * @param anchorMajor true 表示 [anchors, dims] 布局 (少数导出方式)，false 为常见的 [dims, anchors]
+     * @param tf 网络输入 -> 原图坐标变换
+     * @param detections 输出 (NMS 之后)
+     */
+    void decode(const float* data, int dims, int anchors, bool anchorMajor,
+                const InputTransform& tf, std::vector<Detection>& detections);
+
+private:
+    void scanChannelMajor(const float* data, int dims, int anchors);
+    void scanAnchorMajor(const float* data, int dims, int anchors);
+
+    // ---- 复用的缓冲区 ----
+    std::vector<float> m_maxScore;      // 每个 anchor 的最大类别分数
+    std::vector<int> m_argMax;          // 每个 anchor 的最大分数类别
+    std::vector<int> m_candidates;      // 通过阈值的 anchor 下标
+    std::vector<cv::Rect> m_boxes;
+    std::vector<cv::Rect> m_nmsBoxes;   // 按类别偏移后的框 (实现按类别 NMS)
+    std::vector<float> m_scores;
+    std::vector<int> m_classIds;
+    std::vector<int> m_keep;
+};
+
+#endif // YOLODECODER_H
@@ -1,5 +1,6 @@
 #include "YoloDetector.h"
 #include <QDebug> // 使用 Qt 的日志输出，跨平台方便
+#include <cstring>
 
 YoloDetector::YoloDetector() {
     // 根据模型类别修改
@@ -38,118 +39,178 @@ cv::Point2f YoloDetector::detect(const cv::Mat& img, cv::Mat& debugImg) {
         return cv::Point2f(-1, -1);
     }
 
-    // 2. 图像预处理 (Blob)
-    // YOLO 要求归一化 0~1 (scale=1/255)，SwapRB=true (BGR->RGB)，不裁剪
-    cv::Mat blob;
-    // 从图像创建 blob，保持比例，填充到 INPUT_W x INPUT_H
-    cv::dnn::blobFromImage(img, blob, 1.0/255.0, cv::Size(INPUT_W, INPUT_H), cv::Scalar(), true, false);
+    // 2. 图像预处理 (Blob)，blob 缓冲区跨调用复用
+    preprocess(img, m_blob);
 
     // 3. 推理 (Inference)
-    m_net.setInput(blob);
-    
-    // 获取输出层
-    std::vector<cv::Mat> outputs;
-    m_net.forward(outputs, m_net.getUnconnectedOutLayersNames());
+    cv::Mat output0;
+    if (!forward(m_blob, output0)) return cv::Point2f(-1, -1);
 
-    // ==========================================================
-    // 🧩 核心难点：YOLOv12 输出解析 (OpenCV 4.6 兼容写法)
-    // ==========================================================
-    // YOLOv8 输出维度通常是 [1, 4+Classes, 8400]
-    // C++ OpenCV 处理行优先数据方便，所以我们需要把矩阵转置 (Transpose)
-    // 变成 [1, 8400, 4+Classes]
-    
-    // 假设 outputs[0] 是主要输出
-    cv::Mat output0 = outputs[0];
-    
-    // 检查维度，如果不匹配可能需要调整 (这里适配标准的 YOLOv12 导出)
-    int dimensions = output0.size[1]; // 4 + classes
-    int rows = output0.size[2];       // 8400 anchors
-    
-    // 如果维度是 [1, dimensions, rows]，我们需要转置
-    if (dimensions > rows) {
-        // 检查是否是 [1, dimensions, rows]
-        if (output0.size[0] == 1 && output0.size[2] == rows) {
-            // 说明是 [1, dimensions, rows]，需要转置
-            rows = output0.size[1];
-            dimensions = output0.size[2];
-        } else {
-            // 其他情况，保持不变
-            rows = output0.size[2];
-            dimensions = output0.size[1];
+    // 4. 解析数据 + NMS
+    std::vector<Detection> &detections = m_detections;
+    decodeOutput(output0, 0, img.size(), detections);
+
+    // 5. 选取最佳结果
+    cv::Point2f bestCenter(-1, -1);
+    float bestConf = -1.0;
+
+    // 绘制结果
+    drawDetections(debugImg, detections);
+
+    for (const Detection& det : detections) {
+        const cv::Rect& box = det.box;
+
+        // 策略：返回置信度最高的那个
+        if (det.confidence > bestConf) {
+            bestConf = det.confidence;
+            bestCenter = cv::Point2f(box.x + box.width / 2.0f,
+                                     box.y + box.height / 2.0f);
         }
-    } else {
-        // 常见情况：需要转置
-        // 重新构造一个 2D 矩阵 [dimensions, rows]
-        output0 = cv::Mat(dimensions, rows, CV_32F, output0.ptr<float>());
-        // 转置为 [rows, dimensions] -> [8400, 5]
-        cv::transpose(output0, output0);
     }
+    return bestCenter;
+}
 
-    // 4. 解析数据
-    float* data = (float*)output0.data;
-    float x_factor = (float)img.cols / INPUT_W;
-    float y_factor = (float)img.rows / INPUT_H;
-    
-    std::vector<int> class_ids;
-    std::vector<float> confidences;
-    std::vector<cv::Rect> boxes;
-
-    for (int i = 0; i < rows; ++i) {
-        // 每一行数据：[cx, cy, w, h, score]
-        // 前4个是坐标，代表框的中心和宽高；
-        // 后面的 score 是类别的置信度（只有一个类）
-        float conf = data[4]; // 跳过前4个坐标，直接取置信度
-
-        if (conf > CONFIDENCE_THRESHOLD) {
-            float cx = data[0];
-            float cy = data[1];
-            float w = data[2];
-            float h = data[3];
-
-            // 还原回原图尺寸
-            int left = int((cx - 0.5 * w) * x_factor);
-            int top = int((cy - 0.5 * h) * y_factor);
-            int width = int(w * x_factor);
-            int height = int(h * y_factor);
-
-            boxes.push_back(cv::Rect(left, top, width, height));
-            confidences.push_back(conf);
-            class_ids.push_back(0); // 只有一个类，固定为0
+std::vector<std::vector<Detection>> YoloDetector::detectBatch(const std::vector<cv::Mat>& imgs) {
+    std::vector<std::vector<Detection>> results(imgs.size());
+    if (m_net.empty()) {
+        qDebug() << "⚠️ 警告: 模型未加载，无法检测";
+        return results;
+    }
+
+    // 1. 收集非空图像 (blobFromImages 不接受空图)
+    std::vector<cv::Mat> valid;
+    std::vector<size_t> validIdx;
+    for (size_t i = 0; i < imgs.size(); ++i) {
+        if (!imgs[i].empty()) {
+            valid.push_back(imgs[i]);
+            validIdx.push_back(i);
         }
-        
-        // 指针移动到下一行 (dimensions 是步长)
-        data += dimensions;
+    }
+    if (valid.empty()) return results;
+
+    // 2. 一次前向处理整个 batch
+    if (m_batchSupported && valid.size() > 1) {
+        // 逐张走 preprocess() (与 decodeOutput 的拉伸 / letterbox 还原一致)，再拼成 [N, 3, H, W]
+        const int shape[4] = {(int)valid.size(), 3, INPUT_H, INPUT_W};
+        m_batchBlob.create(4, shape, CV_32F);
+        const size_t plane = (size_t)3 * INPUT_H * INPUT_W;
+        for (size_t b = 0; b < valid.size(); ++b) {
+            preprocess(valid[b], m_blob);
+            std::memcpy(m_batchBlob.ptr<float>() + b * plane, m_blob.ptr<float>(), plane * sizeof(float));
+        }
+
+        cv::Mat output0;
+        if (forward(m_batchBlob, output0)) {
+            if (output0.size[0] == (int)valid.size()) {
+                for (size_t b = 0; b < valid.size(); ++b) {
+                    decodeOutput(output0, (int)b, valid[b].size(), results[validIdx[b]]);
+                }
+                return results;
+            }
+            if (output0.size[0] == 1) {
+                // 固定 batch=1 导出的模型: 输入 N 张只出 1 张的结果，之后都走逐张推理
+                m_batchSupported = false;
+                qDebug() << "⚠️ 模型不支持动态 batch，退化为逐张推理 (请用 dynamic=True 重新导出)";
+            } else {
+                qDebug() << "⚠️ 批量输出 batch 维" << output0.size[0] << "与输入" << (int)valid.size()
+                         << "不一致，本次逐张推理";
+            }
+        }
+        // 其他失败 (偶发的推理异常等) 只影响这一次，下次仍然尝试批量
     }
 
-    // 5. NMS (非极大值抑制) - 去除重叠框
-    std::vector<int> nms_result;
-    cv::dnn::NMSBoxes(boxes, confidences, SCORE_THRESHOLD, NMS_THRESHOLD, nms_result);
+    // 3. 退化路径: 逐张推理
+    for (size_t b = 0; b < valid.size(); ++b) {
+        cv::Mat blob;
+        preprocess(valid[b], blob);
+        cv::Mat output0;
+        if (forward(blob, output0)) {
+            decodeOutput(output0, 0, valid[b].size(), results[validIdx[b]]);
+        }
+    }
+    return results;
+}
 
-    // 6. 选取最佳结果
-    cv::Point2f bestCenter(-1, -1);
-    float bestConf = -1.0;
+void YoloDetector::preprocess(const cv::Mat& img, cv::Mat& blob) const {
+    // YOLO 要求归一化 0~1 (scale=1/255)，SwapRB=true (BGR->RGB)，不裁剪
+    if (!m_letterbox) {
+        // 从图像创建 blob，直接拉伸到 INPUT_W x INPUT_H
+        cv::dnn::blobFromImage(img, blob, 1.0/255.0, cv::Size(INPUT_W, INPUT_H), cv::Scalar(), true, false);
+        return;
+    }
 
-    for (int idx : nms_result) {
-        cv::Rect box = boxes[idx];
-        float conf = confidences[idx];
-        int classId = class_ids[idx];
+    // letterbox: 等比缩放后居中，四周填灰 (114)；缓冲区按线程复用
+    thread_local cv::Mat resized, padded;
+    const InputTransform tf = InputTransform::letterbox(img.size(), cv::Size(INPUT_W, INPUT_H));
+    const int w = int(img.cols * tf.scaleX + 0.5f);
+    const int h = int(img.rows * tf.scaleY + 0.5f);
+    cv::resize(img, resized, cv::Size(w, h), 0, 0, cv::INTER_LINEAR);
+    const int left = int(tf.padX);
+    const int top = int(tf.padY);
+    cv::copyMakeBorder(resized, padded, top, INPUT_H - h - top, left, INPUT_W - w - left,
+                       cv::BORDER_CONSTANT, cv::Scalar(114, 114, 114));
+    cv::dnn::blobFromImage(padded, blob, 1.0/255.0, cv::Size(), cv::Scalar(), true, false);
+}
 
-        // 绘制结果
-        cv::rectangle(debugImg, box, cv::Scalar(0, 255, 0), 2);
-        
-        std::string label = m_classNames.size() > classId ? 
-                            m_classNames[classId] : std::to_string(classId);
-        label += " " + std::to_string(conf).substr(0, 4);
-        
-        cv::putText(debugImg, label, cv::Point(box.x, box.y - 5), 
-                    cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 255, 0), 1);
+bool YoloDetector::forward(const cv::Mat& blob, cv::Mat& output) {
+    try {
+        m_net.setInput(blob);
 
-        // 策略：返回置信度最高的那个
-        if (conf > bestConf) {
-            bestConf = conf;
-            bestCenter = cv::Point2f(box.x + box.width / 2.0f, 
-                                     box.y + box.height / 2.0f);
+        // 获取输出层 (输出容器复用)
+        // 上一次的输出如果还被别处引用 (例如流水线的后处理线程)，先放掉，避免被原地覆盖
+        for (cv::Mat &m : m_outputs) {
+            if (m.u && m.u->refcount > 1) m.release();
         }
+        m_net.forward(m_outputs, m_net.getUnconnectedOutLayersNames());
+        if (m_outputs.empty() || m_outputs[0].dims != 3) return false;
+
+        // 假设 outputs[0] 是主要输出
+        output = m_outputs[0];
+        return true;
+    } catch (const cv::Exception& e) {
+        qDebug() << "❌ 推理异常:" << e.what();
+        return false;
     }
-    return bestCenter;
-}
\ No newline at end of file
+}
+
+void YoloDetector::decodeOutput(const cv::Mat& output, int batchIndex, const cv::Size& imgSize,
+                                std::vector<Detection>& detections, YoloDecoder* decoder) const {
+    // ==========================================================
+    // 🧩 YOLOv8/v12 输出解析
+    // ==========================================================
+    // 输出维度通常是 [N, 4+Classes, 8400]，即 "通道优先"，置信度本来就是连续的一行，
+    // YoloDecoder 直接按原布局扫描，不再做整张表的转置
+    int dimensions = output.size[1]; // 4 + classes
+    int rows = output.size[2];       // 8400 anchors
+    bool anchorMajor = false;
+    if (dimensions > rows) {
+        // 少数导出方式是 [N, 8400, 4+Classes]
+        std::swap(dimensions, rows);
+        anchorMajor = true;
+    }
+
+    // 取出第 batchIndex 张图对应的切片 (不拷贝)
+    const float *slice = output.ptr<float>() + (size_t)batchIndex * dimensions * rows;
+
+    const cv::Size input(INPUT_W, INPUT_H);
+    const InputTransform tf = m_letterbox ? InputTransform::letterbox(imgSize, input)
+                                          : InputTransform::stretch(imgSize, input);
+
+    YoloDecoder &dec = decoder ? *decoder : m_decoder;
+    dec.scoreThreshold = SCORE_THRESHOLD;
+    dec.nmsThreshold = NMS_THRESHOLD;
+    dec.decode(slice, dimensions, rows, anchorMajor, tf, detections);
+}
+
+void YoloDetector::drawDetections(cv::Mat& img, const std::vector<Detection>& detections) const {
+    for (const Detection& det : detections) {
+        cv::rectangle(img, det.box, cv::Scalar(0, 255, 0), 2);
+
+        std::string label = (int)m_classNames.size() > det.class_id ?
+                            m_classNames[det.class_id] : std::to_string(det.class_id);
+        label += " " + std::to_string(det.confidence).substr(0, 4);
+
+        cv::putText(img, label, cv::Point(det.box.x, det.box.y - 5),
+                    cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 255, 0), 1);
+    }
+}
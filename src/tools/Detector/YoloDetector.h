@@ -4,12 +4,7 @@
 #include <opencv2/opencv.hpp>
 #include <opencv2/dnn.hpp>
 #include <vector>
-
-struct Detection {
-    int class_id;
-    float confidence;
-    cv::Rect box;
-};
+#include "YoloDecoder.h"
 
 class YoloDetector {
 public:
@@ -26,9 +21,54 @@ public:
      */
     cv::Point2f detect(const cv::Mat& img, cv::Mat& debugImg);
 
+    /**
+     * @brief 批量推理 (多路相机一次前向)
+     * 每张图按 preprocess() 预处理后拼成 N 张图的 blob，只调用一次 forward，再逐个 batch 切片解析。
+     * 需要导出时带动态 batch 维度的模型 (例如 yolo export dynamic=True)；
+     * 模型不支持时自动退化为逐张推理；某次批量推理失败只对这一次逐张推理，下次仍尝试批量。
+     * @param imgs 输入图像 (可以尺寸不同，空图返回空结果)
+     * @return 每张图的检测结果 (已做 NMS，坐标为原图坐标)
+     */
+    std::vector<std::vector<Detection>> detectBatch(const std::vector<cv::Mat>& imgs);
+
+    // 模型是否支持一次推理多张图 (批量输入只得到 batch=1 的输出时变为 false；偶发的推理失败不影响)
+    bool batchSupported() const { return m_batchSupported; }
+
+    // 预处理方式: false = 直接拉伸到 640x640 (默认)，true = 等比缩放 + 灰边填充 (letterbox)
+    // 需与模型训练 / 导出时的预处理一致
+    void setLetterbox(bool enable) { m_letterbox = enable; }
+
+    // ---- 分阶段接口 (供 DetectionPipeline 在不同线程上流水执行) ----
+    // 注意: forward() 使用 cv::dnn::Net，只能在同一个线程里调用；其余阶段不访问网络，可并行
+
+    // 1. 预处理: 图像 -> blob
+    void preprocess(const cv::Mat& img, cv::Mat& blob) const;
+    // 2. 单次前向: 输入 blob，返回主输出 [N, 4+classes, anchors]
+    bool forward(const cv::Mat& blob, cv::Mat& output);
+    /**
+     * @brief 3. 解析第 batchIndex 张图的输出并做 NMS
+     * @param output 主输出张量 [N, 4+classes, anchors]
+     * @param imgSize 原图尺寸 (用于把坐标还原到原图)
+     * @param decoder 使用的解码器 (含复用缓冲区)；为空时用内部的，此时不能与 detect() 并发调用
+     */
+    void decodeOutput(const cv::Mat& output, int batchIndex, const cv::Size& imgSize,
+                      std::vector<Detection>& detections, YoloDecoder* decoder = nullptr) const;
+    // 4. 把检测框画到图上
+    void drawDetections(cv::Mat& img, const std::vector<Detection>& detections) const;
+
 private:
+
     cv::dnn::Net m_net;
     std::vector<std::string> m_classNames;
+    bool m_batchSupported = true;
+    bool m_letterbox = false;
+
+    // 复用的缓冲区 (detect / forward 所在线程使用)
+    cv::Mat m_blob;
+    cv::Mat m_batchBlob;
+    std::vector<cv::Mat> m_outputs;
+    std::vector<Detection> m_detections;
+    mutable YoloDecoder m_decoder;
 
     // YOLO 参数 (根据模型训练时的尺寸修改，通常是 640)
     const int INPUT_W = 640;
@@ -0,0 +1,246 @@
+#include "ArmCollisionChecker.h"
+#include "SimdCompat.h"
+#include <algorithm>
+#include <cmath>
+
+#if CV_SIMD
+using namespace Simd;
+
+namespace {
+// 局部坐标 p 变换到世界坐标的一个分量: R[row] . p + t[row] (p 的 0 分量跳过)
+inline cv::v_float32 transformRow(const cv::v_float32* R, const cv::v_float32& t, int row, const cv::Point3f& p) {
+    cv::v_float32 v = t;
+    if (p.x != 0.0f) v = vAdd(v, vMul(R[row * 3], cv::vx_setall_f32(p.x)));
+    if (p.y != 0.0f) v = vAdd(v, vMul(R[row * 3 + 1], cv::vx_setall_f32(p.y)));
+    if (p.z != 0.0f) v = vAdd(v, vMul(R[row * 3 + 2], cv::vx_setall_f32(p.z)));
+    return v;
+}
+}
+#endif
+
+namespace {
+// 点 c 到线段 a-b 的距离平方，invLen2 = 1 / |b - a|^2 (退化线段传 0)
+inline float pointSegmentDist2(const cv::Point3f& a, const cv::Point3f& ab, float invLen2, const cv::Point3f& c) {
+    const cv::Point3f ap = c - a;
+    const float t = std::min(std::max(ap.dot(ab) * invLen2, 0.0f), 1.0f);
+    const cv::Point3f d = ap - ab * t;
+    return d.dot(d);
+}
+}
+
+ArmCollisionChecker::ArmCollisionChecker() {
+    setCapsules(defaultCapsules());
+}
+
+std::vector<LinkCapsule> ArmCollisionChecker::defaultCapsules() {
+    // 各坐标系原点都在关节轴线上；大臂、小臂相对 DH 连线沿关节轴方向有偏置 (肩部 0.176 m，小臂 0.039 m)
+    const float d1 = (float)UR12e::kD[0], d4 = (float)UR12e::kD[3];
+    const float d5 = (float)UR12e::kD[4], d6 = (float)UR12e::kD[5];
+    const float a2 = (float)-UR12e::kA[1], a3 = (float)-UR12e::kA[2];
+    const float shoulder = 0.176f, forearm = 0.039f;
+    return {
+        {0, cv::Point3f(0, 0, 0),          cv::Point3f(0, 0, d1),        0.090f},   // 底座
+        {1, cv::Point3f(0, 0, 0),          cv::Point3f(0, 0, shoulder),  0.090f},   // 肩关节
+        {2, cv::Point3f(a2, 0, shoulder),  cv::Point3f(0, 0, shoulder),  0.075f},   // 大臂
+        {2, cv::Point3f(0, 0, shoulder),   cv::Point3f(0, 0, forearm),   0.070f},   // 肘关节
+        {3, cv::Point3f(a3, 0, forearm),   cv::Point3f(0, 0, forearm),   0.060f},   // 小臂
+        {3, cv::Point3f(0, 0, forearm),    cv::Point3f(0, 0, d4),        0.060f},   // 腕 1
+        {4, cv::Point3f(0, 0, 0),          cv::Point3f(0, 0, d5),        0.060f},   // 腕 2
+        {5, cv::Point3f(0, 0, 0),          cv::Point3f(0, 0, d6),        0.050f},   // 腕 3 + 法兰
+    };
+}
+
+void ArmCollisionChecker::setCapsules(const std::vector<LinkCapsule>& capsules) {
+    m_capsules = capsules;
+    m_capsuleInvLen2.resize(capsules.size());
+    for (size_t i = 0; i < capsules.size(); ++i) {
+        const cv::Point3f ab = capsules[i].b - capsules[i].a;
+        const float len2 = ab.dot(ab);
+        m_capsuleInvLen2[i] = len2 > 1e-12f ? 1.0f / len2 : 0.0f;
+    }
+}
+
+void ArmCollisionChecker::setObstacles(const std::vector<SphereObstacle>& obstacles) {
+    m_obstacles = obstacles;
+    const size_t n = obstacles.size();
+    m_ox.resize(n); m_oy.resize(n); m_oz.resize(n); m_or.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        m_ox[i] = obstacles[i].center.x;
+        m_oy[i] = obstacles[i].center.y;
+        m_oz[i] = obstacles[i].center.z;
+        m_or[i] = obstacles[i].radius;
+    }
+}
+
+// ================= 标量参考 =================
+
+bool ArmCollisionChecker::collides(const JointVector& q) const {
+    ++m_checked;
+    cv::Matx44d frames[UR12e::kDof];
+    UR12e::forward(q, frames);
+    auto toWorld = [&](int frame, const cv::Point3f& p) {
+        if (frame == 0) return p;
+        const cv::Matx44d &T = frames[frame - 1];
+        return cv::Point3f((float)(T(0, 0) * p.x + T(0, 1) * p.y + T(0, 2) * p.z + T(0, 3)),
+                           (float)(T(1, 0) * p.x + T(1, 1) * p.y + T(1, 2) * p.z + T(1, 3)),
+                           (float)(T(2, 0) * p.x + T(2, 1) * p.y + T(2, 2) * p.z + T(2, 3)));
+    };
+
+    for (size_t ci = 0; ci < m_capsules.size(); ++ci) {
+        const LinkCapsule &cap = m_capsules[ci];
+        const cv::Point3f a = toWorld(cap.frame, cap.a);
+        const cv::Point3f ab = toWorld(cap.frame, cap.b) - a;
+        if (m_floorEnabled && cap.frame > 0 &&
+            std::min(a.z, a.z + ab.z) < m_floorZ + cap.radius + m_margin) return true;
+        for (const auto &obs : m_obstacles) {
+            const float rr = cap.radius + obs.radius + m_margin;
+            if (pointSegmentDist2(a, ab, m_capsuleInvLen2[ci], obs.center) <= rr * rr) return true;
+        }
+    }
+    return false;
+}
+
+// ================= 批量 =================
+
+size_t ArmCollisionChecker::checkBatch(const UR12e::JointBatch& q, std::vector<uint8_t>& hit) const {
+    const size_t n = q.size();
+    hit.assign(n, 0);
+    size_t hits = 0;
+    for (size_t begin = 0; begin < n; begin += kBlock) {
+        const float* qs[UR12e::kDof];
+        for (int j = 0; j < UR12e::kDof; ++j) qs[j] = q.q[j].data() + begin;
+        hits += checkBlock(qs, std::min(kBlock, n - begin), hit.data() + begin, false);
+    }
+    return hits;
+}
+
+bool ArmCollisionChecker::anyCollides(const UR12e::JointBatch& q) const {
+    const size_t n = q.size();
+    for (size_t begin = 0; begin < n; begin += kBlock) {
+        const float* qs[UR12e::kDof];
+        for (int j = 0; j < UR12e::kDof; ++j) qs[j] = q.q[j].data() + begin;
+        if (checkBlock(qs, std::min(kBlock, n - begin), nullptr, true) > 0) return true;
+    }
+    return false;
+}
+
+bool ArmCollisionChecker::motionCollides(const JointVector& from, const JointVector& to, double resolution) const {
+    double maxDiff = 0.0;
+    for (int j = 0; j < UR12e::kDof; ++j) maxDiff = std::max(maxDiff, std::abs(to[j] - from[j]));
+    const int steps = std::max(1, (int)std::ceil(maxDiff / resolution));
+
+    m_motion.resize(steps);
+    for (int k = 1; k <= steps; ++k) {
+        const double s = (double)k / steps;
+        for (int j = 0; j < UR12e::kDof; ++j) m_motion.q[j][k - 1] = (float)(from[j] + (to[j] - from[j]) * s);
+    }
+    return anyCollides(m_motion);
+}
+
+size_t ArmCollisionChecker::checkBlock(const float* const q[UR12e::kDof], size_t n, uint8_t* hit,
+                                       bool stopAtFirst) const {
+    m_frames.resize(size_t(UR12e::kDof) * UR12e::kFrameComponents * kBlock);
+    UR12e::forwardBatch(q, n, m_frames.data(), kBlock);
+    m_checked += n;
+
+    size_t hits = 0;
+#if CV_SIMD
+    // kBlock 是向量宽度的整数倍，最后一组里超出 n 的构型用的是缓冲区里的旧数据，按 valid 掩码丢掉
+    const int lanes = simdLanes();
+    for (size_t k = 0; k < n; k += lanes) {
+        const int count = (int)std::min<size_t>(lanes, n - k);
+        const int valid = (1 << count) - 1;
+        const int mask = laneGroupHits(k, valid) & valid;
+        if (!mask) continue;
+        for (int l = 0; l < count; ++l) {
+            if (!(mask >> l & 1)) continue;
+            ++hits;
+            if (hit) hit[k + l] = 1;
+        }
+        if (stopAtFirst) return hits;
+    }
+#else
+    for (size_t k = 0; k < n; ++k) {
+        if (!scalarHit(k)) continue;
+        ++hits;
+        if (hit) hit[k] = 1;
+        if (stopAtFirst) return hits;
+    }
+#endif
+    return hits;
+}
+
+#if CV_SIMD
+int ArmCollisionChecker::laneGroupHits(size_t k, int valid) const {
+    const cv::v_float32 vzero = cv::vx_setzero_f32();
+    const cv::v_float32 vone = cv::vx_setall_f32(1.0f);
+    cv::v_float32 hit = vzero;
+
+    for (size_t ci = 0; ci < m_capsules.size(); ++ci) {
+        const LinkCapsule &cap = m_capsules[ci];
+        // 胶囊两端的世界坐标 (一组构型各一份)
+        cv::v_float32 ax, ay, az, bx, by, bz;
+        if (cap.frame == 0) {
+            ax = cv::vx_setall_f32(cap.a.x); ay = cv::vx_setall_f32(cap.a.y); az = cv::vx_setall_f32(cap.a.z);
+            bx = cv::vx_setall_f32(cap.b.x); by = cv::vx_setall_f32(cap.b.y); bz = cv::vx_setall_f32(cap.b.z);
+        } else {
+            const float *f = m_frames.data() + size_t(cap.frame - 1) * UR12e::kFrameComponents * kBlock + k;
+            cv::v_float32 R[9];
+            for (int i = 0; i < 9; ++i) R[i] = cv::vx_load(f + i * kBlock);
+            const cv::v_float32 tx = cv::vx_load(f + UR12e::TX * kBlock);
+            const cv::v_float32 ty = cv::vx_load(f + UR12e::TY * kBlock);
+            const cv::v_float32 tz = cv::vx_load(f + UR12e::TZ * kBlock);
+            ax = transformRow(R, tx, 0, cap.a); ay = transformRow(R, ty, 1, cap.a); az = transformRow(R, tz, 2, cap.a);
+            bx = transformRow(R, tx, 0, cap.b); by = transformRow(R, ty, 1, cap.b); bz = transformRow(R, tz, 2, cap.b);
+        }
+        const cv::v_float32 abx = vSub(bx, ax), aby = vSub(by, ay), abz = vSub(bz, az);
+        const cv::v_float32 vinv = cv::vx_setall_f32(m_capsuleInvLen2[ci]);
+
+        if (m_floorEnabled && cap.frame > 0) {
+            const cv::v_float32 lowest = cv::v_min(az, bz);
+            hit = vOr(hit, vLt(lowest, cv::vx_setall_f32(m_floorZ + cap.radius + m_margin)));
+        }
+
+        for (size_t i = 0; i < m_ox.size(); ++i) {
+            const float rr = cap.radius + m_or[i] + m_margin;
+            const cv::v_float32 px = vSub(cv::vx_setall_f32(m_ox[i]), ax);
+            const cv::v_float32 py = vSub(cv::vx_setall_f32(m_oy[i]), ay);
+            const cv::v_float32 pz = vSub(cv::vx_setall_f32(m_oz[i]), az);
+            cv::v_float32 t = vMul(vAdd(vAdd(vMul(px, abx), vMul(py, aby)), vMul(pz, abz)), vinv);
+            t = cv::v_min(cv::v_max(t, vzero), vone);
+            const cv::v_float32 dx = vSub(px, vMul(t, abx));
+            const cv::v_float32 dy = vSub(py, vMul(t, aby));
+            const cv::v_float32 dz = vSub(pz, vMul(t, abz));
+            const cv::v_float32 d2 = vAdd(vAdd(vMul(dx, dx), vMul(dy, dy)), vMul(dz, dz));
+            hit = vOr(hit, vLe(d2, cv::vx_setall_f32(rr * rr)));
+        }
+        // 这一组构型已经全部碰撞，剩下的胶囊不用再测
+        if ((cv::v_signmask(hit) & valid) == valid) break;
+    }
+    return cv::v_signmask(hit);
+}
+#endif
+
+bool ArmCollisionChecker::scalarHit(size_t k) const {
+    for (size_t ci = 0; ci < m_capsules.size(); ++ci) {
+        const LinkCapsule &cap = m_capsules[ci];
+        cv::Point3f a = cap.a, b = cap.b;
+        if (cap.frame > 0) {
+            const float *f = m_frames.data() + size_t(cap.frame - 1) * UR12e::kFrameComponents * kBlock + k;
+            auto world = [&](const cv::Point3f& p) {
+                return cv::Point3f(f[UR12e::R00 * kBlock] * p.x + f[UR12e::R01 * kBlock] * p.y + f[UR12e::R02 * kBlock] * p.z + f[UR12e::TX * kBlock],
+                                   f[UR12e::R10 * kBlock] * p.x + f[UR12e::R11 * kBlock] * p.y + f[UR12e::R12 * kBlock] * p.z + f[UR12e::TY * kBlock],
+                                   f[UR12e::R20 * kBlock] * p.x + f[UR12e::R21 * kBlock] * p.y + f[UR12e::R22 * kBlock] * p.z + f[UR12e::TZ * kBlock]);
+            };
+            a = world(cap.a);
+            b = world(cap.b);
+        }
+        const cv::Point3f ab = b - a;
+        if (m_floorEnabled && cap.frame > 0 && std::min(a.z, b.z) < m_floorZ + cap.radius + m_margin) return true;
+        for (size_t i = 0; i < m_ox.size(); ++i) {
+            const float rr = cap.radius + m_or[i] + m_margin;
+            if (pointSegmentDist2(a, ab, m_capsuleInvLen2[ci], cv::Point3f(m_ox[i], m_oy[i], m_oz[i])) <= rr * rr) return true;
+        }
+    }
+    return false;
+}
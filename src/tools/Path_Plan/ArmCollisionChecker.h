@@ -0,0 +1,95 @@
+#ifndef ARMCOLLISIONCHECKER_H
+#define ARMCOLLISIONCHECKER_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+#include "CollisionChecker.h"
+#include "tools/Robot/URKinematics.h"
+
+// 连杆的胶囊体近似: 坐标系 frame 里的线段 a-b 加半径 (frame 0 为基座，1..6 同 UR12e::forward)
+struct LinkCapsule {
+    int frame;
+    cv::Point3f a, b;
+    float radius;
+};
+
+/**
+ * @brief 整条手臂 (而不只是 TCP 一个点) vs 球形障碍物
+ *
+ * 每根连杆用一个或几个胶囊体包住，胶囊 vs 球 = 球心到线段的距离 <= 两个半径之和 + 余量。
+ * 批量检查 (checkBatch / anyCollides / motionCollides) 按块算: 一块构型先用 UR12e::forwardBatch 算出
+ * 全部坐标系 (SoA)，再以 "一个向量宽度的构型" 为单位，对每个胶囊、每个球做一次 SIMD 距离测试；
+ * 同一组构型全部碰撞后就不再测剩下的球。collides 是逐个构型的 double 标量写法，作为参考和基准。
+ * 不检查自碰撞。查询会用到内部缓冲区，一个实例不能多线程同时查询。
+ */
+class ArmCollisionChecker
+{
+public:
+    ArmCollisionChecker();
+
+    // UR12e 的默认胶囊 (按外形尺寸估的，偏保守)
+    static std::vector<LinkCapsule> defaultCapsules();
+    void setCapsules(const std::vector<LinkCapsule>& capsules);
+    const std::vector<LinkCapsule>& capsules() const { return m_capsules; }
+
+    void setObstacles(const std::vector<SphereObstacle>& obstacles);
+    const std::vector<SphereObstacle>& obstacles() const { return m_obstacles; }
+
+    // 安全余量 (米)，默认 0.02
+    void setMargin(float margin) { m_margin = margin; }
+    float margin() const { return m_margin; }
+
+    // 把 z = height 以下当作障碍 (桌面)，基座胶囊 (frame 0) 不算；默认关闭
+    void setFloor(bool enable, float height = 0.0f) { m_floorEnabled = enable; m_floorZ = height; }
+
+    // 单个构型，标量参考实现
+    bool collides(const JointVector& q) const;
+
+    /**
+     * @brief 批量检查 q 里的全部构型
+     * @param hit 输出，hit[k] = 1 表示第 k 组碰撞
+     * @return 碰撞的构型数
+     */
+    size_t checkBatch(const UR12e::JointBatch& q, std::vector<uint8_t>& hit) const;
+
+    // 有任何一组碰撞就返回 true (算到碰撞的那一块就停)
+    bool anyCollides(const UR12e::JointBatch& q) const;
+
+    /**
+     * @brief 关节空间直线 from -> to 是否碰撞
+     * 按 resolution (任一关节相邻两点之差的上限，rad) 插值，一次批量检查。
+     * 不查 from 本身 (规划时它是已经检查过的树节点)
+     */
+    bool motionCollides(const JointVector& from, const JointVector& to, double resolution) const;
+
+    // 累计检查过的构型数 (给基准和规划统计用)
+    uint64_t checkedCount() const { return m_checked; }
+    void resetCheckedCount() { m_checked = 0; }
+
+    // 每块的构型数: 6 个坐标系 x 12 个分量 x 64 个 float = 18 KB，放得进 L1
+    static constexpr size_t kBlock = 64;
+
+private:
+    // q[j] 指向本块第一组构型的第 j 个关节角，共 n 组 (n <= kBlock)；结果写到 hit (可为空)，stopAtFirst 时碰到就返回
+    size_t checkBlock(const float* const q[UR12e::kDof], size_t n, uint8_t* hit, bool stopAtFirst) const;
+    // 当前块里下标 k 起的一个向量宽度的构型，返回碰撞掩码 (第 l 位 = 第 k + l 组)；
+    // valid 是其中有效构型的掩码，全部碰撞后提前返回
+    int laneGroupHits(size_t k, int valid) const;
+    // 当前块里第 k 组构型 (没有 SIMD 时用)
+    bool scalarHit(size_t k) const;
+
+    std::vector<LinkCapsule> m_capsules;
+    std::vector<float> m_capsuleInvLen2;      // 1 / |b - a|^2 (旋转不改变长度，提前算好)，退化为 0
+    std::vector<SphereObstacle> m_obstacles;
+    std::vector<float> m_ox, m_oy, m_oz, m_or;  // 障碍物 SoA
+    float m_margin = 0.02f;
+    bool m_floorEnabled = false;
+    float m_floorZ = 0.0f;
+
+    mutable std::vector<float> m_frames;      // 当前块的坐标系 [1..6][12][kBlock]
+    mutable UR12e::JointBatch m_motion;       // motionCollides 的插值点
+    mutable uint64_t m_checked = 0;
+};
+
+#endif // ARMCOLLISIONCHECKER_H
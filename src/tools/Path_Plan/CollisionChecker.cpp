@@ -0,0 +1,247 @@
+#include "CollisionChecker.h"
+#include "SimdCompat.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if CV_SIMD
+using namespace Simd;
+#endif
+
+// ================= 障碍物管理 =================
+
+void CollisionChecker::clear() {
+    m_obstacles.clear();
+    m_dirty = true;
+}
+
+void CollisionChecker::addObstacle(const SphereObstacle& obs) {
+    m_obstacles.push_back(obs);
+    m_dirty = true;
+}
+
+void CollisionChecker::setObstacles(const std::vector<SphereObstacle>& obstacles) {
+    m_obstacles = obstacles;
+    m_dirty = true;
+}
+
+// 重建 SoA 数组和均匀网格
+void CollisionChecker::rebuild() const {
+    const size_t n = m_obstacles.size();
+    m_x.resize(n); m_y.resize(n); m_z.resize(n); m_r.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        m_x[i] = m_obstacles[i].center.x;
+        m_y[i] = m_obstacles[i].center.y;
+        m_z[i] = m_obstacles[i].center.z;
+        m_r[i] = m_obstacles[i].radius;
+    }
+    m_dirty = false;
+
+    m_gridBuilt = n >= kBroadPhaseMinObstacles;
+    if (!m_gridBuilt) return;
+
+    // 1. 所有球包围盒的并集
+    cv::Point3f lo(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                   std::numeric_limits<float>::max());
+    cv::Point3f hi(-lo.x, -lo.y, -lo.z);
+    double sumR = 0.0;
+    for (const auto &o : m_obstacles) {
+        const float r = std::max(o.radius, 0.0f);
+        lo.x = std::min(lo.x, o.center.x - r); hi.x = std::max(hi.x, o.center.x + r);
+        lo.y = std::min(lo.y, o.center.y - r); hi.y = std::max(hi.y, o.center.y + r);
+        lo.z = std::min(lo.z, o.center.z - r); hi.z = std::max(hi.z, o.center.z + r);
+        sumR += r;
+    }
+
+    // 2. 格子边长: 不小于球的平均直径，且平均每格约 1 个球；每个轴最多 128 格
+    const float ex = std::max(hi.x - lo.x, 1e-3f);
+    const float ey = std::max(hi.y - lo.y, 1e-3f);
+    const float ez = std::max(hi.z - lo.z, 1e-3f);
+    float cell = std::max(float(2.0 * sumR / n), std::cbrt(ex * ey * ez / n));
+    cell = std::max(cell, std::max(ex, std::max(ey, ez)) / 128.0f);
+    m_cell = cell;
+    m_gridLo = lo;
+    m_nx = std::max(1, (int)std::ceil(ex / cell));
+    m_ny = std::max(1, (int)std::ceil(ey / cell));
+    m_nz = std::max(1, (int)std::ceil(ez / cell));
+    const size_t cells = (size_t)m_nx * m_ny * m_nz;
+
+    auto coord = [&](float v, float l, int cnt) {
+        return std::min(std::max((int)std::floor((v - l) / m_cell), 0), cnt - 1);
+    };
+
+    // 3. 两遍扫描建 CSR: 先数每格多少个，再填
+    m_cellStart.assign(cells + 1, 0);
+    for (int pass = 0; pass < 2; ++pass) {
+        std::vector<uint32_t> fill;
+        if (pass == 1) {
+            for (size_t c = 0; c < cells; ++c) m_cellStart[c + 1] += m_cellStart[c];
+            m_cellItems.resize(m_cellStart[cells]);
+            fill.assign(m_cellStart.begin(), m_cellStart.end() - 1);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            const auto &o = m_obstacles[i];
+            const float r = std::max(o.radius, 0.0f);
+            const int x0 = coord(o.center.x - r, lo.x, m_nx), x1 = coord(o.center.x + r, lo.x, m_nx);
+            const int y0 = coord(o.center.y - r, lo.y, m_ny), y1 = coord(o.center.y + r, lo.y, m_ny);
+            const int z0 = coord(o.center.z - r, lo.z, m_nz), z1 = coord(o.center.z + r, lo.z, m_nz);
+            for (int z = z0; z <= z1; ++z)
+                for (int y = y0; y <= y1; ++y)
+                    for (int x = x0; x <= x1; ++x) {
+                        const size_t c = ((size_t)z * m_ny + y) * m_nx + x;
+                        if (pass == 0) ++m_cellStart[c + 1];
+                        else m_cellItems[fill[c]++] = (uint32_t)i;
+                    }
+        }
+    }
+}
+
+// ================= 查询 =================
+
+bool CollisionChecker::segmentHitsSphere(const cv::Point3f& p1, const cv::Point3f& p2,
+                                         const SphereObstacle& obs, float threshold) {
+    float safeRadius = obs.radius + threshold;
+    cv::Point3f d = p2 - p1;
+    cv::Point3f f = p1 - obs.center;
+    float a = d.dot(d);
+    float b = 2.0f * f.dot(d);
+    float c = f.dot(f) - safeRadius * safeRadius;
+
+    // 处理 a 接近 0 的情况（即P1、P2重合），避免除以零
+    if (std::abs(a) < 1e-6) return c < 0;
+
+    float delta = b*b - 4*a*c;
+    if (delta < 0) return false;
+
+    delta = std::sqrt(delta);
+    float t1 = (-b - delta) / (2*a);
+    float t2 = (-b + delta) / (2*a);
+    return t1 <= 1.0f && t2 >= 0.0f;
+}
+
+// SoA 精检: 和 segmentHitsSphere 同样的运算顺序，一次处理一组球
+bool CollisionChecker::anyHit(const float* cx, const float* cy, const float* cz, const float* r, size_t n,
+                              const cv::Point3f& p1, const cv::Point3f& p2, float threshold) const {
+    const float dx = p2.x - p1.x, dy = p2.y - p1.y, dz = p2.z - p1.z;
+    const float a = dx * dx + dy * dy + dz * dz;
+    const bool degenerate = std::abs(a) < 1e-6;    // 线段退化成点: 只看点是否在球内
+    size_t i = 0;
+
+#if CV_SIMD
+    const int lanes = simdLanes();
+    const cv::v_float32 vp1x = cv::vx_setall_f32(p1.x), vp1y = cv::vx_setall_f32(p1.y), vp1z = cv::vx_setall_f32(p1.z);
+    const cv::v_float32 vdx = cv::vx_setall_f32(dx), vdy = cv::vx_setall_f32(dy), vdz = cv::vx_setall_f32(dz);
+    const cv::v_float32 vthr = cv::vx_setall_f32(threshold);
+    const cv::v_float32 vtwo = cv::vx_setall_f32(2.0f);
+    const cv::v_float32 vfourA = cv::vx_setall_f32(4 * a);
+    const cv::v_float32 vtwoA = cv::vx_setall_f32(2 * a);
+    const cv::v_float32 vzero = cv::vx_setzero_f32();
+    const cv::v_float32 vone = cv::vx_setall_f32(1.0f);
+    for (; i + lanes <= n; i += lanes) {
+        cv::v_float32 sR = vAdd(cv::vx_load(r + i), vthr);
+        cv::v_float32 fx = vSub(vp1x, cv::vx_load(cx + i));
+        cv::v_float32 fy = vSub(vp1y, cv::vx_load(cy + i));
+        cv::v_float32 fz = vSub(vp1z, cv::vx_load(cz + i));
+        cv::v_float32 ff = vAdd(vAdd(vMul(fx, fx), vMul(fy, fy)), vMul(fz, fz));
+        cv::v_float32 c = vSub(ff, vMul(sR, sR));
+        if (degenerate) {
+            if (cv::v_check_any(vLt(c, vzero))) return true;
+            continue;
+        }
+        cv::v_float32 fd = vAdd(vAdd(vMul(fx, vdx), vMul(fy, vdy)), vMul(fz, vdz));
+        cv::v_float32 b = vMul(vtwo, fd);
+        cv::v_float32 delta = vSub(vMul(b, b), vMul(vfourA, c));
+        cv::v_float32 valid = vGe(delta, vzero);
+        cv::v_float32 sq = cv::v_sqrt(cv::v_max(delta, vzero));
+        cv::v_float32 negB = vSub(vzero, b);
+        cv::v_float32 t1 = vDiv(vSub(negB, sq), vtwoA);
+        cv::v_float32 t2 = vDiv(vAdd(negB, sq), vtwoA);
+        cv::v_float32 hit = vAnd(valid, vAnd(vLe(t1, vone), vGe(t2, vzero)));
+        if (cv::v_check_any(hit)) return true;
+    }
+#endif
+
+    // 剩余不足一组的球 (以及没有 SIMD 时的全部球) 走标量
+    for (; i < n; ++i) {
+        SphereObstacle obs{cv::Point3f(cx[i], cy[i], cz[i]), r[i]};
+        if (segmentHitsSphere(p1, p2, obs, threshold)) return true;
+    }
+    return false;
+}
+
+bool CollisionChecker::segmentCollides(const cv::Point3f& p1, const cv::Point3f& p2, float threshold) const {
+    if (m_obstacles.empty()) return false;
+    if (m_dirty) rebuild();
+    return query(p1, p2, threshold, m_scratch);
+}
+
+bool CollisionChecker::segmentCollides(const cv::Point3f& p1, const cv::Point3f& p2, float threshold,
+                                       QueryScratch& scratch) const {
+    if (m_obstacles.empty()) return false;
+    if (m_dirty) {
+        // 没有 prepare(): 不能在共享状态上重建，逐个球标量检查 (结果相同，只是慢)
+        for (const auto &o : m_obstacles) {
+            if (segmentHitsSphere(p1, p2, o, threshold)) return true;
+        }
+        return false;
+    }
+    return query(p1, p2, threshold, scratch);
+}
+
+bool CollisionChecker::query(const cv::Point3f& p1, const cv::Point3f& p2, float threshold,
+                             QueryScratch& scratch) const {
+    const size_t n = m_obstacles.size();
+    if (!m_broadPhaseEnabled || !m_gridBuilt) {
+        return anyHit(m_x.data(), m_y.data(), m_z.data(), m_r.data(), n, p1, p2, threshold);
+    }
+
+    // 1. 粗筛: 线段包围盒按 threshold 外扩 (再留一点余量，保证和逐个精检的结果一致)
+    const float pad = threshold + 1e-4f;
+    auto coord = [&](float v, float l, int cnt) {
+        return std::min(std::max((int)std::floor((v - l) / m_cell), 0), cnt - 1);
+    };
+    const float bx0 = std::min(p1.x, p2.x) - pad, bx1 = std::max(p1.x, p2.x) + pad;
+    const float by0 = std::min(p1.y, p2.y) - pad, by1 = std::max(p1.y, p2.y) + pad;
+    const float bz0 = std::min(p1.z, p2.z) - pad, bz1 = std::max(p1.z, p2.z) + pad;
+
+    // 完全在网格外: 不可能碰到任何球
+    const float gx1 = m_gridLo.x + m_nx * m_cell, gy1 = m_gridLo.y + m_ny * m_cell, gz1 = m_gridLo.z + m_nz * m_cell;
+    if (bx1 < m_gridLo.x || by1 < m_gridLo.y || bz1 < m_gridLo.z || bx0 > gx1 || by0 > gy1 || bz0 > gz1) {
+        return false;
+    }
+
+    const int x0 = coord(bx0, m_gridLo.x, m_nx), x1 = coord(bx1, m_gridLo.x, m_nx);
+    const int y0 = coord(by0, m_gridLo.y, m_ny), y1 = coord(by1, m_gridLo.y, m_ny);
+    const int z0 = coord(bz0, m_gridLo.z, m_nz), z1 = coord(bz1, m_gridLo.z, m_nz);
+
+    // 长线段覆盖的格子太多时，粗筛反而更慢，直接扫全部
+    const size_t cellsCovered = (size_t)(x1 - x0 + 1) * (y1 - y0 + 1) * (z1 - z0 + 1);
+    if (cellsCovered * 4 > n) {
+        return anyHit(m_x.data(), m_y.data(), m_z.data(), m_r.data(), n, p1, p2, threshold);
+    }
+
+    // 2. 收集候选球 (一个球可能跨多个格子，用 stamp 去重)，拷贝成紧凑的 SoA
+    if (scratch.stamp.size() != n || ++scratch.stampId == 0) {
+        scratch.stamp.assign(n, 0);
+        scratch.stampId = 1;
+    }
+    scratch.x.clear(); scratch.y.clear(); scratch.z.clear(); scratch.r.clear();
+    for (int z = z0; z <= z1; ++z)
+        for (int y = y0; y <= y1; ++y)
+            for (int x = x0; x <= x1; ++x) {
+                const size_t c = ((size_t)z * m_ny + y) * m_nx + x;
+                for (uint32_t k = m_cellStart[c]; k < m_cellStart[c + 1]; ++k) {
+                    const uint32_t i = m_cellItems[k];
+                    if (scratch.stamp[i] == scratch.stampId) continue;
+                    scratch.stamp[i] = scratch.stampId;
+                    scratch.x.push_back(m_x[i]);
+                    scratch.y.push_back(m_y[i]);
+                    scratch.z.push_back(m_z[i]);
+                    scratch.r.push_back(m_r[i]);
+                }
+            }
+
+    // 3. 精检
+    return anyHit(scratch.x.data(), scratch.y.data(), scratch.z.data(), scratch.r.data(), scratch.x.size(),
+                  p1, p2, threshold);
+}
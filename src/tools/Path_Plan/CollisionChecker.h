@@ -0,0 +1,93 @@
+#ifndef COLLISIONCHECKER_H
+#define COLLISIONCHECKER_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+
+// 定义障碍物 (保持不变)
+struct SphereObstacle {
+    cv::Point3f center;
+    float radius;
+};
+
+/**
+ * @brief 线段 vs 球形障碍物的碰撞检测
+ *
+ * 两级结构:
+ *   1. 粗筛 (broad phase): 障碍物包围盒挂到均匀网格上，只取线段包围盒覆盖到的格子里的球；
+ *   2. 精检 (narrow phase): 球按 SoA (x[] / y[] / z[] / r[] 分开存) 排布，
+ *      一条线段一次 SIMD 指令测 4/8/16 个球 (取决于编译时启用的指令集，用 OpenCV 通用向量指令)。
+ * 每个球用的公式和原来 RRTPlanner::checkCollision 的标量写法逐步一致 (同样的运算顺序)，结果相同。
+ *
+ * 添加障碍物后网格标记为过期，下一次查询时重建 (O(n))。
+ * 查询会用到内部缓冲区，一个实例不能多线程同时查询；
+ * 多线程共享同一组障碍物时先调用一次 prepare()，之后每个线程带自己的 QueryScratch 查询。
+ */
+class CollisionChecker
+{
+public:
+    // 一次查询用到的缓冲区 (去重标记 + 候选球的 SoA 拷贝)，每个线程一份
+    struct QueryScratch {
+        std::vector<uint32_t> stamp;
+        uint32_t stampId = 0;
+        std::vector<float> x, y, z, r;
+    };
+
+    void clear();
+    void addObstacle(const SphereObstacle& obs);
+    void setObstacles(const std::vector<SphereObstacle>& obstacles);
+
+    const std::vector<SphereObstacle>& obstacles() const { return m_obstacles; }
+    size_t size() const { return m_obstacles.size(); }
+
+    /**
+     * @brief 线段 p1-p2 是否与任何 (半径 + threshold) 的球相交
+     */
+    bool segmentCollides(const cv::Point3f& p1, const cv::Point3f& p2, float threshold = 0.05f) const;
+
+    /**
+     * @brief 同上，但用调用方的缓冲区: prepare() 之后只读障碍物数据，可以多线程同时调用
+     * 查询前不能再添加障碍物 (网格过期时这里不会重建，而是退回扫全部球)
+     */
+    bool segmentCollides(const cv::Point3f& p1, const cv::Point3f& p2, float threshold, QueryScratch& scratch) const;
+
+    // 立即重建 SoA 数组和网格 (否则在下一次查询时重建)
+    void prepare() const { if (m_dirty) rebuild(); }
+
+    // 关闭粗筛 (只用 SoA 精检扫全部球)，用于基准对比
+    void setBroadPhaseEnabled(bool enable) { m_broadPhaseEnabled = enable; }
+
+    // 障碍物少于这个数时不建网格，直接 SIMD 扫全部
+    static constexpr size_t kBroadPhaseMinObstacles = 32;
+
+    // 原始标量实现 (逐个球解二次方程)，作为参考和基准
+    static bool segmentHitsSphere(const cv::Point3f& p1, const cv::Point3f& p2,
+                                  const SphereObstacle& obs, float threshold);
+
+private:
+    void rebuild() const;
+    bool anyHit(const float* cx, const float* cy, const float* cz, const float* r, size_t n,
+                const cv::Point3f& p1, const cv::Point3f& p2, float threshold) const;
+    bool query(const cv::Point3f& p1, const cv::Point3f& p2, float threshold, QueryScratch& scratch) const;
+
+    std::vector<SphereObstacle> m_obstacles;
+    bool m_broadPhaseEnabled = true;
+
+    // ---- SoA 数据 (和 m_obstacles 同序) ----
+    mutable std::vector<float> m_x, m_y, m_z, m_r;
+
+    // ---- 均匀网格 (CSR: 第 i 个格子的球是 m_cellItems[m_cellStart[i] .. m_cellStart[i+1])) ----
+    mutable bool m_dirty = true;
+    mutable bool m_gridBuilt = false;
+    mutable cv::Point3f m_gridLo;
+    mutable float m_cell = 1.0f;
+    mutable int m_nx = 0, m_ny = 0, m_nz = 0;
+    mutable std::vector<uint32_t> m_cellStart;
+    mutable std::vector<uint32_t> m_cellItems;
+
+    // ---- 单线程查询用的缓冲区 ----
+    mutable QueryScratch m_scratch;
+};
+
+#endif // COLLISIONCHECKER_H
@@ -0,0 +1,323 @@
+#include "NearestNeighbor.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+inline float dist2(const cv::Point3f& a, const cv::Point3f& b) {
+    const float dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+    return dx * dx + dy * dy + dz * dz;
+}
+
+inline float axisValue(const cv::Point3f& p, int axis) {
+    return axis == 0 ? p.x : (axis == 1 ? p.y : p.z);
+}
+
+// 更新当前最优 (距离相同取 id 小的，与线性扫描保持一致)
+inline void consider(float d, int id, float& bestD, int& bestId) {
+    if (d < bestD || (d == bestD && id < bestId)) {
+        bestD = d;
+        bestId = id;
+    }
+}
+
+// ================= 1. 线性扫描 =================
+class BruteForceIndex : public NearestNeighborIndex
+{
+public:
+    void clear() override { m_pts.clear(); m_ids.clear(); }
+
+    void insert(int id, const cv::Point3f& p) override {
+        m_pts.push_back(p);
+        m_ids.push_back(id);
+    }
+
+    int nearest(const cv::Point3f& q) const override {
+        float bestD = std::numeric_limits<float>::max();
+        int bestId = -1;
+        for (size_t i = 0; i < m_pts.size(); ++i) {
+            consider(dist2(m_pts[i], q), m_ids[i], bestD, bestId);
+        }
+        return bestId;
+    }
+
+    void withinRadius(const cv::Point3f& q, float radius, std::vector<int>& out) const override {
+        out.clear();
+        const float r2 = radius * radius;
+        for (size_t i = 0; i < m_pts.size(); ++i) {
+            if (dist2(m_pts[i], q) <= r2) out.push_back(m_ids[i]);
+        }
+    }
+
+    size_t size() const override { return m_pts.size(); }
+    NNIndexType type() const override { return NNIndexType::BruteForce; }
+
+private:
+    std::vector<cv::Point3f> m_pts;
+    std::vector<int> m_ids;
+};
+
+// ================= 2. 增量 k-d 树 =================
+// 不做重平衡: RRT 的新节点朝随机采样点生长，插入顺序本身就是随机的，期望深度 O(log n)
+class KdTreeIndex : public NearestNeighborIndex
+{
+public:
+    void clear() override { m_nodes.clear(); }
+
+    void insert(int id, const cv::Point3f& p) override {
+        KdNode node;
+        node.p = p;
+        node.id = id;
+        const int newIdx = (int)m_nodes.size();
+        if (m_nodes.empty()) {
+            node.axis = 0;
+            m_nodes.push_back(node);
+            return;
+        }
+
+        // 从根往下走，挂到叶子上
+        int cur = 0;
+        while (true) {
+            KdNode &n = m_nodes[cur];
+            const bool goLeft = axisValue(p, n.axis) < axisValue(n.p, n.axis);
+            int &child = goLeft ? n.left : n.right;
+            if (child < 0) {
+                child = newIdx;
+                node.axis = (n.axis + 1) % 3;
+                break;
+            }
+            cur = child;
+        }
+        m_nodes.push_back(node);
+    }
+
+    int nearest(const cv::Point3f& q) const override {
+        if (m_nodes.empty()) return -1;
+        float bestD = std::numeric_limits<float>::max();
+        int bestId = -1;
+
+        // 显式栈代替递归 (树可能较深)；每项带上到该子树的距离下界，用来剪枝
+        m_stack.clear();
+        m_stack.push_back({0, 0.0f});
+        while (!m_stack.empty()) {
+            const StackItem item = m_stack.back();
+            m_stack.pop_back();
+            if (item.bound > bestD) continue;
+
+            const KdNode &n = m_nodes[item.node];
+            consider(dist2(n.p, q), n.id, bestD, bestId);
+
+            const float diff = axisValue(q, n.axis) - axisValue(n.p, n.axis);
+            const int nearSide = diff < 0 ? n.left : n.right;
+            const int farSide = diff < 0 ? n.right : n.left;
+            // 先压远侧再压近侧，近侧先出栈
+            if (farSide >= 0) m_stack.push_back({farSide, std::max(item.bound, diff * diff)});
+            if (nearSide >= 0) m_stack.push_back({nearSide, item.bound});
+        }
+        return bestId;
+    }
+
+    void withinRadius(const cv::Point3f& q, float radius, std::vector<int>& out) const override {
+        out.clear();
+        if (m_nodes.empty()) return;
+        const float r2 = radius * radius;
+        m_stack.clear();
+        m_stack.push_back({0, 0.0f});
+        while (!m_stack.empty()) {
+            const KdNode &n = m_nodes[m_stack.back().node];
+            m_stack.pop_back();
+            if (dist2(n.p, q) <= r2) out.push_back(n.id);
+
+            const float diff = axisValue(q, n.axis) - axisValue(n.p, n.axis);
+            if (n.left >= 0 && diff - radius < 0) m_stack.push_back({n.left, 0.0f});
+            if (n.right >= 0 && diff + radius >= 0) m_stack.push_back({n.right, 0.0f});
+        }
+    }
+
+    size_t size() const override { return m_nodes.size(); }
+    NNIndexType type() const override { return NNIndexType::KdTree; }
+
+private:
+    struct KdNode {
+        cv::Point3f p;
+        int id = -1;
+        int axis = 0;
+        int left = -1;
+        int right = -1;
+    };
+    struct StackItem {
+        int node;
+        float bound;    // 到该子树的距离平方下界
+    };
+
+    std::vector<KdNode> m_nodes;
+    mutable std::vector<StackItem> m_stack;     // 查询用的栈，复用避免反复分配
+};
+
+// ================= 3. 均匀网格空间哈希 =================
+// 工作空间按 cellSize 切成格子，查询时从所在格子开始一圈一圈往外找，
+// 一旦当前最优距离小于下一圈的距离下界就可以停。
+// 工作空间外的点 (比如起点/终点在边界外) 单独放一个列表，每次都扫一遍。
+class GridHashIndex : public NearestNeighborIndex
+{
+public:
+    GridHashIndex(const cv::Point3f& lo, const cv::Point3f& hi, float cellSize)
+        : m_lo(lo), m_cell(cellSize > 1e-6f ? cellSize : 0.1f)
+    {
+        m_nx = std::max(1, (int)std::ceil((hi.x - lo.x) / m_cell));
+        m_ny = std::max(1, (int)std::ceil((hi.y - lo.y) / m_cell));
+        m_nz = std::max(1, (int)std::ceil((hi.z - lo.z) / m_cell));
+        m_hi = cv::Point3f(lo.x + m_nx * m_cell, lo.y + m_ny * m_cell, lo.z + m_nz * m_cell);
+        m_cells.resize((size_t)m_nx * m_ny * m_nz);
+    }
+
+    void clear() override {
+        for (auto &c : m_cells) c.clear();
+        m_outside.clear();
+        m_count = 0;
+    }
+
+    void insert(int id, const cv::Point3f& p) override {
+        ++m_count;
+        if (!inside(p)) {
+            m_outside.push_back({p, id});
+            return;
+        }
+        m_cells[cellIndex(cellCoord(p.x, m_lo.x, m_nx), cellCoord(p.y, m_lo.y, m_ny),
+                          cellCoord(p.z, m_lo.z, m_nz))].push_back({p, id});
+    }
+
+    int nearest(const cv::Point3f& q) const override {
+        float bestD = std::numeric_limits<float>::max();
+        int bestId = -1;
+        for (const Entry &e : m_outside) consider(dist2(e.p, q), e.id, bestD, bestId);
+
+        // q 在网格外时投影到网格上: 对网格内任意点 p 有 |q-p|² >= |q-q'|² + |q'-p|²
+        const cv::Point3f qc(std::min(std::max(q.x, m_lo.x), m_hi.x),
+                             std::min(std::max(q.y, m_lo.y), m_hi.y),
+                             std::min(std::max(q.z, m_lo.z), m_hi.z));
+        const float outside2 = dist2(q, qc);
+
+        const int cx = cellCoord(qc.x, m_lo.x, m_nx);
+        const int cy = cellCoord(qc.y, m_lo.y, m_ny);
+        const int cz = cellCoord(qc.z, m_lo.z, m_nz);
+        const int maxRing = std::max(m_nx, std::max(m_ny, m_nz));
+
+        for (int r = 0; r <= maxRing; ++r) {
+            visitRing(cx, cy, cz, r, q, bestD, bestId);
+
+            // 第 r 圈之外 (且在网格内) 的格子离 q 至少这么远
+            const float bound = std::min(ringMargin(qc.x, m_lo.x, cx, r, m_nx),
+                                         std::min(ringMargin(qc.y, m_lo.y, cy, r, m_ny),
+                                                  ringMargin(qc.z, m_lo.z, cz, r, m_nz)));
+            if (bound == std::numeric_limits<float>::max()) break;     // 整个网格都看完了
+            if (bestId >= 0 && bestD < outside2 + bound * bound) break;
+        }
+        return bestId;
+    }
+
+    void withinRadius(const cv::Point3f& q, float radius, std::vector<int>& out) const override {
+        out.clear();
+        const float r2 = radius * radius;
+        for (const Entry &e : m_outside) {
+            if (dist2(e.p, q) <= r2) out.push_back(e.id);
+        }
+
+        const int x0 = cellCoord(q.x - radius, m_lo.x, m_nx), x1 = cellCoord(q.x + radius, m_lo.x, m_nx);
+        const int y0 = cellCoord(q.y - radius, m_lo.y, m_ny), y1 = cellCoord(q.y + radius, m_lo.y, m_ny);
+        const int z0 = cellCoord(q.z - radius, m_lo.z, m_nz), z1 = cellCoord(q.z + radius, m_lo.z, m_nz);
+        for (int x = x0; x <= x1; ++x)
+            for (int y = y0; y <= y1; ++y)
+                for (int z = z0; z <= z1; ++z)
+                    for (const Entry &e : m_cells[cellIndex(x, y, z)]) {
+                        if (dist2(e.p, q) <= r2) out.push_back(e.id);
+                    }
+    }
+
+    size_t size() const override { return m_count; }
+    NNIndexType type() const override { return NNIndexType::GridHash; }
+
+private:
+    struct Entry {
+        cv::Point3f p;
+        int id;
+    };
+
+    bool inside(const cv::Point3f& p) const {
+        return p.x >= m_lo.x && p.x < m_hi.x && p.y >= m_lo.y && p.y < m_hi.y &&
+               p.z >= m_lo.z && p.z < m_hi.z;
+    }
+
+    int cellCoord(float v, float lo, int n) const {
+        const int c = (int)std::floor((v - lo) / m_cell);
+        return std::min(std::max(c, 0), n - 1);
+    }
+
+    size_t cellIndex(int x, int y, int z) const {
+        return ((size_t)z * m_ny + y) * m_nx + x;
+    }
+
+    // 一个轴上 q 到第 r 圈边界的距离；两侧都已经到网格边缘则为无穷大
+    float ringMargin(float v, float lo, int c, int r, int n) const {
+        float m = std::numeric_limits<float>::max();
+        if (c - r > 0) m = std::min(m, v - (lo + (c - r) * m_cell));
+        if (c + r < n - 1) m = std::min(m, lo + (c + r + 1) * m_cell - v);
+        return std::max(0.0f, m);
+    }
+
+    // 访问与 (cx,cy,cz) 切比雪夫距离恰好为 r 的那一圈格子
+    void visitRing(int cx, int cy, int cz, int r, const cv::Point3f& q, float& bestD, int& bestId) const {
+        const int x0 = std::max(cx - r, 0), x1 = std::min(cx + r, m_nx - 1);
+        const int y0 = std::max(cy - r, 0), y1 = std::min(cy + r, m_ny - 1);
+        const int z0 = std::max(cz - r, 0), z1 = std::min(cz + r, m_nz - 1);
+        for (int x = x0; x <= x1; ++x) {
+            const bool edgeX = std::abs(x - cx) == r;
+            for (int y = y0; y <= y1; ++y) {
+                if (edgeX || std::abs(y - cy) == r) {
+                    for (int z = z0; z <= z1; ++z) visitCell(x, y, z, q, bestD, bestId);
+                } else {
+                    // 内部格子在前几圈已经看过了，只看 z 方向的两个外壳
+                    if (cz - r >= 0) visitCell(x, y, cz - r, q, bestD, bestId);
+                    if (r > 0 && cz + r < m_nz) visitCell(x, y, cz + r, q, bestD, bestId);
+                }
+            }
+        }
+    }
+
+    void visitCell(int x, int y, int z, const cv::Point3f& q, float& bestD, int& bestId) const {
+        for (const Entry &e : m_cells[cellIndex(x, y, z)]) {
+            consider(dist2(e.p, q), e.id, bestD, bestId);
+        }
+    }
+
+    cv::Point3f m_lo, m_hi;
+    float m_cell;
+    int m_nx = 1, m_ny = 1, m_nz = 1;
+    std::vector<std::vector<Entry>> m_cells;
+    std::vector<Entry> m_outside;   // 工作空间外的点
+    size_t m_count = 0;
+};
+
+} // namespace
+
+const char* nnIndexTypeName(NNIndexType type) {
+    switch (type) {
+    case NNIndexType::BruteForce: return "BruteForce";
+    case NNIndexType::KdTree:     return "KdTree";
+    case NNIndexType::GridHash:   return "GridHash";
+    }
+    return "Unknown";
+}
+
+std::unique_ptr<NearestNeighborIndex> createNearestNeighborIndex(NNIndexType type,
+                                                                 const cv::Point3f& lo,
+                                                                 const cv::Point3f& hi,
+                                                                 float cellSize) {
+    switch (type) {
+    case NNIndexType::BruteForce: return std::make_unique<BruteForceIndex>();
+    case NNIndexType::KdTree:     return std::make_unique<KdTreeIndex>();
+    case NNIndexType::GridHash:   return std::make_unique<GridHashIndex>(lo, hi, cellSize);
+    }
+    return std::make_unique<BruteForceIndex>();
+}
@@ -0,0 +1,54 @@
+#ifndef NEARESTNEIGHBOR_H
+#define NEARESTNEIGHBOR_H
+
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <vector>
+
+// 最近邻索引的实现方式 (运行时可切换，方便对比)
+enum class NNIndexType {
+    BruteForce,     // 线性扫描 (原始实现，作为基准)
+    KdTree,         // 增量 k-d 树
+    GridHash        // 均匀网格空间哈希 (按工作空间边界划分)
+};
+
+const char* nnIndexTypeName(NNIndexType type);
+
+/**
+ * @brief RRT 树节点的最近邻索引接口
+ *
+ * 节点只增不删，id 由调用者给 (就是节点在 tree 数组里的下标)。
+ * 支持边插入边查询 (RRT 每次迭代都是 先查最近 -> 再插入新点)，
+ * 以及半径查询 (给 RRT* 重连用)。
+ * 距离相同时返回 id 较小的节点，和线性扫描的结果一致。
+ * 不是线程安全的，一棵树一个索引。
+ */
+class NearestNeighborIndex
+{
+public:
+    virtual ~NearestNeighborIndex() = default;
+
+    virtual void clear() = 0;
+    virtual void insert(int id, const cv::Point3f& p) = 0;
+
+    // 最近节点的 id，索引为空时返回 -1
+    virtual int nearest(const cv::Point3f& q) const = 0;
+
+    // 距离 q 不超过 radius 的所有节点 id (顺序不保证)
+    virtual void withinRadius(const cv::Point3f& q, float radius, std::vector<int>& out) const = 0;
+
+    virtual size_t size() const = 0;
+    virtual NNIndexType type() const = 0;
+};
+
+/**
+ * @brief 创建最近邻索引
+ * @param lo, hi 工作空间边界 (网格哈希用来划分格子，边界外的点也能插入，只是慢一点)
+ * @param cellSize 网格边长 (只对 GridHash 有效)，一般取 RRT 步长的 2 倍左右
+ */
+std::unique_ptr<NearestNeighborIndex> createNearestNeighborIndex(NNIndexType type,
+                                                                 const cv::Point3f& lo,
+                                                                 const cv::Point3f& hi,
+                                                                 float cellSize = 0.1f);
+
+#endif // NEARESTNEIGHBOR_H
@@ -0,0 +1,307 @@
+#include "PathSmoother.h"
+#include <QDebug>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <tuple>
+
+namespace {
+const double kQuantum = 1e-4;           // 缓存键的量化步长 (0.1mm)，远小于碰撞余量
+const double kCornerAngle = 0.01;       // 折线上转角超过它 (rad) 视为拐点，必须停稳
+const float kInsertRatio = 0.15f;       // 样条碰撞时在段两端 15% 处加控制点
+
+double dist(const cv::Point3f& a, const cv::Point3f& b) {
+    return cv::norm(b - a);
+}
+
+cv::Point3f lerp(const cv::Point3f& a, const cv::Point3f& b, float t) {
+    return a + (b - a) * t;
+}
+
+// 向心 Catmull-Rom (alpha = 0.5)，在 p1 -> p2 之间取 count 个点 (含 p1，不含 p2)
+void sampleCatmullRom(const cv::Point3f& p0, const cv::Point3f& p1, const cv::Point3f& p2, const cv::Point3f& p3,
+                      int count, std::vector<cv::Point3f>& out) {
+    const double eps = 1e-6;
+    const double t0 = 0.0;
+    const double t1 = t0 + std::sqrt(dist(p0, p1)) + eps;
+    const double t2 = t1 + std::sqrt(dist(p1, p2)) + eps;
+    const double t3 = t2 + std::sqrt(dist(p2, p3)) + eps;
+    for (int k = 0; k < count; ++k) {
+        const double t = t1 + (t2 - t1) * k / count;
+        const cv::Point3f a1 = p0 * float((t1 - t) / (t1 - t0)) + p1 * float((t - t0) / (t1 - t0));
+        const cv::Point3f a2 = p1 * float((t2 - t) / (t2 - t1)) + p2 * float((t - t1) / (t2 - t1));
+        const cv::Point3f a3 = p2 * float((t3 - t) / (t3 - t2)) + p3 * float((t - t2) / (t3 - t2));
+        const cv::Point3f b1 = a1 * float((t2 - t) / (t2 - t0)) + a2 * float((t - t0) / (t2 - t0));
+        const cv::Point3f b2 = a2 * float((t3 - t) / (t3 - t1)) + a3 * float((t - t1) / (t3 - t1));
+        out.push_back(b1 * float((t2 - t) / (t2 - t1)) + b2 * float((t - t1) / (t2 - t1)));
+    }
+}
+
+// 三点外接圆曲率 (Menger): 4 * 面积 / (三边之积)
+double mengerCurvature(const cv::Point3f& a, const cv::Point3f& b, const cv::Point3f& c) {
+    const double ab = dist(a, b), bc = dist(b, c), ac = dist(a, c);
+    if (ab < 1e-9 || bc < 1e-9 || ac < 1e-9) return 0.0;
+    const double area2 = cv::norm((b - a).cross(c - a));
+    return 2.0 * area2 / (ab * bc * ac);
+}
+
+// 折线在 b 处的转角
+double turnAngle(const cv::Point3f& a, const cv::Point3f& b, const cv::Point3f& c) {
+    const cv::Point3f u = b - a, v = c - b;
+    const double nu = cv::norm(u), nv = cv::norm(v);
+    if (nu < 1e-9 || nv < 1e-9) return 0.0;
+    const double cosA = std::max(-1.0, std::min(1.0, double(u.dot(v)) / (nu * nv)));
+    return std::acos(cosA);
+}
+}
+
+PathSmoother::PathSmoother(const CollisionChecker& checker, const SmootherOptions& options)
+    : m_checker(checker)
+    , m_options(options)
+{
+}
+
+double PathSmoother::pathLength(const std::vector<cv::Point3f>& path) {
+    double len = 0.0;
+    for (size_t i = 1; i < path.size(); ++i) len += dist(path[i - 1], path[i]);
+    return len;
+}
+
+bool PathSmoother::segmentFree(const cv::Point3f& a, const cv::Point3f& b) {
+    // 端点量化后排序，a->b 和 b->a 是同一个键
+    SegmentKey key;
+    const cv::Point3f *lo = &a, *hi = &b;
+    if (std::tie(b.x, b.y, b.z) < std::tie(a.x, a.y, a.z)) std::swap(lo, hi);
+    const float coords[6] = {lo->x, lo->y, lo->z, hi->x, hi->y, hi->z};
+    for (int i = 0; i < 6; ++i) key.q[i] = int32_t(std::lround(coords[i] / kQuantum));
+
+    auto it = m_cache.find(key);
+    if (it != m_cache.end()) {
+        ++m_hits;
+        return it->second;
+    }
+    ++m_checks;
+    const bool free = !m_checker.segmentCollides(a, b, m_options.threshold);
+    m_cache.emplace(key, free);
+    return free;
+}
+
+std::vector<cv::Point3f> PathSmoother::shortcut(const std::vector<cv::Point3f>& path) {
+    if (path.size() < 3) return path;
+
+    // 1. 贪心: 每个点直接连到能看到的最远点
+    auto greedy = [this](const std::vector<cv::Point3f>& in) {
+        std::vector<cv::Point3f> out{in.front()};
+        size_t i = 0;
+        while (i + 1 < in.size()) {
+            size_t j = in.size() - 1;
+            while (j > i + 1 && !segmentFree(in[i], in[j])) --j;
+            out.push_back(in[j]);
+            i = j;
+        }
+        return out;
+    };
+    std::vector<cv::Point3f> pts = greedy(path);
+
+    // 2. 随机: 在两条不同的边上各取一点，能直连就把中间剪掉 (路径长度只减不增)
+    std::mt19937 gen(m_options.seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<double> cum;
+    for (int iter = 0; iter < m_options.shortcutIterations && pts.size() >= 3; ++iter) {
+        cum.assign(1, 0.0);
+        for (size_t i = 1; i < pts.size(); ++i) cum.push_back(cum.back() + dist(pts[i - 1], pts[i]));
+        double s1 = unit(gen) * cum.back(), s2 = unit(gen) * cum.back();
+        if (s1 > s2) std::swap(s1, s2);
+        const size_t i1 = std::min(pts.size() - 2, size_t(std::upper_bound(cum.begin(), cum.end(), s1) - cum.begin()) - 1);
+        const size_t i2 = std::min(pts.size() - 2, size_t(std::upper_bound(cum.begin(), cum.end(), s2) - cum.begin()) - 1);
+        if (i1 == i2) continue;
+
+        auto at = [&](size_t i, double s) {
+            const double seg = cum[i + 1] - cum[i];
+            return lerp(pts[i], pts[i + 1], seg > 0.0 ? float((s - cum[i]) / seg) : 0.0f);
+        };
+        const cv::Point3f a = at(i1, s1), b = at(i2, s2);
+        if (!segmentFree(a, b)) continue;
+
+        std::vector<cv::Point3f> next(pts.begin(), pts.begin() + i1 + 1);
+        if (dist(next.back(), a) > 1e-6) next.push_back(a);
+        next.push_back(b);
+        if (dist(b, pts[i2 + 1]) <= 1e-6) next.pop_back();
+        next.insert(next.end(), pts.begin() + i2 + 1, pts.end());
+        pts.swap(next);
+    }
+
+    // 3. 随机捷径会留下可以再合并的点，最后再贪心一遍
+    return greedy(pts);
+}
+
+std::vector<cv::Point3f> PathSmoother::fitSpline(const std::vector<cv::Point3f>& waypoints, int* linearSpans) {
+    if (linearSpans) *linearSpans = 0;
+    if (waypoints.size() < 3) return resamplePolyline(waypoints);
+
+    std::vector<cv::Point3f> ctrl = waypoints;
+    std::vector<char> linear(ctrl.size() - 1, 0);     // 第 i 段 (ctrl[i] -> ctrl[i+1]) 是否退化为直线
+    std::vector<cv::Point3f> samples;
+    std::vector<size_t> spanStart;                     // 每段第一个采样点在 samples 里的下标
+
+    for (int round = 0; ; ++round) {
+        // 1. 采样 (首尾外插一个虚拟点，使端点处切线沿着第一 / 最后一段)
+        samples.clear();
+        spanStart.clear();
+        const size_t n = ctrl.size();
+        for (size_t i = 0; i + 1 < n; ++i) {
+            spanStart.push_back(samples.size());
+            const int count = std::max(1, int(std::ceil(dist(ctrl[i], ctrl[i + 1]) / m_options.sampleStep)));
+            if (linear[i]) {
+                for (int k = 0; k < count; ++k) samples.push_back(lerp(ctrl[i], ctrl[i + 1], float(k) / count));
+                continue;
+            }
+            const cv::Point3f p0 = i > 0 ? ctrl[i - 1] : ctrl[0] * 2.0f - ctrl[1];
+            const cv::Point3f p3 = i + 2 < n ? ctrl[i + 2] : ctrl[n - 1] * 2.0f - ctrl[n - 2];
+            sampleCatmullRom(p0, ctrl[i], ctrl[i + 1], p3, count, samples);
+        }
+        samples.push_back(ctrl.back());
+        spanStart.push_back(samples.size() - 1);
+
+        // 2. 逐段检测
+        std::vector<size_t> blocked;
+        for (size_t i = 0; i + 1 < n; ++i) {
+            if (linear[i]) continue;
+            for (size_t k = spanStart[i]; k < spanStart[i + 1]; ++k) {
+                if (!segmentFree(samples[k], samples[k + 1])) {
+                    blocked.push_back(i);
+                    break;
+                }
+            }
+        }
+        if (blocked.empty()) break;
+
+        // 3. 最后一轮: 仍碰撞的段直接走直线 (直线段是捷径的一部分，一定无碰撞)
+        if (round >= m_options.refineRounds) {
+            for (size_t i : blocked) linear[i] = 1;
+            if (linearSpans) *linearSpans = int(blocked.size());
+            continue;
+        }
+
+        // 4. 在碰撞段两端附近加控制点，把样条往原来的折线上拉
+        std::vector<cv::Point3f> nextCtrl;
+        std::vector<char> nextLinear;
+        size_t b = 0;
+        for (size_t i = 0; i + 1 < n; ++i) {
+            nextCtrl.push_back(ctrl[i]);
+            if (b < blocked.size() && blocked[b] == i) {
+                ++b;
+                nextCtrl.push_back(lerp(ctrl[i], ctrl[i + 1], kInsertRatio));
+                nextCtrl.push_back(lerp(ctrl[i], ctrl[i + 1], 1.0f - kInsertRatio));
+                nextLinear.insert(nextLinear.end(), 3, 0);
+            } else {
+                nextLinear.push_back(linear[i]);
+            }
+        }
+        nextCtrl.push_back(ctrl.back());
+        ctrl.swap(nextCtrl);
+        linear.swap(nextLinear);
+    }
+    return samples;
+}
+
+std::vector<cv::Point3f> PathSmoother::resamplePolyline(const std::vector<cv::Point3f>& path, std::vector<char>* corners) const {
+    std::vector<cv::Point3f> out;
+    if (corners) corners->clear();
+    for (size_t i = 0; i + 1 < path.size(); ++i) {
+        const int count = std::max(1, int(std::ceil(dist(path[i], path[i + 1]) / m_options.sampleStep)));
+        for (int k = 0; k < count; ++k) {
+            out.push_back(lerp(path[i], path[i + 1], float(k) / count));
+            if (corners) {
+                const bool corner = k == 0 && i > 0 && turnAngle(path[i - 1], path[i], path[i + 1]) > kCornerAngle;
+                corners->push_back(corner);
+            }
+        }
+    }
+    if (!path.empty()) {
+        out.push_back(path.back());
+        if (corners) corners->push_back(0);
+    }
+    return out;
+}
+
+TimedTrajectory PathSmoother::parameterize(const std::vector<cv::Point3f>& samples, const std::vector<char>* stops) const {
+    TimedTrajectory traj;
+    const size_t n = samples.size();
+    if (n == 0) return traj;
+    traj.samples.resize(n);
+    for (size_t i = 0; i < n; ++i) traj.samples[i].pos = samples[i];
+    if (n == 1) return traj;
+
+    const double vmax = m_options.maxVel, amax = m_options.maxAcc;
+    std::vector<double> ds(n - 1), vlim(n), v(n);
+
+    // 1. 速度上限曲线: 最大速度 + 法向加速度 (曲率)，首尾和强制停点为 0
+    for (size_t i = 0; i + 1 < n; ++i) ds[i] = dist(samples[i], samples[i + 1]);
+    for (size_t i = 0; i < n; ++i) {
+        double lim = vmax;
+        if (i == 0 || i + 1 == n || (stops && (*stops)[i])) {
+            lim = 0.0;
+        } else {
+            const double k = mengerCurvature(samples[i - 1], samples[i], samples[i + 1]);
+            if (k > 1e-9) lim = std::min(lim, std::sqrt(amax / k));
+        }
+        vlim[i] = lim;
+    }
+
+    // 2. 前向: 加速度限制；后向: 减速度限制
+    v[0] = 0.0;
+    for (size_t i = 0; i + 1 < n; ++i) v[i + 1] = std::min(vlim[i + 1], std::sqrt(v[i] * v[i] + 2.0 * amax * ds[i]));
+    for (size_t i = n - 1; i > 0; --i) v[i - 1] = std::min(v[i - 1], std::sqrt(v[i] * v[i] + 2.0 * amax * ds[i - 1]));
+
+    // 3. 每段按匀加速计算用时: dt = 2 ds / (v0 + v1)
+    double t = 0.0, s = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        TrajectorySample &smp = traj.samples[i];
+        if (i > 0) {
+            const double vs = v[i - 1] + v[i];
+            t += vs > 1e-12 ? 2.0 * ds[i - 1] / vs : 0.0;
+            s += ds[i - 1];
+        }
+        smp.t = t;
+        smp.s = s;
+        smp.speed = v[i];
+        // 速度方向取前后两点的差分
+        const cv::Point3f dir = samples[std::min(i + 1, n - 1)] - samples[i > 0 ? i - 1 : 0];
+        const double len = cv::norm(dir);
+        smp.vel = len > 1e-12 ? dir * float(v[i] / len) : cv::Point3f(0, 0, 0);
+    }
+    traj.length = s;
+    traj.duration = t;
+    return traj;
+}
+
+TimedTrajectory PathSmoother::process(const std::vector<cv::Point3f>& path, SmoothingReport* report) {
+    const auto t0 = std::chrono::steady_clock::now();
+    const uint64_t checks0 = m_checks, hits0 = m_hits;
+
+    const std::vector<cv::Point3f> waypoints = shortcut(path);
+    int linearSpans = 0;
+    const std::vector<cv::Point3f> samples = fitSpline(waypoints, &linearSpans);
+    TimedTrajectory traj = parameterize(samples);
+
+    if (report) {
+        std::vector<char> corners;
+        const std::vector<cv::Point3f> raw = resamplePolyline(path, &corners);
+        report->rawWaypoints = path.size();
+        report->shortcutWaypoints = waypoints.size();
+        report->rawLength = pathLength(path);
+        report->shortcutLength = pathLength(waypoints);
+        report->smoothLength = traj.length;
+        report->rawDuration = parameterize(raw, &corners).duration;
+        report->smoothDuration = traj.duration;
+        report->collisionChecks = m_checks - checks0;
+        report->cacheHits = m_hits - hits0;
+        report->linearSpans = linearSpans;
+        report->elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        qDebug() << "✂️ 路径平滑:" << report->rawWaypoints << "->" << report->shortcutWaypoints << "个点 | 长度"
+                 << report->rawLength << "->" << report->smoothLength << "m | 时间"
+                 << report->rawDuration << "->" << report->smoothDuration << "s | 用时" << report->elapsedMs << "ms";
+    }
+    return traj;
+}
@@ -0,0 +1,129 @@
+#ifndef PATHSMOOTHER_H
+#define PATHSMOOTHER_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include "CollisionChecker.h"
+
+// 带时间的轨迹采样点
+struct TrajectorySample {
+    double t = 0.0;             // 秒
+    double s = 0.0;             // 沿路径的弧长 (米)
+    cv::Point3f pos;
+    cv::Point3f vel;            // m/s
+    double speed = 0.0;         // |vel|
+};
+
+struct TimedTrajectory {
+    std::vector<TrajectorySample> samples;
+    double length = 0.0;        // 米
+    double duration = 0.0;      // 秒
+};
+
+struct SmootherOptions {
+    int shortcutIterations = 200;   // 随机捷径的尝试次数
+    uint32_t seed = 1;              // 随机捷径的种子 (同样的输入 + 种子 = 同样的输出)
+    float threshold = 0.05f;        // 碰撞安全余量，与规划时一致
+    double maxVel = 0.1;            // m/s (MainWindow::MOVE_VEL)
+    double maxAcc = 0.5;            // m/s^2 (MainWindow::MOVE_ACC)，切向和法向分别限制
+    double sampleStep = 0.005;      // 样条 / 时间参数化的弧长采样间隔 (米)
+    int refineRounds = 3;           // 样条碰撞时在拐点附近加控制点的轮数，仍碰撞的段退化为直线
+};
+
+// 一次平滑的前后对比
+struct SmoothingReport {
+    size_t rawWaypoints = 0;
+    size_t shortcutWaypoints = 0;
+    double rawLength = 0.0;         // 米
+    double shortcutLength = 0.0;
+    double smoothLength = 0.0;
+    double rawDuration = 0.0;       // 原始折线按同样的速度/加速度限制走完的时间 (秒)
+    double smoothDuration = 0.0;
+    uint64_t collisionChecks = 0;   // 实际做的线段碰撞检测次数
+    uint64_t cacheHits = 0;         // 被缓存挡掉的重复检测次数
+    int linearSpans = 0;            // 样条碰撞、退化为直线的段数
+    double elapsedMs = 0.0;
+};
+
+/**
+ * @brief RRT 路径后处理: 捷径剪枝 -> 样条拟合 -> 时间参数化
+ *
+ * 1. 贪心捷径: 从起点开始，找能直接无碰撞连到的最远路径点；
+ *    随机捷径: 在路径上随机取两点 (按弧长)，能直连就替换中间部分。
+ *    线段碰撞结果按端点 (0.1mm 量化) 缓存，重复检测直接命中。
+ * 2. 过捷径点的向心 Catmull-Rom 样条，按采样点逐段做碰撞检测；碰撞的段在拐点附近加控制点收紧，
+ *    几轮后仍碰撞就退化为直线。
+ * 3. TOPP 式前向 / 后向两遍积分: 速度上限取 min(maxVel, sqrt(maxAcc / 曲率))，切向加速度不超过 maxAcc，
+ *    起点终点速度为 0。
+ */
+class PathSmoother
+{
+public:
+    explicit PathSmoother(const CollisionChecker& checker, const SmootherOptions& options = SmootherOptions());
+
+    void setOptions(const SmootherOptions& options) { m_options = options; }
+    const SmootherOptions& options() const { return m_options; }
+
+    /**
+     * @brief 完整流程
+     * @param path planPath 返回的原始路径
+     * @param report 可选，输出前后对比
+     */
+    TimedTrajectory process(const std::vector<cv::Point3f>& path, SmoothingReport* report = nullptr);
+
+    // 只做捷径剪枝，返回新的路径点 (首尾不变)
+    std::vector<cv::Point3f> shortcut(const std::vector<cv::Point3f>& path);
+
+    // 只做样条拟合，返回按 sampleStep 采样的无碰撞几何路径
+    std::vector<cv::Point3f> fitSpline(const std::vector<cv::Point3f>& waypoints, int* linearSpans = nullptr);
+
+    /**
+     * @brief 只做时间参数化
+     * @param samples 密集采样的几何路径
+     * @param stops 可选，与 samples 等长，非 0 的点必须停稳 (折线拐点，曲率无穷大)
+     */
+    TimedTrajectory parameterize(const std::vector<cv::Point3f>& samples, const std::vector<char>* stops = nullptr) const;
+
+    /**
+     * @brief 按 sampleStep 重新采样折线，原来的路径点都保留 (用来评估原始路径的执行时间)
+     * @param corners 可选，输出每个采样点是不是拐点
+     */
+    std::vector<cv::Point3f> resamplePolyline(const std::vector<cv::Point3f>& path, std::vector<char>* corners = nullptr) const;
+
+    static double pathLength(const std::vector<cv::Point3f>& path);
+
+    // 缓存 (障碍物变化后需要清空)
+    void clearCache() { m_cache.clear(); }
+    uint64_t collisionChecks() const { return m_checks; }
+    uint64_t cacheHits() const { return m_hits; }
+
+private:
+    // 线段是否无碰撞 (带缓存)
+    bool segmentFree(const cv::Point3f& a, const cv::Point3f& b);
+
+    struct SegmentKey {
+        int32_t q[6];
+        bool operator==(const SegmentKey& o) const {
+            for (int i = 0; i < 6; ++i) if (q[i] != o.q[i]) return false;
+            return true;
+        }
+    };
+    struct SegmentKeyHash {
+        size_t operator()(const SegmentKey& k) const {
+            uint64_t h = 1469598103934665603ull;
+            for (int i = 0; i < 6; ++i) h = (h ^ uint32_t(k.q[i])) * 1099511628211ull;
+            return size_t(h);
+        }
+    };
+
+    const CollisionChecker& m_checker;
+    SmootherOptions m_options;
+    std::unordered_map<SegmentKey, bool, SegmentKeyHash> m_cache;
+    uint64_t m_checks = 0;
+    uint64_t m_hits = 0;
+};
+
+#endif // PATHSMOOTHER_H
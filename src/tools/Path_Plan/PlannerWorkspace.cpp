@@ -0,0 +1,20 @@
+#include "PlannerWorkspace.h"
+
+PlannerWorkspace::PlannerWorkspace() {
+    std::random_device rd;
+    gen.seed(rd());
+}
+
+NearestNeighborIndex& PlannerWorkspace::resetIndex(int k, NNIndexType type, const cv::Point3f& lo,
+                                                   const cv::Point3f& hi, float cellSize) {
+    IndexSlot &slot = m_index[k];
+    if (!slot.index || slot.index->type() != type || slot.lo != lo || slot.hi != hi || slot.cellSize != cellSize) {
+        slot.index = createNearestNeighborIndex(type, lo, hi, cellSize);
+        slot.lo = lo;
+        slot.hi = hi;
+        slot.cellSize = cellSize;
+    } else {
+        slot.index->clear();
+    }
+    return *slot.index;
+}
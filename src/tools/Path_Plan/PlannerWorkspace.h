@@ -0,0 +1,103 @@
+#ifndef PLANNERWORKSPACE_H
+#define PLANNERWORKSPACE_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+#include "NearestNeighbor.h"
+#include "CollisionChecker.h"
+
+/**
+ * @brief 树节点的 SoA 存储: x[] / y[] / z[] / parent[] 分开存
+ *
+ * 节点只增不删，id 就是下标 (和原来 std::vector<Node> 的下标一致)。
+ * clear() 只把长度清零、不释放内存，同一个实例反复规划时不再重新分配 (相当于按最大树大小预留的内存池)。
+ */
+class NodeArena
+{
+public:
+    void clear() { m_x.clear(); m_y.clear(); m_z.clear(); m_parent.clear(); }
+    void reserve(size_t n) { m_x.reserve(n); m_y.reserve(n); m_z.reserve(n); m_parent.reserve(n); }
+
+    int push(const cv::Point3f& p, int parent) {
+        m_x.push_back(p.x);
+        m_y.push_back(p.y);
+        m_z.push_back(p.z);
+        m_parent.push_back(parent);
+        return (int)m_parent.size() - 1;
+    }
+
+    size_t size() const { return m_parent.size(); }
+    cv::Point3f pos(int id) const { return cv::Point3f(m_x[id], m_y[id], m_z[id]); }
+    cv::Point3f back() const { return pos((int)size() - 1); }
+    int parent(int id) const { return m_parent[id]; }
+    void setParent(int id, int parent) { m_parent[id] = parent; }
+
+    // 从 id 沿父节点回溯到根，依次追加到 out (终点在前)
+    void traceToRoot(int id, std::vector<cv::Point3f>& out) const {
+        for (; id != -1; id = m_parent[id]) out.push_back(pos(id));
+    }
+
+private:
+    std::vector<float> m_x, m_y, m_z;
+    std::vector<int> m_parent;
+};
+
+/**
+ * @brief 一次规划需要的全部可变状态，跨多次规划复用
+ *
+ * 规划器本身 (障碍物、步长、边界等参数) 在规划时只读，所以多个线程可以共享一个规划器，
+ * 各自带一个工作区并发规划 (RRTPlanner::planBatch 就是这样做的)。
+ * 里面的节点、索引、缓冲区每次规划开始时清空，容量保留，稳定运行后规划过程中基本不再分配内存。
+ * 一个工作区同一时刻只能给一个线程用。
+ */
+class PlannerWorkspace
+{
+public:
+    // 用 std::random_device 取种子 (需要复现时用 seed 覆盖)
+    PlannerWorkspace();
+    explicit PlannerWorkspace(uint32_t seed) : gen(seed) {}
+
+    PlannerWorkspace(const PlannerWorkspace&) = delete;
+    PlannerWorkspace& operator=(const PlannerWorkspace&) = delete;
+
+    void seed(uint32_t s) { gen.seed(s); }
+
+    /**
+     * @brief 取第 k 棵树 (0 / 1) 的最近邻索引并清空
+     * 类型或边界和上次不同时才重新创建，否则复用原来的内存
+     */
+    NearestNeighborIndex& resetIndex(int k, NNIndexType type, const cv::Point3f& lo, const cv::Point3f& hi,
+                                     float cellSize);
+
+    // 随机数引擎 (采样和目标偏向共用一个，保证给定种子时结果可复现)
+    std::mt19937 gen;
+
+    // 两棵树 (单树算法只用 trees[0]) 和各自的最近邻索引
+    NodeArena trees[2];
+
+    // RRT* 用: 代价和子节点链表 (firstChild / nextSibling，重连时不必给每个节点分配一个 vector)
+    std::vector<float> cost;
+    std::vector<int> firstChild, nextSibling;
+    std::vector<int> nearIds, stack;
+    std::vector<std::pair<float, int>> candidates;
+
+    // 碰撞检测的查询缓冲区 (障碍物在规划器里共享)
+    CollisionChecker::QueryScratch collision;
+
+    // 输出路径 (规划结果先写在这里，RRT* 的改进回调也直接给这个缓冲区)
+    std::vector<cv::Point3f> path;
+
+private:
+    struct IndexSlot {
+        std::unique_ptr<NearestNeighborIndex> index;
+        cv::Point3f lo, hi;
+        float cellSize = 0.0f;
+    };
+    IndexSlot m_index[2];
+};
+
+#endif // PLANNERWORKSPACE_H
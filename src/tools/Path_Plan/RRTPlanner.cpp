@@ -1,148 +1,718 @@
 #include "RRTPlanner.h"
 #include <QDebug>
 #include <limits>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include "ThreadPool.h"
+#include "tools/Trace/LatencyTrace.h"
+
+namespace {
+double elapsedMs(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+}
+}
 
 RRTPlanner::RRTPlanner() {
-    // 初始化随机数种子，这里可以留空
+    // 随机数种子在 m_workspace 构造时用 std::random_device 初始化 (需要复现时用 setSeed 覆盖)
 }
 
 void RRTPlanner::addObstacle(const SphereObstacle& obs) {
-    m_obstacles.push_back(obs);
+    m_collision.addObstacle(obs);
 }
 
 // 碰撞检测
 bool RRTPlanner::checkCollision(const cv::Point3f& p1, const cv::Point3f& p2, float threshold) {
     /*
     通过将三维空间中的线段与球形障碍物进行几何计算，实现碰撞检测
+    具体实现见 CollisionChecker: 先用均匀网格筛出线段附近的球，再按 SoA 布局一次测一组球
     */
-    for (const auto& obs : m_obstacles) {
-        float safeRadius = obs.radius + threshold;
-        cv::Point3f d = p2 - p1;
-        cv::Point3f f = p1 - obs.center;
-        float a = d.dot(d);
-        float b = 2.0f * f.dot(d);
-        float c = f.dot(f) - safeRadius * safeRadius;
-
-        // 处理 a 接近 0 的情况（即P1、P2重合），避免除以零
-        if (std::abs(a) < 1e-6) {
-            if (c < 0) return true;
-            continue;
-        }
+    return m_collision.segmentCollides(p1, p2, threshold);
+}
 
-        float delta = b*b - 4*a*c;
-        if (delta < 0) continue;
+// ================= RRT 核心实现 =================
 
-        delta = std::sqrt(delta);
-        float t1 = (-b - delta) / (2*a);
-        float t2 = (-b + delta) / (2*a);
+std::vector<cv::Point3f> RRTPlanner::planPath(const cv::Point3f& start, const cv::Point3f& goal) {
+    std::vector<cv::Point3f> path;
+    planPath(start, goal, path);
+    return path;
+}
+
+bool RRTPlanner::planPath(const cv::Point3f& start, const cv::Point3f& goal, std::vector<cv::Point3f>& path) {
+    UR_TRACE_SCOPE("plan.path");
+    const auto tStart = std::chrono::steady_clock::now();
+    m_stats = PlanStats();
+    m_collision.prepare();
+
+    const bool found = m_mode == PlannerMode::Parallel
+                           ? planParallel(start, goal)
+                           : planWith(m_mode, start, goal, m_workspace, m_stats, &m_cancel, m_onImproved);
+    if (found) path.assign(m_workspace.path.begin(), m_workspace.path.end());
+    else path.clear();
+    finishPlan(path, tStart);
+    return found;
+}
+
+std::vector<cv::Point3f> RRTPlanner::planPath(const cv::Point3f& start, const cv::Point3f& goal,
+                                              std::chrono::microseconds budget) {
+    UR_TRACE_SCOPE("plan.path");
+    const auto tStart = std::chrono::steady_clock::now();
+    m_stats = PlanStats();
+    m_collision.prepare();
+
+    std::vector<cv::Point3f> path;
+    if (planStar(start, goal, m_workspace, m_stats, &m_cancel, tStart + budget, true, m_onImproved)) {
+        path = m_workspace.path;
+    }
+    finishPlan(path, tStart);
+    return path;
+}
 
-        if (t1 <= 1.0f && t2 >= 0.0f) return true;
+bool RRTPlanner::planWith(PlannerMode mode, const cv::Point3f& start, const cv::Point3f& goal, PlannerWorkspace& ws,
+                          PlanStats& stats, const std::atomic<bool>* cancel,
+                          const ImprovementCallback& onImproved) const {
+    switch (mode) {
+    case PlannerMode::RRT:        return planSingleTree(start, goal, ws, stats, cancel);
+    case PlannerMode::RRTConnect: return planConnect(start, goal, ws, stats, cancel);
+    case PlannerMode::RRTStar:
+        return planStar(start, goal, ws, stats, cancel, std::chrono::steady_clock::time_point::max(), false,
+                        onImproved);
+    case PlannerMode::Parallel:   break;
     }
     return false;
 }
 
-// ================= RRT 核心实现 =================
+void RRTPlanner::finishStats(const std::vector<cv::Point3f>& path, PlanStats& stats,
+                             std::chrono::steady_clock::time_point tStart, bool cancelled) const {
+    for (size_t k = 1; k < path.size(); ++k) stats.pathLength += distance(path[k - 1], path[k]);
+    stats.success = !path.empty();
+    stats.totalMs = elapsedMs(tStart);
+    stats.cancelled = cancelled;
+    if (stats.success && stats.costCurve.empty()) {
+        stats.firstSolutionMs = stats.totalMs;
+        stats.firstPathLength = stats.pathLength;
+    }
+}
 
-std::vector<cv::Point3f> RRTPlanner::planPath(const cv::Point3f& start, const cv::Point3f& goal) {
-    std::vector<Node> tree;
-    tree.push_back({start, -1}); // 1. 把起点加入树，它是根节点 (-1)
+void RRTPlanner::finishPlan(const std::vector<cv::Point3f>& path, std::chrono::steady_clock::time_point tStart) {
+    // 返回时才清除取消标志: 规划开始前 / 刚开始时别的线程调用的 cancel() 不会被吞掉
+    const bool cancelled = m_cancel.exchange(false, std::memory_order_relaxed);
+    finishStats(path, m_stats, tStart, cancelled);
+    if (!path.empty()) {
+        qDebug() << "✅ RRT 找到路径! 迭代次数:" << m_stats.iterations;
+    } else if (cancelled) {
+        qDebug() << "🛑 RRT 规划已取消";
+    } else {
+        qDebug() << "❌ RRT 失败: 达到最大迭代次数 / 时间预算";
+    }
+}
 
-    // 随机数引擎（三件套）
-    std::random_device rd;
-    std::mt19937 gen(rd());     // 返回一个 32 位伪随机整数
+// ----------------- 1. 单棵树 RRT (原始实现) -----------------
+bool RRTPlanner::planSingleTree(const cv::Point3f& start, const cv::Point3f& goal, PlannerWorkspace& ws,
+                                PlanStats& stats, const std::atomic<bool>* cancel) const {
+    NodeArena &tree = ws.trees[0];
+    tree.clear();
+    tree.push(start, -1); // 1. 把起点加入树，它是根节点 (-1)
+
+    // 最近邻索引: 与 tree 同步插入
+    NearestNeighborIndex &index = resetIndex(ws, 0);
+    index.insert(0, start);
+
+    // 随机数: 引擎在工作区里 (可用 setSeed 固定)，这里只定义分布
     std::uniform_real_distribution<> dis(0.0, 1.0);      // 生成 [0, 1) 之间的随机数
 
     bool reached = false;
     int goalNodeId = -1;
 
     // 2. 开始循环生长
-    for (int i = 0; i < m_maxIter; ++i) {
+    int i = 0;
+    for (; i < m_maxIter; ++i) {
+        if (cancel && cancel->load(std::memory_order_relaxed)) break;
+
         // A. 采样: 有一定概率直接选终点作为方向 (Goal Bias)
         cv::Point3f rndPoint;
         /* 
-        dis(gen) 把引擎 gen 吐出的 raw 随机数，按 dis 设定的概率规律（即 [0, 1)）重新洗牌后输出
+        dis(ws.gen) 把引擎 ws.gen 吐出的 raw 随机数，按 dis 设定的概率规律（即 [0, 1)）重新洗牌后输出
         */
-        if (dis(gen) < m_goalBias) {         // 有一定概率直接选终点作为方向 (Goal Bias)
+        if (dis(ws.gen) < m_goalBias) {        // 有一定概率直接选终点作为方向 (Goal Bias)
             rndPoint = goal;
         } else {
-            rndPoint = getRandomPoint(goal); // 否则全图随机撒点
+            rndPoint = getRandomPoint(ws.gen); // 否则全图随机撒点
         }
 
         // B. 找最近: 树上哪个点离这个随机点最近
-        int nearestId = getNearestNodeId(tree, rndPoint);
-        cv::Point3f nearestPoint = tree[nearestId].pos;
+        int nearestId = getNearestNodeId(index, rndPoint, stats);
+        cv::Point3f nearestPoint = tree.pos(nearestId);
 
         // C. 生长: 往那个方向迈一小步 (Step Size)
         cv::Point3f newPoint = step(nearestPoint, rndPoint);
 
         // D. 检测: 这一步有没有撞墙?
-        if (!checkCollision(nearestPoint, newPoint)) {
-            // 没撞! 加入树
-            Node newNode;
-            newNode.pos = newPoint;
-            newNode.parentId = nearestId; // 记录父节点
-            tree.push_back(newNode);
+        if (!segmentBlocked(nearestPoint, newPoint, ws, stats)) {
+            // 没撞! 加入树，记录父节点
+            const int newId = tree.push(newPoint, nearestId);
+            index.insert(newId, newPoint);
 
             // E. 判断: 到终点了吗? (距离小于一步长)
             if (distance(newPoint, goal) < m_stepSize) {
                 reached = true;
-                goalNodeId = tree.size() - 1;
-                qDebug() << "✅ RRT 找到路径! 迭代次数:" << i;
+                goalNodeId = newId;
                 break;
             }
         }
     }
 
+    stats.iterations = reached ? i + 1 : i;
+    stats.treeSize = tree.size();
+
     // 3. 回溯路径 (Backtracking)
-    std::vector<cv::Point3f> path;
+    ws.path.clear();
     if (reached) {
-        int currId = goalNodeId;
-        path.push_back(goal); // 先放终点
+        ws.path.push_back(goal); // 先放终点
+        tree.traceToRoot(goalNodeId, ws.path);
+        // 现在的路径是 终点->...->起点，需要反转
+        std::reverse(ws.path.begin(), ws.path.end());
+    }
+    return reached;
+}
 
-        while (currId != -1) {
-            path.push_back(tree[currId].pos);
-            currId = tree[currId].parentId; // 找爸爸
+// ----------------- 2. RRT-Connect -----------------
+// 从 tree 里离 target 最近的节点向 target 迈一步
+RRTPlanner::ExtendResult RRTPlanner::extend(NodeArena& tree, NearestNeighborIndex& index, const cv::Point3f& target,
+                                            PlannerWorkspace& ws, PlanStats& stats) const {
+    const int nearestId = getNearestNodeId(index, target, stats);
+    const cv::Point3f nearestPoint = tree.pos(nearestId);
+    const cv::Point3f newPoint = step(nearestPoint, target);
+    if (segmentBlocked(nearestPoint, newPoint, ws, stats)) return ExtendResult::Trapped;
+
+    index.insert(tree.push(newPoint, nearestId), newPoint);
+    // step() 在距离小于步长时直接返回 target
+    return (newPoint.x == target.x && newPoint.y == target.y && newPoint.z == target.z)
+               ? ExtendResult::Reached : ExtendResult::Advanced;
+}
+
+bool RRTPlanner::planConnect(const cv::Point3f& start, const cv::Point3f& goal, PlannerWorkspace& ws,
+                             PlanStats& stats, const std::atomic<bool>* cancel) const {
+    // 两棵树: 一棵从起点长，一棵从终点长；每轮交换角色
+    NodeArena &treeStart = ws.trees[0], &treeGoal = ws.trees[1];
+    treeStart.clear();
+    treeGoal.clear();
+    treeStart.push(start, -1);
+    treeGoal.push(goal, -1);
+    NearestNeighborIndex &indexStart = resetIndex(ws, 0), &indexGoal = resetIndex(ws, 1);
+    indexStart.insert(0, start);
+    indexGoal.insert(0, goal);
+
+    NodeArena *treeA = &treeStart, *treeB = &treeGoal;
+    NearestNeighborIndex *indexA = &indexStart, *indexB = &indexGoal;
+
+    bool connected = false;
+    int i = 0;
+    for (; i < m_maxIter; ++i) {
+        if (cancel && cancel->load(std::memory_order_relaxed)) break;
+
+        // A. 树 A 向随机点扩展一步
+        const cv::Point3f rndPoint = getRandomPoint(ws.gen);
+        if (extend(*treeA, *indexA, rndPoint, ws, stats) != ExtendResult::Trapped) {
+            // B. 树 B 朝 A 的新节点一直长 (贪心连接)，直到撞墙或连上
+            const cv::Point3f target = treeA->back();
+            ExtendResult r;
+            do {
+                r = extend(*treeB, *indexB, target, ws, stats);
+            } while (r == ExtendResult::Advanced);
+
+            if (r == ExtendResult::Reached) {
+                connected = true;
+                break;
+            }
         }
-        // 现在的路径是 终点->...->起点，需要反转
-        std::reverse(path.begin(), path.end());
+        std::swap(treeA, treeB);
+        std::swap(indexA, indexB);
+    }
+
+    stats.iterations = connected ? i + 1 : i;
+    stats.treeSize = treeStart.size() + treeGoal.size();
+
+    ws.path.clear();
+    if (!connected) return false;
+
+    // 两棵树的最后一个节点位置相同 (连接点)，各自回溯到根后拼起来
+    treeStart.traceToRoot((int)treeStart.size() - 1, ws.path);
+    std::reverse(ws.path.begin(), ws.path.end());                       // 起点 -> 连接点
+    treeGoal.traceToRoot(treeGoal.parent((int)treeGoal.size() - 1), ws.path);  // 连接点之后 -> 终点
+    return true;
+}
+
+// ----------------- 3. 多核并行 -----------------
+bool RRTPlanner::planParallel(const cv::Point3f& start, const cv::Point3f& goal) {
+    ThreadPool &pool = ThreadPool::shared();
+    const int workers = m_parallelWorkers > 0 ? m_parallelWorkers : (int)pool.threadCount();
+    const PlannerMode base = m_parallelBase == PlannerMode::RRT ? PlannerMode::RRT : PlannerMode::RRTConnect;
+
+    // 所有子规划器共享的状态 (等全部子任务结束后才离开本函数，所以放栈上即可)
+    struct Shared {
+        std::atomic<bool> cancel{false};
+        std::mutex mutex;
+        std::condition_variable done;
+        int remaining = 0;
+        int winner = -1;
+        double nearestMs = 0.0, collisionMs = 0.0;
+        int iterations = 0;
+        size_t treeSize = 0;
+    } shared;
+    shared.remaining = workers;
+
+    // 子规划器只各带一个工作区，障碍物和参数共享本规划器的 (只读)
+    ensureWorkerSpaces((size_t)workers);
+    for (int w = 0; w < workers; ++w) m_workerSpaces[w]->seed((uint32_t)m_workspace.gen());
+
+    for (int w = 0; w < workers; ++w) {
+        PlannerWorkspace *ws = m_workerSpaces[w].get();
+        pool.submit([this, ws, w, base, start, goal, &shared] {
+            PlanStats stats;
+            const bool found = base == PlannerMode::RRT
+                                   ? planSingleTree(start, goal, *ws, stats, &shared.cancel)
+                                   : planConnect(start, goal, *ws, stats, &shared.cancel);
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            shared.nearestMs += stats.nearestMs;
+            shared.collisionMs += stats.collisionMs;
+            shared.iterations += stats.iterations;
+            shared.treeSize += stats.treeSize;
+            if (found && shared.winner < 0) {
+                // 第一个成功的: 记下结果，通知其他规划器停止
+                shared.winner = w;
+                shared.cancel.store(true);
+            }
+            if (--shared.remaining == 0) shared.done.notify_one();
+        });
+    }
+
+    std::unique_lock<std::mutex> lock(shared.mutex);
+    // 等待期间转发外部的 cancel()
+    while (!shared.done.wait_for(lock, std::chrono::milliseconds(1), [&] { return shared.remaining == 0; })) {
+        if (m_cancel.load(std::memory_order_relaxed)) shared.cancel.store(true);
+    }
+
+    // 统计是所有子规划器的总和 (总工作量)
+    m_stats.workers = workers;
+    m_stats.iterations = shared.iterations;
+    m_stats.treeSize = shared.treeSize;
+    m_stats.nearestMs = shared.nearestMs;
+    m_stats.collisionMs = shared.collisionMs;
+    m_workspace.path.clear();
+    if (shared.winner < 0) return false;
+    m_workspace.path.swap(m_workerSpaces[shared.winner]->path);
+    return true;
+}
+
+// ----------------- 4. RRT* (渐进最优) -----------------
+bool RRTPlanner::planStar(const cv::Point3f& start, const cv::Point3f& goal, PlannerWorkspace& ws, PlanStats& stats,
+                          const std::atomic<bool>* cancel, std::chrono::steady_clock::time_point deadline,
+                          bool anytime, const ImprovementCallback& onImproved) const {
+    const auto tStart = std::chrono::steady_clock::now();
+    NodeArena &tree = ws.trees[0];
+    std::vector<float> &cost = ws.cost;             // 从起点沿树走到该节点的长度
+    // 重连后要把代价变化传给整棵子树: 子节点按链表存 (firstChild -> nextSibling -> ...)
+    std::vector<int> &firstChild = ws.firstChild, &nextSibling = ws.nextSibling;
+    tree.clear();
+    tree.push(start, -1);
+    cost.assign(1, 0.0f);
+    firstChild.assign(1, -1);
+    nextSibling.assign(1, -1);
+    NearestNeighborIndex &index = resetIndex(ws, 0);
+    index.insert(0, start);
+
+    auto addNode = [&](const cv::Point3f& p, int parent, float c) {
+        const int id = tree.push(p, parent);
+        cost.push_back(c);
+        firstChild.push_back(-1);
+        nextSibling.push_back(firstChild[parent]);
+        firstChild[parent] = id;
+        index.insert(id, p);
+        return id;
+    };
+
+    // 邻域半径 r = min(gamma * (log n / n)^(1/3), 3 倍步长)，gamma 按工作空间体积取 (Karaman & Frazzoli)
+    const float volume = (x_max - x_min) * (y_max - y_min) * (z_max - z_min);
+    const float gamma = 2.0f * std::cbrt((4.0f / 3.0f) * volume / (4.0f / 3.0f * float(CV_PI)));
+    const float maxRadius = 3.0f * m_stepSize;
+    const float rewireEps = 1e-4f;                  // 0.1mm，避免浮点误差把祖先节点改挂到自己的子孙下面
+
+    std::uniform_real_distribution<> dis(0.0, 1.0);
+    std::vector<int> &nearIds = ws.nearIds;
+    std::vector<std::pair<float, int>> &candidates = ws.candidates;  // (经过该邻居到新节点的代价, 邻居 id)
+    std::vector<int> &stack = ws.stack;
+    int goalId = -1;
+    float bestCost = std::numeric_limits<float>::infinity();
+
+    auto tracePath = [&]() {
+        ws.path.clear();
+        tree.traceToRoot(goalId, ws.path);
+        std::reverse(ws.path.begin(), ws.path.end());
+    };
+
+    int i = 0;
+    for (;; ++i) {
+        if (!anytime && i >= m_maxIter) break;
+        if (cancel && cancel->load(std::memory_order_relaxed)) break;
+        // 每 16 次迭代看一次时钟
+        if (anytime && (i & 15) == 0 && std::chrono::steady_clock::now() >= deadline) break;
+
+        // A. 采样: 没有解时和原始 RRT 一样带目标偏向；有解后只在能缩短路径的椭球里采样
+        cv::Point3f rndPoint;
+        if (goalId >= 0) rndPoint = getInformedPoint(ws.gen, start, goal, bestCost);
+        else if (dis(ws.gen) < m_goalBias) rndPoint = goal;
+        else rndPoint = getRandomPoint(ws.gen);
+
+        // B. 找最近 + 迈一步
+        const int nearestId = getNearestNodeId(index, rndPoint, stats);
+        const cv::Point3f newPoint = step(tree.pos(nearestId), rndPoint);
+        if (goalId >= 0 && newPoint.x == goal.x && newPoint.y == goal.y && newPoint.z == goal.z) continue;
+
+        const float n = float(tree.size() + 1);
+        const float radius = std::min(gamma * std::cbrt(std::log(n) / n), maxRadius);
+        index.withinRadius(newPoint, radius, nearIds);
+        if (std::find(nearIds.begin(), nearIds.end(), nearestId) == nearIds.end()) nearIds.push_back(nearestId);
+        candidates.clear();
+        for (int id : nearIds) candidates.push_back({cost[id] + distance(tree.pos(id), newPoint), id});
+
+        // C. 选父节点: 邻域里 代价 + 距离 最小、且能直连的节点。
+        //    有解后采样集中在椭球里，邻域常有几百个点，用小顶堆按代价依次弹出，一般第一个就无碰撞，不必整体排序
+        auto greater = [](const std::pair<float, int>& a, const std::pair<float, int>& b) { return a.first > b.first; };
+        std::make_heap(candidates.begin(), candidates.end(), greater);
+        // 有解后: 经过新节点的路径下界已经不比当前最好的短，直接跳过
+        if (candidates.front().first + distance(newPoint, goal) >= bestCost) continue;
+
+        int parent = -1;
+        float newCost = 0.0f;
+        for (auto heapEnd = candidates.end(); heapEnd != candidates.begin(); --heapEnd) {
+            std::pop_heap(candidates.begin(), heapEnd, greater);
+            const std::pair<float, int> &c = *(heapEnd - 1);
+            if (!segmentBlocked(tree.pos(c.second), newPoint, ws, stats)) {
+                parent = c.second;
+                newCost = c.first;
+                break;
+            }
+        }
+        if (parent < 0) continue;
+
+        const int newId = addNode(newPoint, parent, newCost);
+
+        // D. 重连: 邻居改挂到新节点下更近时，改父节点并把代价变化传给它的整棵子树
+        for (const auto &c : candidates) {
+            const int id = c.second;
+            if (id == parent) continue;
+            const cv::Point3f p = tree.pos(id);
+            const float viaNew = newCost + distance(newPoint, p);
+            if (viaNew + rewireEps >= cost[id]) continue;
+            if (segmentBlocked(newPoint, p, ws, stats)) continue;
+
+            // 从原父节点的子节点链表里摘下，挂到新节点下
+            int *link = &firstChild[tree.parent(id)];
+            while (*link != id) link = &nextSibling[*link];
+            *link = nextSibling[id];
+            tree.setParent(id, newId);
+            nextSibling[id] = firstChild[newId];
+            firstChild[newId] = id;
+
+            const float delta = viaNew - cost[id];
+            stack.assign(1, id);
+            while (!stack.empty()) {
+                const int k = stack.back();
+                stack.pop_back();
+                cost[k] += delta;
+                for (int ch = firstChild[k]; ch != -1; ch = nextSibling[ch]) stack.push_back(ch);
+            }
+        }
+
+        // E. 第一次到终点附近: 把终点作为节点加进树，之后由重连负责缩短
+        if (goalId < 0 && distance(newPoint, goal) < m_stepSize && !segmentBlocked(newPoint, goal, ws, stats)) {
+            goalId = addNode(goal, newId, newCost + distance(newPoint, goal));
+        }
+
+        // F. 记录代价-时间曲线
+        if (goalId >= 0 && cost[goalId] < bestCost - rewireEps) {
+            const bool first = bestCost == std::numeric_limits<float>::infinity();
+            bestCost = cost[goalId];
+            const double ms = elapsedMs(tStart);
+            stats.costCurve.push_back({ms, bestCost, i + 1});
+            if (first) {
+                stats.firstSolutionMs = ms;
+                stats.firstPathLength = bestCost;
+            }
+            if (onImproved) {
+                tracePath();
+                onImproved(ws.path, bestCost, ms);
+            }
+        }
+    }
+
+    stats.iterations = i;
+    stats.treeSize = tree.size();
+    if (goalId < 0) {
+        ws.path.clear();
+        return false;
+    }
+    tracePath();
+    return true;
+}
+
+// ----------------- 5. 批量规划 -----------------
+std::vector<PlanResult> RRTPlanner::planBatch(const std::vector<PlanQuery>& queries, int threads) {
+    const auto tStart = std::chrono::steady_clock::now();
+    m_stats = PlanStats();
+
+    const size_t n = queries.size();
+    std::vector<PlanResult> results(n);
+    if (n == 0) {
+        m_cancel.store(false, std::memory_order_relaxed);
+        return results;
+    }
+
+    // 并行已经在查询之间，每个查询单线程规划
+    const PlannerMode mode = m_mode != PlannerMode::Parallel ? m_mode
+                             : (m_parallelBase == PlannerMode::RRT ? PlannerMode::RRT : PlannerMode::RRTConnect);
+    ThreadPool &pool = ThreadPool::shared();
+    const size_t workers = std::min(n, threads > 0 ? (size_t)threads : pool.threadCount());
+
+    // 种子按查询顺序预先生成: 哪个线程做哪个查询不影响结果
+    std::vector<uint32_t> seeds(n);
+    for (uint32_t &s : seeds) s = (uint32_t)m_workspace.gen();
+    ensureWorkerSpaces(workers);
+    m_collision.prepare();
+
+    struct Shared {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> slot{0};
+        std::atomic<size_t> done{0};
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+    auto shared = std::make_shared<Shared>();
+    // 和 URKinematics::inverseBatch 一样: 调用线程自己也领查询；领到查询的任务一定在本函数返回前做完，
+    // 来晚的任务领不到查询，不会碰 this / queries / results
+    const ImprovementCallback noCallback;
+    auto work = [this, shared, &queries, &results, &seeds, &noCallback, mode, n] {
+        PlannerWorkspace *ws = nullptr;
+        for (size_t q; (q = shared->next.fetch_add(1)) < n;) {
+            if (!ws) ws = m_workerSpaces[shared->slot.fetch_add(1)].get();
+            UR_TRACE_SCOPE("plan.path");    // 每个查询一条 (在各工作线程上)
+            const auto t0 = std::chrono::steady_clock::now();
+            PlanResult &r = results[q];
+            ws->seed(seeds[q]);
+            if (planWith(mode, queries[q].start, queries[q].goal, *ws, r.stats, &m_cancel, noCallback)) {
+                r.path = ws->path;
+            }
+            finishStats(r.path, r.stats, t0, m_cancel.load(std::memory_order_relaxed));
+            if (shared->done.fetch_add(1) + 1 == n) {
+                std::lock_guard<std::mutex> lock(shared->mutex);
+                shared->cv.notify_all();
+            }
+        }
+    };
+    for (size_t i = 1; i < workers; ++i) pool.submit(work);
+    work();
+    {
+        std::unique_lock<std::mutex> lock(shared->mutex);
+        shared->cv.wait(lock, [&] { return shared->done.load() == n; });
+    }
+
+    // 统计是所有查询的总和
+    int successes = 0;
+    for (const PlanResult &r : results) {
+        successes += r.stats.success ? 1 : 0;
+        m_stats.iterations += r.stats.iterations;
+        m_stats.treeSize += r.stats.treeSize;
+        m_stats.pathLength += r.stats.pathLength;
+        m_stats.nearestMs += r.stats.nearestMs;
+        m_stats.collisionMs += r.stats.collisionMs;
+    }
+    m_stats.success = successes == (int)n;
+    m_stats.workers = (int)workers;
+    m_stats.totalMs = elapsedMs(tStart);
+    m_stats.cancelled = m_cancel.exchange(false, std::memory_order_relaxed);
+    qDebug() << "📦 批量规划:" << successes << "/" << n << "成功 |" << workers << "线程 | 耗时"
+             << m_stats.totalMs << "ms";
+    return results;
+}
+
+// ----------------- 6. 关节空间 RRT-Connect -----------------
+std::vector<JointVector> RRTPlanner::planJointPath(const JointVector& start, const JointVector& goal) {
+    UR_TRACE_SCOPE("plan.joint");
+    const auto tStart = std::chrono::steady_clock::now();
+    m_stats = PlanStats();
+    m_arm.setObstacles(m_collision.obstacles());
+    m_arm.resetCheckedCount();
+
+    auto dist2 = [](const JointVector& a, const JointVector& b) {
+        double d = 0.0;
+        for (int j = 0; j < UR12e::kDof; ++j) d += (a[j] - b[j]) * (a[j] - b[j]);
+        return d;
+    };
+
+    // 和三维的 Node / extend 一样: 节点 + 父节点下标，从最近节点向 target 迈一步
+    struct JointTree {
+        std::vector<JointVector> q;
+        std::vector<int> parent;
+    };
+    auto extendJoint = [&](JointTree& tree, const JointVector& target) {
+        const auto t0 = std::chrono::steady_clock::now();
+        int nearestId = 0;
+        double best = std::numeric_limits<double>::max();
+        for (size_t k = 0; k < tree.q.size(); ++k) {
+            const double d = dist2(tree.q[k], target);
+            if (d < best) { best = d; nearestId = (int)k; }
+        }
+        if (m_profiling) m_stats.nearestMs += elapsedMs(t0);
+
+        const JointVector from = tree.q[nearestId];
+        const double len = std::sqrt(best);
+        JointVector next = target;
+        if (len > m_jointStep) {
+            for (int j = 0; j < UR12e::kDof; ++j) next[j] = from[j] + (target[j] - from[j]) * (m_jointStep / len);
+        }
+
+        const auto t1 = std::chrono::steady_clock::now();
+        const bool blocked = m_arm.motionCollides(from, next, m_jointResolution);
+        if (m_profiling) m_stats.collisionMs += elapsedMs(t1);
+        if (blocked) return ExtendResult::Trapped;
+
+        tree.q.push_back(next);
+        tree.parent.push_back(nearestId);
+        return len > m_jointStep ? ExtendResult::Advanced : ExtendResult::Reached;
+    };
+
+    std::vector<JointVector> path;
+    JointTree treeStart{{start}, {-1}}, treeGoal{{goal}, {-1}};
+    bool connected = false;
+    int i = 0;
+    const bool endpointsFree = !m_arm.collides(start) && !m_arm.collides(goal);
+    if (!endpointsFree) {
+        qDebug() << "❌ 关节空间规划: 起点或终点构型本身就碰撞";
     } else {
-        qDebug() << "❌ RRT 失败: 达到最大迭代次数";
+        std::uniform_real_distribution<double> dis(-m_jointSampleLimit, m_jointSampleLimit);
+        JointTree *treeA = &treeStart, *treeB = &treeGoal;
+        for (; i < m_maxIter; ++i) {
+            if (m_cancel.load(std::memory_order_relaxed)) break;
+
+            JointVector rnd;
+            for (double &v : rnd) v = dis(m_workspace.gen);
+            if (extendJoint(*treeA, rnd) != ExtendResult::Trapped) {
+                const JointVector target = treeA->q.back();
+                ExtendResult r;
+                do {
+                    r = extendJoint(*treeB, target);
+                } while (r == ExtendResult::Advanced);
+
+                if (r == ExtendResult::Reached) {
+                    connected = true;
+                    break;
+                }
+            }
+            std::swap(treeA, treeB);
+        }
+    }
+
+    const bool cancelled = m_cancel.exchange(false, std::memory_order_relaxed);
+    if (connected) {
+        for (int id = (int)treeStart.q.size() - 1; id != -1; id = treeStart.parent[id]) path.push_back(treeStart.q[id]);
+        std::reverse(path.begin(), path.end());
+        for (int id = treeGoal.parent.back(); id != -1; id = treeGoal.parent[id]) path.push_back(treeGoal.q[id]);
+        for (size_t k = 1; k < path.size(); ++k) m_stats.pathLength += (float)std::sqrt(dist2(path[k - 1], path[k]));
+        qDebug() << "✅ 关节空间 RRT-Connect 找到路径! 迭代次数:" << i + 1 << "检查构型数:" << (qulonglong)m_arm.checkedCount();
+    } else if (cancelled) {
+        qDebug() << "🛑 关节空间规划已取消";
+    } else if (endpointsFree) {
+        qDebug() << "❌ 关节空间规划失败: 达到最大迭代次数";
     }
 
+    m_stats.success = connected;
+    m_stats.iterations = connected ? i + 1 : i;
+    m_stats.treeSize = treeStart.q.size() + treeGoal.q.size();
+    m_stats.configsChecked = m_arm.checkedCount();
+    m_stats.totalMs = elapsedMs(tStart);
+    m_stats.cancelled = cancelled;
+    if (connected) {
+        m_stats.firstSolutionMs = m_stats.totalMs;
+        m_stats.firstPathLength = m_stats.pathLength;
+    }
     return path;
 }
 
+
+NearestNeighborIndex& RRTPlanner::resetIndex(PlannerWorkspace& ws, int k) const {
+    // 网格边长取 2 倍步长，一次查询一般只看 1~2 圈格子
+    return ws.resetIndex(k, m_nnType, cv::Point3f(x_min, y_min, z_min), cv::Point3f(x_max, y_max, z_max),
+                         2.0f * m_stepSize);
+}
+
+void RRTPlanner::ensureWorkerSpaces(size_t n) {
+    while (m_workerSpaces.size() < n) m_workerSpaces.push_back(std::make_unique<PlannerWorkspace>());
+}
+
 // --- 辅助函数实现 ---
 
-cv::Point3f RRTPlanner::getRandomPoint(const cv::Point3f& /*goal*/) {
-    // 简单的随机生成器
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+cv::Point3f RRTPlanner::getRandomPoint(std::mt19937& gen) const {
+    // 用工作区的引擎 (原来是函数内 static 引擎，无法固定种子，多个规划器还会互相干扰)
     std::uniform_real_distribution<float> disX(x_min, x_max);
     std::uniform_real_distribution<float> disY(y_min, y_max);
     std::uniform_real_distribution<float> disZ(z_min, z_max);
-    return cv::Point3f(disX(gen), disY(gen), disZ(gen));
+    const float x = disX(gen);
+    const float y = disY(gen);
+    const float z = disZ(gen);
+    return cv::Point3f(x, y, z);
 }
 
-int RRTPlanner::getNearestNodeId(const std::vector<Node>& tree, const cv::Point3f& point) {
-    // 找到树中距离 point 最近的节点
-    int minId = -1;
-    /*
-    用float能表示的最大值 作为初始最小距离，确保后续任何实际距离都能被正确更新
-    */
-    float minDist = std::numeric_limits<float>::max();
+cv::Point3f RRTPlanner::getInformedPoint(std::mt19937& gen, const cv::Point3f& start, const cv::Point3f& goal,
+                                         float cBest) const {
+    const float cMin = distance(start, goal);
+    if (cMin < 1e-6f || !(cBest > cMin)) return getRandomPoint(gen);
 
-    for (size_t i = 0; i < tree.size(); ++i) {
-        float dist = distance(tree[i].pos, point);
-        if (dist < minDist) {
-            minDist = dist;
-            minId = i;
-        }
+    // 椭球: 长轴沿 start->goal，半长轴 cBest/2，另两个半轴 sqrt(cBest^2 - cMin^2)/2
+    const cv::Point3f a1 = (goal - start) * (1.0f / cMin);
+    const cv::Point3f helper = std::abs(a1.x) < 0.9f ? cv::Point3f(1, 0, 0) : cv::Point3f(0, 1, 0);
+    cv::Point3f a2 = a1.cross(helper);
+    a2 = a2 * (1.0f / std::sqrt(a2.dot(a2)));
+    const cv::Point3f a3 = a1.cross(a2);
+    const cv::Point3f center = (start + goal) * 0.5f;
+    const float r1 = 0.5f * cBest;
+    const float r2 = 0.5f * std::sqrt(cBest * cBest - cMin * cMin);
+
+    // 单位球内拒绝采样，再映射到椭球；落在工作空间外就重取 (椭球大部分在外面时退回全局采样)
+    std::uniform_real_distribution<float> dis(-1.0f, 1.0f);
+    for (int attempt = 0; attempt < 8; ++attempt) {
+        cv::Point3f b;
+        do {
+            b = cv::Point3f(dis(gen), dis(gen), dis(gen));
+        } while (b.dot(b) > 1.0f);
+        const cv::Point3f p = center + a1 * (r1 * b.x) + a2 * (r2 * b.y) + a3 * (r2 * b.z);
+        if (p.x >= x_min && p.x <= x_max && p.y >= y_min && p.y <= y_max && p.z >= z_min && p.z <= z_max) return p;
     }
-    return minId;
+    return getRandomPoint(gen);
+}
+
+int RRTPlanner::getNearestNodeId(const NearestNeighborIndex& index, const cv::Point3f& point, PlanStats& stats) const {
+    // 找到树中距离 point 最近的节点
+    // 原来是对整棵树线性扫描 + cv::norm，n 个节点每次 O(n)，整体 O(n²)；
+    // 现在交给空间索引 (k-d 树 / 网格哈希)，BruteForce 模式仍是线性扫描
+    if (!m_profiling) return index.nearest(point);
+    const auto t0 = std::chrono::steady_clock::now();
+    const int id = index.nearest(point);
+    stats.nearestMs += elapsedMs(t0);
+    return id;
+}
+
+bool RRTPlanner::segmentBlocked(const cv::Point3f& p1, const cv::Point3f& p2, PlannerWorkspace& ws,
+                                PlanStats& stats) const {
+    // 同 checkCollision (默认 5cm 余量)，但用工作区的查询缓冲区，障碍物数据只读
+    if (!m_profiling) return m_collision.segmentCollides(p1, p2, 0.05f, ws.collision);
+    const auto t0 = std::chrono::steady_clock::now();
+    const bool hit = m_collision.segmentCollides(p1, p2, 0.05f, ws.collision);
+    stats.collisionMs += elapsedMs(t0);
+    return hit;
 }
 
-cv::Point3f RRTPlanner::step(const cv::Point3f& from, const cv::Point3f& to) {
+cv::Point3f RRTPlanner::step(const cv::Point3f& from, const cv::Point3f& to) const {
 
     cv::Point3f direction = to - from;
     float len = std::sqrt(direction.dot(direction));
@@ -154,7 +724,7 @@ cv::Point3f RRTPlanner::step(const cv::Point3f& from, const cv::Point3f& to) {
     return from + direction * (m_stepSize / len);
 }
 
-float RRTPlanner::distance(const cv::Point3f& p1, const cv::Point3f& p2) {
+float RRTPlanner::distance(const cv::Point3f& p1, const cv::Point3f& p2) const {
     // 计算两点之间的欧氏距离
     return cv::norm(p1 - p2);
 }
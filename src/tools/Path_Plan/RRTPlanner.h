@@ -5,19 +5,66 @@
 #include <vector>
 #include <cmath>
 #include <random> // 用于生成随机数
+#include <memory>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include "NearestNeighbor.h"
+#include "CollisionChecker.h"
+#include "ArmCollisionChecker.h"
+#include "PlannerWorkspace.h"
 
-// 定义障碍物 (保持不变)
-struct SphereObstacle {
-    cv::Point3f center;
-    float radius;
-};
-
-// 树的节点
+// 树的节点 (增量重规划的树用；RRTPlanner 的树按 SoA 存在 PlannerWorkspace 里)
 struct Node {
     cv::Point3f pos; // 当前点的位置
     int parentId;    // 父节点在数组中的索引 (-1表示根节点)
 };
 
+// 规划算法
+enum class PlannerMode {
+    RRT,            // 单棵树 + 目标偏向 (原始实现)
+    RRTConnect,     // 起点、终点各一棵树，交替生长并贪心连接
+    Parallel,       // 多个不同种子的规划器在线程池上同时跑，取最先成功的，其余取消
+    RRTStar         // 渐进最优: 按 代价 + 距离 选父节点并重连邻居，找到路径后继续优化直到 m_maxIter
+};
+
+// 代价-时间曲线上的一个点 (RRT* 每找到一条更短的路径记一次)
+struct CostSample {
+    double ms = 0.0;            // 从开始规划算起
+    float cost = 0.0f;          // 路径长度 (米)
+    int iterations = 0;
+};
+
+// 最近一次 planPath 的统计 (给基准测试用)
+struct PlanStats {
+    bool success = false;
+    int iterations = 0;         // 实际迭代次数
+    size_t treeSize = 0;        // 树的节点数
+    float pathLength = 0.0f;    // 路径总长 (米)，失败为 0
+    double totalMs = 0.0;       // planPath 总耗时
+    double nearestMs = 0.0;     // 其中最近邻查询耗时 (需 setProfiling(true))
+    double collisionMs = 0.0;   // 其中碰撞检测耗时 (需 setProfiling(true))
+    int workers = 1;            // 并行模式下同时运行的规划器数量
+    double firstSolutionMs = 0.0;       // 首次出解时间 (RRT* 之外等于 totalMs)
+    float firstPathLength = 0.0f;
+    std::vector<CostSample> costCurve;  // 只有 RRT* 记录
+    bool cancelled = false;             // 被 cancel() 提前结束
+    uint64_t configsChecked = 0;        // 关节空间规划检查过的构型数 (planJointPath)
+};
+
+// planBatch 的一个查询
+struct PlanQuery {
+    cv::Point3f start;
+    cv::Point3f goal;
+};
+
+// planBatch 的一个结果 (和查询同序)
+struct PlanResult {
+    std::vector<cv::Point3f> path;  // 失败为空
+    PlanStats stats;
+};
+
 class RRTPlanner
 {
 public:
@@ -27,15 +74,106 @@ public:
     bool checkCollision(const cv::Point3f& p1, const cv::Point3f& p2, float threshold = 0.05);
 
     /**
-     * @brief 核心函数：规划路径
+     * @brief 核心函数：规划路径 (算法由 setMode 决定，默认原始 RRT)
      * @param start 起点
      * @param goal 终点
-     * @return 路径点集合 (从起点到终点)
+     * @return 路径点集合 (从起点到终点)，失败为空
      */
     std::vector<cv::Point3f> planPath(const cv::Point3f& start, const cv::Point3f& goal);
 
+    // 同上，结果写进调用方的 path (反复规划时复用它的内存)，返回是否成功
+    bool planPath(const cv::Point3f& start, const cv::Point3f& goal, std::vector<cv::Point3f>& path);
+
+    /**
+     * @brief 带时间预算的渐进最优规划 (总是用 RRT*，不看 setMode)
+     * 尽快找到第一条路径 (setImprovementCallback 可以立即拿到)，之后在椭球内采样 (Informed RRT*)、
+     * 重连邻居继续缩短，预算用完或被 cancel() 时返回目前最好的一条。
+     * 只受时间限制，m_maxIter 在这里不起作用；预算内没找到路径返回空。
+     */
+    std::vector<cv::Point3f> planPath(const cv::Point3f& start, const cv::Point3f& goal,
+                                      std::chrono::microseconds budget);
+
+    /**
+     * @brief 关节空间规划: 6 维 RRT-Connect，检查整条手臂 (连杆的胶囊体) 而不只是 TCP 一个点
+     * 障碍物同 addObstacle；每条边按 setJointResolution 插值，整条边一次批量检查 (ArmCollisionChecker)。
+     * 不看 setMode；m_maxIter 同样限制迭代次数，cancel() 同样有效；
+     * 最近邻是线性扫描 (NearestNeighbor 的索引是三维的)，关节空间的树一般只有几百个节点。
+     * @return 关节角路径点 (首尾为 start / goal)，失败或起点 / 终点本身碰撞时为空；
+     *         lastStats().pathLength 此时是关节空间长度 (rad)
+     */
+    std::vector<JointVector> planJointPath(const JointVector& start, const JointVector& goal);
+
+    /**
+     * @brief 批量规划: 一次算很多组起点 / 终点 (例如抓取序列的各段)，分散到 ThreadPool::shared() 上
+     * 每个线程一个工作区 (跨调用复用)，障碍物和参数所有线程只读共享，不复制。
+     * 算法同 setMode，但 Parallel 模式在这里按 setParallel 的基础算法逐个查询规划 (并行已经在查询之间)；
+     * RRT* 跑满 m_maxIter，不调用改进回调。
+     * 每个查询的种子由本规划器的随机引擎依次生成，所以 setSeed 后结果可复现，和线程调度无关。
+     * 调用线程自己也领查询，所以在线程池的任务里调用也不会卡住；cancel() 让没做完的查询尽快返回空路径。
+     * @param threads 最多用几个线程 (含调用线程，<= 0 表示线程池线程数)
+     * @return 和 queries 同序的结果；lastStats() 是所有查询的总和 (success 表示全部成功，totalMs 是整批耗时)
+     */
+    std::vector<PlanResult> planBatch(const std::vector<PlanQuery>& queries, int threads = 0);
+
+    // 关节空间步长 (rad，默认 0.3) 和边的插值分辨率 (任一关节相邻检查点之差的上限，rad，默认 0.02)
+    void setJointStepSize(double rad) { m_jointStep = rad; }
+    void setJointResolution(double rad) { m_jointResolution = rad; }
+
+    // 胶囊体、安全余量、地面在这里设置；障碍物在每次 planJointPath 开始时从 addObstacle 的列表同步过去
+    ArmCollisionChecker& armCollisionChecker() { return m_arm; }
+
+    // RRT* 找到第一条路径以及之后每次变短时调用 (在规划线程里调用，回调要尽快返回)
+    using ImprovementCallback = std::function<void(const std::vector<cv::Point3f>& path, float cost, double elapsedMs)>;
+    void setImprovementCallback(ImprovementCallback callback) { m_onImproved = std::move(callback); }
+
+    /**
+     * @brief 让正在进行的 planPath 尽快返回 (可以在其他线程调用)
+     * RRT* 返回已经找到的最好路径，其余算法返回空。
+     * 标志在规划返回时清除，所以规划还没开始时调用也有效 (作用于接下来的这一次规划)。
+     */
+    void cancel() { m_cancel.store(true, std::memory_order_relaxed); }
+
+    /**
+     * @brief 选择树的最近邻索引 (默认 k-d 树)
+     * BruteForce 即原来的线性扫描，保留用来对比；GridHash 的格子按工作空间边界划分
+     */
+    void setNearestNeighborType(NNIndexType type) { m_nnType = type; }
+    NNIndexType nearestNeighborType() const { return m_nnType; }
+
+    /**
+     * @brief 固定随机种子，同样的种子 + 同样的障碍物 = 同样的路径
+     * 不调用时构造函数用 std::random_device 取种子 (每次运行都不同)
+     */
+    void setSeed(uint32_t seed) { m_workspace.seed(seed); }
+
+    void setMaxIterations(int iterations) { m_maxIter = iterations; }
+
+    void setMode(PlannerMode mode) { m_mode = mode; }
+    PlannerMode mode() const { return m_mode; }
+
+    /**
+     * @brief 并行模式参数
+     * @param workers 同时运行的规划器数量 (<= 0 表示用线程池的全部线程)
+     * @param base 每个规划器用的算法 (RRT 或 RRTConnect)
+     * 每个规划器的种子由本规划器的随机引擎依次生成，所以 setSeed 后并行模式的种子也是固定的
+     * (但哪个先成功取决于线程调度，结果不保证可复现)。
+     * 各规划器共享本规划器的障碍物，只各带一个工作区。不要在 ThreadPool::shared() 的任务里调用并行模式。
+     */
+    void setParallel(int workers, PlannerMode base = PlannerMode::RRTConnect) {
+        m_parallelWorkers = workers;
+        m_parallelBase = base;
+    }
+
+    // 打开后统计最近邻 / 碰撞检测各自的耗时 (每次调用多两次取时钟，略有开销)
+    void setProfiling(bool enable) { m_profiling = enable; }
+
+    const PlanStats& lastStats() const { return m_stats; }
+
+    // 规划用的障碍物 / 碰撞检测器 (给路径后处理 PathSmoother 复用)
+    const CollisionChecker& collisionChecker() const { return m_collision; }
+
 private:
-    std::vector<SphereObstacle> m_obstacles;
+    CollisionChecker m_collision;   // 障碍物 + 碰撞检测 (网格粗筛 + SIMD 精检)
 
     // --- RRT 辅助参数 ---
     float m_stepSize = 0.05;   // 步长: 每次生长 5cm (太大会穿墙，太小算得慢)
@@ -47,15 +185,72 @@ private:
     float y_min = -0.8, y_max = 0.8;
     float z_min =  0.0, z_max = 1.0;
 
+    // --- 关节空间规划参数 ---
+    ArmCollisionChecker m_arm;
+    double m_jointStep = 0.3;
+    double m_jointResolution = 0.02;    // 约等于 TCP 在臂展处移动 2.5 cm
+    double m_jointSampleLimit = CV_PI;  // 在 ±π 内采样 (关节限位是 ±2π，但 ±π 已经覆盖全部姿态，空间小 64 倍)
+
+    // 最近邻索引类型 (每棵树一个索引，每次规划重建，与 tree 同步插入)
+    NNIndexType m_nnType = NNIndexType::KdTree;
+
+    PlannerMode m_mode = PlannerMode::RRT;
+    int m_parallelWorkers = 0;
+    PlannerMode m_parallelBase = PlannerMode::RRTConnect;
+
+    // planPath / planJointPath 用的工作区 (随机数引擎也在里面)，并行模式和批量规划每个线程再各一个
+    PlannerWorkspace m_workspace;
+    std::vector<std::unique_ptr<PlannerWorkspace>> m_workerSpaces;
+
+    bool m_profiling = false;
+    PlanStats m_stats;
+    std::atomic<bool> m_cancel{false};
+    ImprovementCallback m_onImproved;
+
+    // --- 各算法实现 ---
+    // 只读规划器的参数和障碍物，可变状态全在 ws 里 (结果写进 ws.path，统计写进 stats)，所以可以多线程同时调用；
+    // cancel 非空且被置位时尽快返回 (RRT* 返回目前最好的路径，其余返回空)
+    bool planSingleTree(const cv::Point3f& start, const cv::Point3f& goal, PlannerWorkspace& ws,
+                        PlanStats& stats, const std::atomic<bool>* cancel) const;
+    bool planConnect(const cv::Point3f& start, const cv::Point3f& goal, PlannerWorkspace& ws,
+                     PlanStats& stats, const std::atomic<bool>* cancel) const;
+    // anytime 为 true 时只看 deadline，否则跑满 m_maxIter；onImproved 可以为空
+    bool planStar(const cv::Point3f& start, const cv::Point3f& goal, PlannerWorkspace& ws, PlanStats& stats,
+                  const std::atomic<bool>* cancel, std::chrono::steady_clock::time_point deadline, bool anytime,
+                  const ImprovementCallback& onImproved) const;
+    bool planParallel(const cv::Point3f& start, const cv::Point3f& goal);
+    // 按 mode 选算法 (Parallel 之外)
+    bool planWith(PlannerMode mode, const cv::Point3f& start, const cv::Point3f& goal, PlannerWorkspace& ws,
+                  PlanStats& stats, const std::atomic<bool>* cancel, const ImprovementCallback& onImproved) const;
+    // 路径统计 (+ finishPlan 打日志)
+    void finishStats(const std::vector<cv::Point3f>& path, PlanStats& stats,
+                     std::chrono::steady_clock::time_point tStart, bool cancelled) const;
+    void finishPlan(const std::vector<cv::Point3f>& path, std::chrono::steady_clock::time_point tStart);
+    // 并行模式 / 批量规划用的前 n 个工作区 (不够时补建)
+    void ensureWorkerSpaces(size_t n);
+
+    // RRT-Connect 的一次扩展结果
+    enum class ExtendResult { Trapped, Advanced, Reached };
+    ExtendResult extend(NodeArena& tree, NearestNeighborIndex& index, const cv::Point3f& target,
+                        PlannerWorkspace& ws, PlanStats& stats) const;
+
+    // 清空工作区第 k 棵树的索引 (按当前的类型和工作空间边界)
+    NearestNeighborIndex& resetIndex(PlannerWorkspace& ws, int k) const;
+
     // --- 内部辅助函数 ---
     // 1. 生成一个随机点
-    cv::Point3f getRandomPoint(const cv::Point3f& goal);
-    // 2. 找到树中离随机点最近的节点索引
-    int getNearestNodeId(const std::vector<Node>& tree, const cv::Point3f& point);
+    cv::Point3f getRandomPoint(std::mt19937& gen) const;
+    // 在以 start、goal 为焦点、长轴为 cBest 的椭球内均匀采样 (只有这里的点才可能缩短路径)
+    cv::Point3f getInformedPoint(std::mt19937& gen, const cv::Point3f& start, const cv::Point3f& goal,
+                                 float cBest) const;
+    // 2. 找到树中离随机点最近的节点索引 (开启 profiling 时计时)
+    int getNearestNodeId(const NearestNeighborIndex& index, const cv::Point3f& point, PlanStats& stats) const;
+    // 线段是否碰撞 (开启 profiling 时计时)
+    bool segmentBlocked(const cv::Point3f& p1, const cv::Point3f& p2, PlannerWorkspace& ws, PlanStats& stats) const;
     // 3. 从 'from' 向 'to' 移动一小步，返回新点
-    cv::Point3f step(const cv::Point3f& from, const cv::Point3f& to);
+    cv::Point3f step(const cv::Point3f& from, const cv::Point3f& to) const;
     // 4. 计算两点距离
-    float distance(const cv::Point3f& p1, const cv::Point3f& p2);
+    float distance(const cv::Point3f& p1, const cv::Point3f& p2) const;
 };
 
 #endif // RRTPLANNER_H
@@ -0,0 +1,375 @@
+#include "ReplanSession.h"
+#include <QDebug>
+#include <algorithm>
+#include <chrono>
+
+namespace {
+const int kMaxReattachTries = 8;    // 每棵被切断的子树最多试几个候选父节点
+const int kMaxTreeFactor = 4;       // 树超过 maxIter 的这么多倍时从头开始，避免越积越大
+
+double elapsedMs(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+}
+
+bool samePoint(const cv::Point3f& a, const cv::Point3f& b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+}
+
+ReplanSession::ReplanSession() {
+    std::random_device rd;
+    m_gen.seed(rd());
+    setNearestNeighborType(m_nnType);
+}
+
+void ReplanSession::setNearestNeighborType(NNIndexType type) {
+    m_nnType = type;
+    const cv::Point3f lo(x_min, y_min, z_min), hi(x_max, y_max, z_max);
+    m_index = createNearestNeighborIndex(m_nnType, lo, hi, 2.0f * m_stepSize);
+    m_orphanIndex = createNearestNeighborIndex(m_nnType, lo, hi, 2.0f * m_stepSize);
+    rebuildIndexes();
+}
+
+void ReplanSession::reset(const cv::Point3f& start, const cv::Point3f& goal) {
+    m_start = start;
+    m_goal = goal;
+    m_tree.assign(1, Node{start, -1});
+    m_cut.assign(1, 0);
+    m_orphan.assign(1, 0);
+    m_goalId = -1;
+    m_pendingCuts = 0;
+    rebuildIndexes();
+}
+
+void ReplanSession::setGoal(const cv::Point3f& goal) {
+    if (samePoint(goal, m_goal)) return;
+    m_goal = goal;
+    m_goalId = -1;
+}
+
+void ReplanSession::rebuildIndexes() {
+    m_index->clear();
+    m_orphanIndex->clear();
+    m_orphanCount = 0;
+    for (size_t i = 0; i < m_tree.size(); ++i) {
+        if (m_orphan[i]) {
+            m_orphanIndex->insert((int)i, m_tree[i].pos);
+            ++m_orphanCount;
+        } else {
+            m_index->insert((int)i, m_tree[i].pos);
+        }
+    }
+}
+
+// ================= 障碍物 =================
+
+int ReplanSession::addObstacle(const SphereObstacle& obs) {
+    m_obstacles.push_back(obs);
+    m_alive.push_back(1);
+    syncObstacles();
+    invalidate(obs);
+    return (int)m_obstacles.size() - 1;
+}
+
+bool ReplanSession::updateObstacle(int id, const SphereObstacle& obs) {
+    if (id < 0 || id >= (int)m_obstacles.size() || !m_alive[id]) return false;
+    m_obstacles[id] = obs;
+    syncObstacles();
+    // 原来的位置空出来不影响已有的边，只需检查新位置
+    invalidate(obs);
+    return true;
+}
+
+bool ReplanSession::removeObstacle(int id) {
+    if (id < 0 || id >= (int)m_obstacles.size() || !m_alive[id]) return false;
+    m_alive[id] = 0;
+    syncObstacles();
+    return true;
+}
+
+void ReplanSession::syncObstacles() {
+    std::vector<SphereObstacle> alive;
+    alive.reserve(m_obstacles.size());
+    for (size_t i = 0; i < m_obstacles.size(); ++i) {
+        if (m_alive[i]) alive.push_back(m_obstacles[i]);
+    }
+    m_collision.setObstacles(alive);
+}
+
+void ReplanSession::invalidate(const SphereObstacle& obs) {
+    for (size_t i = 1; i < m_tree.size(); ++i) {
+        if (m_cut[i] || m_tree[i].parentId < 0) continue;
+        const cv::Point3f &parent = m_tree[m_tree[i].parentId].pos;
+        if (CollisionChecker::segmentHitsSphere(parent, m_tree[i].pos, obs, m_threshold)) {
+            m_cut[i] = 1;
+            ++m_pendingCuts;
+        }
+    }
+}
+
+// ================= 修补 =================
+
+void ReplanSession::repairTree() {
+    const int n = (int)m_tree.size();
+
+    // 子节点链表 (重新接上的节点会挂到新父节点的链表头，旧链表里靠 parentId 不匹配跳过)
+    std::vector<int> firstChild(n, -1), nextSibling(n, -1);
+    for (int i = n - 1; i >= 1; --i) {
+        const int p = m_tree[i].parentId;
+        if (p < 0) continue;
+        nextSibling[i] = firstChild[p];
+        firstChild[p] = i;
+    }
+    auto forEachChild = [&](int id, auto&& fn) {
+        for (int k = firstChild[id]; k != -1; k = nextSibling[k]) {
+            if (m_tree[k].parentId == id && !m_cut[k]) fn(k);
+        }
+    };
+
+    // 1. 从根出发能走到的节点 (不经过被切断的边)，放进主树索引 (暂时用旧 id)
+    std::vector<char> linked(n, 0);
+    std::vector<int> queue;
+    queue.reserve(n);
+    auto collect = [&](int root) {
+        size_t head = queue.size();
+        queue.push_back(root);
+        while (head < queue.size()) {
+            const int id = queue[head++];
+            linked[id] = 1;
+            m_index->insert(id, m_tree[id].pos);
+            forEachChild(id, [&](int k) { queue.push_back(k); });
+        }
+    };
+    m_index->clear();
+    collect(0);
+
+    // 2. 被切断的子树 (以及之前留下的孤立子树): 在附近的连通节点里找一条无碰撞的边接回去
+    std::vector<char> blocked(n, 0);
+    std::vector<int> candidates;
+    for (int c = 1; c < n; ++c) {
+        if (linked[c] || !(m_cut[c] || m_tree[c].parentId < 0)) continue;
+        const cv::Point3f p = m_tree[c].pos;
+        if (segmentBlocked(p, p)) {     // 子树的根已经在障碍物里
+            blocked[c] = 1;
+            continue;
+        }
+
+        m_index->withinRadius(p, 2.0f * m_stepSize, candidates);
+        std::sort(candidates.begin(), candidates.end(), [&](int a, int b) {
+            return cv::norm(m_tree[a].pos - p) < cv::norm(m_tree[b].pos - p);
+        });
+        const int tries = std::min((int)candidates.size(), kMaxReattachTries);
+        for (int t = 0; t < tries; ++t) {
+            const int parent = candidates[t];
+            if (segmentBlocked(m_tree[parent].pos, p)) continue;
+            m_tree[c].parentId = parent;
+            m_cut[c] = 0;
+            nextSibling[c] = firstChild[parent];
+            firstChild[parent] = c;
+            collect(c);
+            ++m_stats.reattached;
+            break;
+        }
+    }
+
+    // 3. 剩下的留作孤立子树；落在障碍物里的节点丢掉 (它连出去的边一定都被切断了)，孤立节点太多时全丢
+    std::vector<char> keep(n, 0);
+    size_t orphans = 0;
+    for (int i = 0; i < n; ++i) {
+        if (linked[i]) { keep[i] = 1; continue; }
+        if (blocked[i] || (m_cut[i] && segmentBlocked(m_tree[i].pos, m_tree[i].pos))) continue;
+        keep[i] = 1;
+        ++orphans;
+    }
+    if (orphans > size_t(m_maxIter)) {
+        for (int i = 0; i < n; ++i) keep[i] = linked[i];
+    }
+
+    // 4. 按广度优先重排 (主树在前，父节点在子节点前)，孤立子树跟在后面
+    std::vector<int> newId(n, -1);
+    std::vector<Node> tree;
+    std::vector<char> orphan;
+    tree.reserve(n);
+    orphan.reserve(n);
+    auto isRoot = [&](int i) {
+        const int p = m_tree[i].parentId;
+        return i == 0 || p < 0 || m_cut[i] || !keep[p];
+    };
+    auto emit = [&](int root) {
+        queue.clear();
+        queue.push_back(root);
+        for (size_t head = 0; head < queue.size(); ++head) {
+            const int id = queue[head];
+            newId[id] = (int)tree.size();
+            tree.push_back({m_tree[id].pos, id == root ? -1 : newId[m_tree[id].parentId]});
+            orphan.push_back(linked[id] ? 0 : 1);
+            forEachChild(id, [&](int k) { if (keep[k]) queue.push_back(k); });
+        }
+    };
+    emit(0);
+    for (int i = 1; i < n; ++i) {
+        if (keep[i] && !linked[i] && isRoot(i)) emit(i);
+    }
+
+    m_stats.discarded = n - tree.size();
+    m_goalId = m_goalId >= 0 ? newId[m_goalId] : -1;
+    m_tree.swap(tree);
+    m_orphan.swap(orphan);
+    m_cut.assign(m_tree.size(), 0);
+    m_pendingCuts = 0;
+    rebuildIndexes();
+    m_stats.orphans = m_orphanCount;
+}
+
+void ReplanSession::adopt(int id, int orphan) {
+    // 翻转 orphan 到它所在子树根的父指针，orphan 成为新的子树根并挂到 id 下
+    int prev = id, cur = orphan;
+    while (cur != -1) {
+        const int next = m_tree[cur].parentId;
+        m_tree[cur].parentId = prev;
+        prev = cur;
+        cur = next;
+    }
+
+    // 顺着父指针能走到主树的孤立节点都并进主树 (state: 0 未知, 1 主树, 2 仍孤立)
+    const int n = (int)m_tree.size();
+    std::vector<char> state(n, 0);
+    std::vector<int> chain;
+    for (int i = 0; i < n; ++i) {
+        if (!m_orphan[i] || state[i]) continue;
+        chain.clear();
+        int k = i;
+        while (k != -1 && m_orphan[k] && !state[k]) {
+            chain.push_back(k);
+            k = m_tree[k].parentId;
+        }
+        const char s = (k != -1 && (!m_orphan[k] || state[k] == 1)) ? 1 : 2;
+        for (int c : chain) state[c] = s;
+    }
+    m_orphanIndex->clear();
+    m_orphanCount = 0;
+    for (int i = 0; i < n; ++i) {
+        if (!m_orphan[i]) continue;
+        if (state[i] == 1) {
+            m_orphan[i] = 0;
+            m_index->insert(i, m_tree[i].pos);
+        } else {
+            m_orphanIndex->insert(i, m_tree[i].pos);
+            ++m_orphanCount;
+        }
+    }
+    ++m_stats.adopted;
+}
+
+// ================= 规划 =================
+
+std::vector<cv::Point3f> ReplanSession::replan() {
+    const auto tStart = std::chrono::steady_clock::now();
+    m_stats = ReplanStats();
+    m_stats.invalidatedEdges = m_pendingCuts;
+    if (m_tree.empty()) {
+        qDebug() << "⚠️ 重规划前需要先 reset(起点, 终点)";
+        return {};
+    }
+
+    if (m_tree.size() > size_t(kMaxTreeFactor) * m_maxIter) reset(m_start, m_goal);
+    if (m_pendingCuts > 0) repairTree();
+    m_stats.repairMs = elapsedMs(tStart);
+
+    m_stats.reused = goalReached();
+    if (!m_stats.reused) grow();
+
+    std::vector<cv::Point3f> path = tracePath();
+    for (size_t k = 1; k < path.size(); ++k) m_stats.pathLength += cv::norm(path[k] - path[k - 1]);
+    m_stats.success = !path.empty();
+    m_stats.treeSize = m_tree.size();
+    m_stats.totalMs = elapsedMs(tStart);
+    if (!m_stats.success) qDebug() << "❌ 重规划失败: 达到最大迭代次数";
+    return path;
+}
+
+bool ReplanSession::grow() {
+    // 现有的树可能已经有节点离终点只差一步
+    const int nearestGoal = m_index->nearest(m_goal);
+    if (nearestGoal >= 0 && tryConnectGoal(nearestGoal)) return true;
+
+    // 和 RRTPlanner 的原始 RRT 一样: 目标偏向采样 -> 最近节点 -> 迈一步
+    std::uniform_real_distribution<> dis(0.0, 1.0);
+    for (int i = 0; i < m_maxIter; ++i) {
+        m_stats.iterations = i + 1;
+        const cv::Point3f rndPoint = dis(m_gen) < m_goalBias ? m_goal : randomPoint();
+        const int nearestId = m_index->nearest(rndPoint);
+        const cv::Point3f from = m_tree[nearestId].pos;
+        const cv::Point3f newPoint = step(from, rndPoint);
+        if (segmentBlocked(from, newPoint)) continue;
+
+        m_tree.push_back({newPoint, nearestId});
+        m_cut.push_back(0);
+        m_orphan.push_back(0);
+        const int id = (int)m_tree.size() - 1;
+        m_index->insert(id, newPoint);
+        if (samePoint(newPoint, m_goal)) {
+            m_goalId = id;
+            return true;
+        }
+        if (tryConnectGoal(id)) return true;
+
+        // 像 RRT-Connect 那样朝最近的孤立节点贪心地一直长，连上就把那棵子树整棵接上 (终点可能就在里面)
+        if (m_orphanCount > 0) {
+            const int orphan = m_orphanIndex->nearest(newPoint);
+            const cv::Point3f target = m_tree[orphan].pos;
+            for (int from = id;;) {
+                const cv::Point3f p = step(m_tree[from].pos, target);
+                if (segmentBlocked(m_tree[from].pos, p)) break;
+                if (samePoint(p, target)) {
+                    adopt(from, orphan);
+                    if (goalReached()) return true;
+                    break;
+                }
+                m_tree.push_back({p, from});
+                m_cut.push_back(0);
+                m_orphan.push_back(0);
+                from = (int)m_tree.size() - 1;
+                m_index->insert(from, p);
+                if (tryConnectGoal(from)) return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool ReplanSession::tryConnectGoal(int id) {
+    const cv::Point3f p = m_tree[id].pos;
+    if (cv::norm(p - m_goal) >= m_stepSize || segmentBlocked(p, m_goal)) return false;
+    m_tree.push_back({m_goal, id});
+    m_cut.push_back(0);
+    m_orphan.push_back(0);
+    m_goalId = (int)m_tree.size() - 1;
+    m_index->insert(m_goalId, m_goal);
+    return true;
+}
+
+std::vector<cv::Point3f> ReplanSession::tracePath() const {
+    std::vector<cv::Point3f> path;
+    if (!goalReached()) return path;
+    for (int id = m_goalId; id != -1; id = m_tree[id].parentId) path.push_back(m_tree[id].pos);
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+cv::Point3f ReplanSession::step(const cv::Point3f& from, const cv::Point3f& to) const {
+    const cv::Point3f direction = to - from;
+    const float len = std::sqrt(direction.dot(direction));
+    if (len < m_stepSize) return to;
+    return from + direction * (m_stepSize / len);
+}
+
+cv::Point3f ReplanSession::randomPoint() {
+    std::uniform_real_distribution<float> disX(x_min, x_max);
+    std::uniform_real_distribution<float> disY(y_min, y_max);
+    std::uniform_real_distribution<float> disZ(z_min, z_max);
+    const float x = disX(m_gen);
+    const float y = disY(m_gen);
+    const float z = disZ(m_gen);
+    return cv::Point3f(x, y, z);
+}
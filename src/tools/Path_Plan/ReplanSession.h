@@ -0,0 +1,121 @@
+#ifndef REPLANSESSION_H
+#define REPLANSESSION_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+#include "RRTPlanner.h"
+
+// 最近一次 replan 的统计
+struct ReplanStats {
+    bool success = false;
+    bool reused = false;            // 修补后原路径仍然连通，没有再生长
+    int invalidatedEdges = 0;       // 自上次 replan 以来被障碍物变化切断的边
+    int reattached = 0;             // 修补时直接接回树上的子树数
+    int adopted = 0;                // 生长时碰到、整棵并回树上的孤立子树数
+    size_t orphans = 0;             // 修补后暂时接不回去、留着等生长时再连的节点数
+    size_t discarded = 0;           // 落在障碍物里被丢掉的节点数
+    int iterations = 0;             // 修补后继续生长的迭代次数
+    size_t treeSize = 0;
+    float pathLength = 0.0f;        // 米，失败为 0
+    double repairMs = 0.0;          // 其中修补树的耗时
+    double totalMs = 0.0;
+};
+
+/**
+ * @brief 增量重规划: 在多次规划之间保留 RRT 树 (根为起点)
+ *
+ * 障碍物增加 / 移动时，只检查树边是否碰到 "变化后的那个球" (原来的边对其余球已经无碰撞)，
+ * 碰到的边被切断；障碍物移走或删除只会腾出空间，不切断任何边。
+ * replan() 时先修补: 被切断的子树在附近 (2 倍步长) 的连通节点里找一条无碰撞的边重新接上，
+ * 接不上的留作孤立子树 (自己落在障碍物里的节点丢掉)；终点节点仍连通就直接返回原路径，
+ * 否则从修补后的树继续按原始 RRT 生长，每个新节点再像 RRT-Connect 那样朝最近的孤立节点贪心地长，
+ * 连上就把那棵子树翻转后整棵接上 (常见情况是绕过动态障碍物后接回原来通往终点的那一段)。
+ * 路径是树上的折线，比从头规划的绕一些，执行前交给 PathSmoother。
+ * 障碍物用 id 管理 (addObstacle 返回)，多次更新可以攒到一次 replan 里一起修补。
+ * 不是线程安全的。
+ */
+class ReplanSession
+{
+public:
+    ReplanSession();
+
+    void setSeed(uint32_t seed) { m_gen.seed(seed); }
+    void setMaxIterations(int iterations) { m_maxIter = iterations; }
+    void setNearestNeighborType(NNIndexType type);
+
+    // 清空树，从 start 重新开始 (起点变了只能重来)
+    void reset(const cv::Point3f& start, const cv::Point3f& goal);
+    // 换终点: 树保留，只是原来的终点节点不再当作终点
+    void setGoal(const cv::Point3f& goal);
+
+    // 返回障碍物 id
+    int addObstacle(const SphereObstacle& obs);
+    // id 无效时返回 false
+    bool updateObstacle(int id, const SphereObstacle& obs);
+    bool removeObstacle(int id);
+
+    /**
+     * @brief 修补树并返回起点到终点的路径，失败为空
+     */
+    std::vector<cv::Point3f> replan();
+
+    const ReplanStats& lastStats() const { return m_stats; }
+    const CollisionChecker& collisionChecker() const { return m_collision; }
+    size_t treeSize() const { return m_tree.size(); }
+
+private:
+    // 切断与 obs (加上余量) 相交的边
+    void invalidate(const SphereObstacle& obs);
+    // 障碍物列表变化后同步给碰撞检测器
+    void syncObstacles();
+    // 重新接上被切断的子树，其余的留作孤立子树，按广度优先重排节点并重建索引
+    void repairTree();
+    // 新节点 id 连到孤立节点 orphan: 翻转那棵子树的父指针后并进主树
+    void adopt(int id, int orphan);
+    void rebuildIndexes();
+    bool goalReached() const { return m_goalId >= 0 && !m_orphan[m_goalId]; }
+    // 从已连通的节点向终点生长
+    bool grow();
+    // 节点 id 能直接连到终点时加入终点节点
+    bool tryConnectGoal(int id);
+    std::vector<cv::Point3f> tracePath() const;
+
+    bool segmentBlocked(const cv::Point3f& p1, const cv::Point3f& p2) const {
+        return m_collision.segmentCollides(p1, p2, m_threshold);
+    }
+    cv::Point3f step(const cv::Point3f& from, const cv::Point3f& to) const;
+    cv::Point3f randomPoint();
+
+    CollisionChecker m_collision;
+    std::vector<SphereObstacle> m_obstacles;    // 按 id 存
+    std::vector<char> m_alive;
+
+    std::vector<Node> m_tree;                   // 主树 (根为起点，id 0) + 孤立子树 (根的 parentId 为 -1)
+    std::vector<char> m_cut;                    // 到父节点的边已被切断
+    std::vector<char> m_orphan;                 // 不在主树上
+    std::unique_ptr<NearestNeighborIndex> m_index;          // 主树节点
+    std::unique_ptr<NearestNeighborIndex> m_orphanIndex;    // 孤立节点
+    size_t m_orphanCount = 0;
+    NNIndexType m_nnType = NNIndexType::KdTree;
+    int m_goalId = -1;
+    int m_pendingCuts = 0;
+
+    cv::Point3f m_start, m_goal;
+
+    // 参数与 RRTPlanner 一致
+    float m_stepSize = 0.05f;
+    int m_maxIter = 5000;
+    float m_goalBias = 0.1f;
+    float m_threshold = 0.05f;
+    float x_min = -0.8f, x_max = 0.8f;
+    float y_min = -0.8f, y_max = 0.8f;
+    float z_min =  0.0f, z_max = 1.0f;
+
+    std::mt19937 m_gen;
+    ReplanStats m_stats;
+};
+
+#endif // REPLANSESSION_H
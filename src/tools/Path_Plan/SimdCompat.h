@@ -0,0 +1,44 @@
+#ifndef SIMDCOMPAT_H
+#define SIMDCOMPAT_H
+
+#include <opencv2/core/hal/intrin.hpp>
+
+// ================= SIMD 兼容层 =================
+// 用 OpenCV 的可变宽度向量类型 v_float32: SSE 为 4 路，AVX2 为 8 路，AVX-512 为 16 路。
+// OpenCV 4.8 起推荐函数写法 (v_add / v_le ...)，之前的版本只有运算符写法。
+// 球体碰撞 (CollisionChecker)、整臂碰撞 (ArmCollisionChecker) 和批量运动学 (URKinematics) 共用
+#if CV_SIMD
+namespace Simd {
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 8)
+inline cv::v_float32 vAdd(const cv::v_float32& a, const cv::v_float32& b) { return cv::v_add(a, b); }
+inline cv::v_float32 vSub(const cv::v_float32& a, const cv::v_float32& b) { return cv::v_sub(a, b); }
+inline cv::v_float32 vMul(const cv::v_float32& a, const cv::v_float32& b) { return cv::v_mul(a, b); }
+inline cv::v_float32 vDiv(const cv::v_float32& a, const cv::v_float32& b) { return cv::v_div(a, b); }
+inline cv::v_float32 vLe(const cv::v_float32& a, const cv::v_float32& b) { return cv::v_le(a, b); }
+inline cv::v_float32 vGe(const cv::v_float32& a, const cv::v_float32& b) { return cv::v_ge(a, b); }
+inline cv::v_float32 vLt(const cv::v_float32& a, const cv::v_float32& b) { return cv::v_lt(a, b); }
+inline cv::v_float32 vAnd(const cv::v_float32& a, const cv::v_float32& b) { return cv::v_and(a, b); }
+inline cv::v_float32 vOr(const cv::v_float32& a, const cv::v_float32& b) { return cv::v_or(a, b); }
+#else
+inline cv::v_float32 vAdd(const cv::v_float32& a, const cv::v_float32& b) { return a + b; }
+inline cv::v_float32 vSub(const cv::v_float32& a, const cv::v_float32& b) { return a - b; }
+inline cv::v_float32 vMul(const cv::v_float32& a, const cv::v_float32& b) { return a * b; }
+inline cv::v_float32 vDiv(const cv::v_float32& a, const cv::v_float32& b) { return a / b; }
+inline cv::v_float32 vLe(const cv::v_float32& a, const cv::v_float32& b) { return a <= b; }
+inline cv::v_float32 vGe(const cv::v_float32& a, const cv::v_float32& b) { return a >= b; }
+inline cv::v_float32 vLt(const cv::v_float32& a, const cv::v_float32& b) { return a < b; }
+inline cv::v_float32 vAnd(const cv::v_float32& a, const cv::v_float32& b) { return a & b; }
+inline cv::v_float32 vOr(const cv::v_float32& a, const cv::v_float32& b) { return a | b; }
+#endif
+
+inline int simdLanes() {
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 9)
+    return cv::VTraits<cv::v_float32>::vlanes();
+#else
+    return cv::v_float32::nlanes;
+#endif
+}
+} // namespace Simd
+#endif
+
+#endif // SIMDCOMPAT_H
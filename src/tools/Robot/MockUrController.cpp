@@ -0,0 +1,549 @@
+#include "MockUrController.h"
+#include "tools/Common/SteadyClock.h"
+#include <QDebug>
+#include <QHostAddress>
+#include <QNetworkProxy>
+#include <QStringList>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+const int kAcceptPollMs = 100;                  // 决定 stop() 最长的等待时间
+const qint64 kMaxBacklogBytes = 64 * 1024;      // 客户端不读时最多积压这么多再开始跳包
+const int64_t kResyncNs = 100000000LL;          // 落后排期超过 100 ms (例如被调试器暂停) 就重新排期
+
+double dist3(const double* a, const double* b) {
+    const double dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+// 解析 "[a, b, c]" 或 "p[a, b, c]" 里的数字，p 指向 '[' 之后；返回解析到的个数，end 指向 ']' 之后
+int parseList(const char* p, double* out, int maxCount, const char** end) {
+    int n = 0;
+    while (*p && *p != ']') {
+        char *next = nullptr;
+        const double v = std::strtod(p, &next);
+        if (next == p) return -1;
+        if (n < maxCount) out[n] = v;
+        ++n;
+        p = next;
+        while (*p == ' ' || *p == ',') ++p;
+    }
+    if (*p != ']') return -1;
+    *end = p + 1;
+    return n;
+}
+
+// 读 "name=数字"，找不到时返回 fallback
+double namedArg(const char* p, const char* name, double fallback) {
+    const char *at = std::strstr(p, name);
+    if (!at) return fallback;
+    return std::strtod(at + std::strlen(name), nullptr);
+}
+
+// movel / movep(p[x, y, z, rx, ry, rz], a=..., v=..., r=...)
+bool parseMove(const std::string& line, MockMotionSimulator::Waypoint& wp) {
+    if (line.compare(0, 6, "movel(") != 0 && line.compare(0, 6, "movep(") != 0) return false;
+    const size_t at = line.find("p[");
+    if (at == std::string::npos) return false;
+    double pose[6] = {};
+    const char *end = nullptr;
+    const int n = parseList(line.c_str() + at + 2, pose, 6, &end);
+    if (n < 3) return false;
+    std::copy(pose, pose + 3, wp.xyz);
+    wp.hasRotation = n >= 6;
+    if (wp.hasRotation) std::copy(pose + 3, pose + 6, wp.rot);
+    wp.a = namedArg(end, "a=", 1.2);
+    wp.v = namedArg(end, "v=", 0.25);
+    wp.r = namedArg(end, "r=", 0.0);
+    return wp.a > 0.0 && wp.v > 0.0;
+}
+
+const char* kindName(MockCommandKind kind) {
+    switch (kind) {
+    case MockCommandKind::Speed: return "speed";
+    case MockCommandKind::Stop: return "stop";
+    case MockCommandKind::Move: return "move";
+    case MockCommandKind::Program: return "program";
+    default: return "other";
+    }
+}
+
+// 接管监听到的 socket 描述符，交给各自的连接线程 (QTcpSocket 必须在使用它的线程里创建)
+class DescriptorServer : public QTcpServer
+{
+public:
+    std::vector<qintptr> pending;
+
+protected:
+    void incomingConnection(qintptr descriptor) override { pending.push_back(descriptor); }
+};
+}
+
+// ================= MockMotionSimulator =================
+
+MockMotionSimulator::MockMotionSimulator()
+    : m_pose{0.4, 0.0, 0.3, 0.0, 3.1416, 0.0}   // 与 mock_ur.py 的初始位姿一致
+{
+}
+
+uint64_t MockMotionSimulator::runSpeed(const double v[3], double acc) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_path.clear();
+    std::copy(v, v + 3, m_speedTarget);
+    m_speedAcc = acc > 0.0 ? acc : 0.5;
+    return ++m_version;
+}
+
+uint64_t MockMotionSimulator::runStop(double acc) {
+    const double zero[3] = {0.0, 0.0, 0.0};
+    return runSpeed(zero, acc);
+}
+
+uint64_t MockMotionSimulator::runPath(const std::vector<Waypoint>& moves) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_path.assign(moves.begin(), moves.end());
+    std::fill(m_speedTarget, m_speedTarget + 3, 0.0);
+    m_pathSpeed = std::sqrt(m_vel[0] * m_vel[0] + m_vel[1] * m_vel[1] + m_vel[2] * m_vel[2]);
+    if (!moves.empty() && moves.back().hasRotation) std::copy(moves.back().rot, moves.back().rot + 3, m_pose + 3);
+    return ++m_version;
+}
+
+void MockMotionSimulator::step(double dt) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_t += dt;
+    if (!m_path.empty()) {
+        stepPath(dt);
+        return;
+    }
+    // 速度模式: 每个分量以加速度限制趋近目标
+    const double dv = m_speedAcc * dt;
+    for (int i = 0; i < 3; ++i) {
+        const double diff = m_speedTarget[i] - m_vel[i];
+        m_vel[i] += std::max(-dv, std::min(dv, diff));
+        m_pose[i] += m_vel[i] * dt;
+    }
+}
+
+void MockMotionSimulator::stepPath(double dt) {
+    // 已经在位的点直接跳过 (例如第一个点就是当前位置)
+    while (!m_path.empty() && dist3(m_pose, m_path.front().xyz) < 1e-6 && m_path.front().r == 0.0 &&
+           m_pathSpeed < 1e-9) {
+        m_path.pop_front();
+    }
+    if (m_path.empty()) {
+        std::fill(m_vel, m_vel + 3, 0.0);
+        return;
+    }
+    const Waypoint head = m_path.front();
+
+    // 到下一个必须停稳的点还剩多远
+    double remaining = dist3(m_pose, head.xyz);
+    if (head.r != 0.0) {
+        const double *prev = head.xyz;
+        for (size_t i = 1; i < m_path.size(); ++i) {
+            remaining += dist3(prev, m_path[i].xyz);
+            prev = m_path[i].xyz;
+            if (m_path[i].r == 0.0) break;
+        }
+    }
+    const double s = std::min({head.v, m_pathSpeed + head.a * dt, std::sqrt(2.0 * head.a * remaining)});
+    m_pathSpeed = s;
+
+    double travel = s * dt;
+    while (!m_path.empty() && travel > 0.0) {
+        const double *xyz = m_path.front().xyz;
+        const double d = dist3(m_pose, xyz);
+        if (d <= travel || d < 1e-6) {
+            std::copy(xyz, xyz + 3, m_pose);
+            travel -= d;
+            m_path.pop_front();
+            if (m_path.empty() || m_pathSpeed < 1e-9) break;
+        } else {
+            for (int i = 0; i < 3; ++i) m_pose[i] += (xyz[i] - m_pose[i]) * travel / d;
+            travel = 0.0;
+        }
+    }
+    if (!m_path.empty()) {
+        const double *xyz = m_path.front().xyz;
+        const double d = dist3(m_pose, xyz);
+        for (int i = 0; i < 3; ++i) m_vel[i] = d > 0.0 ? (xyz[i] - m_pose[i]) / d * s : 0.0;
+    } else {
+        std::fill(m_vel, m_vel + 3, 0.0);
+        m_pathSpeed = 0.0;
+    }
+}
+
+double MockMotionSimulator::time() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_t;
+}
+
+uint64_t MockMotionSimulator::snapshot(RobotState& out) const {
+    double t, pose[6], vel[3], target[3];
+    uint64_t version;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        t = m_t;
+        std::copy(m_pose, m_pose + 6, pose);
+        std::copy(m_vel, m_vel + 3, vel);
+        const double *src = m_path.empty() ? m_speedTarget : m_vel;
+        std::copy(src, src + 3, target);
+        version = m_version;
+    }
+
+    out = RobotState();
+    out.time = t;
+    std::copy(target, target + 3, out.qdTarget);
+    for (int j = 0; j < 6; ++j) {
+        const double q = 0.3 * std::sin(0.5 * t + j);
+        out.qTarget[j] = q;
+        out.qActual[j] = q;
+        out.qdActual[j] = 0.15 * std::cos(0.5 * t + j);
+    }
+    std::copy(pose, pose + 6, out.tcpPose);
+    std::copy(vel, vel + 3, out.tcpSpeed);
+    std::copy(pose, pose + 6, out.tcpPoseTarget);
+    out.robotMode = 7.0;        // RUNNING
+    out.safetyMode = 1.0;       // NORMAL
+    out.speedScaling = 1.0;
+    out.programState = 1.0;
+    return version;
+}
+
+// ================= MockUrController =================
+
+// 一条解析好的指令
+struct MockUrController::Command {
+    MockCommandKind kind = MockCommandKind::Other;
+    double v[3] = {};
+    double acc = 0.5;
+    std::vector<MockMotionSimulator::Waypoint> moves;
+    std::string text;
+};
+
+namespace {
+/**
+ * @brief 按行拆分收到的数据；def ... end 收齐后作为一个程序
+ * 半行数据留在 m_pending 里等下一次 (TCP 不保证按指令边界分包)
+ */
+template <typename Command>
+class ScriptParser
+{
+public:
+    template <typename Handler>
+    void feed(const char* data, size_t size, Handler&& handle) {
+        m_pending.append(data, size);
+        size_t start = 0, nl;
+        while ((nl = m_pending.find('\n', start)) != std::string::npos) {
+            size_t b = start, e = nl;
+            while (b < e && (m_pending[b] == ' ' || m_pending[b] == '\t')) ++b;
+            while (e > b && (m_pending[e - 1] == ' ' || m_pending[e - 1] == '\r' || m_pending[e - 1] == '\t')) --e;
+            if (e > b) line(m_pending.substr(b, e - b), handle);
+            start = nl + 1;
+        }
+        m_pending.erase(0, start);
+    }
+
+private:
+    template <typename Handler>
+    void line(const std::string& text, Handler& handle) {
+        if (m_inProgram) {
+            if (text == "end") {
+                m_program.kind = MockCommandKind::Program;
+                handle(m_program);
+                m_program = Command();
+                m_inProgram = false;
+            } else {
+                MockMotionSimulator::Waypoint wp;
+                if (parseMove(text, wp)) m_program.moves.push_back(wp);
+            }
+            return;
+        }
+        if (text.compare(0, 4, "def ") == 0) {
+            m_inProgram = true;
+            m_program = Command();
+            m_program.text = text;
+            return;
+        }
+
+        Command cmd;
+        cmd.text = text;
+        if (text.compare(0, 8, "speedl([") == 0) {
+            const char *end = nullptr;
+            const int n = parseList(text.c_str() + 8, cmd.v, 3, &end);
+            if (n >= 3) {
+                // ], a, t
+                while (*end == ' ' || *end == ',') ++end;
+                cmd.acc = std::strtod(end, nullptr);
+                cmd.kind = MockCommandKind::Speed;
+            }
+        } else if (text.compare(0, 6, "stopl(") == 0 || text.compare(0, 6, "stopj(") == 0) {
+            cmd.acc = std::strtod(text.c_str() + 6, nullptr);
+            cmd.kind = MockCommandKind::Stop;
+        } else if (text.compare(0, 6, "movel(") == 0 || text.compare(0, 6, "movep(") == 0) {
+            MockMotionSimulator::Waypoint wp;
+            if (parseMove(text, wp)) {
+                cmd.moves.push_back(wp);
+                cmd.kind = MockCommandKind::Move;
+            }
+        }
+        handle(cmd);
+    }
+
+    std::string m_pending;
+    bool m_inProgram = false;
+    Command m_program;
+};
+}
+
+MockUrController::MockUrController(const MockControllerOptions& options)
+    : m_options(options)
+{
+    if (m_options.rateHz <= 0.0) m_options.rateHz = 125.0;
+    m_periodNs = int64_t(1e9 / m_options.rateHz);
+}
+
+MockUrController::~MockUrController() {
+    stop();
+}
+
+bool MockUrController::start() {
+    if (m_running.load()) return true;
+    if (m_options.ports.empty()) return false;
+    m_running.store(true);
+
+    if (!m_options.commandLogPath.empty()) {
+        m_log = std::fopen(m_options.commandLogPath.c_str(), "w");
+        if (m_log) std::fprintf(m_log, "id,port,client,recv_ns,controller_time,kind,text\n");
+        else qDebug() << "⚠️ 无法写指令日志:" << QString::fromStdString(m_options.commandLogPath);
+    }
+
+    m_simThread = std::thread(&MockUrController::simulateLoop, this);
+    bool ok = true;
+    for (quint16 port : m_options.ports) {
+        auto ready = std::make_shared<std::promise<bool>>();
+        std::future<bool> listening = ready->get_future();
+        m_listenThreads.emplace_back(&MockUrController::listenLoop, this, port, ready);
+        ok = listening.get() && ok;
+    }
+    if (!ok) {
+        stop();
+        return false;
+    }
+    QStringList ports;
+    for (quint16 port : m_options.ports) ports << QString::number(port);
+    qDebug() << "🤖 模拟控制器已启动:" << m_options.host << "端口" << ports.join(",")
+             << "| 状态包" << RobotStateEncoder::kPacketBytes << "字节 @" << m_options.rateHz << "Hz";
+    return true;
+}
+
+void MockUrController::stop() {
+    m_running.store(false);
+    for (auto &t : m_listenThreads) {
+        if (t.joinable()) t.join();
+    }
+    m_listenThreads.clear();
+    // 监听线程都退出了，不会再有新的连接线程
+    for (auto &t : m_clientThreads) {
+        if (t.joinable()) t.join();
+    }
+    m_clientThreads.clear();
+    if (m_simThread.joinable()) m_simThread.join();
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    if (m_log) {
+        std::fclose(m_log);
+        m_log = nullptr;
+    }
+}
+
+MockControllerStats MockUrController::stats() const {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    return m_stats;
+}
+
+std::vector<MockCommandRecord> MockUrController::recentCommands() const {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    return std::vector<MockCommandRecord>(m_recent.begin(), m_recent.end());
+}
+
+void MockUrController::simulateLoop() {
+    // 按绝对时刻排期，避免累积漂移
+    const double dt = m_periodNs * 1e-9;
+    int64_t next = steadyNowNs();
+    while (m_running.load()) {
+        m_sim.step(dt);
+        next += m_periodNs;
+        const int64_t wait = next - steadyNowNs();
+        if (wait > 0) std::this_thread::sleep_for(std::chrono::nanoseconds(wait));
+        else if (-wait > kResyncNs) next = steadyNowNs();
+    }
+}
+
+void MockUrController::listenLoop(quint16 port, std::shared_ptr<std::promise<bool>> ready) {
+    // 服务器在本线程创建，只用阻塞接口 (waitForNewConnection)，不需要事件循环
+    DescriptorServer server;
+    server.setProxy(QNetworkProxy::NoProxy);
+    if (!server.listen(QHostAddress(m_options.host), port)) {
+        qDebug() << "❌ 无法监听端口" << port << ":" << server.errorString();
+        ready->set_value(false);
+        return;
+    }
+    ready->set_value(true);
+
+    while (m_running.load()) {
+        server.waitForNewConnection(kAcceptPollMs);
+        for (qintptr descriptor : server.pending) {
+            const int client = ++m_nextClient;
+            std::lock_guard<std::mutex> lock(m_clientMutex);
+            m_clientThreads.emplace_back(&MockUrController::clientLoop, this, descriptor, port, client);
+        }
+        server.pending.clear();
+    }
+    server.close();
+}
+
+void MockUrController::clientLoop(qintptr descriptor, quint16 port, int client) {
+    QTcpSocket socket;
+    if (!socket.setSocketDescriptor(descriptor)) {
+        qDebug() << "⚠️ 接管连接失败:" << socket.errorString();
+        return;
+    }
+    // 状态包和指令都是小包，关掉 Nagle 算法
+    socket.setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    const QString peer = QString("%1:%2").arg(socket.peerAddress().toString()).arg(socket.peerPort());
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        ++m_stats.clients;
+        ++m_stats.connections;
+    }
+    qDebug() << "✅ 客户端已连接:" << peer << "-> 端口" << port << "| 连接" << client;
+
+    ScriptParser<Command> parser;
+    std::vector<unsigned char> packet(RobotStateEncoder::kPacketBytes);
+    char readBuffer[4096];
+    RobotState state;
+    uint64_t n = 0;
+    int64_t next = steadyNowNs();
+
+    while (m_running.load()) {
+        int64_t now = steadyNowNs();
+        if (now >= next) {
+            // 1. 到点就发状态包
+            ++n;
+            if (m_options.dropEvery > 0 && n % uint64_t(m_options.dropEvery) == 0) {
+                std::lock_guard<std::mutex> lock(m_statsMutex);
+                ++m_stats.packetsDropped;
+            } else if (socket.bytesToWrite() > kMaxBacklogBytes) {
+                std::lock_guard<std::mutex> lock(m_statsMutex);
+                ++m_stats.packetsBlocked;
+            } else {
+                const uint64_t version = m_sim.snapshot(state);
+                RobotStateEncoder::encode(state, packet.data());
+                socket.write(reinterpret_cast<const char*>(packet.data()), qint64(packet.size()));
+                socket.flush();
+                const int64_t sent = steadyNowNs();
+                onPacketSent(version, sent, sent - next);
+            }
+            next += m_periodNs;
+            if (now - next > kResyncNs) next = now + m_periodNs;
+            continue;
+        }
+
+        // 2. 两次发包之间等客户端数据: 能按毫秒等的部分阻塞在 socket 上，剩下不到 1 ms 的直接睡
+        const int64_t remaining = next - now;
+        if (remaining >= 1500000) {
+            socket.waitForReadyRead(int((remaining - 500000) / 1000000));
+        } else {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(remaining));
+        }
+        if (socket.bytesAvailable() > 0) {
+            const int64_t recvNs = steadyNowNs();
+            while (socket.bytesAvailable() > 0) {
+                const qint64 got = socket.read(readBuffer, sizeof(readBuffer));
+                if (got <= 0) break;
+                parser.feed(readBuffer, size_t(got), [&](const Command& cmd) { execute(cmd, port, client, recvNs); });
+            }
+        }
+        if (socket.state() != QAbstractSocket::ConnectedState) break;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        --m_stats.clients;
+    }
+    socket.abort();
+    qDebug() << "❌ 客户端已断开:" << peer << "| 连接" << client;
+}
+
+void MockUrController::execute(const Command& cmd, quint16 port, int client, int64_t recvNs) {
+    MockCommandRecord record;
+    record.kind = cmd.kind;
+    record.port = port;
+    record.client = client;
+    record.recvNs = recvNs;
+    record.text = cmd.text;
+
+    // 作用到仿真和登记在同一把锁下，保证状态包不会在两者之间发出而漏掉这条指令
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    switch (cmd.kind) {
+    case MockCommandKind::Speed: record.version = m_sim.runSpeed(cmd.v, cmd.acc); break;
+    case MockCommandKind::Stop: record.version = m_sim.runStop(cmd.acc); break;
+    case MockCommandKind::Move:
+    case MockCommandKind::Program: record.version = m_sim.runPath(cmd.moves); break;
+    default: ++m_stats.unknownCommands; break;
+    }
+    record.controllerTime = m_sim.time();
+    record.id = ++m_nextCommandId;
+    ++m_stats.commands;
+
+    if (record.version) m_unreflected.emplace_back(record.id, record.version);
+    if (m_unreflected.size() > kRecentCommands) m_unreflected.pop_front();
+    m_recent.push_back(record);
+    if (m_recent.size() > kRecentCommands) m_recent.pop_front();
+
+    if (m_log) {
+        std::string text = record.text;
+        std::replace(text.begin(), text.end(), '"', '\'');
+        std::fprintf(m_log, "%llu,%u,%d,%lld,%.6f,%s,\"%s\"\n", (unsigned long long)record.id, unsigned(port), client,
+                     (long long)recvNs, record.controllerTime, kindName(record.kind), text.c_str());
+    }
+    if (m_options.logCommands) {
+        if (cmd.kind == MockCommandKind::Program) {
+            qDebug() << "📝 收到程序: 端口" << port << "连接" << client << "| t=" << record.controllerTime
+                     << "|" << cmd.moves.size() << "个运动指令";
+        } else {
+            qDebug() << "📝 收到命令: 端口" << port << "连接" << client << "| t=" << record.controllerTime
+                     << "|" << QString::fromStdString(cmd.text);
+        }
+    }
+}
+
+void MockUrController::onPacketSent(uint64_t version, int64_t sendNs, int64_t lateNs) {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    ++m_stats.packetsSent;
+    const double lateMs = std::max<int64_t>(0, lateNs) * 1e-6;
+    m_sendLateMsSum += lateMs;
+    m_stats.sendLateMsAvg = m_sendLateMsSum / m_stats.packetsSent;
+    m_stats.sendLateMsMax = std::max(m_stats.sendLateMsMax, lateMs);
+
+    // 版本号不超过这一帧的指令都已经体现在状态里了
+    while (!m_unreflected.empty() && m_unreflected.front().second <= version) {
+        const uint64_t id = m_unreflected.front().first;
+        m_unreflected.pop_front();
+        if (m_recent.empty() || id < m_recent.front().id) continue;
+        MockCommandRecord &record = m_recent[size_t(id - m_recent.front().id)];
+        record.reflectedNs = sendNs;
+        const double ms = (sendNs - record.recvNs) * 1e-6;
+        ++m_reflected;
+        m_reflectMsSum += ms;
+        m_stats.reflectMsAvg = m_reflectMsSum / m_reflected;
+        m_stats.reflectMsMax = std::max(m_stats.reflectMsMax, ms);
+    }
+}
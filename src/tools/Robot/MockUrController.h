@@ -0,0 +1,173 @@
+#ifndef MOCKURCONTROLLER_H
+#define MOCKURCONTROLLER_H
+
+#include <QString>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "RobotState.h"
+
+/**
+ * @brief 简化的运动仿真 (所有连接共享)，和 mock_ur.py 的 Simulator 一致
+ *
+ * 只模拟 TCP 位置，够用来验证指令链路和测延迟:
+ *   speedl / stopl: TCP 速度以加速度 a 趋近目标速度
+ *   movel / movep:  沿路径点直线运动，梯形速度；r=0 的点要停稳，r>0 的点不减速直接通过
+ *   新指令会打断正在执行的运动，和真实控制器一致
+ * 每条运动指令让版本号加一，状态快照带上版本号，用来判断某条指令第一次体现在哪一帧状态里。
+ */
+class MockMotionSimulator
+{
+public:
+    struct Waypoint {
+        double xyz[3] = {};
+        double a = 0.0;
+        double v = 0.0;
+        double r = 0.0;
+        double rot[3] = {};
+        bool hasRotation = false;
+    };
+
+    MockMotionSimulator();
+
+    // 以下三个返回这条指令的版本号
+    uint64_t runSpeed(const double v[3], double acc);
+    uint64_t runStop(double acc);
+    uint64_t runPath(const std::vector<Waypoint>& moves);
+
+    void step(double dt);
+    double time() const;
+
+    /**
+     * @brief 当前状态: 时间、TCP 位姿 / 速度、目标速度 (qdTarget 前三个分量，回显检测用)，关节做缓慢的正弦运动
+     * @return 状态对应的指令版本号
+     */
+    uint64_t snapshot(RobotState& out) const;
+
+private:
+    void stepPath(double dt);
+
+    mutable std::mutex m_mutex;
+    double m_t = 0.0;
+    double m_pose[6];
+    double m_vel[3] = {};
+    double m_speedTarget[3] = {};
+    double m_speedAcc = 0.5;
+    std::deque<Waypoint> m_path;
+    double m_pathSpeed = 0.0;
+    uint64_t m_version = 0;
+};
+
+// 模拟控制器的运行参数
+struct MockControllerOptions {
+    QString host = "127.0.0.1";
+    std::vector<quint16> ports{30003};  // 每个端口都推送状态、接收 URScript
+    double rateHz = 125.0;              // 状态包频率 (CB3: 125, e-Series: 500)
+    int dropEvery = 0;                  // 每 N 个包故意不发一个，用于验证丢包统计 (0 = 不丢)
+    bool logCommands = true;            // 每条指令打印一行 (高频点动压测时可关掉)
+    std::string commandLogPath;         // 非空时把每条指令的接收时间写成 CSV
+};
+
+enum class MockCommandKind { Speed, Stop, Move, Program, Other };
+
+// 收到的一条指令 (时间都是 steady_clock 纳秒)
+struct MockCommandRecord {
+    uint64_t id = 0;
+    MockCommandKind kind = MockCommandKind::Other;
+    quint16 port = 0;
+    int client = 0;
+    int64_t recvNs = 0;             // 从 socket 读到的时刻
+    double controllerTime = 0.0;    // 同一时刻的控制器时间 (状态包里的 time)
+    uint64_t version = 0;           // 仿真里的指令版本号 (非运动指令为 0)
+    int64_t reflectedNs = 0;        // 第一帧体现这条指令的状态包发出的时刻 (0 = 还没有)
+    std::string text;               // 指令文本 (程序只记第一行)
+};
+
+// 模拟控制器的运行统计
+struct MockControllerStats {
+    int clients = 0;                // 当前连接数
+    uint64_t connections = 0;       // 累计连接数
+    uint64_t packetsSent = 0;
+    uint64_t packetsDropped = 0;    // 按 dropEvery 故意没发的包
+    uint64_t packetsBlocked = 0;    // 客户端不读、发送缓冲区积压而跳过的包
+    uint64_t commands = 0;
+    uint64_t unknownCommands = 0;   // 不认识的指令 (只记录，不影响仿真)
+    double sendLateMsAvg = 0.0;     // 状态包实际发出时刻相对排期的平均 / 最大延后
+    double sendLateMsMax = 0.0;
+    double reflectMsAvg = 0.0;      // 收到指令 -> 第一帧体现它的状态包发出
+    double reflectMsMax = 0.0;
+};
+
+/**
+ * @brief C++ 版模拟 UR 控制器 (替代 mock_ur.py 做延迟 / 吞吐测试)
+ *
+ * 每个端口一个监听线程，每个连接一个线程: 按绝对时刻排期推送 30003 格式状态包，
+ * 两次发包之间阻塞等待客户端数据，指令到达时立即打上接收时间戳、解析并作用到共享仿真上。
+ * 和真实控制器一样允许多个客户端同时连接 (程序一条发指令、一条收状态)，状态流里带着指令的效果，
+ * 所以 "发指令 -> 状态流响应" 的延迟可以完全在本机测出来；控制器这一侧的 "收到 -> 发出体现它的状态" 也单独统计。
+ */
+class MockUrController
+{
+public:
+    explicit MockUrController(const MockControllerOptions& options = MockControllerOptions());
+    ~MockUrController();
+
+    MockUrController(const MockUrController&) = delete;
+    MockUrController& operator=(const MockUrController&) = delete;
+
+    // 监听全部端口并启动线程；任何一个端口监听失败都会停掉已启动的部分并返回 false
+    bool start();
+    void stop();
+    bool isRunning() const { return m_running.load(); }
+
+    MockControllerStats stats() const;
+    // 最近收到的指令 (最多 kRecentCommands 条，按接收顺序)
+    std::vector<MockCommandRecord> recentCommands() const;
+
+    MockMotionSimulator& simulator() { return m_sim; }
+
+    static const size_t kRecentCommands = 1024;
+
+private:
+    struct Command;
+
+    void listenLoop(quint16 port, std::shared_ptr<std::promise<bool>> ready);
+    void clientLoop(qintptr descriptor, quint16 port, int client);
+    void simulateLoop();
+
+    // 作用到仿真上并记录 (收到指令的连接线程里调用)
+    void execute(const Command& cmd, quint16 port, int client, int64_t recvNs);
+    // 某个客户端发出了版本号为 version 的状态包，比排期晚了 lateNs
+    void onPacketSent(uint64_t version, int64_t sendNs, int64_t lateNs);
+
+    MockControllerOptions m_options;
+    MockMotionSimulator m_sim;
+    int64_t m_periodNs = 0;
+
+    std::atomic<bool> m_running{false};
+    std::thread m_simThread;
+    std::vector<std::thread> m_listenThreads;
+    std::mutex m_clientMutex;
+    std::vector<std::thread> m_clientThreads;
+    std::atomic<int> m_nextClient{0};
+
+    // 指令记录和统计 (m_statsMutex 保护)
+    mutable std::mutex m_statsMutex;
+    MockControllerStats m_stats;
+    std::deque<MockCommandRecord> m_recent;
+    std::deque<std::pair<uint64_t, uint64_t>> m_unreflected;   // (指令编号, 版本号)，等待状态包体现
+    uint64_t m_nextCommandId = 0;
+    double m_reflectMsSum = 0.0;
+    uint64_t m_reflected = 0;
+    double m_sendLateMsSum = 0.0;
+    FILE *m_log = nullptr;
+};
+
+#endif // MOCKURCONTROLLER_H
@@ -0,0 +1,331 @@
+#include "MotionCommandChannel.h"
+#include "RobotStateReceiver.h"
+#include "tools/Trace/LatencyTrace.h"
+#include "tools/Common/SteadyClock.h"
+#include <QDebug>
+#include <QNetworkProxy>
+#include <QTcpSocket>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+
+namespace {
+const int kConnectTimeoutMs = 1000;
+const int kReconnectIntervalMs = 1000;          // 连不上 / 断线后隔这么久重连
+const int kWriteTimeoutMs = 100;
+const int64_t kEchoTimeoutNs = 1000000000LL;    // 1 秒内没看到响应就不再等
+const double kEchoDelta = 1e-4;                 // 目标关节速度变化超过它 (rad/s) 视为已响应
+
+// 往预分配的缓冲区追加文本 / 数字，不经过 QString 和系统 locale (URScript 必须用 '.' 作小数点)
+void appendText(std::string& buf, const char* text) {
+    buf.append(text);
+}
+
+void appendNumber(std::string& buf, double value, int precision) {
+    char tmp[32];
+    const auto res = std::to_chars(tmp, tmp + sizeof(tmp), value, std::chars_format::fixed, precision);
+    buf.append(tmp, res.ptr);
+}
+}
+
+MotionCommandChannel::MotionCommandChannel(const QString& host, quint16 port)
+    : m_host(host)
+    , m_port(port)
+{
+    for (auto &slot : m_scripts) slot.text.reserve(kScriptReserve);
+    m_sendBuffer.reserve(kScriptReserve);
+}
+
+MotionCommandChannel::~MotionCommandChannel() {
+    stop();
+}
+
+void MotionCommandChannel::start() {
+    if (m_running.load()) return;
+    m_running.store(true);
+    m_thread = std::thread(&MotionCommandChannel::run, this);
+}
+
+void MotionCommandChannel::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running.store(false);
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable()) m_thread.join();
+}
+
+uint64_t MotionCommandChannel::sendStop(double acc) {
+    uint64_t id;
+    bool connected;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        id = ++m_nextId;
+        connected = m_connected.load();
+        // 停止之前排队的速度和脚本都作废，否则 stopl 之后还会接着发出停止前排队的 movel
+        if (m_speed.valid) {
+            m_speed.valid = false;
+            ++m_stats.preempted;
+        }
+        m_stats.preempted += uint64_t(m_scriptCount);
+        m_scriptHead = 0;
+        m_scriptCount = 0;
+        m_stop.valid = true;
+        m_stop.id = id;
+        m_stop.enqueueNs = steadyNowNs();
+        m_stop.acc = acc;
+    }
+    m_cv.notify_one();
+    // 未连接时停止指令留在队列里，重连后第一个发出；但现在没发出去，要让调用方知道
+    return connected ? id : 0;
+}
+
+uint64_t MotionCommandChannel::sendSpeed(const double speeds[6], double acc, double time) {
+    uint64_t id;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_connected.load()) {
+            ++m_stats.rejected;
+            return 0;
+        }
+        id = ++m_nextId;
+        if (m_speed.valid) ++m_stats.coalesced;    // 还没发出去的旧速度直接覆盖
+        m_speed.valid = true;
+        m_speed.id = id;
+        m_speed.enqueueNs = steadyNowNs();
+        for (int i = 0; i < 6; ++i) m_speed.v[i] = speeds[i];
+        m_speed.acc = acc;
+        m_speed.time = time;
+    }
+    m_cv.notify_one();
+    return id;
+}
+
+uint64_t MotionCommandChannel::sendScript(const QByteArray& script) {
+    uint64_t id;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_connected.load()) {
+            ++m_stats.rejected;
+            return 0;
+        }
+        if (m_scriptCount == kScriptSlots) {
+            ++m_stats.dropped;
+            return 0;
+        }
+        PendingScript &slot = m_scripts[(m_scriptHead + m_scriptCount) % kScriptSlots];
+        ++m_scriptCount;
+        id = ++m_nextId;
+        slot.id = id;
+        slot.enqueueNs = steadyNowNs();
+        // URScript 必须以换行符 '\n' 结尾，否则机器不执行
+        slot.text.assign(script.constData(), size_t(script.size()));
+        if (slot.text.empty() || slot.text.back() != '\n') slot.text.push_back('\n');
+    }
+    m_cv.notify_one();
+    return id;
+}
+
+MotionChannelStats MotionCommandChannel::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    MotionChannelStats s = m_stats;
+    s.connected = m_connected.load();
+    return s;
+}
+
+bool MotionCommandChannel::takeNext(MotionCommandTiming& timing) {
+    m_sendBuffer.clear();   // 只清长度，容量保留
+    if (m_stop.valid) {
+        m_stop.valid = false;
+        timing.id = m_stop.id;
+        timing.kind = MotionCommandKind::Stop;
+        timing.enqueueNs = m_stop.enqueueNs;
+        appendText(m_sendBuffer, "stopl(");
+        appendNumber(m_sendBuffer, m_stop.acc, 4);
+        appendText(m_sendBuffer, ")\n");
+        return true;
+    }
+    if (m_speed.valid) {
+        m_speed.valid = false;
+        timing.id = m_speed.id;
+        timing.kind = MotionCommandKind::Speed;
+        timing.enqueueNs = m_speed.enqueueNs;
+        // speedl([x,y,z,rx,ry,rz], a, t)
+        appendText(m_sendBuffer, "speedl([");
+        for (int i = 0; i < 6; ++i) {
+            if (i) appendText(m_sendBuffer, ", ");
+            appendNumber(m_sendBuffer, m_speed.v[i], 6);
+        }
+        appendText(m_sendBuffer, "], ");
+        appendNumber(m_sendBuffer, m_speed.acc, 4);
+        appendText(m_sendBuffer, ", ");
+        appendNumber(m_sendBuffer, m_speed.time, 3);
+        appendText(m_sendBuffer, ")\n");
+        return true;
+    }
+    if (m_scriptCount > 0) {
+        PendingScript &slot = m_scripts[m_scriptHead];
+        m_scriptHead = (m_scriptHead + 1) % kScriptSlots;
+        --m_scriptCount;
+        timing.id = slot.id;
+        timing.kind = MotionCommandKind::Script;
+        timing.enqueueNs = slot.enqueueNs;
+        // 交换而不是拷贝: 槽位拿走旧的发送缓冲区，两边的容量都保留下来
+        m_sendBuffer.swap(slot.text);
+        return true;
+    }
+    return false;
+}
+
+void MotionCommandChannel::recordQueue(int64_t ns) {
+    const double ms = ns * 1e-6;
+    m_queueMsSum += ms;
+    m_stats.queueMsAvg = m_queueMsSum / m_stats.sent;
+    if (ms > m_stats.queueMsMax) m_stats.queueMsMax = ms;
+}
+
+void MotionCommandChannel::finishEcho(int64_t nowNs, bool timedOut) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (timedOut) {
+        ++m_stats.echoTimeouts;
+    } else {
+        m_waitingEcho.echoNs = nowNs;
+        ++m_stats.echoed;
+        const double ms = (nowNs - m_waitingEcho.sendNs) * 1e-6;
+        UR_TRACE_SPAN("robot.state_echo", m_waitingEcho.sendNs, nowNs);   // 发出 -> 状态流里看到响应
+        m_echoMsSum += ms;
+        m_stats.echoMsAvg = m_echoMsSum / m_stats.echoed;
+        if (ms > m_stats.echoMsMax) m_stats.echoMsMax = ms;
+        if (m_stats.last.id == m_waitingEcho.id) m_stats.last.echoNs = nowNs;
+    }
+    m_waitingEcho = MotionCommandTiming();
+}
+
+void MotionCommandChannel::setConnected(bool connected) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_connected.store(connected);
+    if (connected) return;
+    // 断线时还没发出的速度和脚本作废: 重连后再执行断线前的点动 / 轨迹很危险。停止指令保留，重连后第一个发出
+    if (m_speed.valid) {
+        m_speed.valid = false;
+        ++m_stats.rejected;
+    }
+    m_stats.rejected += uint64_t(m_scriptCount);
+    m_scriptHead = 0;
+    m_scriptCount = 0;
+}
+
+void MotionCommandChannel::run() {
+    LatencyTrace::setThreadName("motion command");
+    bool everConnected = false;
+    bool reportedFailure = false;
+
+    while (m_running.load()) {
+        // socket 在本线程创建，只用阻塞接口 (waitFor*)，不需要事件循环
+        QTcpSocket socket;
+        socket.setProxy(QNetworkProxy::NoProxy);
+        socket.connectToHost(m_host, m_port);
+        if (!socket.waitForConnected(kConnectTimeoutMs)) {
+            if (!reportedFailure) qDebug() << "⚠️ 指令通道连接失败，稍后重试:" << socket.errorString();
+            reportedFailure = true;
+            // 连不上就隔一会儿再试，stop() 会立即叫醒
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait_for(lock, std::chrono::milliseconds(kReconnectIntervalMs), [this] { return !m_running.load(); });
+            continue;
+        }
+        // 指令都很短，关掉 Nagle 算法，写完立即发出
+        socket.setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        if (everConnected) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_stats.reconnects;
+        }
+        everConnected = true;
+        reportedFailure = false;
+        setConnected(true);
+        qDebug() << "🎮 指令通道已连接:" << m_host << m_port;
+
+        serve(socket);
+
+        setConnected(false);
+        socket.abort();
+        if (m_waitingEcho.id) finishEcho(steadyNowNs(), true);
+        if (m_running.load()) qDebug() << "⚠️ 指令通道断开，准备重连:" << socket.errorString();
+    }
+    qDebug() << "⏹️ 指令通道线程退出";
+}
+
+void MotionCommandChannel::serve(QTcpSocket& socket) {
+    while (true) {
+        MotionCommandTiming timing;
+        bool have = false;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            auto ready = [this] {
+                return !m_running.load() || m_stop.valid || m_speed.valid || m_scriptCount > 0;
+            };
+            // 等回显时短轮询状态流，否则只需定期清掉连接上推过来的状态数据
+            const auto wait = m_waitingEcho.id ? std::chrono::milliseconds(1) : std::chrono::milliseconds(20);
+            m_cv.wait_for(lock, wait, ready);
+            if (!m_running.load()) return;
+            have = takeNext(timing);
+        }
+
+        if (have) {
+            const int64_t writeStartNs = LatencyTrace::enabled() ? steadyNowNs() : 0;
+            const qint64 n = socket.write(m_sendBuffer.data(), qint64(m_sendBuffer.size()));
+            bool ok = (n == qint64(m_sendBuffer.size()));
+            if (ok) {
+                socket.flush();
+                if (socket.bytesToWrite() > 0) ok = socket.waitForBytesWritten(kWriteTimeoutMs);
+            }
+            timing.sendNs = steadyNowNs();
+            if (ok && writeStartNs) {
+                UR_TRACE_SPAN("robot.command_queue", timing.enqueueNs, writeStartNs);
+                UR_TRACE_SPAN("robot.command_send", writeStartNs, timing.sendNs);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (ok) {
+                    ++m_stats.sent;
+                    recordQueue(timing.sendNs - timing.enqueueNs);
+                    m_stats.last = timing;
+                } else {
+                    ++m_stats.sendErrors;
+                    // 没写出去的停止指令放回队列 (期间没有更新的停止)，重连后再发
+                    if (timing.kind == MotionCommandKind::Stop && !m_stop.valid) {
+                        m_stop.valid = true;
+                        m_stop.id = timing.id;
+                        m_stop.enqueueNs = timing.enqueueNs;
+                    }
+                }
+            }
+            if (!ok) qDebug() << "⚠️ 指令写入失败:" << socket.errorString();
+
+            // 以发出时刻的目标关节速度为基准，之后状态流里它一变就算控制器开始响应
+            RobotState rs;
+            if (ok && m_stateSource && m_stateSource->latest(rs)) {
+                if (m_waitingEcho.id) finishEcho(timing.sendNs, true);  // 上一条还没响应就被新指令取代
+                for (int i = 0; i < 6; ++i) m_echoBaseline[i] = rs.qdTarget[i];
+                m_waitingEcho = timing;
+            }
+        }
+
+        // 30003 在这条连接上也会推送状态包，这里直接丢弃 (状态由 RobotStateReceiver 解码)
+        if (socket.bytesAvailable() > 0 || socket.waitForReadyRead(0)) socket.skip(socket.bytesAvailable());
+        if (socket.state() != QAbstractSocket::ConnectedState) return;
+
+        // 回显检测
+        if (m_waitingEcho.id) {
+            RobotState rs;
+            const int64_t now = steadyNowNs();
+            if (m_stateSource->latest(rs) && rs.recvNs > m_waitingEcho.sendNs) {
+                double delta = 0.0;
+                for (int i = 0; i < 6; ++i) delta = std::max(delta, std::fabs(rs.qdTarget[i] - m_echoBaseline[i]));
+                if (delta > kEchoDelta) finishEcho(rs.recvNs, false);
+            }
+            if (m_waitingEcho.id && now - m_waitingEcho.sendNs > kEchoTimeoutNs) finishEcho(now, true);
+        }
+    }
+}
@@ -0,0 +1,138 @@
+#ifndef MOTIONCOMMANDCHANNEL_H
+#define MOTIONCOMMANDCHANNEL_H
+
+#include <QByteArray>
+#include <QString>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class QTcpSocket;
+class RobotStateReceiver;
+
+// 指令类型 (数值越小优先级越高)
+enum class MotionCommandKind {
+    Stop = 0,       // stopl: 抢占一切，同时作废之前排队的速度和脚本指令
+    Speed = 1,      // speedl: 连续点动，未发出的旧速度会被新速度覆盖 (合并)
+    Script = 2      // 任意 URScript: 先进先出
+};
+
+// 单条指令的时间戳 (steady_clock 纳秒，0 表示还没到这一步)
+struct MotionCommandTiming {
+    uint64_t id = 0;
+    MotionCommandKind kind = MotionCommandKind::Script;
+    int64_t enqueueNs = 0;      // 界面线程入队
+    int64_t sendNs = 0;         // 写入 socket 完成
+    int64_t echoNs = 0;         // 状态流里第一次看到目标速度变化
+};
+
+// 指令通道的运行统计
+struct MotionChannelStats {
+    bool connected = false;
+    uint64_t sent = 0;              // 已发送的指令数
+    uint64_t coalesced = 0;         // 被新速度覆盖、没有发出的速度指令数
+    uint64_t preempted = 0;         // 被停止指令作废的速度 / 脚本指令数
+    uint64_t dropped = 0;           // 脚本队列满被拒绝的指令数
+    uint64_t rejected = 0;          // 未连接时被拒绝、或断线时还没发出而作废的速度 / 脚本指令数
+    uint64_t reconnects = 0;        // 断线重连次数
+    uint64_t sendErrors = 0;        // 写失败次数
+    uint64_t echoed = 0;            // 在状态流里观察到响应的指令数
+    uint64_t echoTimeouts = 0;      // 1 秒内没观察到响应的指令数
+    double queueMsAvg = 0.0;        // 入队 -> 发出
+    double queueMsMax = 0.0;
+    double echoMsAvg = 0.0;         // 发出 -> 状态流响应
+    double echoMsMax = 0.0;
+    MotionCommandTiming last;       // 最近一条指令
+};
+
+/**
+ * @brief 机械臂运动指令通道：独立连接 + 独立线程
+ *
+ * 界面线程只把参数放进一个很小的优先级队列就返回，格式化和写 socket 都在通道线程完成，
+ * 界面忙着解码图像时也不会推迟停止指令。
+ *   - 停止 > 速度 > 脚本；停止入队时作废尚未发出的速度和脚本指令
+ *   - 速度指令只保留最新的一条 (连续点动时旧的速度没意义)
+ *   - 指令格式化到预先分配的缓冲区，socket 开启 TCP_NODELAY
+ *   - 每条指令记录 入队 / 发出 / 回显 三个时间戳；回显来自 RobotStateReceiver 的目标关节速度变化
+ *   - 连不上或断线后自动重连；未连接期间拒绝速度和脚本指令，避免点动的停止指令无声丢失
+ */
+class MotionCommandChannel
+{
+public:
+    explicit MotionCommandChannel(const QString& host, quint16 port = 30003);
+    ~MotionCommandChannel();
+
+    MotionCommandChannel(const MotionCommandChannel&) = delete;
+    MotionCommandChannel& operator=(const MotionCommandChannel&) = delete;
+
+    /**
+     * @brief 用于测量回显延迟的状态流 (可选，需在 start() 之前设置，生命周期要长于通道)
+     */
+    void setStateSource(const RobotStateReceiver* receiver) { m_stateSource = receiver; }
+
+    void start();
+    void stop();
+    bool isConnected() const { return m_connected.load(); }
+
+    /**
+     * 以下接口线程安全，只入队不等待，返回指令编号 (0 = 没有发出)。
+     * 通道未连接 (还没连上或断线重连中) 时速度和脚本指令直接拒绝；
+     * 停止指令仍然保留，重连后第一个发出，但同样返回 0，调用方要提示用户停止没能及时送达
+     */
+    uint64_t sendStop(double acc);
+    uint64_t sendSpeed(const double speeds[6], double acc, double time);
+    uint64_t sendScript(const QByteArray& script);
+
+    MotionChannelStats stats() const;
+
+private:
+    static const int kScriptSlots = 16;
+    static const size_t kScriptReserve = 4096;
+
+    struct PendingStop { bool valid = false; uint64_t id = 0; int64_t enqueueNs = 0; double acc = 0.0; };
+    struct PendingSpeed { bool valid = false; uint64_t id = 0; int64_t enqueueNs = 0; double v[6] = {}; double acc = 0.0; double time = 0.0; };
+    struct PendingScript { uint64_t id = 0; int64_t enqueueNs = 0; std::string text; };
+
+    void run();
+    // 一条连接上的发送循环，断线或 stop() 时返回
+    void serve(QTcpSocket& socket);
+    // 更新连接状态；断线时作废还没发出的速度和脚本 (停止指令保留)
+    void setConnected(bool connected);
+    // 取出优先级最高的一条并格式化到 m_sendBuffer，返回是否取到
+    bool takeNext(MotionCommandTiming& timing);
+    void finishEcho(int64_t nowNs, bool timedOut);
+    void recordQueue(int64_t ns);
+
+    QString m_host;
+    quint16 m_port;
+    const RobotStateReceiver* m_stateSource = nullptr;
+
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_connected{false};   // 持有 m_mutex 时修改，和队列状态一致
+
+    // 队列 (m_mutex 保护)
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    uint64_t m_nextId = 0;
+    PendingStop m_stop;
+    PendingSpeed m_speed;
+    std::array<PendingScript, kScriptSlots> m_scripts;  // 环形队列，字符串容量预先分配
+    int m_scriptHead = 0;
+    int m_scriptCount = 0;
+
+    // 只在通道线程里使用
+    std::string m_sendBuffer;               // 待发送的指令文本 (预分配，与脚本槽位交换)
+    MotionCommandTiming m_waitingEcho;      // 正在等回显的指令
+    double m_echoBaseline[6] = {};          // 发出时的目标关节速度
+
+    // 统计 (m_mutex 保护)
+    MotionChannelStats m_stats;
+    double m_queueMsSum = 0.0;
+    double m_echoMsSum = 0.0;
+};
+
+#endif // MOTIONCOMMANDCHANNEL_H
@@ -0,0 +1,148 @@
+#include "RobotState.h"
+#include <cstring>
+
+namespace {
+
+// 30003 实时接口各字段相对包头的字节偏移 (UR 官方 "Real-Time Interface" 文档)
+const size_t kOffTime = 4;
+const size_t kOffQTarget = 12;
+const size_t kOffQdTarget = 60;
+const size_t kOffQActual = 252;
+const size_t kOffQdActual = 300;
+const size_t kOffIActual = 348;
+const size_t kOffToolVector = 444;
+const size_t kOffTcpSpeed = 492;
+const size_t kOffTcpForce = 540;
+const size_t kOffToolVectorTarget = 588;
+const size_t kOffDigitalInputs = 684;
+const size_t kOffMotorTemps = 692;
+const size_t kOffRobotMode = 756;
+const size_t kOffJointModes = 764;
+const size_t kOffSafetyMode = 812;
+const size_t kOffSpeedScaling = 940;
+const size_t kOffDigitalOutputs = 1044;    // 前面 996 ~ 1043 是 6 个关节电压 (V actual)
+const size_t kOffProgramState = 1052;
+
+inline uint64_t loadBE64(const unsigned char* p) {
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap64(v);
+#else
+    return ((v & 0x00000000000000FFull) << 56) | ((v & 0x000000000000FF00ull) << 40) |
+           ((v & 0x0000000000FF0000ull) << 24) | ((v & 0x00000000FF000000ull) << 8) |
+           ((v & 0x000000FF00000000ull) >> 8) | ((v & 0x0000FF0000000000ull) >> 24) |
+           ((v & 0x00FF000000000000ull) >> 40) | ((v & 0xFF00000000000000ull) >> 56);
+#endif
+}
+
+inline double loadBEDouble(const unsigned char* p) {
+    const uint64_t bits = loadBE64(p);
+    double d;
+    std::memcpy(&d, &bits, 8);
+    return d;
+}
+
+inline void loadBEVector(const unsigned char* p, double* out, int n) {
+    for (int i = 0; i < n; ++i) out[i] = loadBEDouble(p + 8 * i);
+}
+
+inline void storeBEDouble(unsigned char* p, double d) {
+    uint64_t bits;
+    std::memcpy(&bits, &d, 8);
+    for (int i = 7; i >= 0; --i) {
+        p[i] = static_cast<unsigned char>(bits & 0xFF);
+        bits >>= 8;
+    }
+}
+
+inline void storeBEVector(unsigned char* p, const double* in, int n) {
+    for (int i = 0; i < n; ++i) storeBEDouble(p + 8 * i, in[i]);
+}
+
+// 整组字段都在包内才解析，返回是否解析了
+inline bool field(const unsigned char* packet, size_t bytes, size_t offset, double* out, int n) {
+    if (offset + 8 * size_t(n) > bytes) return false;
+    loadBEVector(packet + offset, out, n);
+    return true;
+}
+
+} // namespace
+
+namespace RobotStateDecoder {
+
+uint32_t readLength(const unsigned char* p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+bool decode(const unsigned char* packet, size_t bytes, RobotState& out) {
+    uint32_t groups = 0;
+    if (!field(packet, bytes, kOffTime, &out.time, 1)) return false;
+    ++groups;
+
+    // 按偏移顺序逐组解析，遇到第一组越界就停 (老版本控制器的包更短)
+    double bits = 0.0;
+    const bool ok =
+        field(packet, bytes, kOffQTarget, out.qTarget, 6) && ++groups &&
+        field(packet, bytes, kOffQdTarget, out.qdTarget, 6) && ++groups &&
+        field(packet, bytes, kOffQActual, out.qActual, 6) && ++groups &&
+        field(packet, bytes, kOffQdActual, out.qdActual, 6) && ++groups &&
+        field(packet, bytes, kOffIActual, out.currentActual, 6) && ++groups &&
+        field(packet, bytes, kOffToolVector, out.tcpPose, 6) && ++groups &&
+        field(packet, bytes, kOffTcpSpeed, out.tcpSpeed, 6) && ++groups &&
+        field(packet, bytes, kOffTcpForce, out.tcpForce, 6) && ++groups &&
+        field(packet, bytes, kOffToolVectorTarget, out.tcpPoseTarget, 6) && ++groups &&
+        field(packet, bytes, kOffDigitalInputs, &bits, 1) && ++groups &&
+        field(packet, bytes, kOffMotorTemps, out.motorTemperatures, 6) && ++groups &&
+        field(packet, bytes, kOffRobotMode, &out.robotMode, 1) && ++groups &&
+        field(packet, bytes, kOffJointModes, out.jointModes, 6) && ++groups &&
+        field(packet, bytes, kOffSafetyMode, &out.safetyMode, 1) && ++groups &&
+        field(packet, bytes, kOffSpeedScaling, &out.speedScaling, 1) && ++groups;
+    if (groups > 10) out.digitalInputs = uint64_t(bits);   // 控制器把位掩码当 double 发
+
+    if (ok) {
+        if (field(packet, bytes, kOffDigitalOutputs, &bits, 1)) {
+            out.digitalOutputs = uint64_t(bits);
+            ++groups;
+            if (field(packet, bytes, kOffProgramState, &out.programState, 1)) ++groups;
+        }
+    }
+
+    out.packetBytes = uint32_t(bytes);
+    out.validFields = groups;
+    return true;
+}
+
+} // namespace RobotStateDecoder
+
+namespace RobotStateEncoder {
+
+size_t encode(const RobotState& state, unsigned char* out) {
+    std::memset(out, 0, kPacketBytes);
+    out[0] = static_cast<unsigned char>(kPacketBytes >> 24);
+    out[1] = static_cast<unsigned char>(kPacketBytes >> 16);
+    out[2] = static_cast<unsigned char>(kPacketBytes >> 8);
+    out[3] = static_cast<unsigned char>(kPacketBytes);
+
+    storeBEDouble(out + kOffTime, state.time);
+    storeBEVector(out + kOffQTarget, state.qTarget, 6);
+    storeBEVector(out + kOffQdTarget, state.qdTarget, 6);
+    storeBEVector(out + kOffQActual, state.qActual, 6);
+    storeBEVector(out + kOffQdActual, state.qdActual, 6);
+    storeBEVector(out + kOffIActual, state.currentActual, 6);
+    storeBEVector(out + kOffToolVector, state.tcpPose, 6);
+    storeBEVector(out + kOffTcpSpeed, state.tcpSpeed, 6);
+    storeBEVector(out + kOffTcpForce, state.tcpForce, 6);
+    storeBEVector(out + kOffToolVectorTarget, state.tcpPoseTarget, 6);
+    storeBEDouble(out + kOffDigitalInputs, double(state.digitalInputs));
+    storeBEVector(out + kOffMotorTemps, state.motorTemperatures, 6);
+    storeBEDouble(out + kOffRobotMode, state.robotMode);
+    storeBEVector(out + kOffJointModes, state.jointModes, 6);
+    storeBEDouble(out + kOffSafetyMode, state.safetyMode);
+    storeBEDouble(out + kOffSpeedScaling, state.speedScaling);
+    storeBEDouble(out + kOffDigitalOutputs, double(state.digitalOutputs));
+    storeBEDouble(out + kOffProgramState, state.programState);
+    return kPacketBytes;
+}
+
+} // namespace RobotStateEncoder
@@ -0,0 +1,81 @@
+#ifndef ROBOTSTATE_H
+#define ROBOTSTATE_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief UR 实时接口 (端口 30003) 的一帧状态
+ *
+ * 控制器以 125 Hz (CB3) / 500 Hz (e-Series) 推送，每帧格式:
+ *   int32 总长度 (含这 4 字节) + 若干 double，全部大端。
+ * 这里只挑界面和规划要用的字段，定长、无指针，可以直接按字节拷贝 (SeqLock 要求)。
+ * 控制器版本较老、包长不够时，缺的字段保持 0，validFields 标出实际解析到哪一组。
+ */
+struct RobotState {
+    double time = 0.0;              // 控制器启动以来的时间 (秒)
+    double qTarget[6] = {};         // 目标关节角 (rad)
+    double qdTarget[6] = {};        // 目标关节速度 (rad/s)
+    double qActual[6] = {};         // 实际关节角 (rad)
+    double qdActual[6] = {};        // 实际关节速度 (rad/s)
+    double currentActual[6] = {};   // 实际关节电流 (A)
+    double tcpPose[6] = {};         // 实际 TCP 位姿 x,y,z (m) + 旋转向量 rx,ry,rz (rad)
+    double tcpSpeed[6] = {};        // 实际 TCP 速度
+    double tcpForce[6] = {};        // TCP 力/力矩
+    double tcpPoseTarget[6] = {};   // 目标 TCP 位姿
+    double motorTemperatures[6] = {};
+    double jointModes[6] = {};
+    uint64_t digitalInputs = 0;
+    uint64_t digitalOutputs = 0;
+    double robotMode = 0.0;
+    double safetyMode = 0.0;
+    double speedScaling = 0.0;
+    double programState = 0.0;
+
+    // ---- 接收端附加信息 ----
+    uint32_t packetBytes = 0;       // 本帧长度
+    uint32_t validFields = 0;       // 解析到的字段组数 (见 RobotStateDecoder)
+    uint64_t seq = 0;               // 接收端帧序号 (从 1 开始)
+    int64_t recvNs = 0;             // 接收时间 (steady_clock 纳秒)
+};
+
+/**
+ * @brief 30003 实时数据包的解码 (就地解析，不分配内存)
+ */
+namespace RobotStateDecoder {
+
+// 包长的合理范围 (不同控制器版本 560 ~ 1220 字节左右)，超出视为帧错位
+const uint32_t kMinPacketBytes = 4 + 8;
+const uint32_t kMaxPacketBytes = 4096;
+
+// 读取大端 int32 包长
+uint32_t readLength(const unsigned char* p);
+
+/**
+ * @brief 把一整帧解码到 out (out 里接收端附加信息不动)
+ * @param packet 指向包头 (长度字段) 的指针
+ * @param bytes 整帧长度 (= readLength(packet))
+ * @return 至少解析到了 time 字段返回 true
+ */
+bool decode(const unsigned char* packet, size_t bytes, RobotState& out);
+
+} // namespace RobotStateDecoder
+
+/**
+ * @brief 反方向: 把 RobotState 编码成 30003 实时数据包 (模拟控制器用)
+ */
+namespace RobotStateEncoder {
+
+// CB3.5 格式: int32 包长 + 138 个 double，共 1108 字节
+const uint32_t kPacketBytes = 4 + 8 * 138;
+
+/**
+ * @brief 编码一整帧 (大端)，RobotState 里没有的字段填 0，接收端附加信息不编码
+ * @param out 至少 kPacketBytes 字节
+ * @return 写入的字节数 (= kPacketBytes)
+ */
+size_t encode(const RobotState& state, unsigned char* out);
+
+} // namespace RobotStateEncoder
+
+#endif // ROBOTSTATE_H
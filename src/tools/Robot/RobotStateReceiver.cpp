@@ -0,0 +1,181 @@
+#include "RobotStateReceiver.h"
+#include "tools/Common/SteadyClock.h"
+#include <QDebug>
+#include <QNetworkProxy>
+#include <QTcpSocket>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace {
+// 接收缓冲区: 能放下几十个包，界面卡顿或网络突发时也不会溢出
+const size_t kBufferBytes = 64 * 1024;
+const int kConnectTimeoutMs = 1000;
+const int kReadTimeoutMs = 100;         // 决定 stop() 最长的等待时间
+const int64_t kStatsWindowNs = 1000000000LL;
+}
+
+RobotStateReceiver::RobotStateReceiver(const QString& host, quint16 port)
+    : m_host(host)
+    , m_port(port)
+    , m_buffer(kBufferBytes)
+{
+}
+
+RobotStateReceiver::~RobotStateReceiver() {
+    stop();
+}
+
+void RobotStateReceiver::start() {
+    if (m_running.load()) return;
+    m_running.store(true);
+    m_thread = std::thread(&RobotStateReceiver::run, this);
+}
+
+void RobotStateReceiver::stop() {
+    m_running.store(false);
+    if (m_thread.joinable()) m_thread.join();
+}
+
+bool RobotStateReceiver::latest(RobotState& out) const {
+    return m_latest.load(out) > 0;
+}
+
+StateStreamStats RobotStateReceiver::stats() const {
+    StateStreamStats s;
+    s.connected = m_connected.load();
+    s.packets = m_packets.load();
+    s.bytes = m_bytes.load();
+    s.gaps = m_gaps.load();
+    s.framingErrors = m_framingErrors.load();
+    s.reconnects = m_reconnects.load();
+    s.rateHz = m_rateHz.load();
+    s.jitterMs = m_jitterMs.load();
+    s.maxIntervalMs = m_maxIntervalMs.load();
+    return s;
+}
+
+void RobotStateReceiver::run() {
+    bool everConnected = false;
+
+    while (m_running.load()) {
+        // socket 在本线程创建，只用阻塞接口 (waitFor*)，不需要事件循环
+        QTcpSocket socket;
+        socket.setProxy(QNetworkProxy::NoProxy);
+        socket.connectToHost(m_host, m_port);
+        if (!socket.waitForConnected(kConnectTimeoutMs)) {
+            // 连不上就隔一会儿再试，同时保证 stop() 能及时返回
+            for (int i = 0; i < 10 && m_running.load(); ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(kReadTimeoutMs));
+            }
+            continue;
+        }
+
+        if (everConnected) m_reconnects.fetch_add(1);
+        everConnected = true;
+        m_connected.store(true);
+        qDebug() << "📡 实时状态流已连接:" << m_host << m_port;
+
+        // 新连接从头对齐
+        size_t used = 0;
+        m_resyncing = false;
+        m_lastControllerTime = -1.0;
+        m_lastRecvNs = 0;
+        m_windowStart = steadyNowNs();
+        m_windowPackets = 0;
+        m_windowMaxIntervalNs = 0;
+
+        while (m_running.load()) {
+            if (socket.bytesAvailable() == 0 && !socket.waitForReadyRead(kReadTimeoutMs)) {
+                if (socket.state() != QAbstractSocket::ConnectedState) break;
+                continue;   // 只是超时
+            }
+            const qint64 n = socket.read(reinterpret_cast<char*>(m_buffer.data()) + used,
+                                         qint64(m_buffer.size() - used));
+            if (n < 0) break;
+            if (n == 0) continue;
+
+            const int64_t recvNs = steadyNowNs();
+            m_bytes.fetch_add(uint64_t(n));
+            used += size_t(n);
+
+            // 解码所有完整的包，把剩下的半个包挪到缓冲区开头
+            const size_t eaten = consume(m_buffer.data(), used, recvNs);
+            if (eaten > 0) {
+                std::memmove(m_buffer.data(), m_buffer.data() + eaten, used - eaten);
+                used -= eaten;
+            }
+        }
+
+        m_connected.store(false);
+        socket.abort();
+        if (m_running.load()) qDebug() << "⚠️ 实时状态流断开，准备重连:" << socket.errorString();
+    }
+    qDebug() << "⏹️ 实时状态接收线程退出";
+}
+
+size_t RobotStateReceiver::consume(const unsigned char* data, size_t size, int64_t recvNs) {
+    size_t pos = 0;
+    while (size - pos >= 4) {
+        const uint32_t len = RobotStateDecoder::readLength(data + pos);
+        if (len < RobotStateDecoder::kMinPacketBytes || len > RobotStateDecoder::kMaxPacketBytes) {
+            // 包长不合法: 说明帧错位了，逐字节往后找下一个合理的包头 (一次错位只计一次)
+            if (!m_resyncing) m_framingErrors.fetch_add(1);
+            m_resyncing = true;
+            ++pos;
+            continue;
+        }
+        if (size - pos < len) break;    // 半个包，等下次
+        m_resyncing = false;
+        onPacket(data + pos, len, recvNs);
+        pos += len;
+    }
+    return pos;
+}
+
+void RobotStateReceiver::onPacket(const unsigned char* packet, size_t bytes, int64_t recvNs) {
+    if (!RobotStateDecoder::decode(packet, bytes, m_decoding)) return;
+    m_decoding.seq = ++m_seq;
+    m_decoding.recvNs = recvNs;
+    m_latest.store(m_decoding);
+    m_packets.fetch_add(1);
+
+    // 1. 丢包: 控制器时间戳的间隔明显大于周期
+    const double t = m_decoding.time;
+    if (m_lastControllerTime >= 0.0) {
+        const double dt = t - m_lastControllerTime;
+        if (dt > 0.0) {
+            if (m_periodS <= 0.0) {
+                m_periodS = dt;
+            } else if (dt > 1.5 * m_periodS) {
+                m_gaps.fetch_add(uint64_t(std::lround(dt / m_periodS)) - 1);
+            } else {
+                m_periodS += 0.1 * (dt - m_periodS);    // 慢慢跟踪真实周期
+            }
+        }
+    }
+    m_lastControllerTime = t;
+
+    // 2. 抖动: 到达间隔与控制器周期之差的平滑绝对值
+    if (m_lastRecvNs > 0) {
+        const int64_t interval = recvNs - m_lastRecvNs;
+        if (m_periodS > 0.0) {
+            const double d = std::fabs(double(interval) - m_periodS * 1e9);
+            m_jitterNs += (d - m_jitterNs) / 16.0;
+            m_jitterMs.store(m_jitterNs * 1e-6);
+        }
+        if (interval > m_windowMaxIntervalNs) m_windowMaxIntervalNs = interval;
+    }
+    m_lastRecvNs = recvNs;
+
+    // 3. 包率
+    ++m_windowPackets;
+    const int64_t elapsed = recvNs - m_windowStart;
+    if (elapsed >= kStatsWindowNs) {
+        m_rateHz.store(m_windowPackets * 1e9 / elapsed);
+        m_maxIntervalMs.store(m_windowMaxIntervalNs * 1e-6);
+        m_windowStart = recvNs;
+        m_windowPackets = 0;
+        m_windowMaxIntervalNs = 0;
+    }
+}
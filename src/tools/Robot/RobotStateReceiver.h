@@ -0,0 +1,93 @@
+#ifndef ROBOTSTATERECEIVER_H
+#define ROBOTSTATERECEIVER_H
+
+#include <QString>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "RobotState.h"
+#include "SeqLock.h"
+
+// 实时状态流的运行统计
+struct StateStreamStats {
+    bool connected = false;
+    uint64_t packets = 0;           // 成功解码的包数
+    uint64_t bytes = 0;             // 收到的总字节数
+    uint64_t gaps = 0;              // 按控制器时间戳判断出的丢包次数
+    uint64_t framingErrors = 0;     // 包长不合法、逐字节重新对齐的次数
+    uint64_t reconnects = 0;        // 连接断开后重连的次数
+    double rateHz = 0.0;            // 最近一个统计窗口 (约 1 秒) 的包率
+    double jitterMs = 0.0;          // 到达间隔相对控制器周期的平滑抖动 (RFC 3550 式)
+    double maxIntervalMs = 0.0;     // 最近一个统计窗口内最大的到达间隔
+};
+
+/**
+ * @brief UR 实时接口 (端口 30003) 的后台接收器
+ *
+ * 独立 I/O 线程用阻塞 socket 读数据，按大端包长分帧，直接从接收缓冲区解码到定长 RobotState，
+ * 再通过 SeqLock 发布最新值。整个循环只用构造时分配好的缓冲区，稳态下没有任何内存分配。
+ * 界面线程随时调用 latest() 取快照，不会被网络阻塞，也不会阻塞接收线程。
+ * 连接断开会每秒自动重连一次，直到 stop()。
+ */
+class RobotStateReceiver
+{
+public:
+    explicit RobotStateReceiver(const QString& host, quint16 port = 30003);
+    ~RobotStateReceiver();
+
+    RobotStateReceiver(const RobotStateReceiver&) = delete;
+    RobotStateReceiver& operator=(const RobotStateReceiver&) = delete;
+
+    // 启动 / 停止接收线程 (stop 最多等待一个读超时周期)
+    void start();
+    void stop();
+    bool isRunning() const { return m_running.load(); }
+
+    /**
+     * @brief 读取最新状态快照
+     * @return 还没有收到过任何包时返回 false
+     */
+    bool latest(RobotState& out) const;
+
+    StateStreamStats stats() const;
+
+private:
+    void run();     // 接收线程主循环
+    // 处理缓冲区里的完整包，返回消耗的字节数
+    size_t consume(const unsigned char* data, size_t size, int64_t recvNs);
+    void onPacket(const unsigned char* packet, size_t bytes, int64_t recvNs);
+
+    QString m_host;
+    quint16 m_port;
+
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+
+    SeqLock<RobotState> m_latest;
+
+    // 只在接收线程里使用
+    std::vector<unsigned char> m_buffer;    // 定长接收缓冲区
+    RobotState m_decoding;                  // 解码中的状态 (成功后整体发布)
+    uint64_t m_seq = 0;
+    bool m_resyncing = false;
+    double m_lastControllerTime = -1.0;
+    double m_periodS = 0.0;                 // 估计出的控制器周期 (125 Hz / 500 Hz)
+    int64_t m_lastRecvNs = 0;
+    double m_jitterNs = 0.0;
+    int64_t m_windowStart = 0;
+    uint64_t m_windowPackets = 0;
+    int64_t m_windowMaxIntervalNs = 0;
+
+    // 统计计数 (接收线程写，任意线程读)
+    std::atomic<bool> m_connected{false};
+    std::atomic<uint64_t> m_packets{0};
+    std::atomic<uint64_t> m_bytes{0};
+    std::atomic<uint64_t> m_gaps{0};
+    std::atomic<uint64_t> m_framingErrors{0};
+    std::atomic<uint64_t> m_reconnects{0};
+    std::atomic<double> m_rateHz{0.0};
+    std::atomic<double> m_jitterMs{0.0};
+    std::atomic<double> m_maxIntervalMs{0.0};
+};
+
+#endif // ROBOTSTATERECEIVER_H
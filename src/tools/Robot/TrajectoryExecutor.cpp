@@ -0,0 +1,264 @@
+#include "TrajectoryExecutor.h"
+#include "MotionCommandChannel.h"
+#include "RobotStateReceiver.h"
+#include "tools/Path_Plan/CollisionChecker.h"
+#include "tools/Common/SteadyClock.h"
+#include <QDebug>
+#include <QString>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const double kMinBlend = 0.001;     // 小于 1mm 的转接半径没有意义，直接按 0 处理
+const int kBlendHalvings = 4;       // 转接弧碰撞时最多减半几次
+
+double length(const cv::Point3f& a, const cv::Point3f& b) {
+    return cv::norm(b - a);
+}
+
+// URScript 数字: QString::number 不受系统 locale 影响，小数点固定为 '.'
+QString num(double v, int precision = 5) {
+    return QString::number(v, 'f', precision);
+}
+}
+
+TrajectoryExecutor::TrajectoryExecutor(MotionCommandChannel& channel, const RobotStateReceiver& state)
+    : m_channel(channel)
+    , m_stateSource(state)
+{
+}
+
+std::vector<double> TrajectoryExecutor::computeBlendRadii(const std::vector<cv::Point3f>& path) const {
+    std::vector<double> radii(path.size(), 0.0);
+    for (size_t i = 1; i + 1 < path.size(); ++i) {
+        const cv::Point3f &prev = path[i - 1], &p = path[i], &next = path[i + 1];
+        const double lin = length(prev, p);
+        const double lout = length(p, next);
+        if (lin < 1e-9 || lout < 1e-9) continue;
+
+        // UR 要求相邻两个转接区不重叠，所以不超过较短一段的一半 (留 10% 余量)
+        double r = std::min(m_options.maxBlend, 0.45 * std::min(lin, lout));
+
+        if (m_collision) {
+            // 转接弧落在三角形 (a, p, b) 内: 原来的两段已经无碰撞，再检查弦 a-b 和中线 p-mid，
+            // 障碍物加上余量后比三角形大，不可能整个藏在三角形内部而不碰到这几条线
+            bool blocked = true;
+            for (int k = 0; k <= kBlendHalvings && r >= kMinBlend; ++k) {
+                const cv::Point3f a = p + (prev - p) * float(r / lin);
+                const cv::Point3f b = p + (next - p) * float(r / lout);
+                const cv::Point3f mid = (a + b) * 0.5f;
+                blocked = m_collision->segmentCollides(a, b, m_options.clearance) ||
+                          m_collision->segmentCollides(p, mid, m_options.clearance);
+                if (!blocked) break;
+                r *= 0.5;
+            }
+            if (blocked) r = 0.0;
+        }
+        radii[i] = r >= kMinBlend ? r : 0.0;
+    }
+    return radii;
+}
+
+QByteArray TrajectoryExecutor::moveLine(const cv::Point3f& p, const double rotation[3], double radius, bool moveP) const {
+    const cv::Point3f b = toBase(p);
+    return QString("%1(p[%2, %3, %4, %5, %6, %7], a=%8, v=%9, r=%10)")
+        .arg(moveP ? "movep" : "movel")
+        .arg(num(b.x)).arg(num(b.y)).arg(num(b.z))
+        .arg(num(rotation[0])).arg(num(rotation[1])).arg(num(rotation[2]))
+        .arg(num(m_options.acc, 3)).arg(num(m_options.vel, 3)).arg(num(radius))
+        .toUtf8();
+}
+
+QByteArray TrajectoryExecutor::buildProgram(const std::vector<cv::Point3f>& path, const double rotation[3]) const {
+    return buildProgram(path, computeBlendRadii(path), rotation);
+}
+
+QByteArray TrajectoryExecutor::buildProgram(const std::vector<cv::Point3f>& path, const std::vector<double>& radii,
+                                            const double rotation[3]) const {
+    QByteArray program;
+    program.reserve(int(64 + path.size() * 96));
+    program.append("def rrt_path():\n");
+    // 先停稳在起点，再整段连续走完
+    program.append("  ").append(moveLine(path.front(), rotation, 0.0, false)).append('\n');
+    for (size_t i = 1; i < path.size(); ++i) {
+        program.append("  ").append(moveLine(path[i], rotation, radii[i], m_options.useMoveP)).append('\n');
+    }
+    program.append("end\n");
+    return program;
+}
+
+bool TrajectoryExecutor::execute(const std::vector<cv::Point3f>& path, TrajectoryMode mode) {
+    if (path.empty()) return false;
+
+    RobotState rs;
+    if (!m_stateSource.latest(rs)) {
+        qDebug() << "⚠️ 还没有收到机械臂状态，无法执行轨迹";
+        return false;
+    }
+    for (int i = 0; i < 3; ++i) {
+        m_rotation[i] = m_options.keepCurrentRotation ? rs.tcpPose[3 + i] : m_options.rotation[i];
+    }
+
+    UR12e::IKPathResult ik;
+    if (m_options.checkReachability) {
+        std::vector<cv::Point3f> basePath;
+        for (const auto &p : path) basePath.push_back(toBase(p));
+        JointVector seed;
+        for (int j = 0; j < UR12e::kDof; ++j) seed[j] = rs.qActual[j];
+        ik = checkReachable(basePath, m_rotation, seed);
+        if (!ik.ok) {
+            qDebug() << "❌ 轨迹不可执行: 第" << int(ik.failedIndex) << "个采样点"
+                     << (ik.maxStep > m_options.maxJointStep ? "关节跳变 (奇异位形附近)" : "逆解无解 (够不着)");
+            return false;
+        }
+    }
+
+    m_mode = mode;
+    m_path.clear();
+    m_cumLength.assign(1, 0.0);
+    for (const auto &p : path) {
+        if (!m_path.empty()) m_cumLength.push_back(m_cumLength.back() + length(m_path.back(), toBase(p)));
+        m_path.push_back(toBase(p));
+    }
+
+    m_report = TrajectoryReport();
+    m_report.mode = mode;
+    m_report.waypoints = int(path.size());
+    m_report.pathLength = m_cumLength.back();
+    m_report.maxJointStep = ik.maxStep;
+    m_segment = 0;
+    m_progress = 0.0;
+    m_startNs = steadyNowNs();
+
+    // 超时: 按匀速走完 (含从当前位置到第一个点) + 每个点一次加减速估计，再放宽 3 倍
+    const cv::Point3f here(float(rs.tcpPose[0]), float(rs.tcpPose[1]), float(rs.tcpPose[2]));
+    const double estimateS = (length(here, m_path.front()) + m_report.pathLength) / m_options.vel +
+                             path.size() * 2.0 * m_options.vel / m_options.acc;
+    m_deadlineNs = m_startNs + int64_t((3.0 * estimateS + 5.0) * 1e9);
+
+    if (mode == TrajectoryMode::Blended) {
+        // 转接半径要做碰撞检查，只算一次，生成程序和统计共用
+        const std::vector<double> radii = computeBlendRadii(path);
+        const QByteArray program = buildProgram(path, radii, m_rotation);
+        if (m_channel.sendScript(program) == 0) {
+            qDebug() << "⚠️ 轨迹程序发送失败 (指令队列已满或通道未连接)";
+            return false;
+        }
+        m_report.commands = 1;
+        m_report.programBytes = program.size();
+        m_report.blended = int(std::count_if(radii.begin(), radii.end(), [](double r) { return r > 0.0; }));
+        m_nextPoint = m_path.size();
+    } else {
+        const QByteArray cmd = moveLine(path.front(), m_rotation, 0.0, false);
+        if (m_channel.sendScript(cmd) == 0) return false;
+        m_report.commands = 1;
+        m_report.programBytes = cmd.size() + 1;
+        m_nextPoint = 1;
+    }
+
+    m_state = ExecutionState::Running;
+    qDebug() << "🦾 开始执行轨迹:" << path.size() << "个点，"
+             << (mode == TrajectoryMode::Blended ? "整段转接" : "逐点") << "| 长度" << m_report.pathLength << "m";
+    return true;
+}
+
+UR12e::IKPathResult TrajectoryExecutor::checkReachable(const std::vector<cv::Point3f>& path, const double rotation[3],
+                                                      const JointVector& seed, std::vector<JointVector>* joints) const {
+    // 姿态固定，法兰位置 = TCP 位置 - 偏置 x 工具 z 轴
+    const double rotOnly[6] = {0.0, 0.0, 0.0, rotation[0], rotation[1], rotation[2]};
+    const cv::Matx44d R = UR12e::poseFromVector(rotOnly);
+    auto flangeAt = [&](const cv::Point3f& p) {
+        cv::Matx44d T = R;
+        T(0, 3) = p.x - m_options.tcpOffsetZ * R(0, 2);
+        T(1, 3) = p.y - m_options.tcpOffsetZ * R(1, 2);
+        T(2, 3) = p.z - m_options.tcpOffsetZ * R(2, 2);
+        return T;
+    };
+
+    // 每段按 ikSpacing 等分 (movel / movep 在段内是笛卡尔直线)
+    std::vector<cv::Matx44d> poses;
+    for (size_t k = 0; k < path.size(); ++k) {
+        if (k == 0) { poses.push_back(flangeAt(path[0])); continue; }
+        const int steps = std::max(1, int(std::ceil(length(path[k - 1], path[k]) / m_options.ikSpacing)));
+        for (int i = 1; i <= steps; ++i) {
+            poses.push_back(flangeAt(path[k - 1] + (path[k] - path[k - 1]) * (float(i) / steps)));
+        }
+    }
+
+    std::vector<JointVector> local;
+    return UR12e::inversePath(poses, seed, joints ? *joints : local, m_options.maxJointStep);
+}
+
+double TrajectoryExecutor::projectOnPath(const cv::Point3f& tcp) {
+    if (m_path.size() < 2) return 0.0;
+    // 只在当前段往后几段里找，转接时 TCP 会偏离拐点，不能用全局最近
+    const size_t last = std::min(m_segment + 8, m_path.size() - 2);
+    double bestDist = 1e30, bestS = m_cumLength[m_segment];
+    for (size_t i = m_segment; i <= last; ++i) {
+        const cv::Point3f d = m_path[i + 1] - m_path[i];
+        const double len2 = d.dot(d);
+        double t = len2 > 0.0 ? (tcp - m_path[i]).dot(d) / len2 : 0.0;
+        t = std::max(0.0, std::min(1.0, t));
+        const cv::Point3f q = m_path[i] + d * float(t);
+        const double dist = cv::norm(tcp - q);
+        if (dist < bestDist) {
+            bestDist = dist;
+            bestS = m_cumLength[i] + t * (m_cumLength[i + 1] - m_cumLength[i]);
+            m_segment = i;
+        }
+    }
+    return bestS;
+}
+
+ExecutionState TrajectoryExecutor::update() {
+    if (m_state != ExecutionState::Running) return m_state;
+
+    RobotState rs;
+    if (!m_stateSource.latest(rs)) return m_state;
+
+    const int64_t now = steadyNowNs();
+    const cv::Point3f tcp(float(rs.tcpPose[0]), float(rs.tcpPose[1]), float(rs.tcpPose[2]));
+    const double speed = std::sqrt(rs.tcpSpeed[0] * rs.tcpSpeed[0] + rs.tcpSpeed[1] * rs.tcpSpeed[1] +
+                                   rs.tcpSpeed[2] * rs.tcpSpeed[2]);
+    const double total = m_cumLength.back();
+    m_progress = total > 0.0 ? projectOnPath(tcp) / total : 1.0;
+
+    // 只认开始执行之后收到的状态，避免用旧状态误判已到位
+    const bool fresh = rs.recvNs > m_startNs;
+    auto settledAt = [&](const cv::Point3f& target) {
+        return fresh && cv::norm(tcp - target) < m_options.arriveTolerance && speed < m_options.settleSpeed;
+    };
+
+    if (m_mode == TrajectoryMode::PointByPoint && m_nextPoint < m_path.size()) {
+        if (settledAt(m_path[m_nextPoint - 1])) {
+            const cv::Point3f p = m_path[m_nextPoint] - m_options.origin;
+            const QByteArray cmd = moveLine(p, m_rotation, 0.0, false);
+            if (m_channel.sendScript(cmd) != 0) {
+                ++m_report.commands;
+                m_report.programBytes += cmd.size() + 1;
+                ++m_nextPoint;
+            }
+        }
+    } else if (settledAt(m_path.back())) {
+        m_state = ExecutionState::Finished;
+        m_progress = 1.0;
+        m_report.totalMs = (now - m_startNs) * 1e-6;
+        qDebug() << "✅ 轨迹执行完成，用时" << m_report.totalMs << "ms，指令" << m_report.commands << "条";
+        return m_state;
+    }
+
+    if (now > m_deadlineNs) {
+        m_state = ExecutionState::Failed;
+        m_report.totalMs = (now - m_startNs) * 1e-6;
+        qDebug() << "❌ 轨迹执行超时，进度" << m_progress;
+    }
+    return m_state;
+}
+
+void TrajectoryExecutor::abort() {
+    if (m_state != ExecutionState::Running) return;
+    m_channel.sendStop(m_options.acc);
+    m_state = ExecutionState::Failed;
+    m_report.totalMs = (steadyNowNs() - m_startNs) * 1e-6;
+    qDebug() << "🛑 轨迹执行已中止，进度" << m_progress;
+}
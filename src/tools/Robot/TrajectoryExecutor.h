@@ -0,0 +1,134 @@
+#ifndef TRAJECTORYEXECUTOR_H
+#define TRAJECTORYEXECUTOR_H
+
+#include <opencv2/opencv.hpp>
+#include <QByteArray>
+#include <cstdint>
+#include <vector>
+#include "URKinematics.h"
+
+class MotionCommandChannel;
+class RobotStateReceiver;
+class CollisionChecker;
+
+// 执行方式
+enum class TrajectoryMode {
+    Blended,        // 整条路径生成一个 def ... end 程序，一次写完，拐点处按转接半径平滑通过
+    PointByPoint    // 逐点发 movel(r=0)，到位后再发下一个 (原来的方式，用来对比)
+};
+
+enum class ExecutionState { Idle, Running, Finished, Failed };
+
+struct TrajectoryOptions {
+    bool useMoveP = true;           // true: movep (拐点处工具速度恒定)；false: movel
+    double acc = 0.5;               // m/s^2
+    double vel = 0.1;               // m/s
+    double maxBlend = 0.05;         // 转接半径上限 (米)
+    float clearance = 0.05f;        // 转接弧的安全余量，与规划时的碰撞阈值一致
+    cv::Point3f origin{0, 0, 0};    // 规划坐标系原点在机械臂基座坐标系下的位置
+    bool keepCurrentRotation = true;// 用开始执行时的 TCP 姿态；false 时用 rotation
+    double rotation[3] = {0.0, 3.14159265358979, 0.0};  // 旋转向量 rx, ry, rz
+    double arriveTolerance = 0.002; // 到位判定: 距离 (米)
+    double settleSpeed = 0.002;     // 到位判定: TCP 速度 (m/s)
+    bool checkReachability = true;  // 发送前沿路径做逆解: 每个采样点都要可达，相邻采样点之间关节不能跳变
+    double ikSpacing = 0.01;        // 逆解检查的采样间距 (米)
+    double maxJointStep = 0.2;      // 相邻采样点之间单个关节允许的最大变化 (rad)，超过说明经过奇异位形附近
+    double tcpOffsetZ = 0.0;        // 控制器里设置的 TCP 沿法兰 z 轴的偏置 (米)，逆解前换算回法兰
+};
+
+// 一次执行的结果
+struct TrajectoryReport {
+    TrajectoryMode mode = TrajectoryMode::Blended;
+    int waypoints = 0;
+    int commands = 0;               // 发出的指令条数
+    int blended = 0;                // 转接半径 > 0 的拐点数
+    double pathLength = 0.0;        // 米
+    int programBytes = 0;           // 发出的 URScript 总字节数
+    double totalMs = 0.0;           // 开始执行 -> 到达终点并停稳
+    double maxJointStep = 0.0;      // 逆解检查里相邻采样点的最大关节变化 (rad)
+};
+
+/**
+ * @brief 把 RRT 路径交给机械臂执行，并根据实时状态流跟踪进度
+ *
+ * Blended 模式把整条路径写成一个 URScript 程序，经 MotionCommandChannel 一次写出，
+ * 每个中间点的转接半径取 min(maxBlend, 相邻两段较短者的 45%)，
+ * 再用 CollisionChecker 检查转接弧所在的三角形 (弦 + 中线)，碰撞就减半，直到 0。
+ * 不持有线程: 由调用方周期性调用 update() (界面定时器或基准测试循环)。
+ */
+class TrajectoryExecutor
+{
+public:
+    TrajectoryExecutor(MotionCommandChannel& channel, const RobotStateReceiver& state);
+
+    void setOptions(const TrajectoryOptions& options) { m_options = options; }
+    const TrajectoryOptions& options() const { return m_options; }
+
+    // 转接弧碰撞检查用的障碍物 (可选，生命周期要长于执行器)
+    void setCollisionChecker(const CollisionChecker* checker) { m_collision = checker; }
+
+    /**
+     * @brief 计算每个路径点的转接半径 (首尾为 0)
+     */
+    std::vector<double> computeBlendRadii(const std::vector<cv::Point3f>& path) const;
+
+    /**
+     * @brief 生成整条路径的 URScript 程序
+     * @param rotation TCP 姿态 (旋转向量)
+     */
+    QByteArray buildProgram(const std::vector<cv::Point3f>& path, const double rotation[3]) const;
+
+    /**
+     * @brief 沿路径按 ikSpacing 采样做逆解，检查可达和关节连续 (execute 发送前会调用)
+     * @param path 基座坐标系下的路径点
+     * @param rotation TCP 姿态 (旋转向量)
+     * @param seed 当前关节角，第一个采样点取离它最近的解
+     * @param joints 可选，输出每个采样点的关节角
+     */
+    UR12e::IKPathResult checkReachable(const std::vector<cv::Point3f>& path, const double rotation[3],
+                                       const JointVector& seed, std::vector<JointVector>* joints = nullptr) const;
+
+    /**
+     * @brief 开始执行 (立即返回)
+     * @return 路径为空、还没收到状态、路径不可达 (checkReachability) 或指令被拒绝时返回 false
+     */
+    bool execute(const std::vector<cv::Point3f>& path, TrajectoryMode mode = TrajectoryMode::Blended);
+
+    // 周期调用: 读取最新状态，更新进度，逐点模式下发下一个点
+    ExecutionState update();
+
+    // 发 stopl 并结束执行
+    void abort();
+
+    ExecutionState state() const { return m_state; }
+    // 沿路径走过的比例 [0, 1] (按弧长投影)
+    double progress() const { return m_progress; }
+    const TrajectoryReport& report() const { return m_report; }
+
+private:
+    QByteArray moveLine(const cv::Point3f& p, const double rotation[3], double radius, bool moveP) const;
+    QByteArray buildProgram(const std::vector<cv::Point3f>& path, const std::vector<double>& radii,
+                            const double rotation[3]) const;
+    cv::Point3f toBase(const cv::Point3f& p) const { return p + m_options.origin; }
+    // 当前 TCP 在路径上的弧长位置 (只向前搜索，避免在拐点附近来回跳)
+    double projectOnPath(const cv::Point3f& tcp);
+
+    MotionCommandChannel& m_channel;
+    const RobotStateReceiver& m_stateSource;
+    const CollisionChecker* m_collision = nullptr;
+    TrajectoryOptions m_options;
+
+    ExecutionState m_state = ExecutionState::Idle;
+    TrajectoryMode m_mode = TrajectoryMode::Blended;
+    std::vector<cv::Point3f> m_path;        // 基座坐标系
+    std::vector<double> m_cumLength;        // 累计弧长
+    double m_rotation[3] = {};
+    size_t m_segment = 0;                   // 进度投影的当前段
+    size_t m_nextPoint = 0;                 // 逐点模式下一个要发的点
+    double m_progress = 0.0;
+    int64_t m_startNs = 0;
+    int64_t m_deadlineNs = 0;
+    TrajectoryReport m_report;
+};
+
+#endif // TRAJECTORYEXECUTOR_H
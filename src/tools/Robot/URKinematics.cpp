@@ -0,0 +1,361 @@
+#include "URKinematics.h"
+#include <algorithm>
+#include <cmath>
+#include <atomic>
+#include <condition_variable>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include "tools/Path_Plan/SimdCompat.h"
+#include "tools/Path_Plan/ThreadPool.h"
+
+// ================= 标量 / SIMD 通用写法 =================
+// 链式相乘 chainKernel 对 float 和 cv::v_float32 是同一个模板:
+// SIMD 主循环、尾部 (以及没有启用 SIMD 的编译) 走同一段代码，运算顺序一致
+namespace {
+inline float vAdd(float a, float b) { return a + b; }
+inline float vSub(float a, float b) { return a - b; }
+inline float vMul(float a, float b) { return a * b; }
+inline void vSplat(float& out, float a) { out = a; }
+
+#if CV_SIMD
+using Simd::vAdd;
+using Simd::vSub;
+using Simd::vMul;
+using Simd::simdLanes;
+inline void vSplat(cv::v_float32& out, float a) { out = cv::vx_setall_f32(a); }
+
+// AVX-512 下一个向量 16 个 float
+constexpr int kMaxLanes = 16;
+#endif
+
+/**
+ * @brief T_0^1 * T_1^2 * ... 逐个相乘，每得到一个坐标系调用一次 emit(坐标系 1..6, R[9], t[3])
+ * c[j] / s[j] 是关节 j 的 cos / sin。alpha 只有 0 / ±90°，按常量分支展开，省掉乘 0 和乘 1:
+ *   新 R 的第 0 列 = x c + y s，绕 z 转过 θ 后的 y 方向 perp = y c - x s
+ *   alpha = 0:    第 1 列 = perp，     第 2 列 = z
+ *   alpha = ±90°: 第 1 列 = ±z，       第 2 列 = ∓perp
+ *   t += a * 新第 0 列 + d * 旧第 2 列
+ */
+template <typename V, typename Emit>
+inline void chainKernel(const V* c, const V* s, Emit&& emit) {
+    V zero, one;
+    vSplat(zero, 0.0f);
+    vSplat(one, 1.0f);
+    V R[9] = {one, zero, zero, zero, one, zero, zero, zero, one};
+    V t[3] = {zero, zero, zero};
+
+    for (int j = 0; j < UR12e::kDof; ++j) {
+        V a, d;
+        vSplat(a, (float)UR12e::kA[j]);
+        vSplat(d, (float)UR12e::kD[j]);
+        for (int r = 0; r < 3; ++r) {
+            const V x = R[r * 3], y = R[r * 3 + 1], z = R[r * 3 + 2];
+            const V col0 = vAdd(vMul(x, c[j]), vMul(y, s[j]));
+            const V perp = vSub(vMul(y, c[j]), vMul(x, s[j]));
+            R[r * 3] = col0;
+            if (UR12e::kSinAlpha[j] == 0.0) {
+                R[r * 3 + 1] = perp;
+                R[r * 3 + 2] = z;
+            } else if (UR12e::kSinAlpha[j] > 0.0) {
+                R[r * 3 + 1] = z;
+                R[r * 3 + 2] = vSub(zero, perp);
+            } else {
+                R[r * 3 + 1] = vSub(zero, z);
+                R[r * 3 + 2] = perp;
+            }
+            if (UR12e::kA[j] != 0.0) t[r] = vAdd(t[r], vMul(a, col0));
+            if (UR12e::kD[j] != 0.0) t[r] = vAdd(t[r], vMul(d, z));
+        }
+        emit(j + 1, R, t);
+    }
+}
+}
+
+namespace UR12e {
+
+void forward(const JointVector& q, cv::Matx44d frames[kDof]) {
+    cv::Matx44d T = cv::Matx44d::eye();
+    for (int j = 0; j < kDof; ++j) {
+        const double c = std::cos(q[j]), s = std::sin(q[j]);
+        const double ca = kCosAlpha[j], sa = kSinAlpha[j];
+        const cv::Matx44d A(c, -s * ca,  s * sa, kA[j] * c,
+                            s,  c * ca, -c * sa, kA[j] * s,
+                            0.0,    sa,      ca, kD[j],
+                            0.0,   0.0,     0.0, 1.0);
+        T = T * A;
+        frames[j] = T;
+    }
+}
+
+cv::Matx44d flangePose(const JointVector& q) {
+    cv::Matx44d frames[kDof];
+    forward(q, frames);
+    return frames[kDof - 1];
+}
+
+void forwardBatch(const JointBatch& q, FrameBatch& out) {
+    const size_t n = q.size();
+    out.count = n;
+    out.data.resize(size_t(kDof) * kFrameComponents * n);
+    const float* qs[kDof];
+    for (int j = 0; j < kDof; ++j) qs[j] = q.q[j].data();
+    forwardBatch(qs, n, out.data.data(), n);
+}
+
+void forwardBatch(const float* const q[kDof], size_t n, float* frames, size_t stride) {
+    size_t k = 0;
+    // sin / cos 逐个用标量算 (OpenCV 通用向量指令没有三角函数)，SoA 排好后整组装进向量
+#if CV_SIMD
+    const int lanes = std::min(simdLanes(), kMaxLanes);
+    float cbuf[kDof][kMaxLanes], sbuf[kDof][kMaxLanes];
+    for (; k + lanes <= n; k += lanes) {
+        cv::v_float32 c[kDof], s[kDof];
+        for (int j = 0; j < kDof; ++j) {
+            for (int l = 0; l < lanes; ++l) {
+                cbuf[j][l] = std::cos(q[j][k + l]);
+                sbuf[j][l] = std::sin(q[j][k + l]);
+            }
+            c[j] = cv::vx_load(cbuf[j]);
+            s[j] = cv::vx_load(sbuf[j]);
+        }
+        chainKernel(c, s, [&](int f, const cv::v_float32* R, const cv::v_float32* t) {
+            float *dst = frames + size_t(f - 1) * kFrameComponents * stride + k;
+            for (int i = 0; i < 9; ++i) cv::v_store(dst + i * stride, R[i]);
+            for (int i = 0; i < 3; ++i) cv::v_store(dst + (9 + i) * stride, t[i]);
+        });
+    }
+#endif
+    for (; k < n; ++k) {
+        float c[kDof], s[kDof];
+        for (int j = 0; j < kDof; ++j) {
+            c[j] = std::cos(q[j][k]);
+            s[j] = std::sin(q[j][k]);
+        }
+        chainKernel(c, s, [&](int f, const float* R, const float* t) {
+            float *dst = frames + size_t(f - 1) * kFrameComponents * stride + k;
+            for (int i = 0; i < 9; ++i) dst[i * stride] = R[i];
+            for (int i = 0; i < 3; ++i) dst[(9 + i) * stride] = t[i];
+        });
+    }
+}
+
+}
+
+// ================= 逆运动学 =================
+
+namespace {
+// 归一化到 [-π, π) (逆解里的角度都在几圈以内，加减比 floor 快)
+inline double wrapAngle(double a) {
+    while (a >= CV_PI) a -= 2.0 * CV_PI;
+    while (a < -CV_PI) a += 2.0 * CV_PI;
+    return a;
+}
+
+// 数值误差会让 cos 稍微超出 [-1, 1]；超出 tol 视为不可达
+inline bool clampUnit(double& c, double tol = 1e-9) {
+    if (c > 1.0 + tol || c < -1.0 - tol) return false;
+    c = std::min(1.0, std::max(-1.0, c));
+    return true;
+}
+}
+
+namespace UR12e {
+
+cv::Matx44d poseFromVector(const double pose[6]) {
+    // 旋转向量 -> 旋转矩阵 (Rodrigues)
+    const double rx = pose[3], ry = pose[4], rz = pose[5];
+    const double theta = std::sqrt(rx * rx + ry * ry + rz * rz);
+    double kx = 0.0, ky = 0.0, kz = 1.0;
+    if (theta > 1e-12) { kx = rx / theta; ky = ry / theta; kz = rz / theta; }
+    const double c = std::cos(theta), s = std::sin(theta), v = 1.0 - c;
+    return cv::Matx44d(kx * kx * v + c,      kx * ky * v - kz * s, kx * kz * v + ky * s, pose[0],
+                       kx * ky * v + kz * s, ky * ky * v + c,      ky * kz * v - kx * s, pose[1],
+                       kx * kz * v - ky * s, ky * kz * v + kx * s, kz * kz * v + c,      pose[2],
+                       0.0, 0.0, 0.0, 1.0);
+}
+
+/*
+ * 推导要点 (n / s / a 是法兰坐标系的 x / y / z 轴，都在基座坐标系下):
+ *   1. 腕心 p5 = p - d6 a。关节 2/3/4 的轴线平行于 z1 = (s1, -c1, 0)，而 p5 沿 z1 方向的分量恒为 d4:
+ *      p5x s1 - p5y c1 = d4  =>  θ1 = atan2(p5y, p5x) + asin(d4 / r) 或 + π - asin(d4 / r)
+ *   2. z1 就是 y4，而 a 是 z5: cos θ5 = a . z1  =>  θ5 = ±acos
+ *   3. z1 在法兰坐标系下是 (c6 s5, -s6 s5, c5)  =>  θ6 = atan2(-(s . z1) / s5, (n . z1) / s5)
+ *   4. z4 = -(s6 n + c6 s)，腕 1 中心 O4 = p5 - d5 z4；O4 在坐标系 1 的平面内 (x1, y1) 是二连杆问题:
+ *      px = a2 c2 + a3 c23, py = a2 s2 + a3 s23  =>  θ3 = ±acos，θ2 随之确定
+ *   5. x4 = z1 x z4 在坐标系 1 平面内的角度是 θ2 + θ3 + θ4
+ */
+int inverse(const cv::Matx44d& T, IKSolutions& out, double q6Hint) {
+    out.count = 0;
+    const double d1 = kD[0], a2 = kA[1], a3 = kA[2], d4 = kD[3], d5 = kD[4], d6 = kD[5];
+    const double nx = T(0, 0), ny = T(1, 0), nz = T(2, 0);
+    const double sx = T(0, 1), sy = T(1, 1), sz = T(2, 1);
+    const double ax = T(0, 2), ay = T(1, 2), az = T(2, 2);
+    const double p5x = T(0, 3) - d6 * ax, p5y = T(1, 3) - d6 * ay, p5z = T(2, 3) - d6 * az;
+
+    // 1. θ1 = φ + ψ 或 φ + π - ψ；sin / cos 用和角公式，不再调三角函数
+    const double r = std::sqrt(p5x * p5x + p5y * p5y);
+    if (r < 1e-12) return 0;
+    double sinPsi = d4 / r;
+    if (!clampUnit(sinPsi)) return 0;
+    const double cosPsi = std::sqrt(1.0 - sinPsi * sinPsi);
+    const double sinPhi = p5y / r, cosPhi = p5x / r;
+    const double phi = std::atan2(p5y, p5x), psi = std::asin(sinPsi);
+    const double theta1[2][3] = {
+        {phi + psi,          sinPhi * cosPsi + cosPhi * sinPsi,     cosPhi * cosPsi - sinPhi * sinPsi},
+        {phi + CV_PI - psi, -(sinPhi * cosPsi - cosPhi * sinPsi), -(cosPhi * cosPsi + sinPhi * sinPsi)},
+    };
+
+    for (const auto &th1 : theta1) {
+        const double t1 = th1[0], s1 = th1[1], c1 = th1[2];
+
+        // 2. θ5
+        double c5 = ax * s1 - ay * c1;
+        if (!clampUnit(c5, 1e-6)) continue;
+        const double s5abs = std::sqrt(1.0 - c5 * c5);
+        const double t5abs = std::acos(c5);
+        const double nz1 = nx * s1 - ny * c1, sz1 = sx * s1 - sy * c1;
+
+        for (double sign5 : {1.0, -1.0}) {
+            // 3. θ6 (奇异时 z1 和 a 平行，θ6 与 θ2..θ4 的和耦合，取 q6Hint)
+            // (n . z1, s . z1) 的模理论上等于 |s5|，用它归一化比除以 s5 稳定
+            const double h = std::sqrt(nz1 * nz1 + sz1 * sz1);
+            double t6, s6, c6;
+            if (s5abs < 1e-10 || h < 1e-10) {
+                t6 = q6Hint;
+                s6 = std::sin(t6);
+                c6 = std::cos(t6);
+            } else {
+                s6 = -sz1 * sign5 / h;
+                c6 = nz1 * sign5 / h;
+                t6 = std::atan2(s6, c6);
+            }
+
+            // 4. 腕 1 中心和二连杆
+            const double z4x = -(s6 * nx + c6 * sx), z4y = -(s6 * ny + c6 * sy), z4z = -(s6 * nz + c6 * sz);
+            const double o4x = p5x - d5 * z4x, o4y = p5y - d5 * z4y, o4z = p5z - d5 * z4z;
+            const double px = o4x * c1 + o4y * s1, py = o4z - d1;
+            double c3 = (px * px + py * py - a2 * a2 - a3 * a3) / (2.0 * a2 * a3);
+            if (!clampUnit(c3)) continue;
+            const double s3abs = std::sqrt(1.0 - c3 * c3);
+            const double t3abs = std::acos(c3);
+            const double gamma = std::atan2(py, px);
+            // θ2 = γ - atan2(a3 s3, a2 + a3 c3)，两个肘部分支只差 s3 的符号
+            const double beta = std::atan2(a3 * s3abs, a2 + a3 * c3);
+
+            // 5. θ2 + θ3 + θ4: x4 = z1 x z4
+            const double x4x = -c1 * z4z, x4y = -s1 * z4z, x4z = s1 * z4y + c1 * z4x;
+            const double t234 = std::atan2(x4z, x4x * c1 + x4y * s1);
+
+            for (double sign3 : {1.0, -1.0}) {
+                const double t3 = sign3 * t3abs;
+                const double t2 = gamma - sign3 * beta;
+                JointVector &q = out.q[out.count++];
+                q = {wrapAngle(t1), wrapAngle(t2), wrapAngle(t3), wrapAngle(t234 - t2 - t3),
+                     wrapAngle(sign5 * t5abs), wrapAngle(t6)};
+                // 肘部伸直 (s3 = 0) 时两个分支相同
+                if (s3abs < 1e-10) break;
+            }
+            // 腕部奇异时两个分支也相同
+            if (s5abs < 1e-10) break;
+        }
+    }
+    return out.count;
+}
+
+void inverseBatch(const cv::Matx44d* poses, size_t n, IKSolutions* out) {
+    // 小批量直接算；大批量按块分给共享线程池，调用线程自己也取块，
+    // 所以在线程池的任务里调用也不会因为等不到空闲线程而卡住
+    const size_t kChunk = 256;
+    const size_t chunks = (n + kChunk - 1) / kChunk;
+    ThreadPool &pool = ThreadPool::shared();
+    if (chunks < 2 || pool.threadCount() < 2) {
+        for (size_t k = 0; k < n; ++k) inverse(poses[k], out[k]);
+        return;
+    }
+
+    struct Shared {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+    auto shared = std::make_shared<Shared>();
+    // 领到块的任务一定在调用方返回前做完；来晚的任务领不到块，不会碰 poses / out
+    auto work = [shared, poses, out, n, chunks, kChunk] {
+        for (size_t c; (c = shared->next.fetch_add(1)) < chunks;) {
+            for (size_t k = c * kChunk; k < std::min(n, (c + 1) * kChunk); ++k) inverse(poses[k], out[k]);
+            if (shared->done.fetch_add(1) + 1 == chunks) {
+                std::lock_guard<std::mutex> lock(shared->mutex);
+                shared->cv.notify_all();
+            }
+        }
+    };
+    const size_t helpers = std::min(pool.threadCount(), chunks - 1);
+    for (size_t i = 0; i < helpers; ++i) pool.submit(work);
+    work();
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    shared->cv.wait(lock, [&] { return shared->done.load() == chunks; });
+}
+
+bool nearestSolution(const IKSolutions& solutions, const JointVector& reference, JointVector& out) {
+    double best = std::numeric_limits<double>::max();
+    for (int i = 0; i < solutions.count; ++i) {
+        JointVector q = solutions.q[i];
+        double d2 = 0.0;
+        for (int j = 0; j < kDof; ++j) {
+            // 解在 [-π, π)，限位是 ±2π: 等价角 q, q ± 2π 里挑离参考最近的
+            for (double alt : {q[j] - 2.0 * CV_PI, q[j] + 2.0 * CV_PI}) {
+                if (std::abs(alt) <= kJointLimit && std::abs(alt - reference[j]) < std::abs(q[j] - reference[j])) q[j] = alt;
+            }
+            d2 += (q[j] - reference[j]) * (q[j] - reference[j]);
+        }
+        if (d2 < best) {
+            best = d2;
+            out = q;
+        }
+    }
+    return solutions.count > 0;
+}
+
+IKPathResult inversePath(const std::vector<cv::Matx44d>& poses, const JointVector& seed,
+                         std::vector<JointVector>& out, double maxStep) {
+    IKPathResult result;
+    out.clear();
+    out.reserve(poses.size());
+
+    // 先批量求出每个点的全部解 (可以并行)，再顺序选解
+    std::vector<IKSolutions> all(poses.size());
+    inverseBatch(poses.data(), poses.size(), all.data());
+
+    JointVector prev = seed;
+    for (size_t k = 0; k < poses.size(); ++k) {
+        // 腕部奇异时 θ6 不确定，批量求解取的是 0；这里用上一个点的 θ6 重解，保持连续
+        for (int i = 0; i < all[k].count; ++i) {
+            if (std::abs(std::sin(all[k].q[i][4])) < 1e-9) {
+                inverse(poses[k], all[k], wrapAngle(prev[5]));
+                break;
+            }
+        }
+        JointVector q;
+        if (!nearestSolution(all[k], prev, q)) {
+            result.failedIndex = k;
+            return result;
+        }
+        if (k > 0) {
+            double step = 0.0;
+            for (int j = 0; j < kDof; ++j) step = std::max(step, std::abs(q[j] - prev[j]));
+            result.maxStep = std::max(result.maxStep, step);
+            if (step > maxStep) {
+                result.failedIndex = k;
+                return result;
+            }
+        }
+        out.push_back(q);
+        prev = q;
+    }
+    result.ok = true;
+    return result;
+}
+
+}
@@ -0,0 +1,130 @@
+#ifndef URKINEMATICS_H
+#define URKINEMATICS_H
+
+#include <opencv2/opencv.hpp>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// 六个关节角 (rad)，顺序: 基座、肩、肘、腕1、腕2、腕3
+using JointVector = std::array<double, 6>;
+
+/**
+ * @brief UR12e 正 / 逆运动学 (标准 DH，参数取自 Universal Robots 官方 DH 表)
+ *
+ * 坐标系 0 为基座，坐标系 i (1..6) 是第 i 个关节转过之后的连杆坐标系，坐标系 6 即法兰 (不含 TCP 偏置)。
+ * 单组构型用 double 计算 (forward)；批量版本 (forwardBatch) 用 float + SoA:
+ * 每个关节角、每个位姿分量各占一个数组，一条向量指令同时算 4/8/16 组构型的同一个分量，给碰撞检测一次算大量构型。
+ * 逆运动学是解析解 (inverse)，inversePath 给整条笛卡尔路径逐点求解并保持关节连续。
+ */
+namespace UR12e {
+
+constexpr int kDof = 6;
+
+// DH 参数 (米 / 弧度)
+constexpr double kD[kDof]     = {0.1807, 0.0, 0.0, 0.17415, 0.11985, 0.11655};
+constexpr double kA[kDof]     = {0.0, -0.6127, -0.57155, 0.0, 0.0, 0.0};
+constexpr double kAlpha[kDof] = {CV_PI / 2, 0.0, 0.0, CV_PI / 2, -CV_PI / 2, 0.0};
+// alpha 只有 0 / ±90°，cos / sin 直接写成精确值 (std::cos 不是 constexpr)
+constexpr double kCosAlpha[kDof] = {0.0, 1.0, 1.0, 0.0, 0.0, 1.0};
+constexpr double kSinAlpha[kDof] = {1.0, 0.0, 0.0, 1.0, -1.0, 0.0};
+
+// 关节限位: 六个关节都是 ±360°
+constexpr double kJointLimit = 2.0 * CV_PI;
+
+// 单组构型: frames[i] = T_0^(i+1)，i = 0..5
+void forward(const JointVector& q, cv::Matx44d frames[kDof]);
+// 法兰位姿 T_0^6
+cv::Matx44d flangePose(const JointVector& q);
+
+// 位姿的 12 个分量: 行优先的旋转矩阵 r00 r01 r02 r10 ... r22，然后平移 tx ty tz
+constexpr int kFrameComponents = 12;
+enum FrameComponent { R00, R01, R02, R10, R11, R12, R20, R21, R22, TX, TY, TZ };
+
+// 批量输入: 第 j 个关节的 n 个角度连续存放
+struct JointBatch {
+    std::vector<float> q[kDof];
+
+    size_t size() const { return q[0].size(); }
+    void resize(size_t n) { for (auto &v : q) v.resize(n); }
+    void set(size_t k, const JointVector& v) { for (int j = 0; j < kDof; ++j) q[j][k] = (float)v[j]; }
+    JointVector get(size_t k) const {
+        JointVector v;
+        for (int j = 0; j < kDof; ++j) v[j] = q[j][k];
+        return v;
+    }
+};
+
+// 批量输出: 分量 c 在坐标系 f (1..6) 下的 n 个值在 component(f, c)[0 .. n)
+struct FrameBatch {
+    size_t count = 0;
+    std::vector<float> data;    // [坐标系 1..6][分量][count]
+
+    const float* component(int frame, int c) const {
+        return data.data() + (size_t(frame - 1) * kFrameComponents + c) * count;
+    }
+    cv::Point3f origin(int frame, size_t k) const {
+        return cv::Point3f(component(frame, TX)[k], component(frame, TY)[k], component(frame, TZ)[k]);
+    }
+};
+
+void forwardBatch(const JointBatch& q, FrameBatch& out);
+
+/**
+ * @brief 底层批量接口 (给碰撞检测按块调用，不分配内存)
+ * @param q q[j] 指向第 j 个关节的 n 个角度
+ * @param frames 输出，按 [坐标系 1..6][分量][stride] 排布，stride >= n；只写前 n 个
+ */
+void forwardBatch(const float* const q[kDof], size_t n, float* frames, size_t stride);
+
+// UR 的位姿写法 x, y, z (米) + 旋转向量 rx, ry, rz (rad) -> 齐次矩阵
+cv::Matx44d poseFromVector(const double pose[6]);
+
+// ---------------- 逆运动学 ----------------
+
+constexpr int kMaxIKSolutions = 8;
+
+struct IKSolutions {
+    int count = 0;
+    JointVector q[kMaxIKSolutions];
+};
+
+/**
+ * @brief 法兰位姿 -> 全部关节解 (肩 左/右 x 腕 上/下 x 肘 上/下，最多 8 组)
+ * 解析解 (Hawkins 对 UR 系列的推导)，只用到 DH 表里的 6 个长度，换 UR3e/5e/10e 只需改 kD / kA。
+ * 角度都在 [-π, π)；腕部奇异 (sin θ5 ≈ 0) 时 θ6 不确定，取 q6Hint。
+ * 腕心离基座轴线太近或者够不着时返回 0。
+ * 位姿是法兰的；控制器里设置了 TCP 偏置时先乘上偏置的逆。
+ */
+int inverse(const cv::Matx44d& pose, IKSolutions& out, double q6Hint = 0.0);
+
+// 批量: n 个位姿各自求全部解，大批量分块放到 ThreadPool::shared() 上并行
+// (解析式里主要是 atan2 / acos，OpenCV 的通用向量指令没有这些函数，所以按位姿分给线程而不是按 SIMD 通道)
+void inverseBatch(const cv::Matx44d* poses, size_t n, IKSolutions* out);
+
+/**
+ * @brief 在 solutions 里挑离 reference 最近的一组
+ * 每个关节先在 ±kJointLimit 内加减 2π，取离 reference 最近的等价角，再比较平方和。
+ * 没有解时返回 false
+ */
+bool nearestSolution(const IKSolutions& solutions, const JointVector& reference, JointVector& out);
+
+// 整条路径的逆解结果
+struct IKPathResult {
+    bool ok = false;
+    size_t failedIndex = 0;     // 无解或跳变的路径点
+    double maxStep = 0.0;       // 相邻两点之间单个关节的最大变化 (rad)
+};
+
+/**
+ * @brief 整条路径逆解，保持关节连续
+ * 先用 inverseBatch 求出每个点的全部解，再顺序选解:
+ * 第一个点取离 seed 最近的解，之后每个点取离上一个点最近的解 (不会在肩 / 肘 / 腕的分支之间跳)；
+ * 某个点无解，或者和上一个点之间有关节变化超过 maxStep (靠近奇异位形) 时停下，out 里是已经解出的前几个点
+ */
+IKPathResult inversePath(const std::vector<cv::Matx44d>& poses, const JointVector& seed,
+                         std::vector<JointVector>& out, double maxStep = 0.5);
+
+}
+
+#endif // URKINEMATICS_H
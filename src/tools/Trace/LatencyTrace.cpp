@@ -0,0 +1,372 @@
+#include "LatencyTrace.h"
+#include "tools/Common/SteadyClock.h"
+#include <QDebug>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+namespace {
+// ================= 对数-线性分桶 =================
+// v < 32 每个值一格；之后每个 [2^k, 2^(k+1)) 区间等分 32 格
+const int kSubBits = 5;
+const int kSubCount = 1 << kSubBits;
+const int kMaxBit = 40;     // 超过 2^41 ns (约 36 分钟) 的值记到最后一格
+const int kBuckets = (kMaxBit - kSubBits + 2) * kSubCount;
+
+inline int highestBit(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(v);
+#else
+    int msb = 0;
+    while (v >>= 1) ++msb;
+    return msb;
+#endif
+}
+
+int bucketOf(int64_t v) {
+    if (v < kSubCount) return v < 0 ? 0 : int(v);
+    const int msb = highestBit(uint64_t(v));
+    if (msb > kMaxBit) return kBuckets - 1;
+    const int shift = msb - kSubBits;
+    return ((shift + 1) << kSubBits) | int((v >> shift) & (kSubCount - 1));
+}
+
+// 桶的代表值 (区间中点)
+double bucketValue(int idx) {
+    if (idx < kSubCount) return idx;
+    const int shift = (idx >> kSubBits) - 1;
+    const double lower = double(int64_t(kSubCount + (idx & (kSubCount - 1))) << shift);
+    return lower + double(int64_t(1) << shift) / 2.0;
+}
+
+// 单写者直方图: 只有所属线程写 (load + store，不需要原子读改写)，其他线程随时 relaxed 读
+struct Histogram {
+    std::atomic<uint64_t> counts[kBuckets];
+    std::atomic<int64_t> sumNs{0};
+
+    Histogram() { for (auto &c : counts) c.store(0, std::memory_order_relaxed); }
+
+    void add(int64_t ns) {
+        std::atomic<uint64_t> &c = counts[bucketOf(ns)];
+        c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        sumNs.store(sumNs.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+    }
+};
+
+// 事件环形缓冲区的一格 (字段都是原子量，读者读到被覆盖中的格子时靠序号丢弃)
+struct Event {
+    std::atomic<int64_t> startNs{0};
+    std::atomic<int64_t> durNs{0};
+    std::atomic<int> probe{0};
+};
+
+struct ThreadShard {
+    int tid = 0;
+    std::string name;                               // 受 Registry::mutex 保护
+    bool inUse = true;                              // 受 Registry::mutex 保护；线程退出后可被新线程复用
+    std::atomic<Histogram*> hist[LatencyTrace::kMaxProbes];
+    std::unique_ptr<Event[]> events;                // 所属线程第一次记录时分配
+    std::atomic<Event*> eventsPtr{nullptr};
+    // 写者先推进 claimed 再写格子，写完推进 written；读者用 claimed 判断读到的格子是否已被覆盖
+    std::atomic<uint64_t> claimed{0};
+    std::atomic<uint64_t> written{0};
+    uint64_t eventBase = 0;                         // reset() 时的 written，受 Registry::mutex 保护
+
+    ThreadShard() { for (auto &h : hist) h.store(nullptr, std::memory_order_relaxed); }
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::atomic<int> probeCount{0};
+    std::string names[LatencyTrace::kMaxProbes];
+    std::vector<std::unique_ptr<ThreadShard>> shards;
+    // reset() 时的合并计数，snapshot 减掉它 (不去改写各线程的计数，避免和写者竞争)
+    std::vector<uint64_t> baseCounts[LatencyTrace::kMaxProbes];
+    int64_t baseSum[LatencyTrace::kMaxProbes] = {};
+    int nextTid = 1;
+};
+
+// 故意不析构: 线程局部变量和其他静态对象退出时可能还会记录
+Registry& registry() {
+    static Registry *r = new Registry;
+    return *r;
+}
+
+// 线程退出时把分片标记为空闲，之后新建的线程复用它 (线程频繁创建销毁时内存不增长)
+struct ShardHandle {
+    ThreadShard *shard = nullptr;
+    ~ShardHandle() {
+        if (!shard) return;
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        shard->inUse = false;
+    }
+};
+thread_local ShardHandle t_shard;
+
+ThreadShard& currentShard() {
+    if (t_shard.shard) return *t_shard.shard;
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (auto &s : r.shards) {
+        if (!s->inUse) {
+            s->inUse = true;
+            s->name = "thread " + std::to_string(s->tid);
+            t_shard.shard = s.get();
+            return *s;
+        }
+    }
+    r.shards.push_back(std::make_unique<ThreadShard>());
+    ThreadShard *s = r.shards.back().get();
+    s->tid = r.nextTid++;
+    s->name = "thread " + std::to_string(s->tid);
+    t_shard.shard = s;
+    return *s;
+}
+
+bool initialEnabled() {
+    const char *env = std::getenv("UR_TRACE");
+    return env && *env && std::strcmp(env, "0") != 0;
+}
+
+// 合并单个探针在所有线程的计数 (调用方持有 Registry::mutex)
+void mergeProbe(Registry &r, int id, std::vector<uint64_t> &counts, int64_t &sumNs) {
+    counts.assign(kBuckets, 0);
+    sumNs = 0;
+    for (auto &s : r.shards) {
+        const Histogram *h = s->hist[id].load(std::memory_order_acquire);
+        if (!h) continue;
+        for (int b = 0; b < kBuckets; ++b) counts[b] += h->counts[b].load(std::memory_order_relaxed);
+        sumNs += h->sumNs.load(std::memory_order_relaxed);
+    }
+}
+
+void appendJsonString(std::string &out, const std::string &s) {
+    out += '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') { out += '\\'; out += c; }
+        else if (static_cast<unsigned char>(c) < 0x20) out += ' ';
+        else out += c;
+    }
+    out += '"';
+}
+}
+
+std::atomic<bool> LatencyTrace::s_enabled{initialEnabled()};
+
+void LatencyTrace::setEnabled(bool on) {
+    if (s_enabled.exchange(on) != on) qDebug() << (on ? "⏱️ 延迟埋点已开启" : "⏱️ 延迟埋点已关闭");
+}
+
+int LatencyTrace::probe(const char *name) {
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    const int n = r.probeCount.load(std::memory_order_relaxed);
+    for (int i = 0; i < n; ++i) {
+        if (r.names[i] == name) return i;
+    }
+    if (n >= kMaxProbes) {
+        qDebug() << "⚠️ 延迟探针超过上限, 忽略:" << name;
+        return -1;
+    }
+    r.names[n] = name;
+    r.probeCount.store(n + 1, std::memory_order_release);
+    return n;
+}
+
+std::string LatencyTrace::probeName(int id) {
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    return (id >= 0 && id < r.probeCount.load(std::memory_order_relaxed)) ? r.names[id] : std::string();
+}
+
+int64_t LatencyTrace::nowNs() {
+    return steadyNowNs();
+}
+
+void LatencyTrace::record(int probe, int64_t startNs, int64_t endNs) {
+    if (probe < 0 || probe >= kMaxProbes) return;
+    ThreadShard &s = currentShard();
+    const int64_t dur = std::max<int64_t>(0, endNs - startNs);
+
+    // 1. 直方图 (第一次用到这个探针时分配，之后只做普通的加一)
+    Histogram *h = s.hist[probe].load(std::memory_order_relaxed);
+    if (!h) {
+        h = new Histogram();     // 和分片一样不释放，读者随时可能在读
+        s.hist[probe].store(h, std::memory_order_release);
+    }
+    h->add(dur);
+
+    // 2. 事件 (覆盖最旧的)
+    Event *events = s.eventsPtr.load(std::memory_order_relaxed);
+    if (!events) {
+        s.events.reset(new Event[kEventsPerThread]);
+        events = s.events.get();
+        s.eventsPtr.store(events, std::memory_order_release);
+    }
+    const uint64_t n = s.written.load(std::memory_order_relaxed);
+    s.claimed.store(n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    Event &e = events[n % kEventsPerThread];
+    e.startNs.store(startNs, std::memory_order_relaxed);
+    e.durNs.store(dur, std::memory_order_relaxed);
+    e.probe.store(probe, std::memory_order_relaxed);
+    s.written.store(n + 1, std::memory_order_release);
+}
+
+void LatencyTrace::setThreadName(const std::string &name) {
+    ThreadShard &s = currentShard();
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    s.name = name;
+}
+
+std::vector<ProbeStats> LatencyTrace::snapshot() {
+    std::vector<ProbeStats> out;
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    const int n = r.probeCount.load(std::memory_order_relaxed);
+    std::vector<uint64_t> counts;
+    for (int id = 0; id < n; ++id) {
+        int64_t sumNs = 0;
+        mergeProbe(r, id, counts, sumNs);
+        const std::vector<uint64_t> &base = r.baseCounts[id];
+        uint64_t total = 0;
+        for (int b = 0; b < kBuckets; ++b) {
+            if (!base.empty()) counts[b] -= std::min(counts[b], base[b]);
+            total += counts[b];
+        }
+        if (total == 0) continue;
+
+        ProbeStats ps;
+        ps.name = r.names[id];
+        ps.count = total;
+        ps.meanMs = double(sumNs - r.baseSum[id]) / total / 1e6;
+        // 百分位: 累计计数第一次达到 rank 的桶
+        const double q[3] = {0.50, 0.90, 0.99};
+        double *dst[3] = {&ps.p50Ms, &ps.p90Ms, &ps.p99Ms};
+        uint64_t cum = 0;
+        int qi = 0;
+        for (int b = 0; b < kBuckets && qi < 3; ++b) {
+            cum += counts[b];
+            while (qi < 3 && cum >= std::max<uint64_t>(1, uint64_t(q[qi] * total + 0.5))) {
+                *dst[qi++] = bucketValue(b) / 1e6;
+            }
+        }
+        for (int b = kBuckets - 1; b >= 0; --b) {
+            if (counts[b]) { ps.maxMs = bucketValue(b) / 1e6; break; }
+        }
+        out.push_back(ps);
+    }
+    return out;
+}
+
+std::string LatencyTrace::summaryText() {
+    std::string text;
+    char line[160];
+    for (const ProbeStats &ps : snapshot()) {
+        std::snprintf(line, sizeof(line), "%-26s p50 %8.3f  p99 %8.3f ms  (n=%llu)\n",
+                      ps.name.c_str(), ps.p50Ms, ps.p99Ms, (unsigned long long)ps.count);
+        text += line;
+    }
+    if (!text.empty()) text.pop_back();
+    return text;
+}
+
+void LatencyTrace::reset() {
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    const int n = r.probeCount.load(std::memory_order_relaxed);
+    for (int id = 0; id < n; ++id) mergeProbe(r, id, r.baseCounts[id], r.baseSum[id]);
+    for (auto &s : r.shards) s->eventBase = s->written.load(std::memory_order_acquire);
+}
+
+bool LatencyTrace::writeChromeTrace(const std::string &path) {
+    struct Row { int tid; int probe; int64_t startNs; int64_t durNs; };
+    std::vector<Row> rows;
+    std::vector<std::pair<int, std::string>> threads;
+    std::vector<std::string> names;
+    {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        names.assign(r.names, r.names + r.probeCount.load(std::memory_order_relaxed));
+        for (auto &s : r.shards) {
+            const Event *events = s->eventsPtr.load(std::memory_order_acquire);
+            if (!events) continue;
+            threads.emplace_back(s->tid, s->name);
+
+            // 先读 written 确定范围，拷贝，再读 claimed: 已经被写者追上的格子丢掉
+            const uint64_t end = s->written.load(std::memory_order_acquire);
+            uint64_t begin = end > uint64_t(kEventsPerThread) ? end - kEventsPerThread : 0;
+            begin = std::max(begin, s->eventBase);
+            const size_t first = rows.size();
+            for (uint64_t i = begin; i < end; ++i) {
+                const Event &e = events[i % kEventsPerThread];
+                rows.push_back({s->tid, e.probe.load(std::memory_order_relaxed),
+                                e.startNs.load(std::memory_order_relaxed),
+                                e.durNs.load(std::memory_order_relaxed)});
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const uint64_t claimed = s->claimed.load(std::memory_order_relaxed);
+            const uint64_t safe = claimed > uint64_t(kEventsPerThread) ? claimed - kEventsPerThread : 0;
+            if (safe > begin) {
+                const size_t drop = std::min<size_t>(size_t(safe - begin), rows.size() - first);
+                rows.erase(rows.begin() + first, rows.begin() + first + drop);
+            }
+        }
+    }
+
+    // 时间轴从最早的事件开始，单位 us
+    int64_t originNs = 0;
+    for (const Row &row : rows) {
+        if (originNs == 0 || row.startNs < originNs) originNs = row.startNs;
+    }
+
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    char buf[128];
+    bool first = true;
+    for (const auto &t : threads) {
+        json += first ? "" : ",\n";
+        first = false;
+        std::snprintf(buf, sizeof(buf), "{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_name\",\"args\":{\"name\":", t.first);
+        json += buf;
+        appendJsonString(json, t.second);
+        json += "}}";
+    }
+    for (const Row &row : rows) {
+        if (row.probe < 0 || row.probe >= (int)names.size()) continue;
+        json += first ? "" : ",\n";
+        first = false;
+        json += "{\"ph\":\"X\",\"pid\":1,\"cat\":\"latency\",\"name\":";
+        appendJsonString(json, names[row.probe]);
+        std::snprintf(buf, sizeof(buf), ",\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                      row.tid, (row.startNs - originNs) / 1e3, row.durNs / 1e3);
+        json += buf;
+    }
+    json += "\n],\"latencySummary\":[\n";
+    first = true;
+    for (const ProbeStats &ps : snapshot()) {
+        json += first ? "" : ",\n";
+        first = false;
+        json += "{\"name\":";
+        appendJsonString(json, ps.name);
+        std::snprintf(buf, sizeof(buf), ",\"count\":%llu,\"p50_ms\":%.4f,\"p90_ms\":%.4f,\"p99_ms\":%.4f,\"max_ms\":%.4f,\"mean_ms\":%.4f}",
+                      (unsigned long long)ps.count, ps.p50Ms, ps.p90Ms, ps.p99Ms, ps.maxMs, ps.meanMs);
+        json += buf;
+    }
+    json += "\n]}\n";
+
+    FILE *f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        qDebug() << "❌ 无法写入 trace 文件:" << QString::fromStdString(path);
+        return false;
+    }
+    const bool ok = std::fwrite(json.data(), 1, json.size(), f) == json.size();
+    std::fclose(f);
+    qDebug() << (ok ? "💾 已导出 trace:" : "❌ trace 写入失败:") << QString::fromStdString(path)
+             << "| 事件" << rows.size();
+    return ok;
+}
@@ -0,0 +1,111 @@
+#ifndef LATENCYTRACE_H
+#define LATENCYTRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 单个探针的延迟统计 (所有线程合并，单位 ms)
+struct ProbeStats {
+    std::string name;
+    uint64_t count = 0;
+    double p50Ms = 0.0;
+    double p90Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+    double meanMs = 0.0;
+};
+
+/**
+ * @brief 端到端延迟埋点: 静态探针注册表 + 每线程 HDR 直方图 + Chrome trace 导出
+ *
+ * 探针按名字注册 (如 "camera.decode")，id 在进程内固定，通常由 UR_TRACE_SCOPE 用静态局部变量缓存。
+ * 每个线程写自己的直方图和事件环形缓冲区，只有这个线程写，所以记录时不加锁、不做原子读改写；
+ * 读取方 (界面、导出) 随时合并各线程的数据，不会阻塞采集 / 推理 / 指令线程。
+ *
+ * 关闭时 (默认) 探针只剩一次 relaxed 原子读和一个分支，不读时钟；
+ * 环境变量 UR_TRACE=1 启动即打开，也可以运行时 setEnabled()。
+ * 定义 UR_TRACE_OFF 时宏展开为空，探针彻底编译掉。
+ *
+ * 直方图为对数-线性分桶: 每个 2 的幂区间再等分 32 格，相对误差 < 3%，范围 1 ns ~ 约 36 分钟。
+ */
+class LatencyTrace
+{
+public:
+    static const int kMaxProbes = 64;
+    static const int kEventsPerThread = 8192;   // 每个线程保留最近多少条事件 (Chrome trace 用)
+
+    static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool on);
+
+    // 注册 / 查找探针，同名返回同一个 id；超过 kMaxProbes 返回 -1 (之后记录直接忽略)
+    static int probe(const char *name);
+    static std::string probeName(int id);
+
+    // 与相机时间戳、状态流时间戳同一个时钟 (steadyNowNs)
+    static int64_t nowNs();
+
+    // 记录一段区间 [startNs, endNs]，写入当前线程的直方图和事件缓冲区 (调用方自己判断 enabled())
+    static void record(int probe, int64_t startNs, int64_t endNs);
+
+    // 给当前线程起名，导出 Chrome trace 时显示在线程轨道上
+    static void setThreadName(const std::string &name);
+
+    // 合并所有线程的数据 (只包含有记录的探针，按注册顺序)
+    static std::vector<ProbeStats> snapshot();
+    // 多行文本: 每个探针一行 p50 / p99 (界面覆盖层、基准程序输出共用)
+    static std::string summaryText();
+
+    // 清零统计 (以当前数据为基线，不动各线程的缓冲区，可以在记录的同时调用)
+    static void reset();
+
+    // 导出 Chrome trace JSON (chrome://tracing 或 Perfetto 打开)，包含各线程最近的事件和各探针统计
+    static bool writeChromeTrace(const std::string &path);
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+/**
+ * @brief RAII 计时: 构造时读时钟，析构时记录 (关闭时两端都不读时钟)
+ */
+class LatencyScope
+{
+public:
+    explicit LatencyScope(int probe)
+        : m_probe(probe), m_startNs(LatencyTrace::enabled() ? LatencyTrace::nowNs() : 0) {}
+    ~LatencyScope() {
+        if (m_startNs) LatencyTrace::record(m_probe, m_startNs, LatencyTrace::nowNs());
+    }
+
+    LatencyScope(const LatencyScope&) = delete;
+    LatencyScope& operator=(const LatencyScope&) = delete;
+
+private:
+    int m_probe;
+    int64_t m_startNs;
+};
+
+#define UR_TRACE_CONCAT_(a, b) a##b
+#define UR_TRACE_CONCAT(a, b) UR_TRACE_CONCAT_(a, b)
+
+#ifndef UR_TRACE_OFF
+// 统计当前作用域的耗时
+#define UR_TRACE_SCOPE(name) \
+    static const int UR_TRACE_CONCAT(urTraceProbe_, __LINE__) = LatencyTrace::probe(name); \
+    LatencyScope UR_TRACE_CONCAT(urTraceScope_, __LINE__)(UR_TRACE_CONCAT(urTraceProbe_, __LINE__))
+// 记录已有的两个时间戳之间的延迟 (如 采集时间戳 -> 显示)；关闭时参数不求值
+#define UR_TRACE_SPAN(name, startNs, endNs) \
+    do { \
+        if (LatencyTrace::enabled()) { \
+            static const int urTraceProbe_ = LatencyTrace::probe(name); \
+            LatencyTrace::record(urTraceProbe_, (startNs), (endNs)); \
+        } \
+    } while (0)
+#else
+#define UR_TRACE_SCOPE(name) do {} while (0)
+#define UR_TRACE_SPAN(name, startNs, endNs) do {} while (0)
+#endif
+
+#endif // LATENCYTRACE_H